@@ -0,0 +1,59 @@
+/**
+ * WM_Template.h
+ *
+ * precompiled html templates for the WiFiManager portal pages
+ * kept apart from WiFiManager.h so it builds and is tested without the wifi stack (env:native)
+ *
+ * @license MIT
+ */
+
+#ifndef WM_Template_h
+#define WM_Template_h
+
+#include <Arduino.h>
+
+#ifndef WM_TEMPLATE_PARTS
+#define WM_TEMPLATE_PARTS 32  // max literal spans + tokens in a precompiled template
+#endif
+
+/**
+ * html template precompiled into literal spans and {x} token slots
+ * parts point into the source texts (flash or ram), which must outlive the template
+ * rendering is a single pass over the parts, no copy or String::replace per item
+ */
+class WM_Template {
+  public:
+    struct Part {
+      PGM_P    str;     // literal span, or the "{x}" text of a token
+      uint16_t length;  // span length
+      char     token;   // token letter, 0 for a literal span
+    };
+
+    void          clear(){ _count = 0; }
+    void          append(PGM_P text); // parse text and add its parts after the current ones
+    bool          has(char token) const;
+    uint8_t       count() const { return _count; }
+    const Part&   part(uint8_t i) const { return _parts[i]; }
+
+    /**
+     * render in one pass, write(str, length) gets literal spans and token values in order
+     * value(token) returns the text for a token or NULL to keep the token as is
+     * token values are written verbatim, tokens inside a value are not expanded
+     */
+    template <typename Write, typename Value>
+    void render(Write write, Value value) const {
+      for(uint8_t i = 0; i < _count; i++){
+        const Part &p = _parts[i];
+        const char *v = p.token ? value(p.token) : NULL;
+        if(v != NULL) write(v, strlen(v));
+        else write(p.str, p.length);
+      }
+    }
+
+  private:
+    void          add(PGM_P str, uint16_t length, char token);
+    Part          _parts[WM_TEMPLATE_PARTS];
+    uint8_t       _count = 0;
+};
+
+#endif
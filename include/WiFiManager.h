@@ -21,6 +21,7 @@
 #endif
 
 #include <vector>
+#include <algorithm>
 
 // #define WM_MDNS            // includes MDNS, also set MDNS with sethostname
 // #define WM_FIXERASECONFIG  // use erase flash fix
@@ -28,6 +29,8 @@
 // #define WM_RTC             // esp32 info page will include reset reasons
 
 // #define WM_JSTEST                      // build flag for enabling js xhr tests
+// #define WM_INLINE_ASSETS               // build flag for inlining css/js in every page instead of the gzip R_css/R_js routes
+// #define WM_ASYNCWEBSERVER              // build flag for the event driven portal backend, esp-idf httpd and AsyncUDP dns (esp32)
 // #define WIFI_MANAGER_OVERRIDE_STRINGS // build flag for using own strings include
 
 #ifdef ARDUINO_ESP8266_RELEASE_2_3_0
@@ -65,6 +68,10 @@
 
 #define WM_G(string_literal)  (String(FPSTR(string_literal)).c_str())
 
+#ifndef WM_CHUNK_SIZE
+#define WM_CHUNK_SIZE 512     // portal pages are streamed as chunked output through a buffer of this size
+#endif
+
 #ifdef ESP8266
 
     extern "C" {
@@ -99,6 +106,10 @@
         #endif
     #endif
 
+    #ifdef WM_ASYNCWEBSERVER
+        #include "WiFiManagerAsync.h"
+    #endif
+
     #ifdef WM_ERASE_NVS
        #include <nvs.h>
        #include <nvs_flash.h>
@@ -131,7 +142,9 @@
 
 #include <DNSServer.h>
 #include <memory>
+#include <atomic>
 #include "strings_fr.h"
+#include "WM_Template.h"
 
 // prep string concat vars
 #define WM_STRING2(x) #x
@@ -221,6 +234,18 @@ class WiFiManagerParameter {
     friend class WiFiManager;
 };
 
+/**
+ * one wifi scan result, the table of these is built once per scan (sorted, duplicates removed)
+ * and reused by every page render until the next scan
+ */
+struct WM_ScanEntry {
+  uint32_t hash;     // ssid hash (fnv-1a), duplicate ssid key
+  uint8_t  index;    // index in the driver scan results, for WiFi.SSID()
+  int8_t   rssi;     // dBm
+  uint8_t  channel;
+  uint8_t  enc;      // encryption type
+};
+
 
 class WiFiManager
 {
@@ -475,13 +500,18 @@ class WiFiManager
     String        getWiFiHostname();
 
 
-    std::unique_ptr<DNSServer>        dnsServer;
-
-    #if defined(ESP32) && defined(WM_WEBSERVERSHIM)
+    #if defined(ESP32) && defined(WM_ASYNCWEBSERVER)
+        using WM_WebServer = WM_AsyncWebServer;
+        using WM_DNSServer = WM_AsyncDNSServer;
+    #elif defined(ESP32) && defined(WM_WEBSERVERSHIM)
         using WM_WebServer = WebServer;
+        using WM_DNSServer = DNSServer;
     #else
         using WM_WebServer = ESP8266WebServer;
+        using WM_DNSServer = DNSServer;
     #endif
+
+    std::unique_ptr<WM_DNSServer>     dnsServer;
     
     std::unique_ptr<WM_WebServer> server;
 
@@ -507,6 +537,16 @@ class WiFiManager
     int           _numNetworks            = 0; // init index for numnetworks wifiscans
     unsigned long _lastscan               = 0; // ms for timing wifi scans
     unsigned long _startscan              = 0; // ms for timing wifi scans
+    std::vector<WM_ScanEntry> _scanTable;          // cached scan results, strongest first
+    boolean       _scanTableStale         = true;  // a scan completed (or options changed) since the table was built
+
+    #if defined(ESP32) && defined(WM_ASYNCWEBSERVER)
+    // the route handlers run on the httpd task, the portal loop on the caller of startConfigPortal()/process():
+    // portal state (scan table and cache, save and exit flags, credentials, params) is only touched with this
+    // recursive mutex held, the portal loop releases it while it sleeps in waitRequest()
+    SemaphoreHandle_t _portalLock         = NULL;
+    std::atomic<int>  _scanDone{-1};               // async scan result posted by the wifi event task, -1 none
+    #endif
     unsigned long _startconn              = 0; // ms for timing wifi connects
 
     // defaults
@@ -636,6 +676,19 @@ class WiFiManager
     uint8_t       waitForConnectResult(uint32_t timeout);
     void          updateConxResult(uint8_t status);
 
+    // streamed page output, sent in chunks of WM_CHUNK_SIZE so page size never reaches the heap
+    char          _chunkBuf[WM_CHUNK_SIZE];
+    size_t        _chunkLen               = 0;
+    void          HTTPBegin();
+    void          HTTPWrite(const char *str, size_t len);
+    void          HTTPWrite(const char *str);
+    void          HTTPWrite(const __FlashStringHelper *str);
+    void          HTTPWrite(const String &str);
+    template <typename Value>
+    void          HTTPWriteTemplate(const WM_Template &tpl, Value value); // value(token) returns the text or NULL to keep the token
+    void          HTTPWriteHead(String title);
+    void          HTTPEnd();
+
     // webserver handlers
     void          HTTPSend(String content);
     void          handleRoot();
@@ -653,6 +706,7 @@ class WiFiManager
     void          handleRequest();
     void          handleParamSave();
     void          doParamSave();
+    void          handleAsset(const uint8_t *data, size_t len, PGM_P type, PGM_P etag);
 
     boolean       captivePortal();
     boolean       configPortalHasTimeout();
@@ -681,6 +735,19 @@ class WiFiManager
     bool          WiFi_scanNetworks(unsigned int cachetime,bool async);
     bool          WiFi_scanNetworks(unsigned int cachetime);
     void          WiFi_scanComplete(int networksFound);
+    void          WiFi_scanTable();
+    void          WiFi_scanCollect(); // apply an async scan result posted by the wifi event task
+
+    // portal lock, no-ops without WM_ASYNCWEBSERVER
+    void          portalLock();
+    void          portalUnlock();
+    class PortalLock {
+      public:
+        explicit PortalLock(WiFiManager *wm) : _wm(wm) { _wm->portalLock(); }
+        ~PortalLock() { _wm->portalUnlock(); }
+      private:
+        WiFiManager *_wm;
+    };
     bool          WiFiSetCountry();
 
     #ifdef ESP32
@@ -718,19 +785,18 @@ class WiFiManager
     #endif
     #endif
 
-    // output helpers
-    String        getParamOut();
-    String        getIpForm(String id, String title, String value);
-    String        getScanItemOut();
-    String        getStaticOut();
-    String        getHTTPHead(String title);
-    String        getMenuOut();
+    // output helpers, written to the current streamed page
+    void          writeParamOut();
+    void          writeIpForm(const WM_Template &tpl, const char *id, const char *title, const char *value);
+    void          writeScanItemOut();
+    void          writeStaticOut();
+    void          writeMenuOut();
     //helpers
     boolean       isIp(String str);
     String        toStringIp(IPAddress ip);
     boolean       validApPassword();
     String        encryptionTypeStr(uint8_t authmode);
-    void          reportStatus(String &page);
+    void          reportStatus();
     String        getInfoData(String id);
 
     // flags
@@ -0,0 +1,209 @@
+/**
+ * WiFiManagerAsync.h
+ *
+ * Event driven backend for the WiFiManager portal (esp32, WM_ASYNCWEBSERVER)
+ *
+ * WM_AsyncWebServer is the subset of the arduino WebServer api used by WiFiManager and its route
+ * callbacks, on top of the esp-idf httpd: the httpd task sleeps in select() on the listening and
+ * client sockets and runs the route handlers when a request is complete, so there is no
+ * handleClient() polling. Requests are served one at a time, several clients stay connected.
+ *
+ * WM_AsyncDNSServer is the captive portal dns (DNSServer api) on AsyncUDP, answered from the
+ * lwip receive callback instead of processNextRequest().
+ *
+ * handleClient() and processNextRequest() are kept as no-ops so WiFiManager runs unchanged on
+ * either backend.
+ *
+ * Handlers run on the httpd task while the portal loop runs on its own task: with a handler lock
+ * set, each request is served with that mutex held, so the owner of the state the handlers touch
+ * (WiFiManager) serializes its own work with them by holding the same mutex.
+ */
+
+#ifndef WiFiManagerAsync_h
+#define WiFiManagerAsync_h
+
+#if defined(ESP32) && defined(WM_ASYNCWEBSERVER)
+
+#include <Arduino.h>
+#include <WebServer.h>   // HTTPMethod, HTTPUpload, HTTPAuthMethod, CONTENT_LENGTH_*
+#include <DNSServer.h>   // DNSReplyCode
+#include <AsyncUDP.h>
+#include <esp_http_server.h>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#ifndef WM_ASYNC_STACK
+#define WM_ASYNC_STACK        8192  // httpd task stack, route handlers run on it
+#endif
+
+#ifndef WM_ASYNC_PRIORITY
+#define WM_ASYNC_PRIORITY     1     // httpd task priority, keep it under the acquisition tasks
+#endif
+
+#ifndef WM_ASYNC_MAX_BODY
+#define WM_ASYNC_MAX_BODY     4096  // largest form body (or multipart field) read into args
+#endif
+
+#ifndef WM_ASYNC_RESP_HEADERS
+#define WM_ASYNC_RESP_HEADERS 8     // sendHeader() slots per response
+#endif
+
+#ifndef WM_ASYNC_IDLE_MS
+#define WM_ASYNC_IDLE_MS      1000  // blocking portal loop wakeup without requests (timeout checks)
+#endif
+
+#ifndef WM_ASYNC_LOCK_POLL_MS
+#define WM_ASYNC_LOCK_POLL_MS 100   // handler lock wait slice, the httpd task checks for stop() between slices
+#endif
+
+// counters since begin(), the portal cpu share is busyMicros over the time since startMicros
+struct WM_AsyncStats {
+  uint32_t requests;     // requests served
+  uint64_t busyMicros;   // httpd task time spent serving them (body, handler, response)
+  uint64_t lockMicros;   // time requests waited for the handler lock
+  uint32_t wakeups;      // waitRequest() returns
+  uint32_t idleWakeups;  // of which timed out without a request
+  int64_t  startMicros;  // esp_timer time of begin()
+};
+
+class WM_AsyncWebServer;
+
+// what handlers use of WebServer::client()
+class WM_AsyncClient {
+  public:
+    explicit WM_AsyncClient(WM_AsyncWebServer *server) : _server(server) {}
+    IPAddress localIP();
+    IPAddress remoteIP();
+    void      stop();       // close the connection once the response is sent
+
+  private:
+    WM_AsyncWebServer *_server;
+};
+
+class WM_AsyncWebServer {
+  public:
+    typedef std::function<void(void)> THandlerFunction;
+
+    explicit WM_AsyncWebServer(int port = 80);
+    ~WM_AsyncWebServer();
+
+    void begin();
+    void stop();
+    void handleClient() {} // requests are served by the httpd task
+
+    // sleep until a request has been served, false on timeout
+    bool waitRequest(uint32_t ms);
+
+    // recursive mutex held around each request, owned by the caller (state shared with the handlers)
+    void setHandlerLock(SemaphoreHandle_t lock) { _lock = lock; }
+
+    WM_AsyncStats stats() const { return _stats; }
+
+    void on(const String &uri, THandlerFunction fn);
+    void on(const String &uri, HTTPMethod method, THandlerFunction fn);
+    void on(const String &uri, HTTPMethod method, THandlerFunction fn, THandlerFunction ufn);
+    void onNotFound(THandlerFunction fn);
+
+    // request
+    String      uri() { return _uri; }
+    HTTPMethod  method();
+    String      arg(const String &name);
+    String      arg(int i);
+    String      argName(int i);
+    int         args() { return _args.size(); }
+    bool        hasArg(const String &name);
+    String      header(const String &name);
+    bool        hasHeader(const String &name);
+    String      hostHeader() { return header(F("Host")); }
+    void        collectHeaders(const char *headerKeys[], const size_t headerKeysCount) {} // all headers are readable
+    HTTPUpload& upload() { return *_upload; }
+    WM_AsyncClient client() { return WM_AsyncClient(this); }
+
+    bool authenticate(const char *username, const char *password);
+    void requestAuthentication(HTTPAuthMethod mode = BASIC_AUTH, const char *realm = NULL, const String &authFailMsg = String(""));
+
+    // response
+    void sendHeader(const String &name, const String &value, bool first = false);
+    void setContentLength(const size_t contentLength) { _contentLength = contentLength; }
+    void send(int code, const char *content_type = NULL, const String &content = String(""));
+    void send(int code, const String &content_type, const String &content);
+    void send(int code, const char *content_type, const char *content);
+    void send(int code, const char *content_type, const char *content, size_t contentLength);
+    void send_P(int code, PGM_P content_type, PGM_P content);
+    void send_P(int code, PGM_P content_type, PGM_P content, size_t contentLength);
+    void sendContent(const String &content);
+    void sendContent(const char *content, size_t contentLength);
+    void sendContent_P(PGM_P content) { sendContent(content, strlen_P(content)); }
+
+  private:
+    friend class WM_AsyncClient;
+
+    struct Route {
+      String           uri;
+      HTTPMethod       method;
+      THandlerFunction fn;
+      THandlerFunction ufn;
+    };
+
+    struct Arg {
+      String name;
+      String value;
+    };
+
+    static esp_err_t _dispatch(httpd_req_t *req);
+    void  _handleRequest(httpd_req_t *req);
+    bool  _readBody(String &body);
+    bool  _readMultipart(const String &boundary, const Route *route);
+    void  _parseArgs(const char *str, size_t len);
+    int   _recv(char *buf, size_t len);
+
+    int                         _port;
+    httpd_handle_t              _handle = NULL;
+    SemaphoreHandle_t           _served = NULL;
+    SemaphoreHandle_t           _lock = NULL;
+    volatile bool               _stopping = false;
+    WM_AsyncStats               _stats = {};
+    std::vector<Route>          _routes;
+    THandlerFunction            _notFound;
+
+    // current request, only valid on the httpd task while a handler runs
+    httpd_req_t                *_req = NULL;
+    String                      _uri;
+    std::vector<Arg>            _args;
+    std::unique_ptr<HTTPUpload> _upload;
+    String                      _headerName[WM_ASYNC_RESP_HEADERS];
+    String                      _headerValue[WM_ASYNC_RESP_HEADERS];
+    uint8_t                     _headerCount = 0;
+    String                      _contentType;
+    char                        _status[32];
+    size_t                      _contentLength = CONTENT_LENGTH_NOT_SET;
+    bool                        _responded = false;
+    bool                        _chunked = false;
+    bool                        _close = false;
+};
+
+class WM_AsyncDNSServer {
+  public:
+    WM_AsyncDNSServer() {}
+    ~WM_AsyncDNSServer() { stop(); }
+
+    bool start(const uint16_t &port, const String &domainName, const IPAddress &resolvedIP);
+    void stop();
+    void processNextRequest() {} // queries are answered from the udp receive callback
+    void setErrorReplyCode(const DNSReplyCode &replyCode) { _errorReplyCode = (uint8_t)replyCode; }
+    void setTTL(const uint32_t &ttl) { _ttl = ttl; }
+
+  private:
+    void _reply(AsyncUDPPacket &packet);
+
+    AsyncUDP  _udp;
+    String    _domainName;
+    IPAddress _resolvedIP;
+    uint8_t   _errorReplyCode = (uint8_t)DNSReplyCode::NonExistentDomain;
+    uint32_t  _ttl = 60;
+};
+
+#endif
+
+#endif
@@ -0,0 +1,56 @@
+/**
+ * @file acquisition_adc.h
+ * @brief Moteur d'acquisition analogique continue (ADC1 en mode DMA) pour l'ESP32-S2.
+ *
+ * L'ADC échantillonne en arrière-plan toutes les voies déclarées ; le contrôleur DMA
+ * remplit un tampon que l'ordonnanceur vide périodiquement (drainerAdc). À chaque mesure,
+ * les échantillons reçus depuis la mesure précédente sont réduits par un filtre de décimation
+ * (moyenne, médiane ou moyenne tronquée) puis convertis et publiés dans le magasin de mesures.
+ *
+ * Ajouter un capteur analogique revient à déclarer une voie : pas de tâche supplémentaire.
+ */
+
+#ifndef ACQUISITION_ADC
+#define ACQUISITION_ADC
+
+#include <Arduino.h>
+#include "configuration.h"
+#include "mesures.h"
+
+// Filtre de décimation appliqué à la fenêtre d'échantillons d'une voie
+enum FiltreAdc : uint8_t {
+  FILTRE_MOYENNE = 0,
+  FILTRE_MEDIANE,
+  FILTRE_MOYENNE_TRONQUEE   // Moyenne après rejet de ADC_TRONCATURE_POURCENT de chaque côté
+};
+
+// Conversion d'une valeur brute 12 bits (0-4095) vers l'unité du canal
+typedef float (*ConversionAdc)(int valeurBrute);
+
+/**
+ * Déclare une voie analogique (avant demarrerAcquisitionAdc()).
+ * @param canalAdc Canal de l'ADC1 (0-9 sur ESP32-S2)
+ * @param canal Canal du magasin de mesures alimenté par la voie
+ * @param filtre Filtre de décimation
+ * @param conversion Conversion brute -> unité du canal
+ * @return Identifiant de la voie, ou -1 si la table est pleine.
+ */
+int ajouterVoieAdc(uint8_t canalAdc, CanalMesure canal, FiltreAdc filtre, ConversionAdc conversion);
+
+// Configure et démarre l'ADC en mode continu pour toutes les voies déclarées
+bool demarrerAcquisitionAdc();
+
+// Vide le tampon DMA dans les fenêtres des voies (travail périodique de l'ordonnanceur)
+void drainerAdc();
+
+/**
+ * Filtre les échantillons reçus depuis le dernier appel et publie la valeur convertie.
+ * Au plus ADC_FENETRE_ECHANTILLONS échantillons sont conservés : au-delà, les plus anciens sont écrasés.
+ * @param voie Identifiant retourné par ajouterVoieAdc()
+ * @param valeurBrute Valeur brute filtrée (sortie, pour le débogage)
+ * @param nbEchantillons Nombre d'échantillons filtrés (sortie)
+ * @return false si aucun échantillon n'a été reçu (le canal est alors invalidé).
+ */
+bool publierVoieAdc(int voie, int &valeurBrute, uint16_t &nbEchantillons);
+
+#endif
@@ -0,0 +1,97 @@
+/**
+ * @file alarmes.h
+ * @brief Alarmes de seuil et de défaut capteur, envoyées en voie prioritaire.
+ *
+ * Chaque échantillon publié dans le magasin de mesures est comparé au seuil de son canal :
+ * une alarme est levée au franchissement du seuil et close quand la valeur revient au-delà
+ * de l'hystérésis, ce qui évite les rafales autour du seuil ; elle est aussi close quand le
+ * portail désactive le canal ou change son seuil. Un travail périodique de
+ * l'ordonnanceur surveille aussi les capteurs : un canal sans échantillon valide neuf depuis
+ * ALARMES_DEFAUT_MS est en défaut, et l'alarme est close au premier échantillon valide.
+ *
+ * Les alarmes ne passent pas par le journal ni par la politique d'envoi : elles sont déposées
+ * dans une file FreeRTOS qui réveille immédiatement la tâche d'envoi. Celle-ci les publie avant
+ * tout lot du journal, sur une place de la fenêtre MQTT (ou du pipeline HTTP) qui leur est
+ * réservée, et les renvoie jusqu'à leur acquittement. La latence entre la détection et
+ * l'acquittement est mesurée ; le message porte aussi l'horodatage de la capture.
+ *
+ * Les seuils par défaut viennent du registre des capteurs ; le portail peut les modifier
+ * avec une chaîne "cle>seuil/hysteresis;cle<seuil/hysteresis;cle=off" (ex : "co2>1200/100").
+ */
+
+#ifndef ALARMES
+#define ALARMES
+
+#include <Arduino.h>
+#include "configuration.h"
+#include "mesures.h"
+
+// Seuil d'alarme d'un canal (défaut du registre, modifiable depuis le portail)
+struct SeuilAlarme {
+  bool actif;
+  bool superieur;            // Alarme au-dessus du seuil (sinon en dessous)
+  float seuil;               // Dans l'unité du canal
+  float hysteresis;          // Écart sous le seuil (au-dessus pour une alarme basse) qui clôt l'alarme
+};
+
+enum TypeAlarme : uint8_t {
+  ALARME_SEUIL = 0,          // Seuil franchi
+  ALARME_FIN_SEUIL,          // Retour au-delà de l'hystérésis
+  ALARME_DEFAUT,             // Capteur sans échantillon valide
+  ALARME_RETABLI,            // Capteur de nouveau valide
+  NB_TYPES_ALARME
+};
+
+// Événement d'alarme, de la détection à l'acquittement par le serveur
+struct EvenementAlarme {
+  CanalMesure canal;
+  TypeAlarme type;
+  float valeur;              // Valeur qui a déclenché l'événement (dernière valeur connue pour un défaut)
+  float seuil;
+  Horodatage capture;        // Instant de la capture (de la détection pour un défaut)
+  uint32_t detection_ms;     // millis() à la détection, pour la mesure de latence
+};
+
+// Compteurs depuis le démarrage
+struct StatsAlarmes {
+  uint32_t detectees;        // Événements déposés dans la file
+  uint32_t perdues;          // Dépôts refusés, file pleine (retentés à l'échantillon suivant)
+  uint32_t envoyees;         // Premiers envois
+  uint32_t renvois;          // Nouveaux envois après une perte de connexion
+  uint32_t acquittees;
+  uint32_t latenceMoyenne_ms;// Moyenne glissante entre la détection et l'acquittement
+  uint32_t latenceMax_ms;
+  uint32_t latenceDerniere_ms;
+};
+
+// Nom d'un type d'alarme dans les messages ("seuil", "fin_seuil", "defaut", "retabli")
+extern const char *const NOMS_ALARME[NB_TYPES_ALARME];
+
+// Charge les seuils par défaut du registre, crée la file et s'abonne aux publications (dans setup)
+void initAlarmes();
+
+/**
+ * Applique la configuration du portail. Une chaîne vide rétablit les défauts du registre ;
+ * une entrée invalide est ignorée (les autres sont appliquées).
+ * @return false si au moins une entrée était invalide.
+ */
+bool appliquerAlarmes(const char *alarmes);
+
+// Travail périodique de l'ordonnanceur : détection des capteurs en défaut
+void surveillerCapteurs();
+
+/**
+ * Attend le prochain événement d'alarme (tâche d'envoi).
+ * @return false si aucun événement n'est arrivé avant le délai.
+ */
+bool attendreAlarme(EvenementAlarme &alarme, uint32_t delai_ms);
+
+// Comptabilise l'envoi d'un événement (premier envoi ou renvoi)
+void noterEnvoiAlarme(bool renvoi);
+
+// Comptabilise l'acquittement d'un événement et sa latence depuis la détection
+void noterAcquittementAlarme(const EvenementAlarme &alarme);
+
+StatsAlarmes lireStatsAlarmes();
+
+#endif
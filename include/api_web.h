@@ -0,0 +1,32 @@
+/**
+ * @file api_web.h
+ * @brief Points d'accès en lecture du serveur web : /api/sensors, /api/history et /metrics.
+ *
+ * Les réponses sont lues dans le magasin de mesures (instantané sans verrou), l'historique RAM
+ * et les compteurs des modules, puis écrites directement dans la réponse, en fragments chunked,
+ * depuis un tampon fixe de API_TAMPON_REPONSE octets : ni String ni corps complet en RAM.
+ *
+ *   GET /api/sensors                 {"noeud":"...","horloge":"epoch","canaux":{"co2":{"valeur":612,"unite":"ppm","valide":true,"t":...},...}}
+ *   GET /api/history?ch=co2&since=N  {"canal":"co2","horloge":"epoch","echantillons":[[t,v],...],"suivant":M}
+ *                                    since : index absolu rendu par la réponse précédente (0 : tout l'historique)
+ *   GET /metrics                     format texte Prometheus 0.0.4 (mesures, fenêtres, journal, alarmes, baseline SGP30, charge du portail, nœud)
+ *
+ * Les routes sont ajoutées au serveur du portail ; avec API_SERVEUR_PERMANENT, la tâche WiFi ouvre
+ * en mode station un serveur qui ne porte que ces routes (les pages de configuration, l'OTA et
+ * l'effacement ne sont servis que par le portail).
+ */
+
+#ifndef API_WEB
+#define API_WEB
+
+#include <Arduino.h>
+#include "WiFiManager.h"
+#include "configuration.h"
+
+// Serveur du portail : WebServer Arduino, ou serveur httpd événementiel avec WM_ASYNCWEBSERVER
+using ServeurWeb = WiFiManager::WM_WebServer;
+
+// Ajoute les routes de l'API au serveur (rappel de création du serveur du portail)
+void ajouterRoutesApi(ServeurWeb &serveur);
+
+#endif
@@ -0,0 +1,107 @@
+/**
+ * @file client_http.h
+ * @brief Client d'ingestion HTTP/1.1 : connexion persistante, corps en chunked, requêtes pipelinées.
+ *
+ * Transport de repli pour les sites sans broker MQTT. Une seule connexion TCP est gardée ouverte
+ * d'un lot à l'autre (keep-alive). Le corps de chaque POST est envoyé en
+ * `Transfer-Encoding: chunked`, fragment par fragment, à partir d'une source fournie par
+ * l'appelant : aucun corps complet n'est construit en RAM. Jusqu'à HTTP_PIPELINE requêtes sont
+ * envoyées sans attendre les réponses, qui arrivent dans l'ordre (pipelining HTTP/1.1) ; le
+ * débit est plafonné à HTTP_REQUETES_PAR_S requêtes par seconde.
+ *
+ * Contrairement à MQTT, le client ne garde pas de copie des corps : si la connexion tombe ou si
+ * le serveur répond une erreur, la connexion est fermée et les requêtes sans réponse sont
+ * perdues ; l'appelant les reconstruit depuis sa source (journal). Une réponse d'erreur est
+ * signalée avec son statut (surRefus) pour que l'appelant espace ses reprises et écarte un
+ * corps que le serveur refusera toujours.
+ */
+
+#ifndef CLIENT_HTTP
+#define CLIENT_HTTP
+
+#include <Arduino.h>
+#include <Client.h>
+#include "configuration.h"
+
+// Compteurs du client (débit et latence mesurables contre un serveur local)
+struct StatsHttp {
+  uint32_t connexions;       // Connexions TCP ouvertes
+  uint32_t echecsConnexion;  // Connexions TCP refusées
+  uint32_t requetes;         // POST envoyés en entier
+  uint32_t reponsesOk;       // Réponses 2xx
+  uint32_t reponsesErreur;   // Autres réponses, réponses illisibles ou hors délai
+  uint32_t octetsCorps;      // Octets de corps envoyés (hors en-têtes et tailles de fragments)
+  uint32_t latenceMoyenne_ms;// Moyenne glissante entre la fin d'envoi d'une requête et sa réponse
+  uint32_t latenceMax_ms;
+};
+
+// Source du corps : fournit le fragment suivant (pointeur valable jusqu'à l'appel suivant), 0 à la fin
+typedef size_t (*SourceCorps)(const uint8_t **donnees);
+
+// Rappel appelé à la réception d'une réponse 2xx, avec le jeton fourni à envoyer()
+typedef void (*RappelReponse)(uint32_t jeton);
+
+// Rappel appelé à la réception d'une réponse non 2xx, avec le jeton et le statut HTTP
+typedef void (*RappelRefus)(uint32_t jeton, int statut);
+
+class ClientHttp {
+public:
+  explicit ClientHttp(Client &transport) : transport(transport) {}
+
+  /**
+   * Ouvre la connexion TCP ; les requêtes suivantes la réutilisent tant que le serveur la garde.
+   * Si un utilisateur est fourni, les requêtes portent une authentification Basic.
+   * @return false si la connexion échoue, ou si l'hôte ou les identifiants ne tiennent pas dans les en-têtes.
+   */
+  bool connecter(const char *hote, uint16_t port, const char *utilisateur, const char *motDePasse);
+
+  void deconnecter();
+
+  bool connecte();
+
+  /**
+   * Envoie un POST dont le corps est lu fragment par fragment dans `source`, en chunked.
+   * @return false si l'envoi a échoué (connexion fermée) ; true si la requête est en attente de réponse.
+   */
+  bool envoyer(const char *chemin, const char *typeContenu, SourceCorps source, uint32_t jeton);
+
+  // Lit les réponses reçues et ferme la connexion si la plus ancienne requête attend depuis trop longtemps
+  void traiter();
+
+  // Requêtes qui peuvent être envoyées maintenant (place dans le pipeline et plafond de débit,
+  // sauf pour une requête prioritaire : alarme)
+  size_t placesLibres(bool prioritaire = false);
+
+  // Requêtes envoyées sans réponse
+  size_t enVol() const { return nbEnVol; }
+
+  void surReponse(RappelReponse rappel) { rappelReponse = rappel; }
+
+  void surRefus(RappelRefus rappel) { rappelRefus = rappel; }
+
+  const StatsHttp &lireStats() const { return stats; }
+
+private:
+  // Requête envoyée, en attente de sa réponse (file dans l'ordre d'envoi)
+  struct RequeteEnVol {
+    uint32_t jeton;
+    uint32_t envoi_ms;
+  };
+
+  bool ecrire(const void *donnees, size_t longueur);
+  bool lireLigne(char *ligne, size_t taille);
+  bool lireReponse();
+
+  Client &transport;
+  char hote[HTTP_TAILLE_HOTE] = ""; // Valeur de l'en-tête Host (hôte:port)
+  char autorisation[120] = "";      // En-tête Authorization complet, ou vide
+  RequeteEnVol enAttente[HTTP_PIPELINE] = {};
+  size_t premier = 0;
+  size_t nbEnVol = 0;
+  uint32_t derniereRequete_ms = 0;
+  RappelReponse rappelReponse = nullptr;
+  RappelRefus rappelRefus = nullptr;
+  StatsHttp stats = {};
+};
+
+#endif
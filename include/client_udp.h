@@ -0,0 +1,83 @@
+/**
+ * @file client_udp.h
+ * @brief Publication UDP sans connexion : un datagramme par lot, numéro de séquence, trame CoAP NON optionnelle.
+ *
+ * Mode "tirer et oublier" pour les déploiements denses où une perte occasionnelle est acceptable :
+ * ni poignée de main, ni acquittement, ni état de connexion. Un lot part en un seul datagramme
+ * dès que la radio est prête, et la radio peut se rendormir juste après. Le client ne dépend que
+ * de l'interface Arduino `UDP` (WiFiUDP sur la cible, socket UDP sur PC pour les essais contre
+ * un puits local).
+ *
+ * Trame brute : numéro de séquence sur 4 octets (gros-boutiste), puis la charge.
+ * Trame CoAP (RFC 7252) : POST non confirmable (NON), identifiant de message = 16 bits de poids
+ * faible de la séquence, jeton de 4 octets = séquence complète, options Uri-Path et
+ * Content-Format, marqueur 0xFF, puis la charge.
+ * Le récepteur compte les pertes sur les trous de la séquence (remise à zéro au démarrage du nœud).
+ */
+
+#ifndef CLIENT_UDP
+#define CLIENT_UDP
+
+#include <Arduino.h>
+#include <Udp.h>
+#include "configuration.h"
+
+// Compteurs du client
+struct StatsUdp {
+  uint32_t datagrammes;      // Datagrammes remis à la pile réseau
+  uint32_t echecs;           // Datagrammes refusés par la pile (tampon plein, pas de route...)
+  uint32_t octets;           // Octets de datagrammes envoyés (en-têtes de trame compris)
+  uint32_t dureeMoyenne_us;  // Moyenne glissante de la durée d'un envoi (de beginPacket à endPacket)
+  uint32_t dureeMax_us;
+};
+
+// Trame d'un datagramme
+enum TrameUdp : uint8_t {
+  TRAME_BRUTE = 0,           // Séquence + charge
+  TRAME_COAP                 // Message CoAP NON
+};
+
+// Format de la charge (numéros Content-Format CoAP)
+enum FormatContenu : uint16_t {
+  CONTENU_JSON = 50,
+  CONTENU_CBOR = 60
+};
+
+class ClientUdp {
+public:
+  explicit ClientUdp(UDP &transport) : transport(transport) {}
+
+  // Fixe la destination (adresse déjà résolue) et la trame ; aucun paquet n'est échangé
+  void configurer(IPAddress adresse, uint16_t port, TrameUdp trame);
+
+  // Vrai si une destination a été fixée
+  bool configure() const { return port != 0; }
+
+  // Oublie la destination (adresse à résoudre de nouveau) ; la séquence des trames continue
+  void oublier() { port = 0; }
+
+  /**
+   * Envoie un datagramme, sans renvoi. `chemin` ("/mesures"...) donne les options Uri-Path de
+   * la trame CoAP ; il est ignoré en trame brute.
+   * @return false si la charge est trop longue ou si la pile réseau a refusé le datagramme.
+   */
+  bool envoyer(const char *chemin, FormatContenu format, const uint8_t *charge, size_t longueur);
+
+  // Longueur maximale de la charge d'un datagramme (UDP_TAILLE_DATAGRAMME moins l'en-tête de trame)
+  size_t chargeMax(const char *chemin) const;
+
+  const StatsUdp &lireStats() const { return stats; }
+
+private:
+  // Écrit l'en-tête de trame du prochain datagramme ; 0 si le chemin ne tient pas
+  size_t ecrireEnTete(uint8_t *enTete, size_t taille, const char *chemin, FormatContenu format) const;
+
+  UDP &transport;
+  IPAddress adresse;
+  uint16_t port = 0;
+  TrameUdp trame = TRAME_BRUTE;
+  uint32_t sequence = 0;
+  StatsUdp stats = {};
+};
+
+#endif
@@ -10,14 +10,137 @@
  * Selection des périphériques d'entrées/sorties
  */
 
+// Capteurs compilés dans le projet (0 = pilote, frames et champs d'envoi retirés, voir registre_capteurs.h)
+#define CAPTEUR_DHT22_ACTIF          1  // Température/humidité DHT22
+#define CAPTEUR_SGP30_ACTIF          1  // eCO2/TVOC SGP30
+#define CAPTEUR_LUMINOSITE_ACTIF     1  // Luminosité Grove
+
 // Définition des broches
 #define CONFIG_PIN                  0  // broche boot ; si appui alors niveau 0
 #define TEMPHUM_PIN                38  // Broche DHT22 (capteur température/humidité)
-#define DHTTYPE                  DHT22  // Type de capteur DHT
+#define DHT22_RMT_CANAL              0  // Canal RMT qui capture la trame du DHT22
 #define TEMPHUM_INTERVAL_MS      4000  // Intervale de temps de la boucle infinie du capteur temp/hum en ms 
 #define CO2_INTERVAL_MS           1000  // Intervale de temps de la boucle infinie du capteur CO2 en ms (1s recommandé pour SGP30)
+#define SGP30_BANDE_MORTE_TEMP_DIXIEMES    2  // Variation de température (0,1 °C) qui déclenche une nouvelle compensation
+#define SGP30_BANDE_MORTE_HUM_DIXIEMES     5  // Variation d'humidité (0,1 %) qui déclenche une nouvelle compensation
+#define SGP30_DIAGNOSTIC_INTERVAL_MS   30000  // Intervalle des valeurs brutes et du rapport de cadence en ms
+#define SGP30_BASELINE_INTERVAL_MS     60000  // Intervalle de gestion de la baseline IAQ (restauration/sauvegarde) en ms
+#define SGP30_BASELINE_SAUVEGARDE_S     3600  // Intervalle de sauvegarde de la baseline en NVS en s
+#define SGP30_BASELINE_CALIBRATION_S   43200  // Durée de fonctionnement avant une baseline fiable sans restauration (12 h)
+#define SGP30_BASELINE_AGE_MAX_S      604800  // Âge maximal d'une baseline restaurée (7 jours, datasheet SGP30)
 #define LUMINOSITE_PIN               1  // Broche analogique pour le capteur de luminosité Grove Light Sensor
 #define LUMINOSITE_INTERVAL_MS    2000  // Intervale de temps de la boucle infinie du capteur luminosité en ms 
+#define LUMINOSITE_ADC_CANAL         0  // Canal de l'ADC1 de LUMINOSITE_PIN (GPIO1 = ADC1_CH0 sur ESP32-S2)
+
+/**
+ * BUS I2C (une seule tâche propriétaire, partagé par l'OLED et le SGP30)
+ */
+#define I2C_SDA_PIN                  8  // Broche SDA du bus I2C
+#define I2C_SCL_PIN                  9  // Broche SCL du bus I2C
+#define I2C_FREQUENCE_HZ        400000  // Horloge du bus (mode rapide, supporté par le SSD1306 et le SGP30)
+#define I2C_FILE_PROFONDEUR          8  // Transactions en attente par priorité
+#define I2C_DELAI_FILE_MS          100  // Attente maximale d'une place dans la file en ms
+#define I2C_ECHECS_AVANT_REINIT      3  // Erreurs de bus consécutives avant redémarrage du contrôleur
+#define I2C_RAPPORT_MS           60000  // Intervalle d'affichage des statistiques du bus en ms
+#define SGP30_ADRESSE             0x58  // Adresse I2C du SGP30
+#define OLED_ADRESSE              0x3c  // Adresse I2C de l'écran SSD1306
+#define OLED_OCTETS_PAR_TRANSACTION 32  // Octets d'image par transaction : une mesure n'attend qu'un fragment
+
+/**
+ * ACQUISITION ANALOGIQUE CONTINUE (ADC1 en mode DMA)
+ */
+#define ADC_FREQUENCE_HZ          1000  // Fréquence d'échantillonnage totale (répartie entre les voies)
+#define ADC_VIDAGE_INTERVAL_MS     250  // Intervalle de vidage du tampon DMA par l'ordonnanceur en ms
+#define ADC_FENETRE_ECHANTILLONS  2048  // Échantillons filtrés par voie et par mesure au plus (au-delà, seuls les derniers sont gardés)
+#define ADC_NB_VOIES                 2  // Nombre maximal de voies analogiques (fenêtre de 4 Ko chacune)
+#define ADC_TRONCATURE_POURCENT     10  // Part rejetée de chaque côté pour la moyenne tronquée
+
+/**
+ * ORDONNANCEUR DES ACQUISITIONS (une seule tâche pour tous les capteurs)
+ */
+#define ORDONNANCEUR_RESOLUTION_MS   50  // Résolution de la roue temporelle en ms
+#define ORDONNANCEUR_NB_ALVEOLES     64  // Nombre d'alvéoles de la roue
+#define ORDONNANCEUR_NB_TRAVAUX      12  // Nombre maximal de travaux périodiques
+#define ORDONNANCEUR_RAPPORT_MS   60000  // Intervalle d'affichage des statistiques de retard en ms
+
+/**
+ * HISTORIQUE DES MESURES (RAM)
+ */
+#define HISTORIQUE_PROFONDEUR      256  // Nombre d'échantillons conservés par canal (tampon circulaire)
+#define HISTORIQUE_NB_TRANCHES      30  // Nombre de tranches par fenêtre glissante (1 min, 15 min, 1 h)
+
+/**
+ * ENVOI MQTT (session persistante, publication QoS 1 par lots du journal flash)
+ */
+#define MQTT_PORT_DEFAUT          1883  // Port utilisé si le portail n'en fournit pas
+#define MQTT_KEEPALIVE_S            60  // Keep-alive de la session en s
+#define MQTT_FENETRE                 4  // Messages QoS 1 en vol (non acquittés) au maximum
+#define MQTT_TAILLE_MESSAGE       2048  // Taille maximale d'un lot en octets
+#define MQTT_TAILLE_SUJET           64  // Longueur maximale d'un sujet
+#define MQTT_DELAI_CONNEXION_MS   3000  // Attente maximale du CONNACK en ms
+#define ENVOI_RECONNEXION_MIN_MS   1000  // Premier délai avant une nouvelle tentative de connexion
+#define ENVOI_RECONNEXION_MAX_MS  60000  // Délai maximal entre deux tentatives (doublé à chaque échec)
+#define ENVOI_BOUCLE_MS            100  // Période de la boucle de la tâche d'envoi en ms
+#define ENVOI_ECHANTILLONS_PAR_LOT 256  // Échantillons du journal par message au maximum (réduit si le message déborde)
+#define ENVOI_FORMAT_CBOR            1  // 1 : lot binaire delta/varint en enveloppe CBOR (sujet .../mesures/cbor), 0 : JSON
+#define ENVOI_SEUIL_VIDAGE        1024  // Échantillons en attente qui déclenchent un vidage sans attendre de rapport
+
+/**
+ * ENVOI HTTP (repli sans broker : adresse du serveur saisie en "http://hote[:port]/chemin")
+ */
+#define HTTP_PORT_DEFAUT            80  // Port utilisé si le portail n'en fournit pas
+#define HTTP_CHEMIN_DEFAUT   "/mesures"  // Chemin du POST si l'adresse n'en contient pas
+#define HTTP_PIPELINE                4  // Requêtes envoyées sans réponse au maximum
+#define HTTP_REQUETES_PAR_S          2  // Plafond de débit des requêtes
+#define HTTP_DELAI_REPONSE_MS     5000  // Attente maximale d'une réponse avant de fermer la connexion
+#define HTTP_ECHANTILLONS_PAR_REQUETE 2048  // Échantillons du journal par requête au maximum
+#define HTTP_ECHANTILLONS_PAR_FRAGMENT  64  // Échantillons encodés par fragment chunked
+#define HTTP_TAILLE_HOTE            86  // En-tête Host : adresse du portail (79 caractères) + ":65535" + zéro final
+#define HTTP_REFUS_MAX               5  // Refus définitifs (4xx) d'un même lot avant de l'écarter du journal
+
+/**
+ * ENVOI UDP (sans connexion ni acquittement : adresse saisie en "udp://hote[:port]/chemin" ou "coap://...")
+ */
+#define UDP_PORT_DEFAUT           5700  // Port du puits en trame brute si le portail n'en fournit pas
+#define COAP_PORT_DEFAUT          5683  // Port CoAP standard
+#define UDP_TAILLE_DATAGRAMME     1200  // Taille maximale d'un datagramme (sous le MTU : pas de fragmentation IP)
+#define UDP_DATAGRAMMES_PAR_TOUR     8  // Datagrammes envoyés par tour de la tâche d'envoi au maximum
+#define UDP_RESOLUTION_MS       600000  // Âge maximal de l'adresse résolue avant une nouvelle résolution (10 min)
+
+/**
+ * API WEB (serveur du portail gardé actif en mode station : /api/sensors, /api/history, /metrics)
+ */
+#define API_SERVEUR_PERMANENT        1  // 1 : API en lecture servie en mode station après le portail, 0 : seulement pendant le portail
+#define API_TAMPON_REPONSE         512  // Tampon d'écriture des réponses, envoyé en fragments chunked
+#define API_BOUCLE_MS               10  // Période de traitement des requêtes par la tâche WiFi quand le serveur est actif (sans WM_ASYNCWEBSERVER)
+
+/**
+ * STATISTIQUES EN FLUX (nombre, min, max, moyenne, écart-type, p50 et p95 par canal et par fenêtre)
+ */
+#define STATISTIQUES_FENETRE_S        300  // Durée d'une fenêtre de statistiques en s (fenêtres consécutives)
+
+/**
+ * POLITIQUE D'ENVOI SUR CHANGEMENT (bandes mortes et intervalles par canal : registre_capteurs.h)
+ */
+#define RAPPORT_HEARTBEAT_S          3600  // Période du heartbeat par défaut (rapport même sans changement), en s
+#define RAPPORT_DELAI_HEARTBEAT_MS  10000  // Attente maximale des échantillons de tous les canaux avant le rapport heartbeat
+
+/**
+ * ALARMES (seuils et hystérésis par canal : registre_capteurs.h, envoi en voie prioritaire)
+ */
+#define ALARMES_VERIFICATION_MS      1000  // Période de la surveillance des capteurs par l'ordonnanceur
+#define ALARMES_DEFAUT_MS           30000  // Durée sans échantillon valide neuf qui met un canal en défaut
+#define ALARMES_FILE_PROFONDEUR         8  // Événements en attente de la tâche d'envoi
+#define ALARMES_EN_ATTENTE              8  // Événements conservés par la tâche d'envoi jusqu'à leur acquittement
+#define ALARMES_PLACES_RESERVEES        1  // Places de la fenêtre MQTT / du pipeline HTTP interdites aux lots du journal
+
+/**
+ * JOURNAL FLASH (stockage des échantillons en attente d'envoi, partition SPIFFS)
+ */
+#define JOURNAL_NB_SEGMENTS                24  // Segments conservés au maximum (le plus ancien est évincé)
+#define JOURNAL_ENREGISTREMENTS_PAR_SEGMENT 2048  // Enregistrements de 16 octets par segment (32 Ko)
+#define JOURNAL_FILE_PROFONDEUR            64  // Échantillons en attente d'écriture en flash
+#define JOURNAL_PERSISTANCE_CURSEUR_MS  30000  // Intervalle minimal entre deux sauvegardes du curseur en NVS
 
 /**
  * TIME NTP
@@ -25,8 +148,6 @@
 
 #define NTP_SERVER "fr.pool.ntp.org"
 
-#define NTP_UPDATE_INTERVAL_MS      6000  // en ms
-
 /**
  * WIFI 
  */
@@ -0,0 +1,46 @@
+/**
+ * @file dht22_rmt.h
+ * @brief Pilote DHT22 non bloquant basé sur le périphérique RMT de l'ESP32-S2.
+ *
+ * Le protocole 1 fil du DHT22 est capturé par le RMT (horodatage matériel des fronts,
+ * résolution 1 µs) au lieu d'être lu bit à bit avec les interruptions masquées.
+ * Température et humidité sont décodées à partir d'une seule trame de 40 bits.
+ */
+
+#ifndef DHT22_RMT
+#define DHT22_RMT
+
+#include <Arduino.h>
+
+// Résultat d'une lecture ou d'un décodage de trame
+enum ResultatDht22 : uint8_t {
+  DHT22_OK = 0,
+  DHT22_ERREUR_DELAI,      // Aucune trame reçue (capteur absent ou débranché)
+  DHT22_ERREUR_TRAME,      // Nombre d'impulsions ou durées incohérentes
+  DHT22_ERREUR_SOMME       // Somme de contrôle invalide
+};
+
+// Valeurs décodées d'une trame
+struct TrameDht22 {
+  float temperature;   // °C
+  float humidite;      // % d'humidité relative
+};
+
+// Nombre de bits d'une trame DHT22 (16 bits humidité, 16 bits température, 8 bits somme)
+#define DHT22_NB_BITS 40
+
+/**
+ * Décode une trame à partir des durées (µs) des impulsions à l'état haut, dans l'ordre de réception.
+ * Les DHT22_NB_BITS dernières impulsions hautes sont les bits de données (0 ≈ 27 µs, 1 ≈ 70 µs) ;
+ * les impulsions précédentes (relâchement de la ligne, réponse du capteur) sont ignorées.
+ * Fonction pure, sans dépendance matérielle.
+ */
+ResultatDht22 decoderTrameDht22(const uint16_t dureesHautes[], size_t nb, TrameDht22 &trame);
+
+// Configure le canal RMT en réception sur la broche du DHT22
+bool initDht22Rmt(uint8_t broche, uint8_t canalRmt);
+
+// Envoie l'impulsion de démarrage, capture la trame par le RMT puis la décode
+ResultatDht22 lireDht22(TrameDht22 &trame);
+
+#endif
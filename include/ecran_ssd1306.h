@@ -0,0 +1,32 @@
+/**
+ * @file ecran_ssd1306.h
+ * @brief Écran SSD1306 de la bibliothèque OLEDDisplay raccordé à l'arbitre du bus I2C.
+ *
+ * Remplace SSD1306Wire, qui accède directement à Wire. Les commandes et l'image passent
+ * par la file basse priorité de l'arbitre ; l'image est découpée en transactions de
+ * OLED_OCTETS_PAR_TRANSACTION octets pour que les mesures puissent s'intercaler.
+ */
+
+#ifndef ECRAN_SSD1306
+#define ECRAN_SSD1306
+
+#include <Arduino.h>
+#include "OLEDDisplay.h"
+
+class EcranSsd1306 : public OLEDDisplay {
+public:
+  EcranSsd1306(uint8_t adresse, OLEDDISPLAY_GEOMETRY geometrie = GEOMETRY_128_64);
+
+  // Envoie les octets modifiés de l'image depuis le dernier envoi complet (renvoyés après une erreur de bus)
+  void display(void) override;
+
+private:
+  uint8_t adresse;
+
+  // Le bus est initialisé et détenu par la tâche du bus I2C
+  bool connect() override { return true; }
+  int getBufferOffset(void) override { return 0; }
+  void sendCommand(uint8_t commande) override;
+};
+
+#endif
@@ -0,0 +1,44 @@
+/**
+ * @file encodage_lot.h
+ * @brief Encodage binaire compact d'un lot d'échantillons (delta-of-delta + varint, enveloppe CBOR).
+ *
+ * Trame binaire (version 2) :
+ *   - 1 octet d'en-tête : version sur les 4 bits de poids fort, bit 0 = horodatages epoch (sinon ms depuis le démarrage) ;
+ *   - puis une section par série (canal et nature de valeur) présente dans le lot :
+ *       série (1 octet : CanalMesure sur les 4 bits de poids faible, NatureValeur sur les 4 bits de
+ *       poids fort, 0 pour les échantillons bruts), décimales (1 octet), nombre n (varint),
+ *       horodatage du 1er échantillon en ms (varint), valeur entière du 1er échantillon (zigzag varint),
+ *       puis pour chacun des n-1 suivants : delta-of-delta de l'horodatage, delta de la valeur (zigzag varint).
+ * Les valeurs sont mises à l'échelle en entiers (valeur × 10^décimales du registre des capteurs,
+ * 0 décimale pour le nombre d'échantillons d'une fenêtre).
+ * Pour un canal échantillonné à période fixe, un échantillon tient le plus souvent en 2 octets.
+ *
+ * L'enveloppe CBOR optionnelle est une table {"id": IOTName, "mac": octets(6), "lot": octets(trame)}
+ * lisible par n'importe quel décodeur CBOR. L'encodage écrit directement dans le tampon de
+ * l'appelant : ni String ni allocation dynamique.
+ */
+
+#ifndef ENCODAGE_LOT
+#define ENCODAGE_LOT
+
+#include <Arduino.h>
+#include "journal.h"
+
+#define ENCODAGE_LOT_VERSION 2
+
+// Identité du nœud portée par l'enveloppe CBOR
+struct IdentiteNoeud {
+  const char *nom;       // IOTName
+  uint8_t mac[6];        // Adresse MAC WiFi
+};
+
+/**
+ * Encode les enregistrements d'un lot (regroupés par canal dans l'ordre du registre, puis par nature).
+ * Les enregistrements corrompus (JOURNAL_CANAL_CORROMPU) ou de canaux inactifs sont ignorés.
+ * @param identite Identité du nœud pour l'enveloppe CBOR, ou NULL pour la trame binaire seule
+ * @return Nombre d'octets écrits, 0 si le tampon est trop petit.
+ */
+size_t encoderLot(const EnregistrementJournal enregistrements[], size_t nb, bool epoch,
+                  const IdentiteNoeud *identite, uint8_t *tampon, size_t taille);
+
+#endif
@@ -0,0 +1,58 @@
+/**
+ * @file historique.h
+ * @brief Historique RAM des mesures par canal et agrégats sur fenêtres glissantes.
+ *
+ * Chaque canal du magasin de mesures dispose d'un tampon circulaire de taille fixe
+ * (HISTORIQUE_PROFONDEUR échantillons, sans allocation dynamique) et de trois fenêtres
+ * glissantes (1 min, 15 min, 1 h) dont le min, le max, la moyenne et la variance sont
+ * maintenus à chaque ajout. La lecture d'un agrégat ne reparcourt jamais le tampon.
+ */
+
+#ifndef HISTORIQUE
+#define HISTORIQUE
+
+#include <Arduino.h>
+#include "configuration.h"
+#include "mesures.h"
+
+// Fenêtres glissantes disponibles
+enum FenetreHistorique : uint8_t {
+  FENETRE_1MIN = 0,
+  FENETRE_15MIN,
+  FENETRE_1H,
+  NB_FENETRES
+};
+
+// Un échantillon conservé dans l'historique
+struct EchantillonHistorique {
+  uint32_t horodatage;   // millis() au moment de la capture
+  float valeur;
+};
+
+// Agrégat d'une fenêtre glissante
+struct AgregatFenetre {
+  uint32_t nombre;       // Nombre d'échantillons dans la fenêtre (0 = agrégat vide)
+  float min;
+  float max;
+  float moyenne;
+  float variance;        // Variance de population
+};
+
+// Ajoute un échantillon à l'historique du canal (appelé par le magasin de mesures)
+void ajouterHistorique(CanalMesure canal, uint32_t horodatage, float valeur);
+
+// Lit l'agrégat courant d'une fenêtre ; retourne false si la fenêtre est vide
+bool lireAgregat(CanalMesure canal, FenetreHistorique fenetre, AgregatFenetre &agregat);
+
+// Index absolu du prochain échantillon du canal (nombre total d'échantillons ajoutés)
+uint32_t indexHistorique(CanalMesure canal);
+
+/**
+ * Copie les échantillons du canal à partir de l'index absolu `depuis`.
+ * Si une partie a déjà été écrasée, la copie commence au plus ancien échantillon encore présent.
+ * `suivant` reçoit l'index à passer au prochain appel. Retourne le nombre d'échantillons copiés.
+ */
+size_t copierHistorique(CanalMesure canal, uint32_t depuis, EchantillonHistorique *destination,
+                        size_t max, uint32_t &suivant);
+
+#endif
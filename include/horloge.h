@@ -0,0 +1,62 @@
+/**
+ * @file horloge.h
+ * @brief Service d'heure : horodatages en ms depuis 1970, à partir du compteur monotone.
+ *
+ * L'heure courante est le compteur monotone esp_timer plus un décalage calé à chaque
+ * synchronisation SNTP : une lecture coûte une lecture de compteur et une addition, sans
+ * gettimeofday ni conversion de date. Tant que l'heure n'est pas synchronisée, les horodatages
+ * sont en ms depuis le démarrage (champ epoch à false) ; un horodatage pris avant la
+ * synchronisation peut être converti ensuite, tant que le module n'a pas redémarré.
+ *
+ * Les textes d'affichage (OLED...) sont des vues formatées à la demande, seulement quand la
+ * minute affichée change.
+ */
+
+#ifndef HORLOGE
+#define HORLOGE
+
+#include <Arduino.h>
+#include <time.h>
+
+// Instant d'un échantillon ou d'un événement
+struct Horodatage {
+  int64_t ms;        // ms depuis 1970 si epoch, sinon ms depuis le démarrage
+  bool epoch;        // true si l'horloge était synchronisée par NTP
+};
+
+// S'abonne aux synchronisations SNTP (dans setup, avant configTime)
+void initHorloge();
+
+// Instant courant
+Horodatage lireHorodatage();
+
+// true si l'heure a été synchronisée au moins une fois depuis le démarrage
+bool horlogeSynchronisee();
+
+/**
+ * Convertit en epoch un horodatage relatif au démarrage, si l'heure est maintenant connue.
+ * @return true si l'horodatage est (ou était déjà) en epoch.
+ */
+bool convertirEpoch(Horodatage &horodatage);
+
+/**
+ * Formate un horodatage en heure locale (strftime).
+ * @return Longueur écrite ; 0 et texte vide si l'horodatage n'est pas en epoch.
+ */
+size_t formaterHorodatage(const Horodatage &horodatage, const char *format, char *tampon, size_t taille);
+
+// Texte de l'heure locale courante, reformaté seulement quand la minute change
+class VueHorloge {
+public:
+  explicit VueHorloge(const char *format) : format(format) {}
+
+  // Texte à afficher (vide tant que l'heure n'est pas synchronisée)
+  const char *texte();
+
+private:
+  const char *format;
+  int64_t minute = -1;
+  char tampon[24] = "";
+};
+
+#endif
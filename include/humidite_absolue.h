@@ -0,0 +1,26 @@
+/**
+ * @file humidite_absolue.h
+ * @brief Calcul en virgule fixe de l'humidité absolue pour la compensation du SGP30.
+ *
+ * La densité de vapeur saturante (formule de Magnus) est tabulée de -40 à 85 °C par pas
+ * de 0,5 °C et interpolée en quadratique sur des entiers : aucun calcul flottant ni appel à exp().
+ */
+
+#ifndef HUMIDITE_ABSOLUE
+#define HUMIDITE_ABSOLUE
+
+#include <Arduino.h>
+
+// Plage de température couverte par la table (celle du DHT22), en dixièmes de °C
+#define HUMIDITE_TEMP_MIN_DIXIEMES  (-400)
+#define HUMIDITE_TEMP_MAX_DIXIEMES    850
+
+/**
+ * Humidité absolue au format 8.8 (g/m³ × 256) attendu par la commande setHumidity du SGP30.
+ * @param temperature_dixiemes Température en dixièmes de °C (bornée à la plage de la table)
+ * @param humidite_dixiemes Humidité relative en dixièmes de % (bornée à 0-1000)
+ * @return Valeur 8.8, limitée à 0xFFFF.
+ */
+uint16_t humiditeAbsolue8_8(int16_t temperature_dixiemes, int16_t humidite_dixiemes);
+
+#endif
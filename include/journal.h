@@ -0,0 +1,107 @@
+/**
+ * @file journal.h
+ * @brief Journal flash des échantillons en attente d'envoi (stockage puis retransmission).
+ *
+ * Les échantillons retenus par la politique d'envoi (politique_envoi.h) sont ajoutés à un
+ * journal en ajout seul sur la partition SPIFFS. Le journal est découpé en segments (fichiers /jnlNNNNNNNN.bin) de
+ * JOURNAL_ENREGISTREMENTS_PAR_SEGMENT enregistrements de taille fixe, précédés d'un en-tête
+ * protégé par CRC. Au plus JOURNAL_NB_SEGMENTS segments sont conservés : le plus ancien est
+ * évincé quand un nouveau segment est ouvert, ou quand une écriture échoue faute de place.
+ *
+ * Chaque enregistrement a un index absolu. Le curseur de lecture (premier enregistrement non
+ * acquitté par le serveur) est sauvegardé en NVS. Au démarrage, seuls les en-têtes de segment
+ * et le dernier enregistrement du segment courant sont relus. Un enregistrement tronqué par une
+ * coupure d'alimentation est détecté par son CRC et le segment courant est alors clos.
+ *
+ * ajouterJournal ne fait que poster dans une file ; les accès flash se font dans la tâche
+ * d'envoi (viderFileJournal, lireJournal), jamais dans la tâche d'acquisition.
+ */
+
+#ifndef JOURNAL
+#define JOURNAL
+
+#include <Arduino.h>
+#include "configuration.h"
+#include "mesures.h"
+
+// Drapeaux d'un enregistrement
+#define JOURNAL_HORODATAGE_EPOCH 0x01   // horodatage_ms en ms depuis 1970, sinon en ms depuis le démarrage
+#define JOURNAL_NATURE(drapeaux) ((NatureValeur)(((drapeaux) >> 1) & 0x07))   // Bits 1 à 3 : nature de la valeur
+
+// Nature de la valeur d'un enregistrement : échantillon, ou statistique d'une fenêtre (statistiques.h)
+enum NatureValeur : uint8_t {
+  NATURE_ECHANTILLON = 0,
+  NATURE_NOMBRE,
+  NATURE_MIN,
+  NATURE_MAX,
+  NATURE_MOYENNE,
+  NATURE_ECART_TYPE,
+  NATURE_P50,
+  NATURE_P95,
+  NB_NATURES
+};
+
+// Canal d'un enregistrement dont le CRC est invalide, rendu par lireJournal
+#define JOURNAL_CANAL_CORROMPU 0xFF
+
+// Retour de lireJournal quand un segment ne peut pas être lu (fichier absent, erreur de lecture)
+#define JOURNAL_ILLISIBLE ((size_t)-1)
+
+// Enregistrement du journal (16 octets)
+struct EnregistrementJournal {
+  int64_t horodatage_ms;   // Voir JOURNAL_HORODATAGE_EPOCH
+  float valeur;
+  uint8_t canal;           // CanalMesure
+  uint8_t drapeaux;
+  uint16_t crc;            // CRC-16 CCITT des 14 octets précédents
+};
+
+// Compteurs du journal
+struct StatsJournal {
+  uint32_t ecrits;          // Enregistrements écrits en flash depuis le démarrage
+  uint32_t perdus;          // Échantillons perdus : file pleine ou flash inaccessible
+  uint32_t evinces;         // Enregistrements non envoyés supprimés avec leur segment
+  uint32_t corrompus;       // Enregistrements ignorés à la lecture (CRC invalide)
+  uint32_t illisibles;      // Lectures de segment en échec (segment sauté)
+  uint32_t segments;        // Segments présents
+};
+
+// Crée la file d'écriture (dans setup, avant l'acquisition)
+void initJournal();
+
+// Poste une valeur dans la file d'écriture sans attendre ; comptée perdue si la file est pleine
+void ajouterJournal(CanalMesure canal, float valeur, const Horodatage &capture,
+                    NatureValeur nature = NATURE_ECHANTILLON);
+
+// Monte SPIFFS, relit les en-têtes de segment et le curseur NVS ; false si la flash est inaccessible
+bool ouvrirJournal();
+
+// Écrit en flash les échantillons en attente dans la file ; retourne le nombre écrit
+size_t viderFileJournal();
+
+/**
+ * Copie jusqu'à `max` enregistrements à partir de l'index absolu `depuis`, en lecture séquentielle.
+ * Si `depuis` a été évincé, la lecture commence au plus ancien enregistrement conservé ; un lot
+ * ne dépasse pas la fin d'un segment. Les enregistrements corrompus sont copiés avec le canal
+ * JOURNAL_CANAL_CORROMPU : le i-ème copié a l'index `suivant - n + i`.
+ * `suivant` reçoit l'index à passer au prochain appel. Retourne le nombre n d'enregistrements copiés,
+ * 0 à la fin du journal, ou JOURNAL_ILLISIBLE si le segment qui contient `depuis` ne peut pas être
+ * lu : `suivant` reçoit alors la fin de ce segment, pour le sauter.
+ */
+size_t lireJournal(uint32_t depuis, EnregistrementJournal *destination, size_t max, uint32_t &suivant);
+
+// Index absolu du prochain enregistrement écrit
+uint32_t finJournal();
+
+// Index du premier enregistrement non acquitté
+uint32_t curseurJournal();
+
+// Avance le curseur après acquittement ; sauvegardé en NVS au plus toutes les JOURNAL_PERSISTANCE_CURSEUR_MS
+void avancerCurseurJournal(uint32_t index);
+
+// Sauvegarde immédiatement le curseur en NVS s'il a changé
+void persisterCurseurJournal();
+
+StatsJournal lireStatsJournal();
+
+#endif
@@ -0,0 +1,66 @@
+/**
+ * @file mesures.h
+ * @brief Magasin unique des dernières mesures des capteurs (SensorSnapshot).
+ *
+ * Les tâches d'acquisition publient leurs valeurs dans ce magasin protégé par un
+ * verrou de séquence (seqlock). Les lecteurs (OLED, compensation SGP30, envoi...)
+ * obtiennent une copie cohérente de toutes les mesures sans jamais prendre de mutex.
+ */
+
+#ifndef MESURES
+#define MESURES
+
+#include <Arduino.h>
+#include "horloge.h"
+
+// Canaux de mesure disponibles dans le magasin
+enum CanalMesure : uint8_t {
+  CANAL_TEMPERATURE = 0,  // Température DHT22 en °C
+  CANAL_HUMIDITE,         // Humidité relative DHT22 en %
+  CANAL_CO2,              // eCO2 SGP30 en ppm
+  CANAL_TVOC,             // TVOC SGP30 en ppb
+  CANAL_LUMINOSITE,       // Luminosité Grove en lux
+  NB_CANAUX
+};
+
+// Dernière valeur connue d'un canal
+struct EntreeMesure {
+  float valeur;          // Valeur dans l'unité du capteur
+  bool valide;           // false tant qu'aucune mesure valide n'a été publiée (ou après une erreur)
+  Horodatage horodatage; // Instant de la capture (horloge.h)
+  uint32_t sequence;     // Numéro de publication (identique pour des valeurs publiées ensemble)
+};
+
+// Copie cohérente de l'ensemble des canaux
+struct SensorSnapshot {
+  EntreeMesure canaux[NB_CANAUX];
+  uint32_t sequence;     // Numéro de la dernière publication incluse dans la copie
+
+  const EntreeMesure& operator[](CanalMesure canal) const { return canaux[canal]; }
+};
+
+// Abonné notifié après chaque publication, dans la tâche qui publie (traitement court, sans attente)
+typedef void (*AbonneMesures)(const CanalMesure canaux[], const float valeurs[], size_t nb, const Horodatage &capture);
+
+// Nombre maximal d'abonnés aux publications
+#define MESURES_NB_ABONNES 4
+
+// Publie une seule valeur valide pour un canal
+void publierMesure(CanalMesure canal, float valeur);
+
+// Publie plusieurs valeurs dans une même écriture (ex: température + humidité d'une même trame)
+void publierMesures(const CanalMesure canaux[], const float valeurs[], size_t nb);
+
+// Marque un canal comme invalide (erreur capteur) en conservant sa dernière valeur
+void invaliderMesure(CanalMesure canal);
+
+// Abonne une fonction aux publications (à l'initialisation) ; false si la table est pleine
+bool abonnerMesures(AbonneMesures abonne);
+
+// Copie cohérente de tous les canaux, sans verrou côté lecteur
+void lireInstantane(SensorSnapshot &instantane);
+
+// Copie cohérente d'un seul canal, sans verrou côté lecteur
+EntreeMesure lireMesure(CanalMesure canal);
+
+#endif
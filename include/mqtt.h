@@ -0,0 +1,94 @@
+/**
+ * @file mqtt.h
+ * @brief Client MQTT 3.1.1 minimal : session persistante et publication QoS 1 fenêtrée.
+ *
+ * Le client ne dépend que de l'interface Arduino `Client` (WiFiClient sur la cible,
+ * socket TCP sur PC pour les essais contre un broker local). Il publie en QoS 1 avec au
+ * plus MQTT_FENETRE messages en vol : chaque message est conservé jusqu'à son PUBACK et
+ * renvoyé avec le drapeau DUP après une reconnexion. Aucune souscription n'est gérée.
+ */
+
+#ifndef MQTT
+#define MQTT
+
+#include <Arduino.h>
+#include <Client.h>
+#include "configuration.h"
+
+// Compteurs du client
+struct StatsMqtt {
+  uint32_t connexions;       // CONNACK acceptés
+  uint32_t echecsConnexion;  // Connexions TCP ou CONNACK refusés
+  uint32_t publications;     // PUBLISH émis (hors renvois)
+  uint32_t renvois;          // PUBLISH renvoyés avec DUP après reconnexion
+  uint32_t acquittements;    // PUBACK reçus
+};
+
+// Rappel appelé à la réception du PUBACK d'un message, avec le jeton fourni à publier()
+typedef void (*RappelAcquittement)(uint32_t jeton);
+
+class ClientMqtt {
+public:
+  explicit ClientMqtt(Client &transport) : transport(transport) {}
+
+  /**
+   * Ouvre la connexion TCP et la session MQTT (clean session = 0 : le broker conserve l'état QoS 1),
+   * puis renvoie les messages encore en vol. Bloquant au plus MQTT_DELAI_CONNEXION_MS.
+   * @return true si le CONNACK a été accepté.
+   */
+  bool connecter(const char *hote, uint16_t port, const char *idClient,
+                 const char *utilisateur, const char *motDePasse);
+
+  // Ferme proprement la session (les messages en vol sont conservés pour la prochaine connexion)
+  void deconnecter();
+
+  bool connecte();
+
+  /**
+   * Publie en QoS 1. Le message est copié dans la fenêtre jusqu'à son acquittement
+   * (et renvoyé à la reconnexion si l'écriture échoue).
+   * @return false si le message n'a pas été pris en charge : fenêtre pleine, message trop long
+   *         ou session fermée.
+   */
+  bool publier(const char *sujet, const uint8_t *charge, size_t longueur, uint32_t jeton);
+
+  // Lit les paquets reçus (PUBACK, PINGRESP) et entretient la session ; à appeler régulièrement
+  void traiter();
+
+  // Abandonne les messages en vol (changement de serveur : ils ne seront plus renvoyés)
+  void oublierMessages();
+
+  // Nombre de places libres dans la fenêtre d'émission
+  size_t placesLibres() const;
+
+  void surAcquittement(RappelAcquittement rappel) { rappelAcquittement = rappel; }
+
+  const StatsMqtt &lireStats() const { return stats; }
+
+private:
+  // Message QoS 1 en attente de PUBACK
+  struct MessageEnVol {
+    bool occupe;
+    uint16_t id;
+    uint32_t jeton;
+    uint16_t longueurSujet;
+    uint16_t longueurCharge;
+    char sujet[MQTT_TAILLE_SUJET];
+    uint8_t charge[MQTT_TAILLE_MESSAGE];
+  };
+
+  bool envoyerPublish(const MessageEnVol &message, bool dup);
+  bool envoyerPaquet(uint8_t entete, const uint8_t *corps, size_t longueur);
+  bool lirePaquet(uint8_t &entete, uint8_t *corps, size_t taille, size_t &longueur, uint32_t delai_ms);
+
+  Client &transport;
+  MessageEnVol fenetre[MQTT_FENETRE] = {};
+  uint16_t prochainId = 1;
+  uint16_t keepAlive_s = MQTT_KEEPALIVE_S;
+  uint32_t dernierEnvoi_ms = 0;
+  bool pingEnAttente = false;
+  RappelAcquittement rappelAcquittement = nullptr;
+  StatsMqtt stats = {};
+};
+
+#endif
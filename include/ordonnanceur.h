@@ -0,0 +1,47 @@
+/**
+ * @file ordonnanceur.h
+ * @brief Ordonnanceur des acquisitions basé sur une roue temporelle hachée.
+ *
+ * Les pilotes de capteurs enregistrent une fonction de mesure et une période. Une seule
+ * tâche FreeRTOS exécute tous les travaux : elle dort avec vTaskDelayUntil jusqu'à la
+ * prochaine alvéole occupée de la roue, puis exécute dans le même réveil tous les
+ * travaux arrivés à échéance, par priorité décroissante. Le retard de chaque travail est mesuré.
+ */
+
+#ifndef ORDONNANCEUR
+#define ORDONNANCEUR
+
+#include <Arduino.h>
+#include "configuration.h"
+
+// Fonction de mesure appelée à chaque échéance
+typedef void (*FonctionTravail)();
+
+// Statistiques d'exécution d'un travail
+struct StatsTravail {
+  uint32_t executions;     // Nombre d'exécutions
+  uint32_t retardMoyen_us; // Retard moyen entre l'échéance et le début d'exécution
+  uint32_t retardMax_us;   // Retard maximal observé
+  uint32_t dureeMax_us;    // Durée d'exécution maximale
+  uint32_t echeancesManquees; // Échéances sautées car le travail précédent a débordé
+};
+
+/**
+ * Enregistre un travail périodique (avant executerOrdonnanceur()).
+ * @param nom Nom du travail (affiché dans les statistiques)
+ * @param fonction Fonction appelée à chaque échéance
+ * @param periode_ms Période en ms (arrondie à ORDONNANCEUR_RESOLUTION_MS)
+ * @param dephasage_ms Délai avant la première exécution en ms
+ * @param priorite Ordre d'exécution quand plusieurs travaux échoient au même top (le plus grand d'abord)
+ * @return Identifiant du travail, ou -1 si la table est pleine.
+ */
+int ajouterTravail(const char *nom, FonctionTravail fonction, uint32_t periode_ms, uint32_t dephasage_ms = 0,
+                   uint8_t priorite = 0);
+
+// Boucle de l'ordonnanceur, ne retourne jamais (appelée depuis la tâche d'acquisition)
+void executerOrdonnanceur();
+
+// Affiche les statistiques de tous les travaux sur le terminal série
+void afficherStatsOrdonnanceur();
+
+#endif
@@ -0,0 +1,54 @@
+/**
+ * @file politique_envoi.h
+ * @brief Politique d'envoi sur changement : bandes mortes, intervalles min/max et heartbeat.
+ *
+ * La politique est évaluée à chaque publication du magasin de mesures, échantillon par
+ * échantillon. Un échantillon n'est retenu dans le journal d'envoi que :
+ *   - s'il s'écarte du dernier échantillon retenu de plus que la bande morte du canal (absolue
+ *     ou relative) et que l'intervalle minimal est écoulé : c'est un événement, qui demande
+ *     un rapport immédiat ;
+ *   - ou si l'intervalle maximal du canal est écoulé (il part avec le rapport suivant) ;
+ *   - ou au heartbeat du nœud : le prochain échantillon de chaque canal est retenu et un
+ *     rapport est demandé, même si rien n'a changé.
+ *
+ * Un canal peut aussi être envoyé en agrégats : ses échantillons ne sont plus journalisés, mais
+ * les statistiques de chaque fenêtre (statistiques.h : nombre, min, max, moyenne, écart-type,
+ * p50, p95) le sont, et partent avec le rapport suivant.
+ *
+ * Les valeurs par défaut viennent du registre des capteurs ; le portail peut les modifier
+ * avec une chaîne "cle=bande[%]/min_s/max_s;..." ou "cle=stats" pour un canal agrégé
+ * (ex : "co2=stats;luminosite=30%") et une période de heartbeat en secondes.
+ */
+
+#ifndef POLITIQUE_ENVOI
+#define POLITIQUE_ENVOI
+
+#include <Arduino.h>
+#include "configuration.h"
+#include "mesures.h"
+
+// Compteurs de la politique depuis le démarrage
+struct StatsPolitique {
+  uint32_t retenus;          // Échantillons ajoutés au journal
+  uint32_t ignores;          // Échantillons dans la bande morte
+  uint32_t evenements;       // Rapports immédiats demandés sur changement
+  uint32_t heartbeats;       // Rapports demandés par le heartbeat
+  uint32_t agregats;         // Fenêtres de statistiques journalisées (canaux agrégés)
+};
+
+// Charge les politiques par défaut du registre et s'abonne aux publications (dans setup)
+void initPolitiqueEnvoi();
+
+/**
+ * Applique la configuration du portail. Une chaîne vide rétablit les défauts du registre ;
+ * une entrée invalide est ignorée (les autres sont appliquées).
+ * @return false si au moins une entrée était invalide.
+ */
+bool appliquerPolitiqueEnvoi(const char *politique, const char *heartbeat_s);
+
+// Vrai si un rapport a été demandé depuis l'appel précédent (consommé par la tâche d'envoi)
+bool prendreRapportDemande();
+
+StatsPolitique lireStatsPolitique();
+
+#endif
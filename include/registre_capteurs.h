@@ -0,0 +1,240 @@
+/**
+ * @file registre_capteurs.h
+ * @brief Registre des capteurs résolu à la compilation.
+ *
+ * Chaque composant physique est décrit par un type "pilote" (initialisation, mesure
+ * périodique, travaux annexes) et chaque grandeur publiée par un type "canal" (nom, unité,
+ * décimales, icône, clé, politique d'envoi et seuil d'alarme). Les listes de types ci-dessous
+ * sont filtrées par les options CAPTEUR_xxx_ACTIF de configuration.h : la tâche d'acquisition,
+ * la liste des frames OLED et la table d'envoi en sont déduites à la compilation, sans
+ * aiguillage à l'exécution.
+ *
+ * Ajouter un capteur : écrire son pilote (src/taches), déclarer ici un pilote et ses canaux,
+ * puis les ajouter aux listes PilotesDeclares / CanauxDeclares.
+ */
+
+#ifndef REGISTRE_CAPTEURS
+#define REGISTRE_CAPTEURS
+
+#include <Arduino.h>
+#include <array>
+#include <type_traits>
+#include "configuration.h"
+#include "mesures.h"
+#include "alarmes.h"
+#include "ordonnanceur.h"
+#include "taches/tache_tempHum.h"
+#include "taches/tache_co2.h"
+#include "taches/tache_luminosite.h"
+
+// Icône de la frame OLED d'un canal (bitmaps de images.h)
+enum IconeCapteur : uint8_t {
+  ICONE_TEMPERATURE = 0,
+  ICONE_HUMIDITE,
+  ICONE_CO2,
+  ICONE_LUMINOSITE
+};
+
+// Liste de types (pilotes ou canaux)
+template <class... T>
+struct ListeTypes {
+  static constexpr size_t taille = sizeof...(T);
+};
+
+// Concaténation de listes de types
+template <class... Listes>
+struct ConcatTypes;
+
+template <class... A>
+struct ConcatTypes<ListeTypes<A...>> {
+  using type = ListeTypes<A...>;
+};
+
+template <class... A, class... B, class... Reste>
+struct ConcatTypes<ListeTypes<A...>, ListeTypes<B...>, Reste...> {
+  using type = typename ConcatTypes<ListeTypes<A..., B...>, Reste...>::type;
+};
+
+// Sous-liste des types qui vérifient un prédicat
+template <template <class> class Predicat, class Liste>
+struct FiltrerTypes;
+
+template <template <class> class Predicat, class... T>
+struct FiltrerTypes<Predicat, ListeTypes<T...>> {
+  using type = typename ConcatTypes<ListeTypes<>,
+      typename std::conditional<Predicat<T>::value, ListeTypes<T>, ListeTypes<>>::type...>::type;
+};
+
+template <class T> struct EstActif : std::integral_constant<bool, T::actif> {};
+template <class T> struct EstAffiche : std::integral_constant<bool, T::actif && T::affiche> {};
+
+/**
+ * PILOTES (un par composant physique)
+ */
+
+struct PiloteDht22 {
+  static constexpr bool actif = CAPTEUR_DHT22_ACTIF;
+  static constexpr const char *nom = "TempHum DHT22";
+  static constexpr uint32_t periode_ms = TEMPHUM_INTERVAL_MS;
+  static constexpr uint32_t dephasage_ms = 2000;   // Stabilisation du DHT22
+  static constexpr uint8_t priorite = 0;
+  static void init() { initTempHum(); }
+  static void mesurer() { mesurerTempHum(); }
+  static void annexes() {}
+};
+
+struct PiloteSgp30 {
+  static constexpr bool actif = CAPTEUR_SGP30_ACTIF;
+  static constexpr const char *nom = "CO2 SGP30";
+  static constexpr uint32_t periode_ms = CO2_INTERVAL_MS;
+  static constexpr uint32_t dephasage_ms = 2500;   // Après la première trame du DHT22
+  static constexpr uint8_t priorite = 255;         // La mesure doit tenir 1 Hz
+  static void init() { initSGP30(); }
+  static void mesurer() { mesurerCo2(); }
+  static void annexes()
+  {
+    // Compensation d'humidité sur les publications du DHT22 ; travail annexe décalé d'une demi-période
+    abonnerMesures(compenserHumiditeSgp30);
+    ajouterTravail("Diagnostic SGP30", diagnostiquerSgp30, SGP30_DIAGNOSTIC_INTERVAL_MS,
+                   SGP30_DIAGNOSTIC_INTERVAL_MS + CO2_INTERVAL_MS / 2);
+    ajouterTravail("Baseline SGP30", gererBaselineSgp30, SGP30_BASELINE_INTERVAL_MS,
+                   SGP30_BASELINE_INTERVAL_MS + CO2_INTERVAL_MS / 2);
+  }
+};
+
+struct PiloteLuminosite {
+  static constexpr bool actif = CAPTEUR_LUMINOSITE_ACTIF;
+  static constexpr const char *nom = "Luminosite Grove";
+  static constexpr uint32_t periode_ms = LUMINOSITE_INTERVAL_MS;
+  static constexpr uint32_t dephasage_ms = 500;
+  static constexpr uint8_t priorite = 0;
+  static void init() { initLuminosite(); }
+  static void mesurer() { mesurerLuminosite(); }
+  static void annexes() {}
+};
+
+/**
+ * CANAUX (une grandeur publiée dans le magasin de mesures)
+ */
+
+// Politique d'envoi sur changement d'un canal (défaut du registre, modifiable depuis le portail)
+struct PolitiqueCanal {
+  float bandeMorte;          // Écart au dernier échantillon retenu qui déclenche un rapport
+  bool bandeRelative;        // Bande morte en % de la dernière valeur retenue (sinon dans l'unité du canal)
+  uint16_t intervalleMin_s;  // Délai minimal entre deux échantillons retenus
+  uint16_t intervalleMax_s;  // Un échantillon est retenu au moins à cette période, même sans changement
+  bool agreger;              // Statistiques de chaque fenêtre (statistiques.h) envoyées à la place des échantillons
+};
+
+struct CanalTemperature {
+  static constexpr bool actif = PiloteDht22::actif;
+  static constexpr bool affiche = true;
+  static constexpr CanalMesure canal = CANAL_TEMPERATURE;
+  static constexpr const char *nom = "Temp";
+  static constexpr const char *unite = "°C";
+  static constexpr const char *cle = "temperature";
+  static constexpr uint8_t decimales = 2;
+  static constexpr IconeCapteur icone = ICONE_TEMPERATURE;
+  static constexpr PolitiqueCanal politique = { 0.3f, false, 30, 900, false };
+  static constexpr SeuilAlarme alarme = { false, true, 0, 0 };
+};
+
+struct CanalHumidite {
+  static constexpr bool actif = PiloteDht22::actif;
+  static constexpr bool affiche = true;
+  static constexpr CanalMesure canal = CANAL_HUMIDITE;
+  static constexpr const char *nom = "Hum";
+  static constexpr const char *unite = "%";
+  static constexpr const char *cle = "humidite";
+  static constexpr uint8_t decimales = 2;
+  static constexpr IconeCapteur icone = ICONE_HUMIDITE;
+  static constexpr PolitiqueCanal politique = { 2.0f, false, 30, 900, false };
+  static constexpr SeuilAlarme alarme = { false, true, 0, 0 };
+};
+
+struct CanalCo2 {
+  static constexpr bool actif = PiloteSgp30::actif;
+  static constexpr bool affiche = true;
+  static constexpr CanalMesure canal = CANAL_CO2;
+  static constexpr const char *nom = "CO2";
+  static constexpr const char *unite = "ppm";
+  static constexpr const char *cle = "co2";
+  static constexpr uint8_t decimales = 0;
+  static constexpr IconeCapteur icone = ICONE_CO2;
+  static constexpr PolitiqueCanal politique = { 50.0f, false, 10, 900, false };
+  static constexpr SeuilAlarme alarme = { true, true, 1500.0f, 200.0f };   // Aération recommandée
+};
+
+struct CanalTvoc {
+  static constexpr bool actif = PiloteSgp30::actif;
+  static constexpr bool affiche = false;           // Pas de frame : envoyé seulement
+  static constexpr CanalMesure canal = CANAL_TVOC;
+  static constexpr const char *nom = "TVOC";
+  static constexpr const char *unite = "ppb";
+  static constexpr const char *cle = "tvoc";
+  static constexpr uint8_t decimales = 0;
+  static constexpr IconeCapteur icone = ICONE_CO2;
+  static constexpr PolitiqueCanal politique = { 20.0f, true, 10, 900, false };
+  static constexpr SeuilAlarme alarme = { false, true, 0, 0 };
+};
+
+struct CanalLuminosite {
+  static constexpr bool actif = PiloteLuminosite::actif;
+  static constexpr bool affiche = true;
+  static constexpr CanalMesure canal = CANAL_LUMINOSITE;
+  static constexpr const char *nom = "Lum";
+  static constexpr const char *unite = "lux";
+  static constexpr const char *cle = "luminosite";
+  static constexpr uint8_t decimales = 0;
+  static constexpr IconeCapteur icone = ICONE_LUMINOSITE;
+  static constexpr PolitiqueCanal politique = { 20.0f, true, 30, 900, false };
+  static constexpr SeuilAlarme alarme = { false, true, 0, 0 };
+};
+
+/**
+ * REGISTRE (l'ordre des listes est l'ordre d'initialisation, d'affichage et d'envoi)
+ */
+
+using PilotesDeclares = ListeTypes<PiloteDht22, PiloteSgp30, PiloteLuminosite>;
+using CanauxDeclares = ListeTypes<CanalTemperature, CanalHumidite, CanalCo2, CanalTvoc, CanalLuminosite>;
+
+using PilotesActifs = FiltrerTypes<EstActif, PilotesDeclares>::type;
+using CanauxActifs = FiltrerTypes<EstActif, CanauxDeclares>::type;
+using CanauxAffiches = FiltrerTypes<EstAffiche, CanauxDeclares>::type;
+
+// Description d'un canal actif, pour les parcours à l'exécution (envoi, portail...)
+struct InfoCanal {
+  CanalMesure canal;
+  const char *nom;
+  const char *unite;
+  const char *cle;
+  uint8_t decimales;
+  PolitiqueCanal politique;   // Politique par défaut
+  SeuilAlarme alarme;         // Seuil d'alarme par défaut
+};
+
+template <class... C>
+constexpr std::array<InfoCanal, sizeof...(C)> genererTableCanaux(ListeTypes<C...>)
+{
+  return {{ { C::canal, C::nom, C::unite, C::cle, C::decimales, C::politique, C::alarme }... }};
+}
+
+// Table des canaux actifs, en mémoire flash
+constexpr auto TABLE_CANAUX = genererTableCanaux(CanauxActifs{});
+
+// Initialise tous les pilotes actifs
+template <class... P>
+inline void initialiserPilotes(ListeTypes<P...>)
+{
+  (P::init(), ...);
+}
+
+// Enregistre auprès de l'ordonnanceur la mesure et les travaux annexes de chaque pilote actif
+template <class... P>
+inline void planifierPilotes(ListeTypes<P...>)
+{
+  (ajouterTravail(P::nom, P::mesurer, P::periode_ms, P::dephasage_ms, P::priorite), ...);
+  (P::annexes(), ...);
+}
+
+#endif
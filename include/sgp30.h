@@ -0,0 +1,49 @@
+/**
+ * @file sgp30.h
+ * @brief Pilote minimal du SGP30 passant par l'arbitre du bus I2C.
+ *
+ * Remplace la bibliothèque Adafruit_SGP30, qui accède directement à Wire (et le
+ * réinitialise). L'interface reprend les noms de méthodes et de champs de cette
+ * bibliothèque. Chaque commande est une écriture (code + CRC), suivie d'une attente passive
+ * du temps de mesure (la tâche dort, le bus reste disponible pour l'écran),
+ * puis d'une lecture des mots de réponse dont le CRC est vérifié.
+ */
+
+#ifndef PILOTE_SGP30
+#define PILOTE_SGP30
+
+#include <Arduino.h>
+
+class CapteurSgp30 {
+public:
+  // Lit le numéro de série et vérifie le jeu de fonctionnalités ; false si le capteur ne répond pas
+  bool begin();
+
+  // Démarre l'algorithme IAQ (baseline par défaut, 15 s de chauffe)
+  bool IAQinit();
+
+  // Mesure eCO2/TVOC (à appeler toutes les secondes) ; résultats dans eCO2 et TVOC
+  bool IAQmeasure();
+
+  // Mesure des signaux bruts ; résultats dans rawH2 et rawEthanol
+  bool IAQmeasureRaw();
+
+  // Lecture et écriture de la baseline de l'algorithme IAQ
+  bool getIAQBaseline(uint16_t *eco2_base, uint16_t *tvoc_base);
+  bool setIAQBaseline(uint16_t eco2_base, uint16_t tvoc_base);
+
+  // Compensation d'humidité : humidité absolue au format 8.8 en g/m³ (0 désactive la compensation)
+  bool setHumidity(uint16_t absolute_humidity);
+
+  uint16_t TVOC = 0;          // ppb
+  uint16_t eCO2 = 0;          // ppm
+  uint16_t rawH2 = 0;
+  uint16_t rawEthanol = 0;
+  uint16_t serialnumber[3] = {};
+
+private:
+  bool commande(uint16_t code, const uint16_t *arguments, uint8_t nbArguments,
+                uint16_t delai_ms, uint16_t *reponse, uint8_t nbMots);
+};
+
+#endif
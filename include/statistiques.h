@@ -0,0 +1,92 @@
+/**
+ * @file statistiques.h
+ * @brief Statistiques en flux par canal et par fenêtre : nombre, min, max, moyenne, écart-type, p50, p95.
+ *
+ * Chaque canal du magasin de mesures accumule ses échantillons sur des fenêtres fixes et
+ * consécutives de STATISTIQUES_FENETRE_S secondes. La moyenne et l'écart-type sont tenus par
+ * l'algorithme de Welford, les quantiles par l'estimateur P² (Jain et Chlamtac, 1985) : cinq
+ * marqueurs par quantile, mémoire constante, sans conserver les échantillons.
+ *
+ * À la fin d'une fenêtre (premier échantillon reçu après son terme), les statistiques sont
+ * conservées comme dernière fenêtre close du canal et transmises au rappel de fin de fenêtre
+ * (la politique d'envoi les journalise pour les canaux envoyés en agrégats).
+ */
+
+#ifndef STATISTIQUES
+#define STATISTIQUES
+
+#include <Arduino.h>
+#include "configuration.h"
+#include "mesures.h"
+
+/**
+ * Estimateur P² d'un quantile : cinq hauteurs de marqueurs ajustées à chaque échantillon par
+ * interpolation parabolique. Valeur exacte tant que moins de cinq échantillons ont été ajoutés.
+ * Erreur de rang sur des distributions unimodales (test/test_statistiques) : 6 points sur
+ * 100 échantillons, 1,5 point au-delà de 1000. Moins précis sur des valeurs répétées
+ * (l'estimation tombe entre deux paliers) et sur une distribution bimodale en petite fenêtre.
+ */
+class EstimateurP2 {
+public:
+  explicit EstimateurP2(float quantile) : p(quantile) {}
+
+  void ajouter(float x);
+
+  // Quantile estimé (0 si aucun échantillon)
+  float valeur() const;
+
+  void reinitialiser() { n = 0; }
+
+private:
+  float p;
+  uint32_t n = 0;
+  float hauteurs[5] = {};      // Hauteurs des marqueurs (min, p/2, p, (1+p)/2, max)
+  int32_t positions[5] = {};   // Positions réelles des marqueurs (rangs, à partir de 1)
+};
+
+// Statistiques d'une fenêtre d'un canal
+struct StatistiquesFenetre {
+  uint32_t nombre;       // Échantillons de la fenêtre (0 = aucune fenêtre close)
+  float min;
+  float max;
+  float moyenne;
+  float ecartType;       // Écart-type de population
+  float p50;             // Médiane estimée (P²)
+  float p95;             // 95e centile estimé (P²)
+};
+
+// Accumulateur d'une fenêtre : Welford, extrêmes et deux estimateurs P²
+class AccumulateurStatistiques {
+public:
+  void ajouter(float x);
+
+  // Statistiques des échantillons ajoutés depuis la dernière réinitialisation
+  StatistiquesFenetre lire() const;
+
+  void reinitialiser();
+
+  uint32_t nombre() const { return n; }
+
+private:
+  uint32_t n = 0;
+  float min = 0;
+  float max = 0;
+  float moyenne = 0;
+  float m2 = 0;                // Somme des carrés des écarts à la moyenne
+  EstimateurP2 p50 = EstimateurP2(0.50f);
+  EstimateurP2 p95 = EstimateurP2(0.95f);
+};
+
+// Rappel de fin de fenêtre, dans la tâche qui publie les mesures ; debut = capture du premier échantillon
+typedef void (*RappelFinFenetre)(CanalMesure canal, const StatistiquesFenetre &statistiques, const Horodatage &debut);
+
+// S'abonne aux publications du magasin de mesures (dans setup, avant l'acquisition)
+void initStatistiques();
+
+// Enregistre le rappel de fin de fenêtre (un seul)
+void surFinFenetre(RappelFinFenetre rappel);
+
+// Statistiques de la dernière fenêtre close du canal ; false s'il n'y en a pas encore
+bool lireStatistiques(CanalMesure canal, StatistiquesFenetre &statistiques);
+
+#endif
@@ -293,6 +293,8 @@ const char R_erase[]              PROGMEM = "/erase";
 const char R_status[]             PROGMEM = "/status";
 const char R_update[]             PROGMEM = "/update";
 const char R_updatedone[]         PROGMEM = "/u";
+const char R_css[]                PROGMEM = "/wm.css"; // HTTP_STYLE, gzip, see outils/ressources_portail.py
+const char R_js[]                 PROGMEM = "/wm.js";  // HTTP_SCRIPT, gzip
 
 
 //Strings
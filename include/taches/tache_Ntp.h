@@ -8,5 +8,5 @@
 
 
 void fetchTimeFromNTP(void * parameter);
-        
+
 #endif
\ No newline at end of file
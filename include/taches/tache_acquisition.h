@@ -0,0 +1,7 @@
+#ifndef TACHE_ACQUISITION
+#define TACHE_ACQUISITION
+
+// Tâche unique qui exécute les mesures de tous les capteurs via l'ordonnanceur
+void tache_acquisition(void *pvParameters);
+
+#endif
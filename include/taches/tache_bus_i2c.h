@@ -0,0 +1,67 @@
+/**
+ * @file tache_bus_i2c.h
+ * @brief Tâche propriétaire du bus I2C et file de transactions.
+ *
+ * Seule cette tâche appelle la bibliothèque Wire. Les clients (SGP30, écran OLED...)
+ * déposent des transactions (écriture, lecture, écriture puis lecture) dans la file de
+ * leur priorité et attendent leur résultat ; la tâche sert toujours la file la plus
+ * prioritaire en premier, si bien qu'une mesure n'attend au plus qu'une transaction
+ * d'affichage (un fragment de page) avant d'accéder au bus.
+ */
+
+#ifndef TACHE_BUS_I2C
+#define TACHE_BUS_I2C
+
+#include <Arduino.h>
+#include "configuration.h"
+
+// Priorité d'un client du bus (0 = la plus urgente)
+enum PrioriteI2c : uint8_t {
+  I2C_PRIORITE_CAPTEUR = 0,   // Mesures : servies avant tout le reste
+  I2C_PRIORITE_AFFICHAGE,     // Rafraîchissement de l'écran
+  I2C_NB_PRIORITES
+};
+
+// Résultat d'une transaction
+enum ResultatI2c : uint8_t {
+  I2C_OK = 0,
+  I2C_ERREUR_NACK,       // Périphérique absent ou donnée refusée
+  I2C_ERREUR_BUS,        // Bus bloqué, délai dépassé ou lecture incomplète
+  I2C_ERREUR_TAILLE,     // Transaction plus longue que le tampon de Wire
+  I2C_ERREUR_FILE        // Bus non initialisé ou file pleine
+};
+
+// Statistiques du bus
+struct StatsBusI2c {
+  uint32_t transactions[I2C_NB_PRIORITES];      // Transactions servies par priorité
+  uint32_t latenceMoyenne_us[I2C_NB_PRIORITES]; // Dépôt → fin de transaction
+  uint32_t latenceMax_us[I2C_NB_PRIORITES];
+  uint32_t erreurs;              // Transactions en erreur (NACK compris)
+  uint32_t deblocages;           // Libérations du bus par impulsions d'horloge
+  uint32_t reinitialisations;    // Redémarrages complets du contrôleur I2C (dernier recours)
+  uint8_t occupation_pourcent;   // Part du temps passée en transaction depuis la dernière lecture
+};
+
+// Initialise le contrôleur I2C et les files (dans setup(), avant la création des tâches clientes)
+void initBusI2c();
+
+// Tâche FreeRTOS propriétaire du bus : exécute les transactions déposées
+void tache_bus_i2c(void *pvParameters);
+
+// Écrit `longueur` octets à l'adresse 7 bits `adresse`
+ResultatI2c ecrireI2c(uint8_t adresse, const uint8_t *donnees, size_t longueur, PrioriteI2c priorite);
+
+// Lit `longueur` octets depuis l'adresse `adresse`
+ResultatI2c lireI2c(uint8_t adresse, uint8_t *donnees, size_t longueur, PrioriteI2c priorite);
+
+// Écrit puis lit dans la même transaction (condition de redémarrage entre les deux)
+ResultatI2c ecrireLireI2c(uint8_t adresse, const uint8_t *ecriture, size_t longueurEcriture,
+                          uint8_t *lecture, size_t longueurLecture, PrioriteI2c priorite);
+
+// Copie les statistiques du bus et remet à zéro la mesure d'occupation
+void lireStatsBusI2c(StatsBusI2c &stats);
+
+// Affiche les statistiques du bus sur le terminal série
+void afficherStatsBusI2c();
+
+#endif
@@ -1,24 +1,48 @@
 #ifndef TASK_CO2
 #define TASK_CO2
-#include "variablesGlobales.h"
-#include <Adafruit_SGP30.h>
+#include <Arduino.h>
+#include "mesures.h"
+#include "sgp30.h"
 
 // Déclaration de l'objet SGP30 (externe)
-extern Adafruit_SGP30 sgp30;
+extern CapteurSgp30 sgp30;
 
-// Variable pour stocker la valeur de CO2 (eCO2 en ppm)
-extern volatile uint16_t co2;
+// État de la baseline IAQ du SGP30 (télémétrie)
+struct EtatBaselineSgp30 {
+  bool valide;        // Baseline fiable : restaurée récente ou 12 h de fonctionnement
+  bool restauree;     // Baseline restaurée depuis la NVS depuis le dernier IAQinit()
+  uint16_t eco2;      // Dernière baseline eCO2 connue
+  uint16_t tvoc;      // Dernière baseline TVOC connue
+  int32_t age_s;      // Âge de la baseline sauvegardée en s (-1 si inconnu)
+};
 
-// Variable pour stocker la valeur de TVOC (ppb) - bonus du SGP30
-extern volatile uint16_t tvoc;
-
-// Nom du capteur
-extern const char* Nom_co2;
+// Statistiques de cadence des mesures IAQ (l'algorithme du SGP30 suppose 1 mesure par seconde)
+struct StatsCadenceCo2 {
+  uint32_t nombre;             // Nombre de périodes mesurées
+  uint32_t periodeMoyenne_us;  // Période moyenne entre deux IAQmeasure()
+  uint32_t gigueP99_us;        // 99 % des périodes s'écartent de CO2_INTERVAL_MS de moins que cette valeur
+  uint32_t gigueMax_us;        // Écart maximal observé
+};
 
 // Fonction d'initialisation du capteur SGP30
 bool initSGP30();
 
-// Tâche FreeRTOS pour la mesure du CO2
-void tache_co2(void *pvParameters); 
+// Restauration/sauvegarde de la baseline IAQ, exécutée par l'ordonnanceur toutes les SGP30_BASELINE_INTERVAL_MS
+void gererBaselineSgp30();
+
+// Copie l'état de la baseline IAQ
+void lireEtatBaselineSgp30(EtatBaselineSgp30 &etat);
+
+// Mesure du CO2, exécutée par l'ordonnanceur toutes les CO2_INTERVAL_MS
+void mesurerCo2();
+
+// Compensation d'humidité, abonnée aux publications du magasin de mesures (trames DHT22)
+void compenserHumiditeSgp30(const CanalMesure canaux[], const float valeurs[], size_t nb, const Horodatage &capture);
+
+// Valeurs brutes et rapport de cadence, exécutés par l'ordonnanceur toutes les SGP30_DIAGNOSTIC_INTERVAL_MS
+void diagnostiquerSgp30();
+
+// Copie les statistiques de cadence des mesures IAQ
+void lireStatsCadenceCo2(StatsCadenceCo2 &stats);
 
 #endif
\ No newline at end of file
@@ -0,0 +1,14 @@
+/**
+ * @file tache_envoi.h
+ * @brief Header de la tâche d'envoi des mesures vers le serveur MQTT.
+ */
+
+#ifndef TACHE_ENVOI
+#define TACHE_ENVOI
+
+#include <Arduino.h>
+
+// Tâche FreeRTOS qui écrit le journal flash, entretient la session MQTT et publie le journal par lots
+void tache_envoi(void *pvParameters);
+
+#endif
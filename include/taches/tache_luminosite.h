@@ -2,22 +2,19 @@
  * @file tache_luminosite.h
  * @brief Header de la tâche de gestion du capteur de luminosité Grove Light Sensor.
  * 
- * Ce fichier déclare la tâche FreeRTOS qui lit les données du capteur de luminosité
+ * Ce fichier déclare la mesure périodique qui lit les données du capteur de luminosité
  * et les convertit en lumens pour l'affichage.
  */
 
 #ifndef TACHE_LUMINOSITE
 #define TACHE_LUMINOSITE
 
-#include "variablesGlobales.h"
+#include <Arduino.h>
 
-// Variable globale pour stocker la valeur de luminosité en lux (approximatif)
-extern volatile float luminosite;
+// Déclaration de l'entrée analogique du capteur auprès du moteur ADC
+void initLuminosite();
 
-// Nom du capteur
-extern const char* Nom_luminosite;
-
-// Tâche FreeRTOS pour la mesure de la luminosité
-void tache_luminosite(void *pvParameters);
+// Mesure de la luminosité, exécutée par l'ordonnanceur toutes les LUMINOSITE_INTERVAL_MS
+void mesurerLuminosite();
 
 #endif
@@ -1,13 +1,10 @@
 #ifndef TACHE_TEMPHUM
 #define TACHE_TEMPHUM
 
-#include <freertos/FreeRTOS.h>
-#include <freertos/semphr.h>
+// Initialisation du capteur DHT22 (appelée par la tâche d'acquisition)
+void initTempHum();
 
-// Sémaphore pour signaler que les premières mesures de température/humidité sont disponibles
-// Ce sémaphore est utilisé par la tâche CO2 pour attendre avant de démarrer
-extern SemaphoreHandle_t xSemaphoreTempHumReady;
-
-void tache_tempHum(void *pvParameters);
+// Mesure température/humidité, exécutée par l'ordonnanceur toutes les TEMPHUM_INTERVAL_MS
+void mesurerTempHum();
 
 #endif
@@ -2,6 +2,11 @@
 #define VARIABLES
 #include <Arduino.h>
 #include "configuration.h"
+#include "mesures.h"
+#include "journal.h"
+#include "statistiques.h"
+#include "politique_envoi.h"
+#include "alarmes.h"
 #include <Preferences.h>
 #include "taches/tache_Ntp.h"
 #include "taches/tache_Wifi.h"
@@ -11,6 +16,9 @@
 #include "taches/tache_tempHum.h"
 #include "taches/tache_co2.h"
 #include "taches/tache_luminosite.h"
+#include "taches/tache_acquisition.h"
+#include "taches/tache_bus_i2c.h"
+#include "taches/tache_envoi.h"
 #include <WiFiUdp.h>
 
 //ESP32S2
@@ -35,27 +43,19 @@ struct CustomParams {
   char pass_mon_serveur[32];
   char data_mon_serveur[32];
   char timeZone[3];
+  char politique[100];       // Politique d'envoi "cle=bande[%]/min_s/max_s;..." (voir politique_envoi.h)
+  char heartbeat[6];         // Période du heartbeat en s
+  char alarmes[100];         // Seuils d'alarme "cle>seuil/hysteresis;..." (voir alarmes.h)
                     };
 
 extern CustomParams params ;
 
-//Pour l'heure par protocole NTP
-extern char affHorodatageNtp[50]; 
-extern char horodatageNtp[15]; 
-extern char affHorodatageNTPDate[10];
-extern char affHorodatageNTPHeure[6];
+//Pour l'heure par protocole NTP : horodatages et textes d'affichage dans horloge.h
 
 //pour les entrées/sorties
 extern bool OLED;
-extern const char* Nom_temperature;
-extern const char* Nom_humidite;
-extern const char* Nom_co2;
-extern const char* Nom_luminosite;
-
-// pour les capteurs
-extern volatile float temperature;
-extern volatile float humidite;
-extern volatile uint16_t co2;
-extern volatile float luminosite;
+
+// pour les capteurs : les valeurs sont dans le magasin de mesures (mesures.h),
+// noms, unités et clés d'envoi dans le registre des capteurs (registre_capteurs.h)
 
 #endif
\ No newline at end of file
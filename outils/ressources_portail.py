@@ -0,0 +1,134 @@
+"""
+@file ressources_portail.py
+@brief Étape de build : feuille de style et script du portail WiFi compressés gzip en flash.
+
+Extrait HTTP_STYLE et HTTP_SCRIPT de include/strings_fr.h (seule source des textes du portail),
+retire les balises <style>/<script>, compresse en gzip et écrit include/ressources_portail.h :
+tableaux d'octets PROGMEM servis tels quels sur R_css et R_js, avec leur ETag (empreinte du
+contenu compressé), et les balises <link>/<script> à placer dans l'en-tête des pages. L'URL de ces
+balises porte l'empreinte (?v=...) : le navigateur garde la ressource en cache sans revalider, et
+la recharge dès qu'un nouveau firmware en change le contenu. Le fichier n'est réécrit que si son
+contenu change, pour ne pas relancer la compilation.
+
+Lancé par PlatformIO avant la compilation (extra_scripts = pre:outils/ressources_portail.py), ou
+à la main : python outils/ressources_portail.py
+"""
+
+import gzip
+import hashlib
+import os
+import re
+
+RESSOURCES = [
+    # (texte dans strings_fr.h, balise retirée, route dans strings_fr.h, préfixe des symboles générés)
+    ("HTTP_STYLE", "style", "R_css", "WM_CSS"),
+    ("HTTP_SCRIPT", "script", "R_js", "WM_JS"),
+]
+
+# Balise d'en-tête de page de chaque ressource, {u} : route et empreinte
+BALISES = {
+    "style": "<link rel='stylesheet' href='{u}'>",
+    "script": "<script src='{u}'></script>",
+}
+
+
+def lire_chaine_c(source, nom):
+    """Valeur d'une constante 'const char NOM[] PROGMEM = "..." "...";' (littéraux concaténés)."""
+    m = re.search(r"const\s+char\s+" + nom + r"\s*\[\]\s*PROGMEM\s*=", source)
+    if m is None:
+        raise ValueError(nom + " introuvable dans strings_fr.h")
+    i, morceaux = m.end(), []
+    while True:
+        if source.startswith("//", i):
+            i = source.index("\n", i)
+        elif source.startswith("/*", i):
+            i = source.index("*/", i) + 2
+        elif source[i] == '"':
+            i += 1
+            while source[i] != '"':
+                if source[i] == "\\":
+                    echappe = source[i + 1]
+                    morceaux.append({"n": "\n", "t": "\t", "r": "\r", "0": "\0"}.get(echappe, echappe))
+                    i += 2
+                else:
+                    morceaux.append(source[i])
+                    i += 1
+            i += 1
+        elif source[i] == ";":
+            return "".join(morceaux)
+        else:
+            i += 1
+
+
+def retirer_balise(texte, balise):
+    debut, fin = "<" + balise + ">", "</" + balise + ">"
+    if not (texte.startswith(debut) and texte.endswith(fin)):
+        raise ValueError("balise <" + balise + "> attendue autour du texte")
+    return texte[len(debut):-len(fin)]
+
+
+def tableau_c(octets):
+    lignes = []
+    for i in range(0, len(octets), 16):
+        lignes.append("  " + ", ".join("0x%02x" % o for o in octets[i:i + 16]) + ",")
+    return "\n".join(lignes)
+
+
+def generer(racine):
+    with open(os.path.join(racine, "include", "strings_fr.h"), encoding="utf-8") as f:
+        source = f.read()
+
+    sortie = [
+        "/**",
+        " * @file ressources_portail.h",
+        " * @brief Feuille de style et script du portail, compressés gzip (généré, ne pas modifier).",
+        " *",
+        " * Généré par outils/ressources_portail.py depuis HTTP_STYLE et HTTP_SCRIPT de strings_fr.h.",
+        " */",
+        "",
+        "#ifndef RESSOURCES_PORTAIL",
+        "#define RESSOURCES_PORTAIL",
+        "",
+        "#include <Arduino.h>",
+    ]
+    entete = ""
+    for constante, balise, route, prefixe in RESSOURCES:
+        texte = retirer_balise(lire_chaine_c(source, constante), balise).encode("utf-8")
+        compresse = gzip.compress(texte, compresslevel=9, mtime=0)
+        empreinte = hashlib.sha256(compresse).hexdigest()[:16]
+        etag = '\\"' + empreinte + '\\"'
+        entete += BALISES[balise].replace("{u}", lire_chaine_c(source, route) + "?v=" + empreinte)
+        sortie += [
+            "",
+            "// %s : %d octets, %d octets compressés" % (constante, len(texte), len(compresse)),
+            'const char    %s_ETAG[] PROGMEM = "%s";' % (prefixe, etag),
+            "const size_t  %s_GZ_TAILLE = %d;" % (prefixe, len(compresse)),
+            "const uint8_t %s_GZ[] PROGMEM = {" % prefixe,
+            tableau_c(compresse),
+            "};",
+        ]
+    sortie += [
+        "",
+        "// Balises de l'en-tête des pages, à la place de HTTP_STYLE et HTTP_SCRIPT",
+        'const char    WM_HEAD_ASSETS[] PROGMEM = "%s";' % entete,
+        "",
+        "#endif",
+        "",
+    ]
+    contenu = "\n".join(sortie)
+
+    chemin = os.path.join(racine, "include", "ressources_portail.h")
+    if os.path.exists(chemin):
+        with open(chemin, encoding="utf-8") as f:
+            if f.read() == contenu:
+                return
+    with open(chemin, "w", encoding="utf-8") as f:
+        f.write(contenu)
+    print("ressources_portail.h régénéré")
+
+
+try:
+    Import("env")  # noqa: F821 (fourni par PlatformIO)
+    generer(env["PROJECT_DIR"])  # noqa: F821
+except NameError:
+    generer(os.path.join(os.path.dirname(os.path.abspath(__file__)), ".."))
@@ -0,0 +1,40 @@
+/**
+ * WM_Template.cpp
+ *
+ * precompiled html templates for the WiFiManager portal pages
+ *
+ * @license MIT
+ */
+
+#include "WM_Template.h"
+
+/**
+ * parse a template text into literal spans and single letter {x} tokens
+ * once the part table is nearly full, the rest of the text stays literal
+ */
+void WM_Template::append(PGM_P text){
+  size_t len = strlen_P(text);
+  size_t lit = 0; // start of the current literal span
+  for(size_t i = 0; i + 2 < len && _count + 3 <= WM_TEMPLATE_PARTS; i++){
+    if(pgm_read_byte(text + i) != '{' || pgm_read_byte(text + i + 2) != '}') continue;
+    char token = pgm_read_byte(text + i + 1);
+    if(token == '{' || token == '}') continue;
+    if(i > lit) add(text + lit, i - lit, 0);
+    add(text + i, 3, token);
+    i  += 2;
+    lit = i + 1;
+  }
+  if(len > lit) add(text + lit, len - lit, 0);
+}
+
+void WM_Template::add(PGM_P str, uint16_t length, char token){
+  if(_count >= WM_TEMPLATE_PARTS) return;
+  _parts[_count++] = { str, length, token };
+}
+
+bool WM_Template::has(char token) const {
+  for(uint8_t i = 0; i < _count; i++){
+    if(_parts[i].token == token) return true;
+  }
+  return false;
+}
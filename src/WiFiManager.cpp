@@ -11,6 +11,9 @@
  */
 
 #include "WiFiManager.h"
+#ifndef WM_INLINE_ASSETS
+#include "ressources_portail.h"
+#endif
 
 
 #ifdef ESP32
@@ -241,6 +244,10 @@ WiFiManager::~WiFiManager() {
     WiFi.removeEvent(wm_event_id);
   #endif
 
+  #if defined(ESP32) && defined(WM_ASYNCWEBSERVER)
+  if(_portalLock) vSemaphoreDelete(_portalLock);
+  #endif
+
   #ifdef WM_DEBUG_LEVEL
   DEBUG_WM(DEBUG_DEV,F("unloading"));
   #endif
@@ -262,6 +269,23 @@ void WiFiManager::_end(){
   // if(_usermode != WIFI_OFF) WiFi.mode(_usermode);
 }
 
+/**
+ * serialize the portal loop with the route handlers (httpd task), see _portalLock
+ * created on first use, always before the server that takes it around each request
+ */
+void WiFiManager::portalLock(){
+  #if defined(ESP32) && defined(WM_ASYNCWEBSERVER)
+  if(!_portalLock) _portalLock = xSemaphoreCreateRecursiveMutex();
+  xSemaphoreTakeRecursive(_portalLock, portMAX_DELAY);
+  #endif
+}
+
+void WiFiManager::portalUnlock(){
+  #if defined(ESP32) && defined(WM_ASYNCWEBSERVER)
+  xSemaphoreGiveRecursive(_portalLock);
+  #endif
+}
+
 // AUTOCONNECT
 
 boolean WiFiManager::autoConnect() {
@@ -567,6 +591,7 @@ bool WiFiManager::startAP(){
  * @return {[type]} [description]
  */
 void WiFiManager::startWebPortal() {
+  PortalLock lock(this);
   if(configPortalActive || webPortalActive) return;
   connect = abort = false;
   setupConfigPortal();
@@ -579,6 +604,7 @@ void WiFiManager::startWebPortal() {
  * @return {[type]} [description]
  */
 void WiFiManager::stopWebPortal() {
+  PortalLock lock(this);
   if(!configPortalActive && !webPortalActive) return;
   #ifdef WM_DEBUG_LEVEL
   DEBUG_WM(DEBUG_VERBOSE,F("Stopping Web Portal"));  
@@ -641,6 +667,9 @@ void WiFiManager::setupHTTPServer(){
 
   server.reset(new WM_WebServer(_httpPort));
   // This is not the safest way to reset the webserver, it can cause crashes on callbacks initilized before this and since its a shared pointer...
+  #if defined(ESP32) && defined(WM_ASYNCWEBSERVER)
+  server->setHandlerLock(_portalLock); // held here, created by the caller's PortalLock
+  #endif
 
   if ( _webservercallback != NULL) {
     #ifdef WM_DEBUG_LEVEL
@@ -665,6 +694,12 @@ void WiFiManager::setupHTTPServer(){
   server->on(WM_G(R_close),      std::bind(&WiFiManager::handleClose, this));
   server->on(WM_G(R_erase),      std::bind(&WiFiManager::handleErase, this, false));
   server->on(WM_G(R_status),     std::bind(&WiFiManager::handleWiFiStatus, this));
+  #ifndef WM_INLINE_ASSETS
+  server->on(WM_G(R_css),        std::bind(&WiFiManager::handleAsset, this, WM_CSS_GZ, WM_CSS_GZ_TAILLE, PSTR("text/css"), WM_CSS_ETAG));
+  server->on(WM_G(R_js),         std::bind(&WiFiManager::handleAsset, this, WM_JS_GZ, WM_JS_GZ_TAILLE, PSTR("application/javascript"), WM_JS_ETAG));
+  const char *assetHeaders[] = { "If-None-Match" };
+  server->collectHeaders(assetHeaders, 1);
+  #endif
   
   // Routes pour la détection du portail captif (Android, iOS, Windows)
   // Android
@@ -705,7 +740,7 @@ void WiFiManager::setupHTTPServer(){
 }
 
 void WiFiManager::setupDNSD(){
-  dnsServer.reset(new DNSServer());
+  dnsServer.reset(new WM_DNSServer());
 
   /* Setup the DNS server redirecting all the domains to the apIP */
   dnsServer->setErrorReplyCode(DNSReplyCode::NoError);
@@ -735,6 +770,7 @@ boolean WiFiManager::startConfigPortal() {
  * @return {[type]}      [description]
  */
 boolean  WiFiManager::startConfigPortal(char const *apName, char const *apPassword) {
+  PortalLock lock(this); // released only while the blocking loop sleeps, handlers run then
   _begin();
 
   if(configPortalActive){
@@ -852,7 +888,13 @@ boolean  WiFiManager::startConfigPortal(char const *apName, char const *apPasswo
 
     if(!configPortalActive) break;
 
+    #ifdef WM_ASYNCWEBSERVER
+    portalUnlock();
+    server->waitRequest(WM_ASYNC_IDLE_MS); // sleep until a request was served (save, exit) or the timeout check is due
+    portalLock();
+    #else
     yield(); // watchdog
+    #endif
   }
 
   #ifdef WM_DEBUG_LEVEL
@@ -867,6 +909,7 @@ boolean  WiFiManager::startConfigPortal(char const *apName, char const *apPasswo
  * @return bool connected
  */
 boolean WiFiManager::process(){
+    PortalLock lock(this); // handlers wait while save and exit flags are processed
     // process mdns, esp32 not required
 	
     if(webPortalActive || (configPortalActive && !_configPortalIsBlocking)){
@@ -900,6 +943,8 @@ boolean WiFiManager::process(){
  * @return {[type]} [description]
  */
 uint8_t WiFiManager::processConfigPortal(){
+    WiFi_scanCollect();
+
     if(configPortalActive){
       //DNS handler
       dnsServer->processNextRequest();
@@ -992,6 +1037,7 @@ uint8_t WiFiManager::processConfigPortal(){
  * @return bool success (softapdisconnect)
  */
 bool WiFiManager::shutdownConfigPortal(){
+  PortalLock lock(this);
   #ifdef WM_DEBUG_LEVEL
   DEBUG_WM(DEBUG_VERBOSE,F("shutdownConfigPortal"));
   #endif
@@ -1012,6 +1058,8 @@ bool WiFiManager::shutdownConfigPortal(){
   server.reset();
 
   WiFi.scanDelete(); // free wifi scan results
+  std::vector<WM_ScanEntry>().swap(_scanTable);
+  _scanTableStale = true;
 
   if(!configPortalActive) return false;
 
@@ -1332,24 +1380,85 @@ void WiFiManager::startWPS() {
 }
 #endif
 
-String WiFiManager::getHTTPHead(String title){
-  String page;
-  page += FPSTR(HTTP_HEAD_START);
-  page.replace(FPSTR(T_v), title);
-  page += FPSTR(HTTP_SCRIPT);
-  page += FPSTR(HTTP_STYLE);
-  page += _customHeadElement;
+/**
+ * start a streamed page, 200 with unknown length, the body follows as chunks
+ */
+void WiFiManager::HTTPBegin(){
+  _chunkLen = 0;
+  server->setContentLength(CONTENT_LENGTH_UNKNOWN);
+  server->send(200, FPSTR(HTTP_HEAD_CT), "");
+}
+
+/**
+ * append to the streamed page, a chunk is sent each time the buffer fills
+ * str may be in flash (PGM_P), it is copied out slice by slice
+ */
+void WiFiManager::HTTPWrite(const char *str, size_t len){
+  while(len > 0){
+    size_t n = std::min(len, sizeof(_chunkBuf) - _chunkLen);
+    memcpy_P(_chunkBuf + _chunkLen, str, n);
+    _chunkLen += n;
+    str += n;
+    len -= n;
+    if(_chunkLen == sizeof(_chunkBuf)){
+      server->sendContent(_chunkBuf, _chunkLen);
+      _chunkLen = 0;
+    }
+  }
+}
+
+void WiFiManager::HTTPWrite(const char *str){
+  HTTPWrite(str, strlen_P(str));
+}
+
+void WiFiManager::HTTPWrite(const __FlashStringHelper *str){
+  HTTPWrite((PGM_P)str);
+}
+
+void WiFiManager::HTTPWrite(const String &str){
+  HTTPWrite(str.c_str(), str.length());
+}
+
+/**
+ * render a precompiled template in one pass, literal spans and token values go straight to the stream
+ */
+template <typename Value>
+void WiFiManager::HTTPWriteTemplate(const WM_Template &tpl, Value value){
+  tpl.render([this](const char *str, size_t length){ HTTPWrite(str, length); }, value);
+}
+
+/**
+ * stream the page head, script and style are referenced (gzip routes) or inlined from flash
+ */
+void WiFiManager::HTTPWriteHead(String title){
+  String str = FPSTR(HTTP_HEAD_START);
+  str.replace(FPSTR(T_v), title);
+  HTTPWrite(str);
+  #ifdef WM_INLINE_ASSETS
+  HTTPWrite(FPSTR(HTTP_SCRIPT));
+  HTTPWrite(FPSTR(HTTP_STYLE));
+  #else
+  HTTPWrite(FPSTR(WM_HEAD_ASSETS));
+  #endif
+  HTTPWrite(_customHeadElement);
 
   if(_bodyClass != ""){
-    String p = FPSTR(HTTP_HEAD_END);
-    p.replace(FPSTR(T_c), _bodyClass); // add class str
-    page += p;
+    str = FPSTR(HTTP_HEAD_END);
+    str.replace(FPSTR(T_c), _bodyClass); // add class str
+    HTTPWrite(str);
   }
   else {
-    page += FPSTR(HTTP_HEAD_END);
+    HTTPWrite(FPSTR(HTTP_HEAD_END));
   } 
+}
 
-  return page;
+/**
+ * send what is left in the buffer and the final empty chunk
+ */
+void WiFiManager::HTTPEnd(){
+  if(_chunkLen > 0) server->sendContent(_chunkBuf, _chunkLen);
+  _chunkLen = 0;
+  server->sendContent("");
 }
 
 void WiFiManager::HTTPSend(String content){
@@ -1392,23 +1501,38 @@ void WiFiManager::handleRoot() {
   #endif
   if (captivePortal()) return; // If captive portal redirect instead of displaying the page
   handleRequest();
-  String page = getHTTPHead(_title); // @token options @todo replace options with title
+  HTTPBegin();
+  HTTPWriteHead(_title); // @token options @todo replace options with title
   String str  = FPSTR(HTTP_ROOT_MAIN); // @todo custom title
   str.replace(FPSTR(T_t),_title);
   str.replace(FPSTR(T_v),configPortalActive ? _apName : (getWiFiHostname() + " - " + WiFi.localIP().toString())); // use ip if ap is not active for heading @todo use hostname?
-  page += str;
-  page += FPSTR(HTTP_PORTAL_OPTIONS);
-  page += getMenuOut();
-  reportStatus(page);
-  page += FPSTR(HTTP_END);
-
-  HTTPSend(page);
+  HTTPWrite(str);
+  HTTPWrite(FPSTR(HTTP_PORTAL_OPTIONS));
+  writeMenuOut();
+  reportStatus();
+  HTTPWrite(FPSTR(HTTP_END));
+  HTTPEnd();
   if(_preloadwifiscan) WiFi_scanNetworks(_scancachetime,true); // preload wifiscan throttled, async
   // @todo buggy, captive portals make a query on every page load, causing this to run every time in addition to the real page load
   // I dont understand why, when you are already in the captive portal, I guess they want to know that its still up and not done or gone
   // if we can detect these and ignore them that would be great, since they come from the captive portal redirect maybe there is a refferer
 }
 
+/**
+ * HTTPD CALLBACK css/js, gzip compressed at build time
+ * the page links carry the content hash, so the long cache is safe; the ETag covers revalidation
+ */
+void WiFiManager::handleAsset(const uint8_t *data, size_t len, PGM_P type, PGM_P etag){
+  server->sendHeader(F("ETag"), FPSTR(etag));
+  server->sendHeader(F("Cache-Control"), F("public, max-age=31536000, immutable"));
+  if(server->header(F("If-None-Match")) == String(FPSTR(etag))){
+    server->send(304);
+    return;
+  }
+  server->sendHeader(F("Content-Encoding"), F("gzip"));
+  server->send_P(200, type, (PGM_P)data, len);
+}
+
 /**
  * HTTPD CALLBACK Wifi config page handler
  */
@@ -1417,19 +1541,20 @@ void WiFiManager::handleWifi(boolean scan) {
   DEBUG_WM(DEBUG_VERBOSE,F("<- HTTP Wifi"));
   #endif
   handleRequest();
-  String page = getHTTPHead(FPSTR(S_titlewifi)); // @token titlewifi
   if (scan) {
     #ifdef WM_DEBUG_LEVEL
     // DEBUG_WM(DEBUG_DEV,"refresh flag:",server->hasArg(F("refresh")));
     #endif
-    WiFi_scanNetworks(server->hasArg(F("refresh")),false); //wifiscan, force if arg refresh
-    page += getScanItemOut();
+    WiFi_scanNetworks(server->hasArg(F("refresh")),false); //wifiscan, force if arg refresh, before the page starts
   }
+  HTTPBegin();
+  HTTPWriteHead(FPSTR(S_titlewifi)); // @token titlewifi
+  if (scan) writeScanItemOut();
   String pitem = "";
 
   pitem = FPSTR(HTTP_FORM_START);
   pitem.replace(FPSTR(T_v), F("wifisave")); // set form action
-  page += pitem;
+  HTTPWrite(pitem);
 
   pitem = FPSTR(HTTP_FORM_WIFI);
   pitem.replace(FPSTR(T_v), WiFi_SSID());
@@ -1444,21 +1569,20 @@ void WiFiManager::handleWifi(boolean scan) {
     pitem.replace(FPSTR(T_p),"");    
   }
 
-  page += pitem;
+  HTTPWrite(pitem);
 
-  page += getStaticOut();
-  page += FPSTR(HTTP_FORM_WIFI_END);
+  writeStaticOut();
+  HTTPWrite(FPSTR(HTTP_FORM_WIFI_END));
   if(_paramsInWifi && _paramsCount>0){
-    page += FPSTR(HTTP_FORM_PARAM_HEAD);
-    page += getParamOut();
+    HTTPWrite(FPSTR(HTTP_FORM_PARAM_HEAD));
+    writeParamOut();
   }
-  page += FPSTR(HTTP_FORM_END);
-  page += FPSTR(HTTP_SCAN_LINK);
-  if(_showBack) page += FPSTR(HTTP_BACKBTN);
-  reportStatus(page);
-  page += FPSTR(HTTP_END);
-
-  HTTPSend(page);
+  HTTPWrite(FPSTR(HTTP_FORM_END));
+  HTTPWrite(FPSTR(HTTP_SCAN_LINK));
+  if(_showBack) HTTPWrite(FPSTR(HTTP_BACKBTN));
+  reportStatus();
+  HTTPWrite(FPSTR(HTTP_END));
+  HTTPEnd();
 
   #ifdef WM_DEBUG_LEVEL
   DEBUG_WM(DEBUG_DEV,F("Sent config page"));
@@ -1473,21 +1597,21 @@ void WiFiManager::handleParam(){
   DEBUG_WM(DEBUG_VERBOSE,F("<- HTTP Param"));
   #endif
   handleRequest();
-  String page = getHTTPHead(FPSTR(S_titleparam)); // @token titlewifi
+  HTTPBegin();
+  HTTPWriteHead(FPSTR(S_titleparam)); // @token titlewifi
 
   String pitem = "";
 
   pitem = FPSTR(HTTP_FORM_START);
   pitem.replace(FPSTR(T_v), F("paramsave"));
-  page += pitem;
+  HTTPWrite(pitem);
 
-  page += getParamOut();
-  page += FPSTR(HTTP_FORM_END);
-  if(_showBack) page += FPSTR(HTTP_BACKBTN);
-  reportStatus(page);
-  page += FPSTR(HTTP_END);
-
-  HTTPSend(page);
+  writeParamOut();
+  HTTPWrite(FPSTR(HTTP_FORM_END));
+  if(_showBack) HTTPWrite(FPSTR(HTTP_BACKBTN));
+  reportStatus();
+  HTTPWrite(FPSTR(HTTP_END));
+  HTTPEnd();
 
   #ifdef WM_DEBUG_LEVEL
   DEBUG_WM(DEBUG_DEV,F("Sent param page"));
@@ -1495,19 +1619,15 @@ void WiFiManager::handleParam(){
 }
 
 
-String WiFiManager::getMenuOut(){
-  String page;  
-
+void WiFiManager::writeMenuOut(){
   for(auto menuId :_menuIds ){
     if((String)_menutokens[menuId] == "param" && _paramsCount == 0) continue; // no params set, omit params from menu, @todo this may be undesired by someone, use only menu to force?
     if((String)_menutokens[menuId] == "custom" && _customMenuHTML!=NULL){
-      page += _customMenuHTML;
+      HTTPWrite(_customMenuHTML);
       continue;
     }
-    page += HTTP_PORTAL_MENU[menuId];
+    HTTPWrite(HTTP_PORTAL_MENU[menuId]);
   }
-
-  return page;
 }
 
 // // is it possible in softap mode to detect aps without scanning
@@ -1518,12 +1638,64 @@ String WiFiManager::getMenuOut(){
 void WiFiManager::WiFi_scanComplete(int networksFound){
   _lastscan = millis();
   _numNetworks = networksFound;
+  _scanTableStale = true; // rebuilt by the portal task, esp32 scan events arrive on the event task
   #ifdef WM_DEBUG_LEVEL
   DEBUG_WM(DEBUG_VERBOSE,F("WiFi Scan ASYNC completed"), "in "+(String)(_lastscan - _startscan)+" ms");  
   DEBUG_WM(DEBUG_VERBOSE,F("WiFi Scan ASYNC found:"),_numNetworks);
   #endif
 }
 
+void WiFiManager::WiFi_scanCollect(){
+  #if defined(ESP32) && defined(WM_ASYNCWEBSERVER)
+  int n = _scanDone.exchange(-1);
+  if(n >= 0) WiFi_scanComplete(n);
+  #endif
+}
+
+/**
+ * build the scan table from the driver results, once per scan
+ * sorted strongest first, duplicate ssids keep their strongest bssid, hidden ssids are dropped
+ * O(n log n), each result is read once from the driver
+ */
+void WiFiManager::WiFi_scanTable(){
+  WiFi_scanCollect();
+  if(!_scanTableStale) return;
+  _scanTableStale = false;
+  _scanTable.clear();
+
+  int n = std::min(_numNetworks, 255); // driver accessors take a uint8_t index
+  if(n <= 0) return;
+  _scanTable.reserve(n);
+  for (int i = 0; i < n; i++) {
+    String ssid = WiFi.SSID(i);
+    if(ssid == "") continue; // No idea why I am seeing these, lets just skip them for now
+    uint32_t hash = 2166136261u;
+    for (size_t c = 0; c < ssid.length(); c++) {
+      hash = (hash ^ (uint8_t)ssid[c]) * 16777619u;
+    }
+    _scanTable.push_back({ hash, (uint8_t)i, (int8_t)WiFi.RSSI(i), (uint8_t)WiFi.channel(i), (uint8_t)WiFi.encryptionType(i) });
+  }
+
+  // remove duplicates, strongest bssid first within each ssid then keep the first
+  if (_removeDuplicateAPs) {
+    std::sort(_scanTable.begin(), _scanTable.end(), [](const WM_ScanEntry &a, const WM_ScanEntry &b) {
+      return a.hash != b.hash ? a.hash < b.hash : a.rssi > b.rssi;
+    });
+    auto last = std::unique(_scanTable.begin(), _scanTable.end(), [](const WM_ScanEntry &a, const WM_ScanEntry &b) {
+      return a.hash == b.hash;
+    });
+    #ifdef WM_DEBUG_LEVEL
+    DEBUG_WM(DEBUG_VERBOSE,F("DUP APs removed:"),(int)(_scanTable.end() - last));
+    #endif
+    _scanTable.erase(last, _scanTable.end());
+  }
+
+  // RSSI SORT
+  std::stable_sort(_scanTable.begin(), _scanTable.end(), [](const WM_ScanEntry &a, const WM_ScanEntry &b) {
+    return a.rssi > b.rssi;
+  });
+}
+
 bool WiFiManager::WiFi_scanNetworks(){
   return WiFi_scanNetworks(false,false);
 }
@@ -1535,6 +1707,7 @@ bool WiFiManager::WiFi_scanNetworks(unsigned int cachetime){
     return WiFi_scanNetworks(millis()-_lastscan > cachetime,false);
 }
 bool WiFiManager::WiFi_scanNetworks(bool force,bool async){
+    WiFi_scanCollect();
     #ifdef WM_DEBUG_LEVEL
     // DEBUG_WM(DEBUG_DEV,"scanNetworks async:",async == true);
     // DEBUG_WM(DEBUG_DEV,_numNetworks,(millis()-_lastscan ));
@@ -1599,6 +1772,7 @@ bool WiFiManager::WiFi_scanNetworks(bool force,bool async){
       }
       else if(res >=0 ) _numNetworks = res;
       _lastscan = millis();
+      _scanTableStale = true;
       #ifdef WM_DEBUG_LEVEL
       DEBUG_WM(DEBUG_VERBOSE,F("WiFi Scan completed"), "in "+(String)(_lastscan - _startscan)+" ms");
       #endif
@@ -1612,63 +1786,25 @@ bool WiFiManager::WiFi_scanNetworks(bool force,bool async){
     return false;
 }
 
-String WiFiManager::WiFiManager::getScanItemOut(){
-    String page;
-
+void WiFiManager::WiFiManager::writeScanItemOut(){
     if(!_numNetworks) WiFi_scanNetworks(); // scan in case this gets called before any scans
 
-    int n = _numNetworks;
+    WiFi_scanTable();
+
+    int n = _scanTable.size();
     if (n == 0) {
       #ifdef WM_DEBUG_LEVEL
       DEBUG_WM(F("No networks found"));
       #endif
-      page += FPSTR(S_nonetworks); // @token nonetworks
-      page += F("<br/><br/>");
+      HTTPWrite(FPSTR(S_nonetworks)); // @token nonetworks
+      HTTPWrite(F("<br/><br/>"));
     }
     else {
       #ifdef WM_DEBUG_LEVEL
       DEBUG_WM(n,F("networks found"));
       #endif
-      //sort networks
-      int indices[n];
-      for (int i = 0; i < n; i++) {
-        indices[i] = i;
-      }
-
-      // RSSI SORT
-      for (int i = 0; i < n; i++) {
-        for (int j = i + 1; j < n; j++) {
-          if (WiFi.RSSI(indices[j]) > WiFi.RSSI(indices[i])) {
-            std::swap(indices[i], indices[j]);
-          }
-        }
-      }
 
-      /* test std:sort
-        std::sort(indices, indices + n, [](const int & a, const int & b) -> bool
-        {
-        return WiFi.RSSI(a) > WiFi.RSSI(b);
-        });
-       */
-
-      // remove duplicates ( must be RSSI sorted )
-      if (_removeDuplicateAPs) {
-        String cssid;
-        for (int i = 0; i < n; i++) {
-          if (indices[i] == -1) continue;
-          cssid = WiFi.SSID(indices[i]);
-          for (int j = i + 1; j < n; j++) {
-            if (cssid == WiFi.SSID(indices[j])) {
-              #ifdef WM_DEBUG_LEVEL
-              DEBUG_WM(DEBUG_VERBOSE,F("DUP AP:"),WiFi.SSID(indices[j]));
-              #endif
-              indices[j] = -1; // set dup aps to index -1
-            }
-          }
-        }
-      }
-
-      // token precheck, to speed up replacements on large ap lists
+      // item template, composed and compiled once per page
       String HTTP_ITEM_STR = FPSTR(HTTP_ITEM);
 
       // toggle icons with percentage
@@ -1676,48 +1812,49 @@ String WiFiManager::WiFiManager::getScanItemOut(){
       HTTP_ITEM_STR.replace("{h}",_scanDispOptions ? "" : "h");
       HTTP_ITEM_STR.replace("{qi}", FPSTR(HTTP_ITEM_QI));
       HTTP_ITEM_STR.replace("{h}",_scanDispOptions ? "h" : "");
- 
-      // set token precheck flags
-      bool tok_r = HTTP_ITEM_STR.indexOf(FPSTR(T_r)) > 0;
-      bool tok_R = HTTP_ITEM_STR.indexOf(FPSTR(T_R)) > 0;
-      bool tok_e = HTTP_ITEM_STR.indexOf(FPSTR(T_e)) > 0;
-      bool tok_q = HTTP_ITEM_STR.indexOf(FPSTR(T_q)) > 0;
-      bool tok_i = HTTP_ITEM_STR.indexOf(FPSTR(T_i)) > 0;
+
+      WM_Template tpl;
+      tpl.append(HTTP_ITEM_STR.c_str());
+
+      // set token precheck flags, values are only built for tokens in the template
+      bool tok_e = tpl.has('e');
       
       //display networks in page
       for (int i = 0; i < n; i++) {
-        if (indices[i] == -1) continue; // skip dups
+        const WM_ScanEntry &ap = _scanTable[i];
 
-        #ifdef WM_DEBUG_LEVEL
-        DEBUG_WM(DEBUG_VERBOSE,F("AP: "),(String)WiFi.RSSI(indices[i]) + " " + (String)WiFi.SSID(indices[i]));
-        #endif
-
-        int rssiperc = getRSSIasQuality(WiFi.RSSI(indices[i]));
-        uint8_t enc_type = WiFi.encryptionType(indices[i]);
+        int rssiperc = getRSSIasQuality(ap.rssi);
+        uint8_t enc_type = ap.enc;
 
         if (_minimumQuality == -1 || _minimumQuality < rssiperc) {
-          String item = HTTP_ITEM_STR;
-          if(WiFi.SSID(indices[i]) == ""){
-            // Serial.println(WiFi.BSSIDstr(indices[i]));
-            continue; // No idea why I am seeing these, lets just skip them for now
-          }
-          item.replace(FPSTR(T_V), htmlEntities(WiFi.SSID(indices[i]))); // ssid no encoding
-          item.replace(FPSTR(T_v), htmlEntities(WiFi.SSID(indices[i]),true)); // ssid no encoding
-          if(tok_e) item.replace(FPSTR(T_e), encryptionTypeStr(enc_type));
-          if(tok_r) item.replace(FPSTR(T_r), (String)rssiperc); // rssi percentage 0-100
-          if(tok_R) item.replace(FPSTR(T_R), (String)WiFi.RSSI(indices[i])); // rssi db
-          if(tok_q) item.replace(FPSTR(T_q), (String)int(round(map(rssiperc,0,100,1,4)))); //quality icon 1-4
-          if(tok_i){
-            if (enc_type != WM_WIFIOPEN) {
-              item.replace(FPSTR(T_i), F("l"));
-            } else {
-              item.replace(FPSTR(T_i), "");
+          String ssid = WiFi.SSID(ap.index);
+          #ifdef WM_DEBUG_LEVEL
+          DEBUG_WM(DEBUG_VERBOSE,F("AP: "),(String)ap.rssi + " ch" + (String)ap.channel + " " + ssid);
+          #endif
+          if(ssid == "") continue; // results freed by a new scan since the table was built
+          String ssidText = htmlEntities(ssid);      // ssid no encoding
+          String ssidAttr = htmlEntities(ssid,true); // ssid no encoding
+          String enc      = tok_e ? encryptionTypeStr(enc_type) : "";
+          char perc[5], rssi[5], qual[2];
+          snprintf(perc, sizeof(perc), "%d", rssiperc); // rssi percentage 0-100
+          snprintf(rssi, sizeof(rssi), "%d", ap.rssi); // rssi db
+          snprintf(qual, sizeof(qual), "%d", int(round(map(rssiperc,0,100,1,4)))); //quality icon 1-4
+
+          HTTPWriteTemplate(tpl, [&](char token) -> const char* {
+            switch(token){
+              case 'V': return ssidText.c_str();
+              case 'v': return ssidAttr.c_str();
+              case 'e': return enc.c_str();
+              case 'r': return perc;
+              case 'R': return rssi;
+              case 'q': return qual;
+              case 'i': return enc_type != WM_WIFIOPEN ? "l" : "";
+              default:  return NULL;
             }
-          }
+          });
           #ifdef WM_DEBUG_LEVEL
-          DEBUG_WM(DEBUG_DEV,item);
+          DEBUG_WM(DEBUG_DEV,F("AP item:"),ssid);
           #endif
-          page += item;
           delay(0);
         } else {
           #ifdef WM_DEBUG_LEVEL
@@ -1726,73 +1863,60 @@ String WiFiManager::WiFiManager::getScanItemOut(){
         }
 
       }
-      page += FPSTR(HTTP_BR);
+      HTTPWrite(FPSTR(HTTP_BR));
     }
-
-    return page;
 }
 
-String WiFiManager::getIpForm(String id, String title, String value){
-    String item = FPSTR(HTTP_FORM_LABEL);
-    item += FPSTR(HTTP_FORM_PARAM);
-    item.replace(FPSTR(T_i), id);
-    item.replace(FPSTR(T_n), id);
-    item.replace(FPSTR(T_p), FPSTR(T_t));
-    // item.replace(FPSTR(T_p), default);
-    item.replace(FPSTR(T_t), title);
-    item.replace(FPSTR(T_l), F("15"));
-    item.replace(FPSTR(T_v), value);
-    item.replace(FPSTR(T_c), "");
-    return item;  
+void WiFiManager::writeIpForm(const WM_Template &tpl, const char *id, const char *title, const char *value){
+    HTTPWriteTemplate(tpl, [&](char token) -> const char* {
+      switch(token){
+        case 'i':
+        case 'n': return id;
+        case 'p': // legacy placeholder token, same as title
+        case 't': return title;
+        case 'l': return "15";
+        case 'v': return value;
+        case 'c': return "";
+        default:  return NULL;
+      }
+    });
 }
 
-String WiFiManager::getStaticOut(){
-  String page;
+void WiFiManager::writeStaticOut(){
+  bool fields = false;
+  WM_Template tpl;
+  tpl.append(HTTP_FORM_LABEL);
+  tpl.append(HTTP_FORM_PARAM);
   if ((_staShowStaticFields || _sta_static_ip) && _staShowStaticFields>=0) {
     #ifdef WM_DEBUG_LEVEL
     DEBUG_WM(DEBUG_DEV,F("_staShowStaticFields"));
     #endif
-    page += FPSTR(HTTP_FORM_STATIC_HEAD);
+    HTTPWrite(FPSTR(HTTP_FORM_STATIC_HEAD));
     // @todo how can we get these accurate settings from memory , wifi_get_ip_info does not seem to reveal if struct ip_info is static or not
-    page += getIpForm(FPSTR(S_ip),FPSTR(S_staticip),(_sta_static_ip ? _sta_static_ip.toString() : "")); // @token staticip
+    writeIpForm(tpl,S_ip,S_staticip,(_sta_static_ip ? _sta_static_ip.toString() : "").c_str()); // @token staticip
     // WiFi.localIP().toString();
-    page += getIpForm(FPSTR(S_gw),FPSTR(S_staticgw),(_sta_static_gw ? _sta_static_gw.toString() : "")); // @token staticgw
+    writeIpForm(tpl,S_gw,S_staticgw,(_sta_static_gw ? _sta_static_gw.toString() : "").c_str()); // @token staticgw
     // WiFi.gatewayIP().toString();
-    page += getIpForm(FPSTR(S_sn),FPSTR(S_subnet),(_sta_static_sn ? _sta_static_sn.toString() : "")); // @token subnet
+    writeIpForm(tpl,S_sn,S_subnet,(_sta_static_sn ? _sta_static_sn.toString() : "").c_str()); // @token subnet
     // WiFi.subnetMask().toString();
+    fields = true;
   }
 
   if((_staShowDns || _sta_static_dns) && _staShowDns>=0){
-    page += getIpForm(FPSTR(S_dns),FPSTR(S_staticdns),(_sta_static_dns ? _sta_static_dns.toString() : "")); // @token dns
+    writeIpForm(tpl,S_dns,S_staticdns,(_sta_static_dns ? _sta_static_dns.toString() : "").c_str()); // @token dns
+    fields = true;
   }
 
-  if(page!="") page += FPSTR(HTTP_BR); // @todo remove these, use css
-
-  return page;
+  if(fields) HTTPWrite(FPSTR(HTTP_BR)); // @todo remove these, use css
 }
 
-String WiFiManager::getParamOut(){
-  String page;
-
+void WiFiManager::writeParamOut(){
   #ifdef WM_DEBUG_LEVEL
-  DEBUG_WM(DEBUG_DEV,F("getParamOut"),_paramsCount);
+  DEBUG_WM(DEBUG_DEV,F("writeParamOut"),_paramsCount);
   #endif
 
   if(_paramsCount > 0){
 
-    String HTTP_PARAM_temp = FPSTR(HTTP_FORM_LABEL);
-    HTTP_PARAM_temp += FPSTR(HTTP_FORM_PARAM);
-    bool tok_I = HTTP_PARAM_temp.indexOf(FPSTR(T_I)) > 0;
-    bool tok_i = HTTP_PARAM_temp.indexOf(FPSTR(T_i)) > 0;
-    bool tok_n = HTTP_PARAM_temp.indexOf(FPSTR(T_n)) > 0;
-    bool tok_p = HTTP_PARAM_temp.indexOf(FPSTR(T_p)) > 0;
-    bool tok_t = HTTP_PARAM_temp.indexOf(FPSTR(T_t)) > 0;
-    bool tok_l = HTTP_PARAM_temp.indexOf(FPSTR(T_l)) > 0;
-    bool tok_v = HTTP_PARAM_temp.indexOf(FPSTR(T_v)) > 0;
-    bool tok_c = HTTP_PARAM_temp.indexOf(FPSTR(T_c)) > 0;
-
-    char valLength[5];
-
     for (int i = 0; i < _paramsCount; i++) {
       //Serial.println((String)_params[i]->_length);
       if (_params[i] == NULL || _params[i]->_length == 0 || _params[i]->_length > 99999) {
@@ -1800,51 +1924,69 @@ String WiFiManager::getParamOut(){
         #ifdef WM_DEBUG_LEVEL
         DEBUG_WM(DEBUG_ERROR,F("[ERROR] WiFiManagerParameter is out of scope"));
         #endif
-        return "";
+        return;
       }
     }
 
+    // one template per label placement, compiled when the placement changes
+    WM_Template tpl;
+    int placement = -1;
+    char idNum[16];
+    char valLength[5];
+
     // add the extra parameters to the form
     for (int i = 0; i < _paramsCount; i++) {
-     // label before or after, @todo this could be done via floats or CSS and eliminated
-     String pitem;
-      switch (_params[i]->getLabelPlacement()) {
-        case WFM_LABEL_BEFORE:
-          pitem = FPSTR(HTTP_FORM_LABEL);
-          pitem += FPSTR(HTTP_FORM_PARAM);
-          break;
-        case WFM_LABEL_AFTER:
-          pitem = FPSTR(HTTP_FORM_PARAM);
-          pitem += FPSTR(HTTP_FORM_LABEL);
-          break;
-        default:
-          // WFM_NO_LABEL
-          pitem = FPSTR(HTTP_FORM_PARAM);
-          break;
-      }
+      WiFiManagerParameter *param = _params[i];
 
-      // Input templating
-      // "<br/><input id='{i}' name='{n}' maxlength='{l}' value='{v}' {c}>";
       // if no ID use customhtml for item, else generate from param string
-      if (_params[i]->getID() != NULL) {
-        if(tok_I)pitem.replace(FPSTR(T_I), (String)FPSTR(S_parampre)+(String)i); // T_I id number
-        if(tok_i)pitem.replace(FPSTR(T_i), _params[i]->getID()); // T_i id name
-        if(tok_n)pitem.replace(FPSTR(T_n), _params[i]->getID()); // T_n id name alias
-        if(tok_p)pitem.replace(FPSTR(T_p), FPSTR(T_t)); // T_p replace legacy placeholder token
-        if(tok_t)pitem.replace(FPSTR(T_t), _params[i]->getLabel()); // T_t title/label
-        snprintf(valLength, 5, "%d", _params[i]->getValueLength());
-        if(tok_l)pitem.replace(FPSTR(T_l), valLength); // T_l value length
-        if(tok_v)pitem.replace(FPSTR(T_v), _params[i]->getValue()); // T_v value
-        if(tok_c)pitem.replace(FPSTR(T_c), _params[i]->getCustomHTML()); // T_c meant for additional attributes, not html, but can stuff
-      } else {
-        pitem = _params[i]->getCustomHTML();
+      if (param->getID() == NULL) {
+        if(param->getCustomHTML() != NULL) HTTPWrite(param->getCustomHTML());
+        continue;
       }
 
-      page += pitem;
+      // label before or after, @todo this could be done via floats or CSS and eliminated
+      if (param->getLabelPlacement() != placement) {
+        placement = param->getLabelPlacement();
+        tpl.clear();
+        switch (placement) {
+          case WFM_LABEL_BEFORE:
+            tpl.append(HTTP_FORM_LABEL);
+            tpl.append(HTTP_FORM_PARAM);
+            break;
+          case WFM_LABEL_AFTER:
+            tpl.append(HTTP_FORM_PARAM);
+            tpl.append(HTTP_FORM_LABEL);
+            break;
+          default:
+            // WFM_NO_LABEL
+            tpl.append(HTTP_FORM_PARAM);
+            break;
+        }
+      }
+
+      // Input templating
+      // "<br/><input id='{i}' name='{n}' maxlength='{l}' value='{v}' {c}>";
+      strncpy_P(idNum, S_parampre, sizeof(idNum) - 1);
+      idNum[sizeof(idNum) - 1] = '\0';
+      snprintf(idNum + strlen(idNum), sizeof(idNum) - strlen(idNum), "%d", i);
+      snprintf(valLength, sizeof(valLength), "%d", param->getValueLength());
+      HTTPWriteTemplate(tpl, [&](char token) -> const char* {
+        const char *v;
+        switch(token){
+          case 'I': return idNum; // T_I id number
+          case 'i': // T_i id name
+          case 'n': return param->getID(); // T_n id name alias
+          case 'p': // T_p legacy placeholder token, same as title
+          case 't': v = param->getLabel(); break; // T_t title/label
+          case 'l': return valLength; // T_l value length
+          case 'v': v = param->getValue(); break; // T_v value
+          case 'c': v = param->getCustomHTML(); break; // T_c meant for additional attributes, not html, but can stuff
+          default:  return NULL;
+        }
+        return v != NULL ? v : "";
+      });
     }
   }
-
-  return page;
 }
 
 void WiFiManager::handleWiFiStatus(){
@@ -1960,22 +2102,21 @@ void WiFiManager::handleWifiSave() {
   }
   #endif
 
-  String page;
+  server->sendHeader(FPSTR(HTTP_HEAD_CORS), FPSTR(HTTP_HEAD_CORS_ALLOW_ALL)); // @HTTPHEAD send cors
+  HTTPBegin();
 
   if(_ssid == ""){
-    page = getHTTPHead(FPSTR(S_titlewifisettings)); // @token titleparamsaved
-    page += FPSTR(HTTP_PARAMSAVED);
+    HTTPWriteHead(FPSTR(S_titlewifisettings)); // @token titleparamsaved
+    HTTPWrite(FPSTR(HTTP_PARAMSAVED));
   }
   else {
-    page = getHTTPHead(FPSTR(S_titlewifisaved)); // @token titlewifisaved
-    page += FPSTR(HTTP_SAVED);
+    HTTPWriteHead(FPSTR(S_titlewifisaved)); // @token titlewifisaved
+    HTTPWrite(FPSTR(HTTP_SAVED));
   }
 
-  if(_showBack) page += FPSTR(HTTP_BACKBTN);
-  page += FPSTR(HTTP_END);
-
-  server->sendHeader(FPSTR(HTTP_HEAD_CORS), FPSTR(HTTP_HEAD_CORS_ALLOW_ALL)); // @HTTPHEAD send cors
-  HTTPSend(page);
+  if(_showBack) HTTPWrite(FPSTR(HTTP_BACKBTN));
+  HTTPWrite(FPSTR(HTTP_END));
+  HTTPEnd();
 
   #ifdef WM_DEBUG_LEVEL
   DEBUG_WM(DEBUG_DEV,F("Sent wifi save page"));
@@ -1996,12 +2137,12 @@ void WiFiManager::handleParamSave() {
 
   doParamSave();
 
-  String page = getHTTPHead(FPSTR(S_titleparamsaved)); // @token titleparamsaved
-  page += FPSTR(HTTP_PARAMSAVED);
-  if(_showBack) page += FPSTR(HTTP_BACKBTN); 
-  page += FPSTR(HTTP_END);
-
-  HTTPSend(page);
+  HTTPBegin();
+  HTTPWriteHead(FPSTR(S_titleparamsaved)); // @token titleparamsaved
+  HTTPWrite(FPSTR(HTTP_PARAMSAVED));
+  if(_showBack) HTTPWrite(FPSTR(HTTP_BACKBTN)); 
+  HTTPWrite(FPSTR(HTTP_END));
+  HTTPEnd();
 
   #ifdef WM_DEBUG_LEVEL
   DEBUG_WM(DEBUG_DEV,F("Sent param save page"));
@@ -2062,8 +2203,9 @@ void WiFiManager::handleInfo() {
   DEBUG_WM(DEBUG_VERBOSE,F("<- HTTP Info"));
   #endif
   handleRequest();
-  String page = getHTTPHead(FPSTR(S_titleinfo)); // @token titleinfo
-  reportStatus(page);
+  HTTPBegin();
+  HTTPWriteHead(FPSTR(S_titleinfo)); // @token titleinfo
+  reportStatus();
 
   uint16_t infos = 0;
 
@@ -2137,27 +2279,26 @@ void WiFiManager::handleInfo() {
   #endif
 
   for(size_t i=0; i<infos;i++){
-    if(infoids[i] != NULL) page += getInfoData(infoids[i]);
+    if(infoids[i] != NULL) HTTPWrite(getInfoData(infoids[i]));
   }
-  page += F("</dl>");
+  HTTPWrite(F("</dl>"));
 
-  page += F("<h3>About</h3><hr><dl>");
-  page += getInfoData("aboutver");
-  page += getInfoData("aboutarduinover");
-  page += getInfoData("aboutidfver");
-  page += getInfoData("aboutdate");
-  page += F("</dl>");
+  HTTPWrite(F("<h3>About</h3><hr><dl>"));
+  HTTPWrite(getInfoData("aboutver"));
+  HTTPWrite(getInfoData("aboutarduinover"));
+  HTTPWrite(getInfoData("aboutidfver"));
+  HTTPWrite(getInfoData("aboutdate"));
+  HTTPWrite(F("</dl>"));
 
   if(_showInfoUpdate){
-    page += HTTP_PORTAL_MENU[8];
-    page += HTTP_PORTAL_MENU[9];
+    HTTPWrite(HTTP_PORTAL_MENU[8]);
+    HTTPWrite(HTTP_PORTAL_MENU[9]);
   }
-  if(_showInfoErase) page += FPSTR(HTTP_ERASEBTN);
-  if(_showBack) page += FPSTR(HTTP_BACKBTN);
-  page += FPSTR(HTTP_HELP);
-  page += FPSTR(HTTP_END);
-
-  HTTPSend(page);
+  if(_showInfoErase) HTTPWrite(FPSTR(HTTP_ERASEBTN));
+  if(_showBack) HTTPWrite(FPSTR(HTTP_BACKBTN));
+  HTTPWrite(FPSTR(HTTP_HELP));
+  HTTPWrite(FPSTR(HTTP_END));
+  HTTPEnd();
 
   #ifdef WM_DEBUG_LEVEL
   DEBUG_WM(DEBUG_DEV,F("Sent info page"));
@@ -2382,11 +2523,12 @@ void WiFiManager::handleExit() {
   DEBUG_WM(DEBUG_VERBOSE,F("<- HTTP Exit"));
   #endif
   handleRequest();
-  String page = getHTTPHead(FPSTR(S_titleexit)); // @token titleexit
-  page += FPSTR(S_exiting); // @token exiting
   // ('Logout', 401, {'WWW-Authenticate': 'Basic realm="Login required"'})
   server->sendHeader(F("Cache-Control"), F("no-cache, no-store, must-revalidate")); // @HTTPHEAD send cache
-  HTTPSend(page);
+  HTTPBegin();
+  HTTPWriteHead(FPSTR(S_titleexit)); // @token titleexit
+  HTTPWrite(FPSTR(S_exiting)); // @token exiting
+  HTTPEnd();
   delay(2000);
   abort = true;
 }
@@ -2399,11 +2541,11 @@ void WiFiManager::handleReset() {
   DEBUG_WM(DEBUG_VERBOSE,F("<- HTTP Reset"));
   #endif
   handleRequest();
-  String page = getHTTPHead(FPSTR(S_titlereset)); //@token titlereset
-  page += FPSTR(S_resetting); //@token resetting
-  page += FPSTR(HTTP_END);
-
-  HTTPSend(page);
+  HTTPBegin();
+  HTTPWriteHead(FPSTR(S_titlereset)); //@token titlereset
+  HTTPWrite(FPSTR(S_resetting)); //@token resetting
+  HTTPWrite(FPSTR(HTTP_END));
+  HTTPEnd();
 
   #ifdef WM_DEBUG_LEVEL
   DEBUG_WM(F("RESETTING ESP"));
@@ -2424,20 +2566,20 @@ void WiFiManager::handleErase(boolean opt) {
   DEBUG_WM(DEBUG_NOTIFY,F("<- HTTP Erase"));
   #endif
   handleRequest();
-  String page = getHTTPHead(FPSTR(S_titleerase)); // @token titleerase
-
   bool ret = erase(opt);
 
-  if(ret) page += FPSTR(S_resetting); // @token resetting
+  HTTPBegin();
+  HTTPWriteHead(FPSTR(S_titleerase)); // @token titleerase
+  if(ret) HTTPWrite(FPSTR(S_resetting)); // @token resetting
   else {
-    page += FPSTR(S_error); // @token erroroccur
+    HTTPWrite(FPSTR(S_error)); // @token erroroccur
     #ifdef WM_DEBUG_LEVEL
     DEBUG_WM(DEBUG_ERROR,F("[ERROR] WiFi EraseConfig failed"));
     #endif
   }
 
-  page += FPSTR(HTTP_END);
-  HTTPSend(page);
+  HTTPWrite(FPSTR(HTTP_END));
+  HTTPEnd();
 
   if(ret){
     delay(2000);
@@ -2514,12 +2656,13 @@ void WiFiManager::handleClose(){
   DEBUG_WM(DEBUG_VERBOSE,F("<- HTTP close"));
   #endif
   handleRequest();
-  String page = getHTTPHead(FPSTR(S_titleclose)); // @token titleclose
-  page += FPSTR(S_closing); // @token closing
-  HTTPSend(page);
+  HTTPBegin();
+  HTTPWriteHead(FPSTR(S_titleclose)); // @token titleclose
+  HTTPWrite(FPSTR(S_closing)); // @token closing
+  HTTPEnd();
 }
 
-void WiFiManager::reportStatus(String &page){
+void WiFiManager::reportStatus(){
   // updateConxResult(WiFi.status()); // @todo: this defeats the purpose of last result, update elsewhere or add logic here
   DEBUG_WM(DEBUG_DEV,F("[WIFI] reportStatus prev:"),getWLStatusString(_lastconxresult));
   DEBUG_WM(DEBUG_DEV,F("[WIFI] reportStatus current:"),getWLStatusString(WiFi.status()));
@@ -2557,7 +2700,7 @@ void WiFiManager::reportStatus(String &page){
   else {
     str = FPSTR(HTTP_STATUS_NONE);
   }
-  page += str;
+  HTTPWrite(str);
 }
 
 // PUBLIC
@@ -2573,6 +2716,7 @@ void WiFiManager::reportStatus(String &page){
  * @return {[type]} [description]
  */
 bool WiFiManager::stopConfigPortal(){
+  PortalLock lock(this);
   if(_configPortalIsBlocking){
     abort = true;
     return true;
@@ -2939,6 +3083,7 @@ void WiFiManager::setCustomMenuHTML(const char* html) {
  */
 void WiFiManager::setRemoveDuplicateAPs(boolean removeDuplicates) {
   _removeDuplicateAPs = removeDuplicates;
+  _scanTableStale     = true;
 }
 
 /**
@@ -3802,7 +3947,11 @@ String WiFiManager::WiFi_psk(bool persistent) const {
   }
   else if(event == ARDUINO_EVENT_WIFI_SCAN_DONE && _asyncScan){
     uint16_t scans = WiFi.scanComplete();
+    #ifdef WM_ASYNCWEBSERVER
+    _scanDone = scans; // event task, applied with the portal lock held by WiFi_scanCollect()
+    #else
     WiFi_scanComplete(scans);
+    #endif
   }
 }
 #endif
@@ -3826,16 +3975,16 @@ void WiFiManager::handleUpdate() {
 	DEBUG_WM(DEBUG_VERBOSE,F("<- Handle update"));
   #endif
 	if (captivePortal()) return; // If captive portal redirect instead of displaying the page
-	String page = getHTTPHead(_title); // @token options
+	HTTPBegin();
+	HTTPWriteHead(_title); // @token options
 	String str = FPSTR(HTTP_ROOT_MAIN);
   str.replace(FPSTR(T_t), _title);
 	str.replace(FPSTR(T_v), configPortalActive ? _apName : (getWiFiHostname() + " - " + WiFi.localIP().toString())); // use ip if ap is not active for heading
-	page += str;
+	HTTPWrite(str);
 
-	page += FPSTR(HTTP_UPDATE);
-	page += FPSTR(HTTP_END);
-
-	HTTPSend(page);
+	HTTPWrite(FPSTR(HTTP_UPDATE));
+	HTTPWrite(FPSTR(HTTP_END));
+	HTTPEnd();
 
 }
 
@@ -3933,24 +4082,25 @@ void WiFiManager::handleUpdateDone() {
 	DEBUG_WM(DEBUG_VERBOSE, F("<- Handle update done"));
 	// if (captivePortal()) return; // If captive portal redirect instead of displaying the page
 
-	String page = getHTTPHead(FPSTR(S_options)); // @token options
+	HTTPBegin();
+	HTTPWriteHead(FPSTR(S_options)); // @token options
 	String str  = FPSTR(HTTP_ROOT_MAIN);
   str.replace(FPSTR(T_t),_title);
 	str.replace(FPSTR(T_v), configPortalActive ? _apName : WiFi.localIP().toString()); // use ip if ap is not active for heading
-	page += str;
+	HTTPWrite(str);
 
 	if (Update.hasError()) {
-		page += FPSTR(HTTP_UPDATE_FAIL);
-    page += "OTA Error: " + (String)Update.errorString();
+		HTTPWrite(FPSTR(HTTP_UPDATE_FAIL));
+    HTTPWrite(F("OTA Error: "));
+    HTTPWrite(Update.errorString());
 		DEBUG_WM(F("[OTA] update failed"));
 	}
 	else {
-		page += FPSTR(HTTP_UPDATE_SUCCESS);
+		HTTPWrite(FPSTR(HTTP_UPDATE_SUCCESS));
 		DEBUG_WM(F("[OTA] update ok"));
 	}
-	page += FPSTR(HTTP_END);
-
-	HTTPSend(page);
+	HTTPWrite(FPSTR(HTTP_END));
+	HTTPEnd();
 
 	delay(1000); // send page
 	if (!Update.hasError()) {
@@ -0,0 +1,633 @@
+/**
+ * WiFiManagerAsync.cpp
+ *
+ * Event driven backend for the WiFiManager portal (esp32, WM_ASYNCWEBSERVER)
+ * see WiFiManagerAsync.h
+ */
+
+#include "WiFiManager.h"
+
+#if defined(ESP32) && defined(WM_ASYNCWEBSERVER)
+
+#include <base64.h>
+#include <esp_timer.h>
+#include <lwip/sockets.h>
+
+// -----------------------------------------------------------------------------------------------
+// helpers
+
+static const char *statusText(int code){
+  switch(code){
+    case 200: return "OK";
+    case 204: return "No Content";
+    case 301: return "Moved Permanently";
+    case 302: return "Found";
+    case 304: return "Not Modified";
+    case 400: return "Bad Request";
+    case 401: return "Unauthorized";
+    case 403: return "Forbidden";
+    case 404: return "Not Found";
+    case 413: return "Payload Too Large";
+    case 500: return "Internal Server Error";
+    default:  return "";
+  }
+}
+
+static uint8_t hexValue(char c){
+  if(c >= 'a') return c - 'a' + 10;
+  if(c >= 'A') return c - 'A' + 10;
+  return c - '0';
+}
+
+// url decode, '+' is a space in form encoding
+static String urlDecode(const char *str, size_t len){
+  String out;
+  out.reserve(len);
+  for(size_t i = 0; i < len; i++){
+    char c = str[i];
+    if(c == '+') c = ' ';
+    else if(c == '%' && i + 2 < len && isxdigit(str[i + 1]) && isxdigit(str[i + 2])){
+      c = (hexValue(str[i + 1]) << 4) | hexValue(str[i + 2]);
+      i += 2;
+    }
+    out += c;
+  }
+  return out;
+}
+
+// first index of pat in buf, -1 if absent
+static int findBytes(const uint8_t *buf, size_t len, const char *pat, size_t plen){
+  for(const uint8_t *p = buf; len >= plen; ){
+    const uint8_t *c = (const uint8_t *)memchr(p, pat[0], len - plen + 1);
+    if(c == NULL) return -1;
+    if(memcmp(c, pat, plen) == 0) return c - buf;
+    len -= c + 1 - p;
+    p = c + 1;
+  }
+  return -1;
+}
+
+// quoted value of key (' name="', ' filename="') in multipart part headers
+static String partParam(const String &headers, const char *key){
+  int i = headers.indexOf(key);
+  if(i < 0) return String();
+  i += strlen(key);
+  int e = headers.indexOf('"', i);
+  return e < 0 ? String() : headers.substring(i, e);
+}
+
+// address of one end of a connection, httpd listens on a dual stack socket (ipv4 mapped addresses)
+static IPAddress socketIP(int fd, bool local){
+  struct sockaddr_storage addr;
+  socklen_t len = sizeof(addr);
+  int res = local ? getsockname(fd, (struct sockaddr *)&addr, &len) : getpeername(fd, (struct sockaddr *)&addr, &len);
+  if(res != 0) return IPAddress();
+  if(addr.ss_family == AF_INET) return IPAddress(((struct sockaddr_in *)&addr)->sin_addr.s_addr);
+  #if LWIP_IPV6
+  const uint8_t *a = ((struct sockaddr_in6 *)&addr)->sin6_addr.s6_addr;
+  return IPAddress(a[12], a[13], a[14], a[15]);
+  #else
+  return IPAddress();
+  #endif
+}
+
+// -----------------------------------------------------------------------------------------------
+// WM_AsyncClient
+
+IPAddress WM_AsyncClient::localIP(){
+  return _server->_req ? socketIP(httpd_req_to_sockfd(_server->_req), true) : IPAddress();
+}
+
+IPAddress WM_AsyncClient::remoteIP(){
+  return _server->_req ? socketIP(httpd_req_to_sockfd(_server->_req), false) : IPAddress();
+}
+
+void WM_AsyncClient::stop(){
+  _server->_close = true;
+}
+
+// -----------------------------------------------------------------------------------------------
+// WM_AsyncWebServer
+
+WM_AsyncWebServer::WM_AsyncWebServer(int port) : _port(port) {
+  _served = xSemaphoreCreateBinary();
+}
+
+WM_AsyncWebServer::~WM_AsyncWebServer(){
+  stop();
+  if(_served) vSemaphoreDelete(_served);
+}
+
+/**
+ * start the httpd task, every uri goes to one handler per method which dispatches on the routes
+ */
+void WM_AsyncWebServer::begin(){
+  if(_handle) return;
+
+  httpd_config_t config    = HTTPD_DEFAULT_CONFIG();
+  config.server_port       = _port;
+  config.stack_size        = WM_ASYNC_STACK;
+  config.task_priority     = WM_ASYNC_PRIORITY;
+  config.max_uri_handlers  = 2;
+  config.max_resp_headers  = WM_ASYNC_RESP_HEADERS;
+  config.lru_purge_enable  = true; // a new client closes the least recently used connection instead of waiting
+  config.uri_match_fn      = httpd_uri_match_wildcard;
+
+  _stats = {};
+  _stats.startMicros = esp_timer_get_time();
+
+  if(httpd_start(&_handle, &config) != ESP_OK){
+    log_e("httpd start failed on port %d", _port);
+    _handle = NULL;
+    return;
+  }
+
+  const httpd_method_t methods[] = { HTTP_GET, HTTP_POST };
+  for(httpd_method_t m : methods){
+    httpd_uri_t u = {};
+    u.uri      = "/*";
+    u.method   = m;
+    u.handler  = _dispatch;
+    u.user_ctx = this;
+    httpd_register_uri_handler(_handle, &u);
+  }
+}
+
+/**
+ * stop the httpd task, waits for a running handler, must not be called from a handler
+ * may be called with the handler lock held: a request waiting for the lock gives up
+ */
+void WM_AsyncWebServer::stop(){
+  if(!_handle) return;
+  _stopping = true;
+  httpd_stop(_handle);
+  _handle   = NULL;
+  _stopping = false;
+}
+
+bool WM_AsyncWebServer::waitRequest(uint32_t ms){
+  if(!_served){
+    delay(ms);
+    return false;
+  }
+  bool served = xSemaphoreTake(_served, pdMS_TO_TICKS(ms)) == pdTRUE;
+  _stats.wakeups++;
+  if(!served) _stats.idleWakeups++;
+  return served;
+}
+
+void WM_AsyncWebServer::on(const String &uri, THandlerFunction fn){
+  on(uri, HTTP_ANY, fn, THandlerFunction());
+}
+
+void WM_AsyncWebServer::on(const String &uri, HTTPMethod method, THandlerFunction fn){
+  on(uri, method, fn, THandlerFunction());
+}
+
+void WM_AsyncWebServer::on(const String &uri, HTTPMethod method, THandlerFunction fn, THandlerFunction ufn){
+  _routes.push_back({ uri, method, fn, ufn });
+}
+
+void WM_AsyncWebServer::onNotFound(THandlerFunction fn){
+  _notFound = fn;
+}
+
+/**
+ * httpd task entry, the request is served with the handler lock held
+ * the lock is taken in slices so a stop() from the lock holder does not wait on this request
+ */
+esp_err_t WM_AsyncWebServer::_dispatch(httpd_req_t *req){
+  WM_AsyncWebServer *server = (WM_AsyncWebServer *)req->user_ctx;
+  int64_t start = esp_timer_get_time();
+  if(server->_lock){
+    while(xSemaphoreTakeRecursive(server->_lock, pdMS_TO_TICKS(WM_ASYNC_LOCK_POLL_MS)) != pdTRUE){
+      if(server->_stopping) return ESP_FAIL; // httpd closes the connection
+    }
+  }
+  int64_t locked = esp_timer_get_time();
+  server->_handleRequest(req);
+  if(server->_lock) xSemaphoreGiveRecursive(server->_lock);
+
+  server->_stats.requests++;
+  server->_stats.lockMicros += locked - start;
+  server->_stats.busyMicros += esp_timer_get_time() - locked;
+  xSemaphoreGive(server->_served);
+  return ESP_OK;
+}
+
+/**
+ * one request on the httpd task: args from the query and the body, then the route handler
+ */
+void WM_AsyncWebServer::_handleRequest(httpd_req_t *req){
+  _req           = req;
+  _args.clear();
+  _headerCount   = 0;
+  _contentLength = CONTENT_LENGTH_NOT_SET;
+  _responded     = _chunked = _close = false;
+
+  const char *query = strchr(req->uri, '?');
+  _uri = urlDecode(req->uri, query ? query - req->uri : strlen(req->uri));
+  if(query) _parseArgs(query + 1, strlen(query + 1));
+
+  const Route *route = NULL;
+  for(const Route &r : _routes){
+    if((r.method == HTTP_ANY || r.method == req->method) && r.uri == _uri){
+      route = &r;
+      break;
+    }
+  }
+
+  bool ok = true;
+  if(req->content_len > 0){
+    String type = header(F("Content-Type"));
+    int b = type.indexOf(F("boundary="));
+    if(type.startsWith(F("multipart/form-data")) && b >= 0){
+      String boundary = type.substring(b + 9);
+      int e = boundary.indexOf(';');
+      if(e >= 0) boundary = boundary.substring(0, e);
+      boundary.trim();
+      if(boundary.startsWith("\"")) boundary = boundary.substring(1, boundary.length() - 1);
+      ok = _readMultipart(boundary, route);
+    }
+    else {
+      String body;
+      ok = _readBody(body);
+      if(ok && type.startsWith(F("application/x-www-form-urlencoded"))) _parseArgs(body.c_str(), body.length());
+      else if(ok) _args.push_back({ String(F("plain")), body });
+    }
+  }
+
+  if(!ok) send(400, "text/plain", statusText(400));
+  else if(route) route->fn();
+  else if(_notFound) _notFound();
+  else send(404, "text/plain", String(F("Not found: ")) + _uri);
+
+  if(_chunked) httpd_resp_send_chunk(req, NULL, 0); // stream left open by the handler
+  if(!_responded || _close) httpd_sess_trigger_close(_handle, httpd_req_to_sockfd(req));
+
+  _upload.reset();
+  _req = NULL;
+}
+
+int WM_AsyncWebServer::_recv(char *buf, size_t len){
+  for(uint8_t retry = 0; retry < 3; retry++){
+    int n = httpd_req_recv(_req, buf, len);
+    if(n != HTTPD_SOCK_ERR_TIMEOUT) return n;
+  }
+  return -1;
+}
+
+bool WM_AsyncWebServer::_readBody(String &body){
+  size_t len = _req->content_len;
+  if(len > WM_ASYNC_MAX_BODY) return false;
+  std::unique_ptr<char[]> buf(new (std::nothrow) char[len + 1]);
+  if(!buf) return false;
+  for(size_t n = 0; n < len; ){
+    int r = _recv(buf.get() + n, len - n);
+    if(r <= 0) return false;
+    n += r;
+  }
+  buf[len] = '\0';
+  body = buf.get();
+  return true;
+}
+
+void WM_AsyncWebServer::_parseArgs(const char *str, size_t len){
+  const char *end = str + len;
+  while(str < end){
+    const char *amp = (const char *)memchr(str, '&', end - str);
+    if(amp == NULL) amp = end;
+    const char *eq = (const char *)memchr(str, '=', amp - str);
+    if(amp > str){
+      if(eq) _args.push_back({ urlDecode(str, eq - str), urlDecode(eq + 1, amp - eq - 1) });
+      else _args.push_back({ urlDecode(str, amp - str), String() });
+    }
+    str = amp + 1;
+  }
+}
+
+/**
+ * stream a multipart/form-data body, fields become args, file parts go to the route upload
+ * handler in HTTP_UPLOAD_BUFLEN slices (UPLOAD_FILE_START, _WRITE, _END or _ABORTED)
+ * the window keeps the last delimiter length of bytes, a delimiter split between two reads is found
+ */
+bool WM_AsyncWebServer::_readMultipart(const String &boundary, const Route *route){
+  const String delim = "\r\n--" + boundary;
+  const size_t dlen  = delim.length();
+  const size_t cap   = HTTP_UPLOAD_BUFLEN + 256;
+  if(boundary.length() == 0 || dlen > 128) return false;
+
+  std::unique_ptr<uint8_t[]> buf(new (std::nothrow) uint8_t[cap]);
+  if(!buf) return false;
+  uint8_t *b = buf.get();
+  size_t len = 2;
+  size_t remaining = _req->content_len;
+  b[0] = '\r'; // the first delimiter has no leading crlf
+  b[1] = '\n';
+
+  auto fill = [&]() -> bool {
+    if(remaining == 0 || len == cap) return false;
+    int n = _recv((char *)b + len, std::min(cap - len, remaining));
+    if(n <= 0) return false;
+    len += n;
+    remaining -= n;
+    return true;
+  };
+  auto consume = [&](size_t n){
+    memmove(b, b + n, len - n);
+    len -= n;
+  };
+
+  // preamble
+  int at;
+  while((at = findBytes(b, len, delim.c_str(), dlen)) < 0){
+    if(len > dlen) consume(len - dlen);
+    if(!fill()) return false;
+  }
+  consume(at + dlen);
+
+  for(;;){
+    // after a delimiter, "--" ends the body, crlf starts a part
+    while(len < 2) if(!fill()) return false;
+    if(b[0] == '-' && b[1] == '-') return true;
+
+    // part headers up to the blank line, they must fit in the window
+    while((at = findBytes(b, len, "\r\n\r\n", 4)) < 0) if(!fill()) return false;
+    b[at] = '\0';
+    String headers = (const char *)b;
+    consume(at + 4);
+
+    String name      = partParam(headers, " name=\"");
+    bool   file      = headers.indexOf(F(" filename=\"")) >= 0;
+    bool   uploading = file && route && route->ufn;
+    String value;
+
+    if(uploading){
+      _upload.reset(new (std::nothrow) HTTPUpload());
+      if(!_upload) return false;
+      String lower = headers;
+      lower.toLowerCase();
+      int t = lower.indexOf(F("content-type:"));
+      if(t >= 0){
+        int e = headers.indexOf('\r', t);
+        _upload->type = headers.substring(t + 13, e < 0 ? headers.length() : e);
+        _upload->type.trim();
+      }
+      _upload->name        = name;
+      _upload->filename    = partParam(headers, " filename=\"");
+      _upload->status      = UPLOAD_FILE_START;
+      _upload->totalSize   = 0;
+      _upload->currentSize = 0;
+      route->ufn();
+    }
+
+    // part body up to the next delimiter
+    for(;;){
+      at = findBytes(b, len, delim.c_str(), dlen);
+      size_t n = at >= 0 ? at : (len > dlen ? len - dlen : 0);
+      const uint8_t *data = b;
+      for(size_t left = n; left > 0; ){
+        if(uploading){
+          size_t k = std::min(left, (size_t)HTTP_UPLOAD_BUFLEN - _upload->currentSize);
+          memcpy(_upload->buf + _upload->currentSize, data, k);
+          _upload->currentSize += k;
+          data += k;
+          left -= k;
+          if(_upload->currentSize == HTTP_UPLOAD_BUFLEN){
+            _upload->status     = UPLOAD_FILE_WRITE;
+            _upload->totalSize += _upload->currentSize;
+            route->ufn();
+            _upload->currentSize = 0;
+          }
+        }
+        else {
+          if(!file && value.length() + left <= WM_ASYNC_MAX_BODY) value.concat((const char *)data, left);
+          left = 0;
+        }
+      }
+      consume(n);
+      if(at >= 0){
+        consume(dlen);
+        break;
+      }
+      if(!fill()){
+        if(uploading){
+          _upload->status = UPLOAD_FILE_ABORTED;
+          route->ufn();
+        }
+        return false;
+      }
+    }
+
+    if(uploading){
+      if(_upload->currentSize > 0){
+        _upload->status     = UPLOAD_FILE_WRITE;
+        _upload->totalSize += _upload->currentSize;
+        route->ufn();
+        _upload->currentSize = 0;
+      }
+      _upload->status = UPLOAD_FILE_END;
+      route->ufn();
+    }
+    else if(!file){
+      _args.push_back({ name, value });
+    }
+  }
+}
+
+HTTPMethod WM_AsyncWebServer::method(){
+  return _req ? (HTTPMethod)_req->method : HTTP_GET;
+}
+
+String WM_AsyncWebServer::arg(const String &name){
+  for(const Arg &a : _args){
+    if(a.name == name) return a.value;
+  }
+  return String();
+}
+
+String WM_AsyncWebServer::arg(int i){
+  return i >= 0 && i < (int)_args.size() ? _args[i].value : String();
+}
+
+String WM_AsyncWebServer::argName(int i){
+  return i >= 0 && i < (int)_args.size() ? _args[i].name : String();
+}
+
+bool WM_AsyncWebServer::hasArg(const String &name){
+  for(const Arg &a : _args){
+    if(a.name == name) return true;
+  }
+  return false;
+}
+
+String WM_AsyncWebServer::header(const String &name){
+  if(!_req) return String();
+  size_t len = httpd_req_get_hdr_value_len(_req, name.c_str());
+  if(len == 0) return String();
+  std::unique_ptr<char[]> buf(new (std::nothrow) char[len + 1]);
+  if(!buf || httpd_req_get_hdr_value_str(_req, name.c_str(), buf.get(), len + 1) != ESP_OK) return String();
+  return String(buf.get());
+}
+
+bool WM_AsyncWebServer::hasHeader(const String &name){
+  return _req && httpd_req_get_hdr_value_len(_req, name.c_str()) > 0;
+}
+
+bool WM_AsyncWebServer::authenticate(const char *username, const char *password){
+  String auth = header(F("Authorization"));
+  if(!auth.startsWith(F("Basic "))) return false;
+  return auth.substring(6) == base64::encode(String(username) + ":" + password);
+}
+
+// basic auth only, digest is not implemented on this backend
+void WM_AsyncWebServer::requestAuthentication(HTTPAuthMethod mode, const char *realm, const String &authFailMsg){
+  sendHeader(F("WWW-Authenticate"), String(F("Basic realm=\"")) + (realm ? realm : "Login Required") + "\"");
+  send(401, "text/html", authFailMsg);
+}
+
+void WM_AsyncWebServer::sendHeader(const String &name, const String &value, bool first){
+  if(_headerCount >= WM_ASYNC_RESP_HEADERS){
+    log_w("too many response headers, %s dropped", name.c_str());
+    return;
+  }
+  _headerName[_headerCount]  = name;
+  _headerValue[_headerCount] = value;
+  _headerCount++;
+}
+
+/**
+ * status line and headers, then the content with its length, or the first chunk of a stream
+ * when the length is unknown (CONTENT_LENGTH_UNKNOWN, or announced ahead of sendContent())
+ * httpd keeps pointers to the header strings, they live until the request ends
+ */
+void WM_AsyncWebServer::send(int code, const char *content_type, const char *content, size_t contentLength){
+  if(!_req || _responded) return;
+  _responded = true;
+
+  snprintf(_status, sizeof(_status), "%d %s", code, statusText(code));
+  httpd_resp_set_status(_req, _status);
+  _contentType = content_type ? content_type : "text/html";
+  httpd_resp_set_type(_req, _contentType.c_str());
+  for(uint8_t i = 0; i < _headerCount; i++){
+    httpd_resp_set_hdr(_req, _headerName[i].c_str(), _headerValue[i].c_str());
+  }
+
+  if(_contentLength == CONTENT_LENGTH_NOT_SET || _contentLength == contentLength){
+    httpd_resp_send(_req, content, contentLength);
+  }
+  else {
+    _chunked = true;
+    if(contentLength > 0) httpd_resp_send_chunk(_req, content, contentLength);
+  }
+  _contentLength = CONTENT_LENGTH_NOT_SET;
+}
+
+void WM_AsyncWebServer::send(int code, const char *content_type, const String &content){
+  send(code, content_type, content.c_str(), content.length());
+}
+
+void WM_AsyncWebServer::send(int code, const String &content_type, const String &content){
+  send(code, content_type.c_str(), content.c_str(), content.length());
+}
+
+void WM_AsyncWebServer::send(int code, const char *content_type, const char *content){
+  send(code, content_type, content, content ? strlen(content) : 0);
+}
+
+// flash is memory mapped on esp32
+void WM_AsyncWebServer::send_P(int code, PGM_P content_type, PGM_P content){
+  send(code, content_type, content);
+}
+
+void WM_AsyncWebServer::send_P(int code, PGM_P content_type, PGM_P content, size_t contentLength){
+  send(code, content_type, content, contentLength);
+}
+
+void WM_AsyncWebServer::sendContent(const String &content){
+  sendContent(content.c_str(), content.length());
+}
+
+// next chunk of a stream, an empty one ends it
+void WM_AsyncWebServer::sendContent(const char *content, size_t contentLength){
+  if(!_req || !_chunked) return;
+  if(contentLength == 0){
+    httpd_resp_send_chunk(_req, NULL, 0);
+    _chunked = false;
+    return;
+  }
+  httpd_resp_send_chunk(_req, content, contentLength);
+}
+
+// -----------------------------------------------------------------------------------------------
+// WM_AsyncDNSServer
+
+bool WM_AsyncDNSServer::start(const uint16_t &port, const String &domainName, const IPAddress &resolvedIP){
+  _domainName = domainName;
+  _domainName.toLowerCase();
+  if(_domainName.startsWith(F("www."))) _domainName = _domainName.substring(4);
+  _resolvedIP = resolvedIP;
+  if(!_udp.listen(port)) return false;
+  _udp.onPacket([this](AsyncUDPPacket &packet){ _reply(packet); });
+  return true;
+}
+
+void WM_AsyncDNSServer::stop(){
+  _udp.close();
+}
+
+/**
+ * answer a query from the udp receive callback
+ * a single question for the domain (or any with "*") gets the portal ip as A record, other
+ * types get an empty answer, other domains and malformed queries the error reply code
+ */
+void WM_AsyncDNSServer::_reply(AsyncUDPPacket &packet){
+  const uint8_t *q = packet.data();
+  size_t len = packet.length();
+  if(len < 12 || len > 512 || (q[2] & 0x80)) return; // not a query
+
+  bool question = ((q[2] >> 3) & 0x0F) == 0 && q[4] == 0 && q[5] == 1; // standard query, one question
+  size_t end = 12;
+  String name;
+  while(question && end < len && q[end] != 0){
+    size_t l = q[end];
+    if((l & 0xC0) || end + 1 + l >= len){
+      question = false;
+      break;
+    }
+    if(name.length()) name += '.';
+    for(size_t i = 1; i <= l; i++) name += (char)tolower(q[end + i]);
+    end += 1 + l;
+  }
+  end += 5; // root label, qtype, qclass
+  question = question && end <= len;
+
+  if(name.startsWith(F("www."))) name = name.substring(4);
+  bool match = question && (_domainName == "*" || name == _domainName);
+  uint16_t qtype = question ? (q[end - 4] << 8) | q[end - 3] : 0;
+
+  uint8_t r[512 + 16];
+  size_t n = question ? end : 12;
+  memcpy(r, q, n);
+  r[2] = 0x84 | (q[2] & 0x79);          // response, authoritative, opcode and rd from the query
+  r[3] = match ? 0 : _errorReplyCode;   // no recursion, rcode
+  r[4] = 0;
+  r[5] = question ? 1 : 0;
+  memset(r + 6, 0, 6);                  // answer, authority and additional counts
+
+  if(match && (qtype == 1 || qtype == 255)){
+    const uint8_t answer[] = {
+      0xC0, 0x0C,                       // name, pointer to the question
+      0x00, 0x01, 0x00, 0x01,           // A, IN
+      (uint8_t)(_ttl >> 24), (uint8_t)(_ttl >> 16), (uint8_t)(_ttl >> 8), (uint8_t)_ttl,
+      0x00, 0x04,
+      _resolvedIP[0], _resolvedIP[1], _resolvedIP[2], _resolvedIP[3]
+    };
+    memcpy(r + n, answer, sizeof(answer));
+    n += sizeof(answer);
+    r[7] = 1;
+  }
+  packet.write(r, n);
+}
+
+#endif
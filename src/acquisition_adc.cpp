@@ -0,0 +1,194 @@
+/**
+ * @file acquisition_adc.cpp
+ * @brief Implémentation du moteur d'acquisition analogique continue (ADC1 + DMA).
+ *
+ * drainerAdc() et publierVoieAdc() sont appelées par l'ordonnanceur de la tâche d'acquisition :
+ * elles s'exécutent dans la même tâche et n'ont donc pas besoin de verrou.
+ */
+
+#include "acquisition_adc.h"
+#include <algorithm>
+#include <driver/adc.h>
+
+// Taille du tampon interne du pilote (octets) et nombre d'octets par interruption DMA
+static const uint32_t TAILLE_TAMPON_DMA = 2048;
+static const uint32_t OCTETS_PAR_CONVERSION = 256;
+
+// Voie analogique et sa fenêtre d'échantillons bruts
+struct VoieAdc {
+  uint8_t canalAdc;
+  CanalMesure canal;
+  FiltreAdc filtre;
+  ConversionAdc conversion;
+  uint16_t fenetre[ADC_FENETRE_ECHANTILLONS];  // Tampon circulaire des derniers échantillons
+  uint16_t ecriture;                           // Prochaine position d'écriture
+  uint16_t nombre;                             // Échantillons reçus depuis la dernière mesure
+};
+
+static VoieAdc voies[ADC_NB_VOIES];
+static int nbVoies = 0;
+static bool adcDemarre = false;
+
+// Nombre de débordements du tampon du pilote (échantillons perdus entre deux vidages)
+static uint32_t debordementsAdc = 0;
+
+// Copie de travail pour la médiane et la moyenne tronquée
+static uint16_t tri[ADC_FENETRE_ECHANTILLONS];
+
+int ajouterVoieAdc(uint8_t canalAdc, CanalMesure canal, FiltreAdc filtre, ConversionAdc conversion)
+{
+    if (adcDemarre || nbVoies >= ADC_NB_VOIES) {
+        Serial.println("[ADC] Impossible d'ajouter la voie !");
+        return -1;
+    }
+    VoieAdc &v = voies[nbVoies];
+    v.canalAdc = canalAdc;
+    v.canal = canal;
+    v.filtre = filtre;
+    v.conversion = conversion;
+    v.ecriture = 0;
+    v.nombre = 0;
+    return nbVoies++;
+}
+
+bool demarrerAcquisitionAdc()
+{
+    if (nbVoies == 0) {
+        return false;
+    }
+
+    adc_digi_init_config_t init = {};
+    init.max_store_buf_size = TAILLE_TAMPON_DMA;
+    init.conv_num_each_intr = OCTETS_PAR_CONVERSION;
+    for (int i = 0; i < nbVoies; i++) {
+        init.adc1_chan_mask |= BIT(voies[i].canalAdc);
+    }
+    if (adc_digi_initialize(&init) != ESP_OK) {
+        Serial.println("[ADC] Erreur: adc_digi_initialize");
+        return false;
+    }
+
+    // Une entrée de motif par voie : l'ADC les convertit à tour de rôle
+    adc_digi_pattern_config_t motif[ADC_NB_VOIES] = {};
+    for (int i = 0; i < nbVoies; i++) {
+        motif[i].atten = ADC_ATTEN_DB_11;   // Plage complète, comme analogSetPinAttenuation(ADC_11db)
+        motif[i].channel = voies[i].canalAdc;
+        motif[i].unit = 0;                  // ADC1
+        motif[i].bit_width = SOC_ADC_DIGI_MAX_BITWIDTH;
+    }
+
+    adc_digi_configuration_t config = {};
+    config.conv_limit_en = false;
+    config.pattern_num = nbVoies;
+    config.adc_pattern = motif;
+    config.sample_freq_hz = ADC_FREQUENCE_HZ;
+    config.conv_mode = ADC_CONV_SINGLE_UNIT_1;
+    config.format = ADC_DIGI_OUTPUT_FORMAT_TYPE2;
+    if (adc_digi_controller_configure(&config) != ESP_OK || adc_digi_start() != ESP_OK) {
+        Serial.println("[ADC] Erreur: configuration du mode continu");
+        return false;
+    }
+
+    adcDemarre = true;
+    Serial.printf("[ADC] Mode continu demarre : %d voie(s), %d Hz\n", nbVoies, ADC_FREQUENCE_HZ);
+    return true;
+}
+
+void drainerAdc()
+{
+    if (!adcDemarre) {
+        return;
+    }
+
+    static uint8_t octets[OCTETS_PAR_CONVERSION];
+    for (;;) {
+        uint32_t longueur = 0;
+        const esp_err_t err = adc_digi_read_bytes(octets, sizeof(octets), &longueur, 0);
+        if (err == ESP_ERR_INVALID_STATE) {
+            debordementsAdc++;    // Le tampon du pilote a débordé ; les données lues restent valides
+        } else if (err != ESP_OK) {
+            break;                // ESP_ERR_TIMEOUT : plus rien à lire
+        }
+        if (longueur == 0) {
+            break;
+        }
+
+        const adc_digi_output_data_t *resultats = (const adc_digi_output_data_t *)octets;
+        for (uint32_t i = 0; i < longueur / sizeof(adc_digi_output_data_t); i++) {
+            const adc_digi_output_data_t &r = resultats[i];
+            if (r.type2.unit != 0) {
+                continue;
+            }
+            for (int v = 0; v < nbVoies; v++) {
+                if (voies[v].canalAdc == r.type2.channel) {
+                    VoieAdc &voie = voies[v];
+                    voie.fenetre[voie.ecriture] = r.type2.data;
+                    voie.ecriture = (voie.ecriture + 1) % ADC_FENETRE_ECHANTILLONS;
+                    if (voie.nombre < ADC_FENETRE_ECHANTILLONS) voie.nombre++;
+                    break;
+                }
+            }
+        }
+    }
+}
+
+/**
+ * @brief Applique le filtre de décimation aux `nombre` derniers échantillons de la voie.
+ *
+ * @return Valeur filtrée, dans la résolution de sortie du DMA.
+ */
+static uint32_t filtrerVoie(const VoieAdc &v)
+{
+    const uint16_t nombre = v.nombre;
+    const uint16_t debut = (v.ecriture + ADC_FENETRE_ECHANTILLONS - nombre) % ADC_FENETRE_ECHANTILLONS;
+
+    if (v.filtre == FILTRE_MOYENNE) {
+        uint32_t somme = 0;
+        for (uint16_t i = 0; i < nombre; i++) {
+            somme += v.fenetre[(debut + i) % ADC_FENETRE_ECHANTILLONS];
+        }
+        return somme / nombre;
+    }
+
+    for (uint16_t i = 0; i < nombre; i++) {
+        tri[i] = v.fenetre[(debut + i) % ADC_FENETRE_ECHANTILLONS];
+    }
+
+    if (v.filtre == FILTRE_MEDIANE) {
+        std::nth_element(tri, tri + nombre / 2, tri + nombre);
+        return tri[nombre / 2];
+    }
+
+    // Moyenne tronquée : rejet des extrêmes (pics, parasites) de chaque côté
+    std::sort(tri, tri + nombre);
+    const uint16_t rejet = (uint32_t)nombre * ADC_TRONCATURE_POURCENT / 100;
+    uint32_t somme = 0;
+    for (uint16_t i = rejet; i < nombre - rejet; i++) {
+        somme += tri[i];
+    }
+    return somme / (nombre - 2 * rejet);
+}
+
+bool publierVoieAdc(int voie, int &valeurBrute, uint16_t &nbEchantillons)
+{
+    if (voie < 0 || voie >= nbVoies) {
+        return false;
+    }
+    VoieAdc &v = voies[voie];
+
+    // Récupère les derniers échantillons avant de filtrer
+    drainerAdc();
+
+    nbEchantillons = v.nombre;
+    if (v.nombre == 0) {
+        invaliderMesure(v.canal);
+        return false;
+    }
+
+    // Le format DMA (type 2) de l'ESP32-S2 fournit 11 bits ; ramené à 12 bits (0-4095) pour la conversion
+    valeurBrute = (int)(filtrerVoie(v) << 1);
+    v.nombre = 0;
+
+    publierMesure(v.canal, v.conversion(valeurBrute));
+    return true;
+}
@@ -0,0 +1,234 @@
+/**
+ * @file alarmes.cpp
+ * @brief Implémentation des alarmes de seuil et de défaut capteur.
+ */
+
+#include "alarmes.h"
+#include "registre_capteurs.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
+
+const char *const NOMS_ALARME[NB_TYPES_ALARME] = { "seuil", "fin_seuil", "defaut", "retabli" };
+
+// Configuration modifiable par le portail (tâche WiFi) et lue par la tâche d'acquisition
+static SeuilAlarme seuils[NB_CANAUX] = {};
+static bool configurees = false;  // Configuration du portail déjà appliquée (la tâche WiFi démarre avant)
+static portMUX_TYPE verrouAlarmes = portMUX_INITIALIZER_UNLOCKED;
+
+// État des canaux, mis à jour uniquement dans la tâche d'acquisition
+static bool enAlarme[NB_CANAUX] = {};
+static SeuilAlarme seuilLeve[NB_CANAUX] = {};   // Seuil en vigueur quand l'alarme a été levée
+static bool enDefaut[NB_CANAUX] = {};
+static uint32_t derniereSequence[NB_CANAUX] = {};
+static uint32_t dernierValide_ms[NB_CANAUX] = {};
+
+static QueueHandle_t fileAlarmes = NULL;
+static StatsAlarmes stats = {};
+
+/**
+ * @brief Dépose un événement dans la file de la tâche d'envoi, sans attendre.
+ *
+ * @return false si la file est pleine : l'appelant garde l'état précédent du canal, et la
+ * transition est signalée de nouveau à l'échantillon (ou au passage) suivant.
+ */
+static bool signaler(CanalMesure canal, TypeAlarme type, float valeur, float seuil, const Horodatage &capture)
+{
+    const EvenementAlarme alarme = { canal, type, valeur, seuil, capture, (uint32_t)millis() };
+    if (fileAlarmes == NULL || xQueueSend(fileAlarmes, &alarme, 0) != pdTRUE) {
+        stats.perdues++;
+        return false;
+    }
+    stats.detectees++;
+    return true;
+}
+
+/**
+ * @brief Abonné aux mesures : comparaison de chaque échantillon au seuil de son canal.
+ */
+static void comparerMesures(const CanalMesure canaux[], const float valeurs[], size_t nb, const Horodatage &capture)
+{
+    SeuilAlarme copie[NB_CANAUX];
+    portENTER_CRITICAL(&verrouAlarmes);
+    memcpy(copie, seuils, sizeof(copie));
+    portEXIT_CRITICAL(&verrouAlarmes);
+
+    for (size_t i = 0; i < nb; i++) {
+        const CanalMesure canal = canaux[i];
+        const SeuilAlarme &s = copie[canal];
+        const float v = valeurs[i];
+        // L'état ne change qu'une fois l'événement déposé : une transition refusée (file pleine)
+        // est retentée tant que la condition tient, et le serveur ne voit jamais de fin sans début.
+        // Canal désactivé ou seuil modifié dans le portail : l'alarme levée sur l'ancien seuil est
+        // close avant que le nouveau seuil ne soit comparé
+        const SeuilAlarme &leve = seuilLeve[canal];
+        if (enAlarme[canal] && (!s.actif || s.superieur != leve.superieur || s.seuil != leve.seuil)) {
+            if (!signaler(canal, ALARME_FIN_SEUIL, v, leve.seuil, capture)) {
+                continue;
+            }
+            enAlarme[canal] = false;
+        }
+        if (!s.actif) {
+            continue;
+        }
+        if (!enAlarme[canal] && (s.superieur ? v > s.seuil : v < s.seuil)) {
+            enAlarme[canal] = signaler(canal, ALARME_SEUIL, v, s.seuil, capture);
+            seuilLeve[canal] = s;
+        } else if (enAlarme[canal] && (s.superieur ? v < s.seuil - s.hysteresis : v > s.seuil + s.hysteresis)) {
+            enAlarme[canal] = !signaler(canal, ALARME_FIN_SEUIL, v, s.seuil, capture);
+        }
+    }
+}
+
+void surveillerCapteurs()
+{
+    const uint32_t maintenant = millis();
+    for (const InfoCanal &info : TABLE_CANAUX) {
+        const CanalMesure canal = info.canal;
+        const EntreeMesure e = lireMesure(canal);
+
+        // Échantillon valide neuf depuis le dernier passage (un canal invalidé change aussi de séquence)
+        const bool neuf = e.sequence != derniereSequence[canal];
+        derniereSequence[canal] = e.sequence;
+        if (e.valide && neuf) {
+            dernierValide_ms[canal] = maintenant;
+        }
+
+        // Au démarrage, un capteur qui n'a encore rien publié a ALARMES_DEFAUT_MS pour le faire
+        const bool defaut = maintenant - dernierValide_ms[canal] >= ALARMES_DEFAUT_MS;
+        if (defaut != enDefaut[canal] &&
+            signaler(canal, defaut ? ALARME_DEFAUT : ALARME_RETABLI, e.valeur, 0,
+                     defaut ? lireHorodatage() : e.horodatage)) {
+            enDefaut[canal] = defaut;
+        }
+    }
+}
+
+void initAlarmes()
+{
+    portENTER_CRITICAL(&verrouAlarmes);
+    if (!configurees) {
+        for (const InfoCanal &info : TABLE_CANAUX) {
+            seuils[info.canal] = info.alarme;
+        }
+    }
+    portEXIT_CRITICAL(&verrouAlarmes);
+    fileAlarmes = xQueueCreate(ALARMES_FILE_PROFONDEUR, sizeof(EvenementAlarme));
+    abonnerMesures(comparerMesures);
+}
+
+/**
+ * @brief Lit une entrée "cle>seuil/hysteresis", "cle<seuil/hysteresis" (hystérésis nulle si
+ * absente) ou "cle=off".
+ *
+ * @return false si l'entrée est invalide.
+ */
+static bool lireEntree(const char *entree, size_t longueur, SeuilAlarme nouveaux[])
+{
+    const size_t lCle = strcspn(entree, "<>=");
+    if (lCle >= longueur) {
+        return false;
+    }
+    const InfoCanal *info = NULL;
+    for (const InfoCanal &i : TABLE_CANAUX) {
+        if (strlen(i.cle) == lCle && strncmp(i.cle, entree, lCle) == 0) {
+            info = &i;
+        }
+    }
+    if (info == NULL) {
+        return false;
+    }
+
+    char valeurs[32];
+    const size_t l = longueur - lCle - 1;
+    if (l >= sizeof(valeurs)) {
+        return false;
+    }
+    memcpy(valeurs, entree + lCle + 1, l);
+    valeurs[l] = '\0';
+
+    const char operateur = entree[lCle];
+    if (operateur == '=') {
+        if (strcmp(valeurs, "off") != 0) {
+            return false;
+        }
+        nouveaux[info->canal].actif = false;
+        return true;
+    }
+
+    SeuilAlarme s = { true, operateur == '>', 0, 0 };
+    char *suite;
+    s.seuil = strtof(valeurs, &suite);
+    if (suite == valeurs) {
+        return false;
+    }
+    if (*suite == '/') {
+        const char *debut = suite + 1;
+        s.hysteresis = strtof(debut, &suite);
+        if (suite == debut || s.hysteresis < 0) return false;
+    }
+    if (*suite != '\0') {
+        return false;
+    }
+    nouveaux[info->canal] = s;
+    return true;
+}
+
+bool appliquerAlarmes(const char *alarmes)
+{
+    SeuilAlarme nouveaux[NB_CANAUX] = {};
+    for (const InfoCanal &info : TABLE_CANAUX) {
+        nouveaux[info.canal] = info.alarme;
+    }
+
+    bool valide = true;
+    const char *entree = alarmes;
+    while (entree && *entree) {
+        const size_t longueur = strcspn(entree, ";");
+        if (longueur > 0 && !lireEntree(entree, longueur, nouveaux)) {
+            Serial.printf("[ALARME] Entree ignoree : %.*s\n", (int)longueur, entree);
+            valide = false;
+        }
+        entree += longueur;
+        if (*entree == ';') entree++;
+    }
+
+    portENTER_CRITICAL(&verrouAlarmes);
+    memcpy(seuils, nouveaux, sizeof(seuils));
+    configurees = true;
+    portEXIT_CRITICAL(&verrouAlarmes);
+    return valide;
+}
+
+bool attendreAlarme(EvenementAlarme &alarme, uint32_t delai_ms)
+{
+    if (fileAlarmes == NULL) {
+        vTaskDelay(pdMS_TO_TICKS(delai_ms));
+        return false;
+    }
+    return xQueueReceive(fileAlarmes, &alarme, pdMS_TO_TICKS(delai_ms)) == pdTRUE;
+}
+
+void noterEnvoiAlarme(bool renvoi)
+{
+    if (renvoi) {
+        stats.renvois++;
+    } else {
+        stats.envoyees++;
+    }
+}
+
+void noterAcquittementAlarme(const EvenementAlarme &alarme)
+{
+    const uint32_t latence = millis() - alarme.detection_ms;
+    stats.latenceMoyenne_ms = stats.acquittees == 0 ? latence : (7 * stats.latenceMoyenne_ms + latence) / 8;
+    if (latence > stats.latenceMax_ms) {
+        stats.latenceMax_ms = latence;
+    }
+    stats.latenceDerniere_ms = latence;
+    stats.acquittees++;
+}
+
+StatsAlarmes lireStatsAlarmes()
+{
+    return stats;
+}
@@ -0,0 +1,271 @@
+/**
+ * @file api_web.cpp
+ * @brief Implémentation des points d'accès /api/sensors, /api/history et /metrics.
+ */
+
+#include "api_web.h"
+#include "registre_capteurs.h"
+#include "historique.h"
+#include "statistiques.h"
+#include "journal.h"
+#include "alarmes.h"
+#include "taches/tache_co2.h"
+#include <WiFi.h>
+#include <esp_timer.h>
+#include <stdarg.h>
+
+extern const char IOTName[];
+
+// Serveur des routes (recréé par le portail à chaque démarrage, les routes sont alors rajoutées)
+static ServeurWeb *serveurApi = NULL;
+
+// Nom des fenêtres glissantes de l'historique dans les métriques
+static const char *const NOMS_FENETRE[NB_FENETRES] = { "1min", "15min", "1h" };
+
+/**
+ * Réponse écrite par fragments : le texte formaté s'accumule dans un tampon fixe, envoyé en
+ * fragment chunked chaque fois qu'il est plein.
+ */
+class ReponseFlux {
+public:
+  ReponseFlux(ServeurWeb &serveur, const char *type) : serveur(serveur)
+  {
+    serveur.setContentLength(CONTENT_LENGTH_UNKNOWN);
+    serveur.send(200, type, "");
+  }
+
+  // Ajoute du texte formaté (une ligne plus longue que le tampon est tronquée)
+  void ecrire(const char *format, ...)
+  {
+    for (int essai = 0; essai < 2; essai++) {
+      va_list args;
+      va_start(args, format);
+      const int m = vsnprintf(tampon + n, sizeof(tampon) - n, format, args);
+      va_end(args);
+      if (m < 0) {
+        return;
+      }
+      if ((size_t)m < sizeof(tampon) - n) {
+        n += m;
+        return;
+      }
+      if (n == 0) {
+        n = sizeof(tampon) - 1;
+        return;
+      }
+      vider();
+    }
+  }
+
+  // Envoie le dernier fragment et termine la réponse
+  void terminer()
+  {
+    vider();
+    serveur.sendContent("");
+  }
+
+private:
+  void vider()
+  {
+    if (n > 0) {
+      serveur.sendContent(tampon, n);
+      n = 0;
+    }
+  }
+
+  ServeurWeb &serveur;
+  char tampon[API_TAMPON_REPONSE];
+  size_t n = 0;
+};
+
+/**
+ * @brief Âge d'une capture en ms, par rapport à l'instant courant.
+ */
+static int64_t ageCapture(const Horodatage &capture, const Horodatage &maintenant)
+{
+    Horodatage h = capture;
+    convertirEpoch(h);
+    return h.epoch == maintenant.epoch ? maintenant.ms - h.ms : 0;
+}
+
+/**
+ * @brief GET /api/sensors : dernière valeur de chaque canal actif.
+ */
+static void servirCapteurs()
+{
+    SensorSnapshot instantane;
+    lireInstantane(instantane);
+    const Horodatage maintenant = lireHorodatage();
+
+    ReponseFlux r(*serveurApi, "application/json");
+    r.ecrire("{\"noeud\":\"%s\",\"horloge\":\"%s\",\"canaux\":{", IOTName, maintenant.epoch ? "epoch" : "millis");
+    bool premier = true;
+    for (const InfoCanal &info : TABLE_CANAUX) {
+        const EntreeMesure &e = instantane[info.canal];
+        Horodatage capture = e.horodatage;
+        convertirEpoch(capture);
+        r.ecrire("%s\"%s\":{\"valeur\":%.*f,\"unite\":\"%s\",\"valide\":%s,\"t\":%lld}", premier ? "" : ",",
+                 info.cle, info.decimales, e.valeur, info.unite, e.valide ? "true" : "false", (long long)capture.ms);
+        premier = false;
+    }
+    r.ecrire("}}");
+    r.terminer();
+}
+
+/**
+ * @brief GET /api/history?ch=cle&since=index : échantillons de l'historique RAM d'un canal.
+ *
+ * Les horodatages de l'historique (millis() de capture) sont ramenés sur l'horloge courante.
+ */
+static void servirHistorique()
+{
+    const InfoCanal *info = NULL;
+    for (const InfoCanal &i : TABLE_CANAUX) {
+        if (strcmp(i.cle, serveurApi->arg("ch").c_str()) == 0) {
+            info = &i;
+        }
+    }
+    if (info == NULL) {
+        serveurApi->send(404, "application/json", "{\"erreur\":\"canal inconnu\"}");
+        return;
+    }
+    uint32_t depuis = strtoul(serveurApi->arg("since").c_str(), NULL, 10);
+
+    const Horodatage maintenant = lireHorodatage();
+    const uint32_t maintenant_ms = millis();
+
+    ReponseFlux r(*serveurApi, "application/json");
+    r.ecrire("{\"canal\":\"%s\",\"horloge\":\"%s\",\"echantillons\":[", info->cle,
+             maintenant.epoch ? "epoch" : "millis");
+
+    // Au plus un tour de tampon : les échantillons publiés pendant l'envoi partiront au prochain appel
+    EchantillonHistorique lot[32];
+    size_t total = 0;
+    uint32_t suivant = depuis;
+    while (total < HISTORIQUE_PROFONDEUR) {
+        const size_t nb = copierHistorique(info->canal, depuis, lot,
+                                           min<size_t>(32, HISTORIQUE_PROFONDEUR - total), suivant);
+        if (nb == 0) {
+            break;
+        }
+        for (size_t i = 0; i < nb; i++) {
+            const int64_t t = maintenant.ms - (int32_t)(maintenant_ms - lot[i].horodatage);
+            r.ecrire("%s[%lld,%.*f]", total + i == 0 ? "" : ",", (long long)t, info->decimales, lot[i].valeur);
+        }
+        total += nb;
+        depuis = suivant;
+    }
+    r.ecrire("],\"suivant\":%lu}", (unsigned long)suivant);
+    r.terminer();
+}
+
+/**
+ * @brief GET /metrics : métriques au format texte Prometheus.
+ */
+static void servirMetriques()
+{
+    SensorSnapshot instantane;
+    lireInstantane(instantane);
+    const Horodatage maintenant = lireHorodatage();
+
+    ReponseFlux r(*serveurApi, "text/plain; version=0.0.4");
+
+    r.ecrire("# HELP noeud_mesure Derniere valeur du canal.\n# TYPE noeud_mesure gauge\n");
+    for (const InfoCanal &info : TABLE_CANAUX) {
+        const EntreeMesure &e = instantane[info.canal];
+        if (e.valide) {
+            r.ecrire("noeud_mesure{canal=\"%s\",unite=\"%s\"} %.*f\n", info.cle, info.unite, info.decimales, e.valeur);
+        }
+    }
+    r.ecrire("# HELP noeud_mesure_valide 1 si la derniere mesure du canal est valide.\n# TYPE noeud_mesure_valide gauge\n");
+    for (const InfoCanal &info : TABLE_CANAUX) {
+        r.ecrire("noeud_mesure_valide{canal=\"%s\"} %d\n", info.cle, instantane[info.canal].valide ? 1 : 0);
+    }
+    r.ecrire("# HELP noeud_mesure_age_secondes Age de la derniere capture.\n# TYPE noeud_mesure_age_secondes gauge\n");
+    for (const InfoCanal &info : TABLE_CANAUX) {
+        r.ecrire("noeud_mesure_age_secondes{canal=\"%s\"} %.1f\n", info.cle,
+                 ageCapture(instantane[info.canal].horodatage, maintenant) / 1000.0);
+    }
+
+    // Fenêtres glissantes de l'historique RAM
+    static const char *const GRANDEURS[] = { "moyenne", "min", "max" };
+    for (size_t g = 0; g < 3; g++) {
+        r.ecrire("# HELP noeud_fenetre_%s %s du canal sur la fenetre glissante.\n# TYPE noeud_fenetre_%s gauge\n",
+                 GRANDEURS[g], GRANDEURS[g], GRANDEURS[g]);
+        for (const InfoCanal &info : TABLE_CANAUX) {
+            for (uint8_t f = 0; f < NB_FENETRES; f++) {
+                AgregatFenetre a;
+                if (!lireAgregat(info.canal, (FenetreHistorique)f, a)) {
+                    continue;
+                }
+                const float v = g == 0 ? a.moyenne : g == 1 ? a.min : a.max;
+                r.ecrire("noeud_fenetre_%s{canal=\"%s\",fenetre=\"%s\"} %.*f\n", GRANDEURS[g], info.cle,
+                         NOMS_FENETRE[f], info.decimales + 1, v);
+            }
+        }
+    }
+
+    // Quantiles de la dernière fenêtre de statistiques close
+    r.ecrire("# HELP noeud_quantile Quantile du canal sur la derniere fenetre de statistiques close.\n"
+             "# TYPE noeud_quantile gauge\n");
+    for (const InfoCanal &info : TABLE_CANAUX) {
+        StatistiquesFenetre s;
+        if (lireStatistiques(info.canal, s)) {
+            r.ecrire("noeud_quantile{canal=\"%s\",quantile=\"0.5\"} %.*f\n", info.cle, info.decimales, s.p50);
+            r.ecrire("noeud_quantile{canal=\"%s\",quantile=\"0.95\"} %.*f\n", info.cle, info.decimales, s.p95);
+        }
+    }
+
+    const StatsJournal j = lireStatsJournal();
+    r.ecrire("# TYPE noeud_journal_ecrits_total counter\nnoeud_journal_ecrits_total %u\n", j.ecrits);
+    r.ecrire("# TYPE noeud_journal_perdus_total counter\nnoeud_journal_perdus_total %u\n", j.perdus);
+    r.ecrire("# TYPE noeud_journal_evinces_total counter\nnoeud_journal_evinces_total %u\n", j.evinces);
+    r.ecrire("# TYPE noeud_journal_en_attente gauge\nnoeud_journal_en_attente %u\n", finJournal() - curseurJournal());
+
+    const StatsAlarmes a = lireStatsAlarmes();
+    r.ecrire("# TYPE noeud_alarmes_detectees_total counter\nnoeud_alarmes_detectees_total %u\n", a.detectees);
+    r.ecrire("# TYPE noeud_alarmes_acquittees_total counter\nnoeud_alarmes_acquittees_total %u\n", a.acquittees);
+    r.ecrire("# TYPE noeud_alarme_latence_ms gauge\nnoeud_alarme_latence_ms{stat=\"moyenne\"} %u\n"
+             "noeud_alarme_latence_ms{stat=\"max\"} %u\n", a.latenceMoyenne_ms, a.latenceMax_ms);
+
+#if CAPTEUR_SGP30_ACTIF
+    // Baseline IAQ du SGP30 : fiabilité et âge de la baseline sauvegardée (-1 tant qu'il est inconnu)
+    EtatBaselineSgp30 b;
+    lireEtatBaselineSgp30(b);
+    r.ecrire("# HELP noeud_sgp30_baseline_valide 1 si la baseline IAQ est fiable (restauree ou calibree).\n"
+             "# TYPE noeud_sgp30_baseline_valide gauge\nnoeud_sgp30_baseline_valide %d\n", b.valide ? 1 : 0);
+    r.ecrire("# TYPE noeud_sgp30_baseline_restauree gauge\nnoeud_sgp30_baseline_restauree %d\n", b.restauree ? 1 : 0);
+    r.ecrire("# TYPE noeud_sgp30_baseline_age_secondes gauge\nnoeud_sgp30_baseline_age_secondes %ld\n", (long)b.age_s);
+#endif
+
+#ifdef WM_ASYNCWEBSERVER
+    // Charge du portail : temps de la tâche httpd passé à servir les requêtes, attente du verrou du
+    // portail, et réveils de la boucle bloquante (sur requête ou au délai WM_ASYNC_IDLE_MS)
+    const WM_AsyncStats p = serveurApi->stats();
+    const int64_t depuis_us = esp_timer_get_time() - p.startMicros;
+    r.ecrire("# TYPE noeud_portail_requetes_total counter\nnoeud_portail_requetes_total %u\n", p.requests);
+    r.ecrire("# HELP noeud_portail_occupation_secondes_total Temps de la tache httpd passe a servir les requetes.\n"
+             "# TYPE noeud_portail_occupation_secondes_total counter\nnoeud_portail_occupation_secondes_total %.3f\n",
+             p.busyMicros / 1e6);
+    r.ecrire("# HELP noeud_portail_occupation_pourcent Part du temps passee a servir les requetes depuis le demarrage du serveur.\n"
+             "# TYPE noeud_portail_occupation_pourcent gauge\nnoeud_portail_occupation_pourcent %.3f\n",
+             depuis_us > 0 ? 100.0 * p.busyMicros / depuis_us : 0.0);
+    r.ecrire("# TYPE noeud_portail_attente_verrou_secondes_total counter\nnoeud_portail_attente_verrou_secondes_total %.3f\n",
+             p.lockMicros / 1e6);
+    r.ecrire("# TYPE noeud_portail_reveils_total counter\nnoeud_portail_reveils_total{cause=\"requete\"} %u\n"
+             "noeud_portail_reveils_total{cause=\"delai\"} %u\n", p.wakeups - p.idleWakeups, p.idleWakeups);
+#endif
+
+    r.ecrire("# TYPE noeud_uptime_secondes counter\nnoeud_uptime_secondes %lu\n", (unsigned long)(millis() / 1000));
+    r.ecrire("# TYPE noeud_memoire_libre_octets gauge\nnoeud_memoire_libre_octets %u\n", ESP.getFreeHeap());
+    r.ecrire("# TYPE noeud_wifi_rssi_dbm gauge\nnoeud_wifi_rssi_dbm %d\n", WiFi.RSSI());
+    r.terminer();
+}
+
+void ajouterRoutesApi(ServeurWeb &serveur)
+{
+    serveurApi = &serveur;
+    serveur.on("/api/sensors", HTTP_GET, servirCapteurs);
+    serveur.on("/api/history", HTTP_GET, servirHistorique);
+    serveur.on("/metrics", HTTP_GET, servirMetriques);
+}
@@ -0,0 +1,260 @@
+/**
+ * @file client_http.cpp
+ * @brief Implémentation du client d'ingestion HTTP/1.1 (keep-alive, chunked, pipelining).
+ */
+
+#include "client_http.h"
+
+/**
+ * @brief Encode en base64 (authentification Basic).
+ *
+ * @return Nombre de caractères écrits (sans le zéro final), 0 si la destination est trop petite.
+ */
+static size_t encoderBase64(char *destination, size_t taille, const uint8_t *source, size_t longueur)
+{
+    static const char ALPHABET[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    const size_t n = (longueur + 2) / 3 * 4;
+    if (n + 1 > taille) {
+        return 0;
+    }
+    char *d = destination;
+    for (size_t i = 0; i < longueur; i += 3) {
+        const uint32_t bloc = (uint32_t)source[i] << 16 |
+                              (i + 1 < longueur ? (uint32_t)source[i + 1] << 8 : 0) |
+                              (i + 2 < longueur ? source[i + 2] : 0);
+        *d++ = ALPHABET[(bloc >> 18) & 0x3F];
+        *d++ = ALPHABET[(bloc >> 12) & 0x3F];
+        *d++ = i + 1 < longueur ? ALPHABET[(bloc >> 6) & 0x3F] : '=';
+        *d++ = i + 2 < longueur ? ALPHABET[bloc & 0x3F] : '=';
+    }
+    *d = '\0';
+    return n;
+}
+
+bool ClientHttp::connecter(const char *hote, uint16_t port, const char *utilisateur, const char *motDePasse)
+{
+    transport.stop();
+    premier = 0;
+    nbEnVol = 0;
+
+    const int h = snprintf(this->hote, sizeof(this->hote), port == 80 ? "%s" : "%s:%u", hote, port);
+    if (h < 0 || (size_t)h >= sizeof(this->hote)) {
+        this->hote[0] = '\0';
+        stats.echecsConnexion++;
+        return false;
+    }
+    autorisation[0] = '\0';
+    if (utilisateur && utilisateur[0] != '\0') {
+        char identifiants[80];
+        const int l = snprintf(identifiants, sizeof(identifiants), "%s:%s", utilisateur, motDePasse ? motDePasse : "");
+        const size_t debut = snprintf(autorisation, sizeof(autorisation), "Authorization: Basic ");
+        if (l < 0 || (size_t)l >= sizeof(identifiants) ||
+            encoderBase64(autorisation + debut, sizeof(autorisation) - debut - 2, (const uint8_t *)identifiants, l) == 0) {
+            stats.echecsConnexion++;
+            return false;
+        }
+        strcat(autorisation, "\r\n");
+    }
+
+    if (!transport.connect(hote, port)) {
+        stats.echecsConnexion++;
+        return false;
+    }
+    stats.connexions++;
+    return true;
+}
+
+void ClientHttp::deconnecter()
+{
+    transport.stop();
+}
+
+bool ClientHttp::connecte()
+{
+    return transport.connected();
+}
+
+size_t ClientHttp::placesLibres(bool prioritaire)
+{
+    if (!transport.connected()) {
+        return 0;
+    }
+    if (!prioritaire && stats.requetes > 0 && millis() - derniereRequete_ms < 1000UL / HTTP_REQUETES_PAR_S) {
+        return 0;
+    }
+    return HTTP_PIPELINE - nbEnVol;
+}
+
+bool ClientHttp::ecrire(const void *donnees, size_t longueur)
+{
+    if (transport.write((const uint8_t *)donnees, longueur) != longueur) {
+        transport.stop();
+        return false;
+    }
+    return true;
+}
+
+bool ClientHttp::envoyer(const char *chemin, const char *typeContenu, SourceCorps source, uint32_t jeton)
+{
+    if (nbEnVol == HTTP_PIPELINE || !transport.connected()) {
+        return false;
+    }
+    derniereRequete_ms = millis();
+
+    // Ligne de requête, Host, Authorization et en-têtes fixes
+    char entetes[HTTP_TAILLE_HOTE + sizeof(autorisation) + 192];
+    const int n = snprintf(entetes, sizeof(entetes),
+                           "POST %s HTTP/1.1\r\nHost: %s\r\nContent-Type: %s\r\nTransfer-Encoding: chunked\r\n%s\r\n",
+                           chemin, hote, typeContenu, autorisation);
+    if (n < 0 || (size_t)n >= sizeof(entetes) || !ecrire(entetes, n)) {
+        return false;
+    }
+
+    // Un fragment chunked par fragment de la source : "<taille hexa>\r\n<données>\r\n"
+    const uint8_t *donnees;
+    size_t longueur;
+    while ((longueur = source(&donnees)) > 0) {
+        char taille[12];
+        const int t = snprintf(taille, sizeof(taille), "%x\r\n", (unsigned)longueur);
+        if (!ecrire(taille, t) || !ecrire(donnees, longueur) || !ecrire("\r\n", 2)) {
+            return false;
+        }
+        stats.octetsCorps += longueur;
+    }
+    if (!ecrire("0\r\n\r\n", 5)) {
+        return false;
+    }
+
+    enAttente[(premier + nbEnVol) % HTTP_PIPELINE] = { jeton, (uint32_t)millis() };
+    nbEnVol++;
+    stats.requetes++;
+    return true;
+}
+
+bool ClientHttp::lireLigne(char *ligne, size_t taille)
+{
+    const size_t n = transport.readBytesUntil('\n', ligne, taille - 1);
+    if (n == 0) {
+        return false;
+    }
+    ligne[n] = '\0';
+    if (ligne[n - 1] == '\r') {
+        ligne[n - 1] = '\0';
+    }
+    return true;
+}
+
+/**
+ * @brief Lit la réponse de la plus ancienne requête en vol : ligne d'état, en-têtes, corps ignoré.
+ *
+ * @return false si la réponse est illisible ou n'est pas un succès (la connexion doit être fermée).
+ */
+bool ClientHttp::lireReponse()
+{
+    transport.setTimeout(HTTP_DELAI_REPONSE_MS);
+
+    char ligne[128];
+    int statut = 0;
+    if (!lireLigne(ligne, sizeof(ligne)) || sscanf(ligne, "HTTP/1.%*d %d", &statut) != 1) {
+        return false;
+    }
+
+    long longueurCorps = 0;
+    bool chunked = false;
+    bool fermeture = false;
+    for (;;) {
+        if (!lireLigne(ligne, sizeof(ligne))) {
+            return false;
+        }
+        if (ligne[0] == '\0') {
+            break;
+        }
+        if (strncasecmp(ligne, "Content-Length:", 15) == 0) {
+            longueurCorps = atol(ligne + 15);
+        } else if (strncasecmp(ligne, "Transfer-Encoding:", 18) == 0) {
+            chunked = strstr(ligne + 18, "chunked") != NULL;
+        } else if (strncasecmp(ligne, "Connection:", 11) == 0) {
+            fermeture = strcasestr(ligne + 11, "close") != NULL;
+        }
+    }
+
+    // Corps de la réponse lu et ignoré
+    uint8_t poubelle[64];
+    for (;;) {
+        if (chunked) {
+            if (!lireLigne(ligne, sizeof(ligne))) {
+                return false;
+            }
+            longueurCorps = strtol(ligne, NULL, 16);
+            if (longueurCorps == 0) {
+                while (lireLigne(ligne, sizeof(ligne)) && ligne[0] != '\0') {}   // En-têtes de fin
+                break;
+            }
+            longueurCorps += 2;   // CRLF qui suit le fragment
+        }
+        while (longueurCorps > 0) {
+            const size_t n = transport.readBytes(poubelle, min<long>(longueurCorps, sizeof(poubelle)));
+            if (n == 0) {
+                return false;
+            }
+            longueurCorps -= n;
+        }
+        if (!chunked) {
+            break;
+        }
+    }
+
+    const RequeteEnVol requete = enAttente[premier];
+    premier = (premier + 1) % HTTP_PIPELINE;
+    nbEnVol--;
+
+    const uint32_t latence = millis() - requete.envoi_ms;
+    stats.latenceMoyenne_ms = stats.reponsesOk + stats.reponsesErreur == 0
+                                  ? latence : (7 * stats.latenceMoyenne_ms + latence) / 8;
+    if (latence > stats.latenceMax_ms) {
+        stats.latenceMax_ms = latence;
+    }
+
+    if (statut < 200 || statut > 299) {
+        stats.reponsesErreur++;
+        if (rappelRefus) {
+            rappelRefus(requete.jeton, statut);
+        }
+        return false;
+    }
+    stats.reponsesOk++;
+    if (rappelReponse) {
+        rappelReponse(requete.jeton);
+    }
+    if (fermeture) {
+        transport.stop();
+    }
+    return true;
+}
+
+void ClientHttp::traiter()
+{
+    if (!transport.connected()) {
+        return;
+    }
+
+    while (transport.available() > 0) {
+        if (nbEnVol == 0) {
+            transport.read();   // Données hors requête : ignorées
+            continue;
+        }
+        if (!lireReponse()) {
+            transport.stop();
+            return;
+        }
+        if (!transport.connected()) {
+            return;
+        }
+    }
+
+    // Réponse attendue trop longtemps : la connexion est considérée comme perdue
+    if (nbEnVol > 0 && millis() - enAttente[premier].envoi_ms > HTTP_DELAI_REPONSE_MS) {
+        stats.reponsesErreur++;
+        transport.stop();
+    }
+}
@@ -0,0 +1,138 @@
+/**
+ * @file client_udp.cpp
+ * @brief Implémentation de la publication UDP (trame brute ou CoAP NON).
+ */
+
+#include "client_udp.h"
+
+// En-tête CoAP : version 1, type NON (1), jeton de 4 octets ; code 0.02 POST
+static const uint8_t COAP_VERSION_NON_TKL4 = 0x54;
+static const uint8_t COAP_POST = 0x02;
+static const uint8_t COAP_FIN_OPTIONS = 0xFF;
+static const uint16_t COAP_OPTION_URI_PATH = 11;
+static const uint16_t COAP_OPTION_CONTENT_FORMAT = 12;
+
+// En-tête de trame le plus long accepté (chemin compris)
+static const size_t TAILLE_EN_TETE_MAX = 96;
+
+/**
+ * @brief Écrit une option CoAP (delta et longueur sur 4 bits, étendus d'un octet au-delà de 12).
+ *
+ * @return Octets écrits, 0 si la place manque.
+ */
+static size_t ecrireOption(uint8_t *d, size_t taille, uint16_t delta, const uint8_t *valeur, size_t longueur)
+{
+    if (delta >= 269 || longueur >= 269) {
+        return 0;
+    }
+    const size_t n = 1 + (delta >= 13) + (longueur >= 13) + longueur;
+    if (n > taille) {
+        return 0;
+    }
+    size_t i = 0;
+    d[i++] = (delta >= 13 ? 13 : delta) << 4 | (longueur >= 13 ? 13 : longueur);
+    if (delta >= 13) d[i++] = delta - 13;
+    if (longueur >= 13) d[i++] = longueur - 13;
+    memcpy(d + i, valeur, longueur);
+    return n;
+}
+
+void ClientUdp::configurer(IPAddress adresse, uint16_t port, TrameUdp trame)
+{
+    this->adresse = adresse;
+    this->port = port;
+    this->trame = trame;
+}
+
+size_t ClientUdp::ecrireEnTete(uint8_t *enTete, size_t taille, const char *chemin, FormatContenu format) const
+{
+    if (trame == TRAME_BRUTE) {
+        if (taille < 4) {
+            return 0;
+        }
+        enTete[0] = sequence >> 24;
+        enTete[1] = sequence >> 16;
+        enTete[2] = sequence >> 8;
+        enTete[3] = sequence;
+        return 4;
+    }
+
+    if (taille < 8) {
+        return 0;
+    }
+    size_t n = 0;
+    enTete[n++] = COAP_VERSION_NON_TKL4;
+    enTete[n++] = COAP_POST;
+    enTete[n++] = sequence >> 8;        // Identifiant du message
+    enTete[n++] = sequence;
+    enTete[n++] = sequence >> 24;       // Jeton : séquence complète
+    enTete[n++] = sequence >> 16;
+    enTete[n++] = sequence >> 8;
+    enTete[n++] = sequence;
+
+    // Une option Uri-Path par segment du chemin, dans l'ordre des numéros d'option
+    uint16_t derniere = 0;
+    const char *segment = chemin;
+    while (segment && *segment) {
+        segment += strspn(segment, "/");
+        const size_t l = strcspn(segment, "/");
+        if (l == 0) {
+            break;
+        }
+        const size_t m = ecrireOption(enTete + n, taille - n, COAP_OPTION_URI_PATH - derniere,
+                                      (const uint8_t *)segment, l);
+        if (m == 0) {
+            return 0;
+        }
+        n += m;
+        derniere = COAP_OPTION_URI_PATH;
+        segment += l;
+    }
+
+    const uint8_t contenu = format;
+    const size_t m = ecrireOption(enTete + n, taille - n, COAP_OPTION_CONTENT_FORMAT - derniere, &contenu, 1);
+    if (m == 0 || n + m >= taille) {
+        return 0;
+    }
+    n += m;
+    enTete[n++] = COAP_FIN_OPTIONS;
+    return n;
+}
+
+size_t ClientUdp::chargeMax(const char *chemin) const
+{
+    uint8_t enTete[TAILLE_EN_TETE_MAX];
+    const size_t n = ecrireEnTete(enTete, sizeof(enTete), chemin, CONTENU_CBOR);
+    return n == 0 ? 0 : UDP_TAILLE_DATAGRAMME - n;
+}
+
+bool ClientUdp::envoyer(const char *chemin, FormatContenu format, const uint8_t *charge, size_t longueur)
+{
+    uint8_t enTete[TAILLE_EN_TETE_MAX];
+    const size_t n = ecrireEnTete(enTete, sizeof(enTete), chemin, format);
+    if (!configure() || n == 0 || n + longueur > UDP_TAILLE_DATAGRAMME) {
+        stats.echecs++;
+        return false;
+    }
+
+    const uint32_t debut = micros();
+    const bool envoye = transport.beginPacket(adresse, port) &&
+                        transport.write(enTete, n) == n &&
+                        transport.write(charge, longueur) == longueur &&
+                        transport.endPacket();
+    const uint32_t duree = micros() - debut;
+
+    // Un datagramme refusé n'est pas parti : la séquence n'avance pas, les trous restent des pertes réseau
+    if (!envoye) {
+        stats.echecs++;
+        return false;
+    }
+    sequence++;
+    stats.datagrammes++;
+    stats.octets += n + longueur;
+    stats.dureeMoyenne_us = stats.datagrammes == 1 ? duree : (7 * stats.dureeMoyenne_us + duree) / 8;
+    if (duree > stats.dureeMax_us) {
+        stats.dureeMax_us = duree;
+    }
+    return true;
+}
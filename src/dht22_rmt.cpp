@@ -0,0 +1,132 @@
+/**
+ * @file dht22_rmt.cpp
+ * @brief Implémentation du pilote DHT22 basé sur le RMT.
+ *
+ * Déroulement d'une lecture :
+ * 1. la broche (open-drain) est maintenue à 0 pendant 2 ms : la tâche dort, les interruptions restent actives ;
+ * 2. la ligne est relâchée et la réception RMT démarrée ;
+ * 3. le RMT horodate tous les fronts de la réponse (~5 ms) et dépose la trame dans son tampon
+ *    circulaire dès que la ligne reste inactive plus de 100 µs ;
+ * 4. la tâche récupère la trame (attente passive) et la décode.
+ */
+
+#include "dht22_rmt.h"
+#ifdef ARDUINO
+#include <driver/rmt.h>
+#include <driver/gpio.h>
+#endif
+
+// Seuil de durée haute séparant un bit 0 (~27 µs) d'un bit 1 (~70 µs)
+static const uint16_t SEUIL_BIT_US = 48;
+// Durée haute maximale plausible d'un bit
+static const uint16_t DUREE_BIT_MAX_US = 100;
+
+ResultatDht22 decoderTrameDht22(const uint16_t dureesHautes[], size_t nb, TrameDht22 &trame)
+{
+    if (nb < DHT22_NB_BITS) {
+        return DHT22_ERREUR_TRAME;
+    }
+
+    uint8_t octets[DHT22_NB_BITS / 8] = {};
+    const uint16_t *bits = dureesHautes + (nb - DHT22_NB_BITS);
+    for (size_t i = 0; i < DHT22_NB_BITS; i++) {
+        if (bits[i] == 0 || bits[i] > DUREE_BIT_MAX_US) {
+            return DHT22_ERREUR_TRAME;
+        }
+        octets[i / 8] = (octets[i / 8] << 1) | (bits[i] > SEUIL_BIT_US ? 1 : 0);
+    }
+
+    if ((uint8_t)(octets[0] + octets[1] + octets[2] + octets[3]) != octets[4]) {
+        return DHT22_ERREUR_SOMME;
+    }
+
+    // Humidité et température en dixièmes ; le bit de poids fort de la température est le signe
+    trame.humidite = ((octets[0] << 8) | octets[1]) * 0.1f;
+    trame.temperature = (((octets[2] & 0x7F) << 8) | octets[3]) * 0.1f;
+    if (octets[2] & 0x80) {
+        trame.temperature = -trame.temperature;
+    }
+    return DHT22_OK;
+}
+
+#ifdef ARDUINO   // Capture par le RMT : cible seulement, le décodage ci-dessus est aussi testé sur PC (env:native)
+
+// Durée sans front qui termine la capture (l'état de repos final n'est pas une impulsion)
+static const uint16_t SEUIL_INACTIVITE_US = 100;
+// Nombre maximal d'impulsions hautes conservées (réponse + données + marge)
+static const size_t NB_IMPULSIONS_MAX = DHT22_NB_BITS + 8;
+
+static gpio_num_t brocheDht22 = GPIO_NUM_NC;
+static rmt_channel_t canalDht22 = RMT_CHANNEL_0;
+static RingbufHandle_t tamponRmt = NULL;
+
+bool initDht22Rmt(uint8_t broche, uint8_t canalRmt)
+{
+    brocheDht22 = (gpio_num_t)broche;
+    canalDht22 = (rmt_channel_t)canalRmt;
+
+    rmt_config_t config = RMT_DEFAULT_CONFIG_RX(brocheDht22, canalDht22);
+    config.clk_div = 80;                          // APB 80 MHz / 80 = 1 tick par µs
+    config.mem_block_num = 1;                     // 64 éléments : une trame en compte ~43
+    config.rx_config.filter_en = true;
+    config.rx_config.filter_ticks_thresh = 100;   // Parasites < 1,25 µs ignorés (ticks APB)
+    config.rx_config.idle_threshold = SEUIL_INACTIVITE_US;  // Fin de trame après 100 µs sans front
+
+    if (rmt_config(&config) != ESP_OK ||
+        rmt_driver_install(canalDht22, 1024, 0) != ESP_OK ||
+        rmt_get_ringbuf_handle(canalDht22, &tamponRmt) != ESP_OK) {
+        Serial.println("DHT22 - Erreur d'initialisation du RMT");
+        return false;
+    }
+
+    // Ligne en open-drain : le RMT continue d'écouter pendant que l'on pilote l'impulsion de démarrage
+    gpio_set_pull_mode(brocheDht22, GPIO_PULLUP_ONLY);
+    gpio_set_direction(brocheDht22, GPIO_MODE_INPUT_OUTPUT_OD);
+    gpio_set_level(brocheDht22, 1);
+    return true;
+}
+
+ResultatDht22 lireDht22(TrameDht22 &trame)
+{
+    if (tamponRmt == NULL) {
+        return DHT22_ERREUR_DELAI;
+    }
+
+    // Impulsion de démarrage : au moins 1 ms à l'état bas
+    gpio_set_level(brocheDht22, 0);
+    vTaskDelay(pdMS_TO_TICKS(2));
+
+    // Relâchement de la ligne et capture de la réponse
+    rmt_rx_start(canalDht22, true);
+    gpio_set_level(brocheDht22, 1);
+
+    size_t taille = 0;
+    rmt_item32_t *elements = (rmt_item32_t *)xRingbufferReceive(tamponRmt, &taille, pdMS_TO_TICKS(20));
+    rmt_rx_stop(canalDht22);
+    if (elements == NULL) {
+        return DHT22_ERREUR_DELAI;
+    }
+
+    // Extraction des durées des impulsions hautes, dans l'ordre de réception
+    uint16_t dureesHautes[NB_IMPULSIONS_MAX];
+    size_t nb = 0;
+    for (size_t i = 0; i < taille / sizeof(rmt_item32_t); i++) {
+        const uint16_t durees[2] = { (uint16_t)elements[i].duration0, (uint16_t)elements[i].duration1 };
+        const uint8_t niveaux[2] = { (uint8_t)elements[i].level0, (uint8_t)elements[i].level1 };
+        for (size_t j = 0; j < 2; j++) {
+            if (niveaux[j] == 1 && durees[j] != 0 && durees[j] < SEUIL_INACTIVITE_US) {
+                if (nb == NB_IMPULSIONS_MAX) {
+                    // On ne garde que les dernières impulsions : décalage d'un cran
+                    memmove(dureesHautes, dureesHautes + 1, (NB_IMPULSIONS_MAX - 1) * sizeof(uint16_t));
+                    nb--;
+                }
+                dureesHautes[nb++] = durees[j];
+            }
+        }
+    }
+    vRingbufferReturnItem(tamponRmt, elements);
+
+    return decoderTrameDht22(dureesHautes, nb, trame);
+}
+
+#endif // ARDUINO
@@ -0,0 +1,87 @@
+/**
+ * @file ecran_ssd1306.cpp
+ * @brief Implémentation de l'écran SSD1306 sur l'arbitre du bus I2C.
+ */
+
+#include "ecran_ssd1306.h"
+#include "configuration.h"
+#include "taches/tache_bus_i2c.h"
+
+// Octets de contrôle du SSD1306 : suite de commandes, une seule commande, données d'image
+static const uint8_t CONTROLE_COMMANDES = 0x00;
+static const uint8_t CONTROLE_COMMANDE = 0x80;
+static const uint8_t CONTROLE_DONNEES = 0x40;
+
+EcranSsd1306::EcranSsd1306(uint8_t adresse, OLEDDISPLAY_GEOMETRY geometrie) : adresse(adresse)
+{
+    setGeometry(geometrie);
+}
+
+void EcranSsd1306::sendCommand(uint8_t commande)
+{
+    const uint8_t trame[2] = { CONTROLE_COMMANDE, commande };
+    ecrireI2c(adresse, trame, sizeof(trame), I2C_PRIORITE_AFFICHAGE);
+}
+
+void EcranSsd1306::display(void)
+{
+    const uint8_t decalageX = (128 - width()) / 2;
+    const uint8_t nbPages = height() / 8;
+
+#ifdef OLEDDISPLAY_DOUBLE_BUFFER
+    // Rectangle (colonnes x pages) des octets modifiés depuis la dernière image envoyée
+    uint8_t minX = UINT8_MAX, maxX = 0, minPage = UINT8_MAX, maxPage = 0;
+    for (uint8_t page = 0; page < nbPages; page++) {
+        for (uint8_t x = 0; x < width(); x++) {
+            const uint16_t pos = x + page * width();
+            if (buffer[pos] != buffer_back[pos]) {
+                if (x < minX) minX = x;
+                if (x > maxX) maxX = x;
+                if (page < minPage) minPage = page;
+                if (page > maxPage) maxPage = page;
+            }
+        }
+    }
+    if (minPage == UINT8_MAX) {
+        return;
+    }
+#else
+    const uint8_t minX = 0, maxX = width() - 1, minPage = 0, maxPage = nbPages - 1;
+#endif
+
+    // Fenêtre d'écriture en une transaction : le pointeur du SSD1306 avance ensuite seul
+    const uint8_t fenetre[7] = { CONTROLE_COMMANDES,
+                                 COLUMNADDR, (uint8_t)(decalageX + minX), (uint8_t)(decalageX + maxX),
+                                 PAGEADDR, minPage, maxPage };
+    if (ecrireI2c(adresse, fenetre, sizeof(fenetre), I2C_PRIORITE_AFFICHAGE) != I2C_OK) {
+        return;
+    }
+
+    // Image par fragments : une mesure n'attend jamais plus d'un fragment
+    uint8_t trame[1 + OLED_OCTETS_PAR_TRANSACTION];
+    trame[0] = CONTROLE_DONNEES;
+    size_t longueur = 1;
+    for (uint8_t page = minPage; page <= maxPage; page++) {
+        for (uint8_t x = minX; x <= maxX; x++) {
+            trame[longueur++] = buffer[x + page * width()];
+            if (longueur == sizeof(trame)) {
+                if (ecrireI2c(adresse, trame, longueur, I2C_PRIORITE_AFFICHAGE) != I2C_OK) {
+                    return;
+                }
+                longueur = 1;
+            }
+        }
+    }
+    if (longueur > 1 && ecrireI2c(adresse, trame, longueur, I2C_PRIORITE_AFFICHAGE) != I2C_OK) {
+        return;
+    }
+
+#ifdef OLEDDISPLAY_DOUBLE_BUFFER
+    // Image de référence mise à jour seulement une fois tout le rectangle transmis :
+    // après une erreur de bus, le même rectangle est renvoyé à l'appel suivant
+    for (uint8_t page = minPage; page <= maxPage; page++) {
+        const uint16_t debut = minX + page * width();
+        memcpy(buffer_back + debut, buffer + debut, maxX - minX + 1);
+    }
+#endif
+}
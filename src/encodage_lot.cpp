@@ -0,0 +1,190 @@
+/**
+ * @file encodage_lot.cpp
+ * @brief Implémentation de l'encodage binaire compact des lots d'échantillons.
+ */
+
+#include "encodage_lot.h"
+#include "registre_capteurs.h"
+
+// Puissances de 10 pour la mise à l'échelle des valeurs (décimales du registre)
+static const float ECHELLES[] = { 1.0f, 10.0f, 100.0f, 1000.0f, 10000.0f };
+
+// Tampon d'écriture borné : les écritures au-delà de la taille sont refusées mais comptées dans n
+struct Ecriture {
+  uint8_t *tampon;
+  size_t taille;
+  size_t n;
+  bool debordement;
+
+  void octet(uint8_t o)
+  {
+      if (n < taille) {
+          tampon[n] = o;
+      } else {
+          debordement = true;
+      }
+      n++;
+  }
+
+  void octets(const void *donnees, size_t longueur)
+  {
+      if (n > taille || longueur > taille - n) {
+          debordement = true;
+      } else {
+          memcpy(tampon + n, donnees, longueur);
+      }
+      n += longueur;
+  }
+
+  // Entier non signé par groupes de 7 bits, poids faible en premier
+  void varint(uint64_t v)
+  {
+      while (v >= 0x80) {
+          octet((uint8_t)v | 0x80);
+          v >>= 7;
+      }
+      octet((uint8_t)v);
+  }
+
+  // Entier signé : zigzag (0, -1, 1, -2... -> 0, 1, 2, 3...) puis varint
+  void zigzag(int64_t v)
+  {
+      varint(((uint64_t)v << 1) ^ (uint64_t)(v >> 63));
+  }
+
+  // En-tête CBOR : type majeur sur 3 bits et argument sur 0, 1, 2, 4 ou 8 octets
+  void cbor(uint8_t type, uint64_t argument)
+  {
+      type <<= 5;
+      if (argument < 24) {
+          octet(type | argument);
+      } else if (argument <= 0xFF) {
+          octet(type | 24);
+          octet(argument);
+      } else if (argument <= 0xFFFF) {
+          octet(type | 25);
+          octet(argument >> 8);
+          octet(argument);
+      } else {
+          octet(type | 26);
+          for (int decalage = 24; decalage >= 0; decalage -= 8) {
+              octet(argument >> decalage);
+          }
+      }
+  }
+
+  void cborTexte(const char *texte)
+  {
+      const size_t longueur = strlen(texte);
+      cbor(3, longueur);
+      octets(texte, longueur);
+  }
+};
+
+static const uint8_t CBOR_OCTETS = 2;
+static const uint8_t CBOR_TABLE = 5;
+
+/**
+ * @brief Écrit la section d'une série : en-tête, premier échantillon, puis deltas.
+ */
+static void ecrireSerie(Ecriture &e, const EnregistrementJournal enregistrements[], size_t nb,
+                        const InfoCanal &info, uint8_t nature, size_t nombre)
+{
+    const uint8_t decimales = nature == NATURE_NOMBRE ? 0 :
+        info.decimales < sizeof(ECHELLES) / sizeof(ECHELLES[0]) ? info.decimales : 0;
+    e.octet(info.canal | nature << 4);
+    e.octet(decimales);
+    e.varint(nombre);
+
+    bool premier = true;
+    int64_t horodatage = 0;
+    int64_t delta = 0;
+    int32_t valeur = 0;
+    for (size_t i = 0; i < nb; i++) {
+        const EnregistrementJournal &r = enregistrements[i];
+        if (r.canal != info.canal || JOURNAL_NATURE(r.drapeaux) != nature) {
+            continue;
+        }
+        const int32_t v = (int32_t)lroundf(r.valeur * ECHELLES[decimales]);
+        if (premier) {
+            e.varint((uint64_t)r.horodatage_ms);
+            e.zigzag(v);
+            premier = false;
+        } else {
+            const int64_t d = r.horodatage_ms - horodatage;
+            e.zigzag(d - delta);
+            e.zigzag((int64_t)v - valeur);
+            delta = d;
+        }
+        horodatage = r.horodatage_ms;
+        valeur = v;
+    }
+}
+
+/**
+ * @brief Écrit la trame binaire : en-tête puis une section par série (canal, nature) présente.
+ */
+static void ecrireTrame(Ecriture &e, const EnregistrementJournal enregistrements[], size_t nb, bool epoch)
+{
+    e.octet((ENCODAGE_LOT_VERSION << 4) | (epoch ? 0x01 : 0x00));
+
+    // Nombre d'enregistrements de chaque série, en une passe
+    uint16_t nombres[NB_CANAUX][NB_NATURES] = {};
+    for (size_t i = 0; i < nb; i++) {
+        if (enregistrements[i].canal < NB_CANAUX) {
+            nombres[enregistrements[i].canal][JOURNAL_NATURE(enregistrements[i].drapeaux)]++;
+        }
+    }
+
+    for (const InfoCanal &info : TABLE_CANAUX) {
+        for (uint8_t nature = 0; nature < NB_NATURES; nature++) {
+            if (nombres[info.canal][nature] > 0) {
+                ecrireSerie(e, enregistrements, nb, info, nature, nombres[info.canal][nature]);
+            }
+        }
+    }
+}
+
+size_t encoderLot(const EnregistrementJournal enregistrements[], size_t nb, bool epoch,
+                  const IdentiteNoeud *identite, uint8_t *tampon, size_t taille)
+{
+    Ecriture e = { tampon, taille, 0, false };
+
+    if (identite == NULL) {
+        ecrireTrame(e, enregistrements, nb, epoch);
+        return e.debordement ? 0 : e.n;
+    }
+
+    // Enveloppe CBOR : la longueur de la chaîne d'octets "lot" précède la trame. La trame est
+    // écrite en fin de tampon, puis ramenée derrière l'en-tête une fois sa longueur connue.
+    e.cbor(CBOR_TABLE, 3);
+    e.cborTexte("id");
+    e.cborTexte(identite->nom);
+    e.cborTexte("mac");
+    e.cbor(CBOR_OCTETS, sizeof(identite->mac));
+    e.octets(identite->mac, sizeof(identite->mac));
+    e.cborTexte("lot");
+    if (e.debordement) {
+        return 0;
+    }
+
+    const size_t enTete = e.n;
+    const size_t reserve = min(taille - enTete, (size_t)5);   // En-tête CBOR de la chaîne d'octets : au plus 5 octets
+    Ecriture trame = { tampon + enTete + reserve, taille - enTete - reserve, 0, false };
+    ecrireTrame(trame, enregistrements, nb, epoch);
+    if (trame.debordement) {
+        // La réserve a pu manquer de peu : la longueur exacte est connue, la trame est
+        // réécrite derrière un en-tête à sa taille si l'ensemble tient dans le tampon.
+        e.cbor(CBOR_OCTETS, trame.n);
+        if (e.n + trame.n > taille) {
+            return 0;
+        }
+        trame = { tampon + e.n, trame.n, 0, false };
+        ecrireTrame(trame, enregistrements, nb, epoch);
+        return e.n + trame.n;
+    }
+
+    e.cbor(CBOR_OCTETS, trame.n);
+    memmove(tampon + e.n, trame.tampon, trame.n);
+    return e.n + trame.n;
+}
@@ -0,0 +1,241 @@
+/**
+ * @file historique.cpp
+ * @brief Implémentation de l'historique RAM et des agrégats glissants.
+ *
+ * Chaque fenêtre de largeur W est découpée en HISTORIQUE_NB_TRANCHES tranches de largeur
+ * W / HISTORIQUE_NB_TRANCHES. Une tranche résume ses échantillons (nombre, somme, somme des
+ * carrés, min, max). La fenêtre couvre la tranche courante et les tranches précédentes :
+ * - la somme et la somme des carrés de la fenêtre sont mises à jour à chaque ajout ;
+ * - le min et le max sont donnés par deux files monotones de tranches (O(1) amorti) ;
+ * - quand une tranche sort de la fenêtre, elle est retirée et les totaux sont recalculés
+ *   à partir des tranches restantes (HISTORIQUE_NB_TRANCHES additions) pour éviter toute dérive.
+ *
+ * Les sommes sont calculées relativement à une valeur de référence (premier échantillon du
+ * canal) pour limiter la perte de précision du calcul de variance.
+ */
+
+#include "historique.h"
+#include <freertos/FreeRTOS.h>
+
+// Largeur de chaque fenêtre en ms
+static const uint32_t LARGEUR_FENETRE_MS[NB_FENETRES] = { 60UL * 1000, 15UL * 60 * 1000, 60UL * 60 * 1000 };
+
+// Résumé des échantillons d'une tranche
+struct Tranche {
+  uint16_t nombre;
+  float somme;          // Somme des (valeur - référence)
+  float sommeCarres;    // Somme des (valeur - référence)²
+  float min;
+  float max;
+};
+
+// File monotone de numéros de tranches (tampon circulaire de HISTORIQUE_NB_TRANCHES éléments)
+struct FileMonotone {
+  uint32_t tranches[HISTORIQUE_NB_TRANCHES];
+  uint8_t debut;
+  uint8_t taille;
+};
+
+// Fenêtre glissante d'un canal
+struct Fenetre {
+  Tranche tranches[HISTORIQUE_NB_TRANCHES];
+  FileMonotone fileMin;     // Tranches de min croissant
+  FileMonotone fileMax;     // Tranches de max décroissant
+  uint32_t numeroCourant;   // Numéro (croissant) de la tranche courante
+  uint32_t debutCourant;    // Horodatage de début de la tranche courante
+  uint32_t nombre;
+  double somme;
+  double sommeCarres;
+};
+
+// Historique complet d'un canal
+struct HistoriqueCanal {
+  EchantillonHistorique tampon[HISTORIQUE_PROFONDEUR];
+  uint32_t total;           // Nombre total d'échantillons ajoutés (index absolu du prochain)
+  float reference;          // Valeur de référence des sommes
+  Fenetre fenetres[NB_FENETRES];
+};
+
+static HistoriqueCanal historiques[NB_CANAUX];
+
+// Protège l'historique : écritures depuis les tâches capteurs, lectures depuis les autres tâches
+static portMUX_TYPE verrouHistorique = portMUX_INITIALIZER_UNLOCKED;
+
+static inline Tranche &trancheNumero(Fenetre &f, uint32_t numero)
+{
+    return f.tranches[numero % HISTORIQUE_NB_TRANCHES];
+}
+
+static inline uint32_t &dernierDeFile(FileMonotone &file)
+{
+    return file.tranches[(file.debut + file.taille - 1) % HISTORIQUE_NB_TRANCHES];
+}
+
+static inline void empilerFile(FileMonotone &file, uint32_t numero)
+{
+    file.tranches[(file.debut + file.taille) % HISTORIQUE_NB_TRANCHES] = numero;
+    file.taille++;
+}
+
+/**
+ * @brief Retire des files monotones les tranches sorties de la fenêtre.
+ */
+static void purgerFiles(Fenetre &f, uint32_t plusAncienne)
+{
+    while (f.fileMin.taille && (int32_t)(f.fileMin.tranches[f.fileMin.debut] - plusAncienne) < 0) {
+        f.fileMin.debut = (f.fileMin.debut + 1) % HISTORIQUE_NB_TRANCHES;
+        f.fileMin.taille--;
+    }
+    while (f.fileMax.taille && (int32_t)(f.fileMax.tranches[f.fileMax.debut] - plusAncienne) < 0) {
+        f.fileMax.debut = (f.fileMax.debut + 1) % HISTORIQUE_NB_TRANCHES;
+        f.fileMax.taille--;
+    }
+}
+
+/**
+ * @brief Recalcule les totaux de la fenêtre à partir de ses tranches.
+ */
+static void recalculerTotaux(Fenetre &f)
+{
+    f.nombre = 0;
+    f.somme = 0;
+    f.sommeCarres = 0;
+    for (size_t i = 0; i < HISTORIQUE_NB_TRANCHES; i++) {
+        f.nombre += f.tranches[i].nombre;
+        f.somme += f.tranches[i].somme;
+        f.sommeCarres += f.tranches[i].sommeCarres;
+    }
+}
+
+/**
+ * @brief Fait glisser la fenêtre jusqu'à l'instant donné.
+ *
+ * Les tranches qui sortent de la fenêtre sont vidées. Le calcul se fait sur des différences
+ * d'horodatages et reste donc correct au débordement de millis().
+ */
+static void avancerFenetre(Fenetre &f, uint32_t largeurTranche, uint32_t maintenant)
+{
+    const uint32_t ecart = maintenant - f.debutCourant;
+    if ((int32_t)ecart < 0 || ecart < largeurTranche) {
+        return;
+    }
+
+    uint32_t pas = ecart / largeurTranche;
+    f.debutCourant += pas * largeurTranche;
+    if (pas > HISTORIQUE_NB_TRANCHES) {
+        pas = HISTORIQUE_NB_TRANCHES;
+    }
+    f.numeroCourant += pas;
+    for (uint32_t i = 0; i < pas; i++) {
+        trancheNumero(f, f.numeroCourant - i) = Tranche{};
+    }
+
+    purgerFiles(f, f.numeroCourant - (HISTORIQUE_NB_TRANCHES - 1));
+    recalculerTotaux(f);
+}
+
+/**
+ * @brief Ajoute un écart à la référence dans la tranche courante de la fenêtre.
+ */
+static void ajouterFenetre(Fenetre &f, float ecart)
+{
+    Tranche &t = trancheNumero(f, f.numeroCourant);
+    if (t.nombre == 0) {
+        t.min = ecart;
+        t.max = ecart;
+    } else {
+        if (ecart < t.min) t.min = ecart;
+        if (ecart > t.max) t.max = ecart;
+    }
+    t.nombre++;
+    t.somme += ecart;
+    t.sommeCarres += ecart * ecart;
+
+    f.nombre++;
+    f.somme += ecart;
+    f.sommeCarres += (double)ecart * ecart;
+
+    // La tranche courante est (ré)insérée en queue des files monotones
+    while (f.fileMin.taille && trancheNumero(f, dernierDeFile(f.fileMin)).min >= t.min) {
+        f.fileMin.taille--;
+    }
+    empilerFile(f.fileMin, f.numeroCourant);
+    while (f.fileMax.taille && trancheNumero(f, dernierDeFile(f.fileMax)).max <= t.max) {
+        f.fileMax.taille--;
+    }
+    empilerFile(f.fileMax, f.numeroCourant);
+}
+
+void ajouterHistorique(CanalMesure canal, uint32_t horodatage, float valeur)
+{
+    HistoriqueCanal &h = historiques[canal];
+
+    portENTER_CRITICAL(&verrouHistorique);
+    if (h.total == 0) {
+        h.reference = valeur;
+        for (size_t i = 0; i < NB_FENETRES; i++) {
+            h.fenetres[i].debutCourant = horodatage;
+        }
+    }
+
+    h.tampon[h.total % HISTORIQUE_PROFONDEUR] = { horodatage, valeur };
+    h.total++;
+
+    const float ecart = valeur - h.reference;
+    for (size_t i = 0; i < NB_FENETRES; i++) {
+        avancerFenetre(h.fenetres[i], LARGEUR_FENETRE_MS[i] / HISTORIQUE_NB_TRANCHES, horodatage);
+        ajouterFenetre(h.fenetres[i], ecart);
+    }
+    portEXIT_CRITICAL(&verrouHistorique);
+}
+
+bool lireAgregat(CanalMesure canal, FenetreHistorique fenetre, AgregatFenetre &agregat)
+{
+    HistoriqueCanal &h = historiques[canal];
+    Fenetre &f = h.fenetres[fenetre];
+
+    portENTER_CRITICAL(&verrouHistorique);
+    if (h.total != 0) {
+        // Les tranches trop anciennes sortent de la fenêtre même sans nouvel échantillon
+        avancerFenetre(f, LARGEUR_FENETRE_MS[fenetre] / HISTORIQUE_NB_TRANCHES, millis());
+    }
+    agregat.nombre = f.nombre;
+    if (f.nombre != 0) {
+        const double moyenneEcart = f.somme / f.nombre;
+        const double variance = f.sommeCarres / f.nombre - moyenneEcart * moyenneEcart;
+        agregat.moyenne = h.reference + (float)moyenneEcart;
+        agregat.variance = variance > 0 ? (float)variance : 0.0f;
+        agregat.min = h.reference + trancheNumero(f, f.fileMin.tranches[f.fileMin.debut]).min;
+        agregat.max = h.reference + trancheNumero(f, f.fileMax.tranches[f.fileMax.debut]).max;
+    }
+    portEXIT_CRITICAL(&verrouHistorique);
+
+    return agregat.nombre != 0;
+}
+
+uint32_t indexHistorique(CanalMesure canal)
+{
+    portENTER_CRITICAL(&verrouHistorique);
+    const uint32_t total = historiques[canal].total;
+    portEXIT_CRITICAL(&verrouHistorique);
+    return total;
+}
+
+size_t copierHistorique(CanalMesure canal, uint32_t depuis, EchantillonHistorique *destination,
+                        size_t max, uint32_t &suivant)
+{
+    HistoriqueCanal &h = historiques[canal];
+    size_t copies = 0;
+
+    portENTER_CRITICAL(&verrouHistorique);
+    const uint32_t plusAncien = h.total > HISTORIQUE_PROFONDEUR ? h.total - HISTORIQUE_PROFONDEUR : 0;
+    uint32_t index = depuis < plusAncien ? plusAncien : depuis;
+    while (index < h.total && copies < max) {
+        destination[copies++] = h.tampon[index % HISTORIQUE_PROFONDEUR];
+        index++;
+    }
+    portEXIT_CRITICAL(&verrouHistorique);
+
+    suivant = index;
+    return copies;
+}
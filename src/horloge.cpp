@@ -0,0 +1,123 @@
+/**
+ * @file horloge.cpp
+ * @brief Implémentation du service d'heure (compteur monotone + décalage SNTP).
+ */
+
+#include "horloge.h"
+#include <esp_timer.h>
+#include <esp_sntp.h>
+#include <sys/time.h>
+
+// En dessous de cette date (01/01/2024), l'horloge n'est pas encore synchronisée par NTP
+static const time_t EPOCH_SYNCHRONISEE = 1704067200;
+
+// Décalage entre l'heure epoch et le compteur monotone, en ms (valable si synchronisee)
+static int64_t decalage_ms = 0;
+static bool synchronisee = false;
+static portMUX_TYPE verrouHorloge = portMUX_INITIALIZER_UNLOCKED;
+
+/**
+ * @brief Cale le décalage sur une heure epoch lue au même instant que le compteur monotone.
+ */
+static void caler(const struct timeval &tv)
+{
+    const int64_t epoch_ms = (int64_t)tv.tv_sec * 1000 + tv.tv_usec / 1000;
+    const int64_t monotone_ms = esp_timer_get_time() / 1000;
+    portENTER_CRITICAL(&verrouHorloge);
+    decalage_ms = epoch_ms - monotone_ms;
+    synchronisee = true;
+    portEXIT_CRITICAL(&verrouHorloge);
+}
+
+/**
+ * @brief Rappel SNTP, appelé après chaque réglage de l'heure système.
+ */
+static void surSynchronisation(struct timeval *tv)
+{
+    caler(*tv);
+}
+
+/**
+ * @brief Lit le décalage courant.
+ *
+ * Si le rappel SNTP n'a pas encore été reçu mais que l'heure système est déjà réglée (réglage
+ * avant initHorloge, settimeofday...), le décalage est calé à cette occasion.
+ *
+ * @return false si l'heure n'est pas synchronisée.
+ */
+static bool lireDecalage(int64_t &decalage)
+{
+    portENTER_CRITICAL(&verrouHorloge);
+    const bool s = synchronisee;
+    decalage = decalage_ms;
+    portEXIT_CRITICAL(&verrouHorloge);
+    if (s) {
+        return true;
+    }
+
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    if (tv.tv_sec < EPOCH_SYNCHRONISEE) {
+        return false;
+    }
+    caler(tv);
+    return lireDecalage(decalage);
+}
+
+void initHorloge()
+{
+    sntp_set_time_sync_notification_cb(surSynchronisation);
+}
+
+Horodatage lireHorodatage()
+{
+    Horodatage h = { esp_timer_get_time() / 1000, false };
+    convertirEpoch(h);
+    return h;
+}
+
+bool horlogeSynchronisee()
+{
+    int64_t decalage;
+    return lireDecalage(decalage);
+}
+
+bool convertirEpoch(Horodatage &horodatage)
+{
+    int64_t decalage;
+    if (horodatage.epoch) {
+        return true;
+    }
+    if (!lireDecalage(decalage)) {
+        return false;
+    }
+    horodatage.ms += decalage;
+    horodatage.epoch = true;
+    return true;
+}
+
+size_t formaterHorodatage(const Horodatage &horodatage, const char *format, char *tampon, size_t taille)
+{
+    if (taille == 0) {
+        return 0;
+    }
+    tampon[0] = '\0';
+    if (!horodatage.epoch) {
+        return 0;
+    }
+    const time_t secondes = horodatage.ms / 1000;
+    struct tm date;
+    localtime_r(&secondes, &date);
+    return strftime(tampon, taille, format, &date);
+}
+
+const char *VueHorloge::texte()
+{
+    const Horodatage h = lireHorodatage();
+    const int64_t m = h.epoch ? h.ms / 60000 : -1;
+    if (m != minute) {
+        minute = m;
+        formaterHorodatage(h, format, tampon, sizeof(tampon));
+    }
+    return tampon;
+}
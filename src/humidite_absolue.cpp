@@ -0,0 +1,72 @@
+/**
+ * @file humidite_absolue.cpp
+ * @brief Table de Magnus en virgule fixe et interpolation de l'humidité absolue.
+ *
+ * ρsat(T) = 6.112 * exp(17.62 * T / (243.12 + T)) * 216.7 / (273.15 + T)   [g/m³]
+ * La table contient ρsat × 65536 (Q16) tous les 0,5 °C ; l'interpolation quadratique entre
+ * trois points (différences de Newton) s'écarte de la formule de moins de 0,02 LSB de la
+ * sortie 8.8 : le résultat arrondi reste à 0,52 LSB au plus de la valeur flottante
+ * (test/test_humidite_absolue).
+ */
+
+#include "humidite_absolue.h"
+
+// Pas de la table en dixièmes de °C
+static const int16_t PAS_DIXIEMES = 5;
+
+// Densité de vapeur saturante en g/m³ × 65536, de -40 °C à 85 °C par pas de 0,5 °C
+static const uint32_t DENSITE_SATURANTE_Q16[] = {
+    11586, 12176, 12792, 13437, 14110, 14814, 15549, 16316, 17118, 17954,  // -40,0..-35,5 °C
+    18827, 19737, 20687, 21678, 22711, 23787, 24909, 26078, 27296, 28565,  // -35,0..-30,5 °C
+    29886, 31262, 32693, 34183, 35733, 37346, 39023, 40767, 42580, 44465,  // -30,0..-25,5 °C
+    46423, 48459, 50573, 52769, 55049, 57416, 59874, 62425, 65072, 67818,  // -25,0..-20,5 °C
+    70666, 73620, 76684, 79860, 83152, 86564, 90099, 93762, 97556, 101485,  // -20,0..-15,5 °C
+    105554, 109767, 114128, 118641, 123312, 128144, 133143, 138313, 143660, 149189,  // -15,0..-10,5 °C
+    154905, 160813, 166918, 173228, 179747, 186481, 193436, 200619, 208035, 215692,  // -10,0..-5,5 °C
+    223596, 231753, 240171, 248857, 257817, 267060, 276592, 286422, 296557, 307006,  // -5,0..-0,5 °C
+    317776, 328876, 340314, 352100, 364242, 376748, 389630, 402895, 416553, 430615,  // 0,0..4,5 °C
+    445090, 459989, 475322, 491099, 507332, 524031, 541208, 558875, 577042, 595722,  // 5,0..9,5 °C
+    614927, 634669, 654961, 675816, 697246, 719266, 741888, 765126, 788994, 813507,  // 10,0..14,5 °C
+    838680, 864526, 891060, 918299, 946258, 974952, 1004397, 1034611, 1065609, 1097408,  // 15,0..19,5 °C
+    1130026, 1163480, 1197788, 1232968, 1269038, 1306017, 1343923, 1382777, 1422597, 1463403,  // 20,0..24,5 °C
+    1505216, 1548056, 1591944, 1636901, 1682948, 1730108, 1778401, 1827851, 1878481, 1930312,  // 25,0..29,5 °C
+    1983370, 2037678, 2093259, 2150139, 2208342, 2267893, 2328818, 2391142, 2454893, 2520097,  // 30,0..34,5 °C
+    2586780, 2654970, 2724695, 2795984, 2868863, 2943364, 3019514, 3097344, 3176883, 3258162,  // 35,0..39,5 °C
+    3341213, 3426065, 3512752, 3601305, 3691756, 3784139, 3878488, 3974835, 4073214, 4173662,  // 40,0..44,5 °C
+    4276212, 4380901, 4487764, 4596837, 4708158, 4821763, 4937691, 5055979, 5176666, 5299792,  // 45,0..49,5 °C
+    5425395, 5553516, 5684195, 5817473, 5953392, 6091993, 6233318, 6377411, 6524315, 6674074,  // 50,0..54,5 °C
+    6826731, 6982331, 7140921, 7302544, 7467249, 7635080, 7806087, 7980315, 8157814, 8338632,  // 55,0..59,5 °C
+    8522818, 8710423, 8901496, 9096088, 9294250, 9496034, 9701493, 9910679, 10123646, 10340447,  // 60,0..64,5 °C
+    10561138, 10785772, 11014405, 11247094, 11483894, 11724864, 11970060, 12219541, 12473366, 12731593,  // 65,0..69,5 °C
+    12994283, 13261496, 13533293, 13809735, 14090884, 14376804, 14667556, 14963205, 15263815, 15569451,  // 70,0..74,5 °C
+    15880178, 16196062, 16517170, 16843569, 17175326, 17512510, 17855189, 18203433, 18557312, 18916896,  // 75,0..79,5 °C
+    19282257, 19653466, 20030595, 20413718, 20802907, 21198237, 21599782, 22007617, 22421819, 22842464,  // 80,0..84,5 °C
+    23269628,  // 85,0 °C
+};
+
+static const int16_t NB_POINTS = sizeof(DENSITE_SATURANTE_Q16) / sizeof(DENSITE_SATURANTE_Q16[0]);
+
+uint16_t humiditeAbsolue8_8(int16_t temperature_dixiemes, int16_t humidite_dixiemes)
+{
+    if (temperature_dixiemes < HUMIDITE_TEMP_MIN_DIXIEMES) temperature_dixiemes = HUMIDITE_TEMP_MIN_DIXIEMES;
+    if (temperature_dixiemes > HUMIDITE_TEMP_MAX_DIXIEMES) temperature_dixiemes = HUMIDITE_TEMP_MAX_DIXIEMES;
+    if (humidite_dixiemes < 0) humidite_dixiemes = 0;
+    if (humidite_dixiemes > 1000) humidite_dixiemes = 1000;
+
+    // Premier des trois points encadrants et écart au premier point en dixièmes (0 à 2 pas)
+    const int16_t decalage = temperature_dixiemes - HUMIDITE_TEMP_MIN_DIXIEMES;
+    int16_t indice = decalage / PAS_DIXIEMES;
+    if (indice > NB_POINTS - 3) indice = NB_POINTS - 3;
+    const int64_t f = decalage - indice * PAS_DIXIEMES;
+
+    // Newton : ρ = y0 + (f/pas)·Δ1 + (f/pas)·(f/pas - 1)/2·Δ2, ici multiplié par 2·pas²
+    const int64_t y0 = DENSITE_SATURANTE_Q16[indice];
+    const int64_t delta1 = (int64_t)DENSITE_SATURANTE_Q16[indice + 1] - y0;
+    const int64_t delta2 = (int64_t)DENSITE_SATURANTE_Q16[indice + 2] - 2 * (int64_t)DENSITE_SATURANTE_Q16[indice + 1] + y0;
+    const int64_t densite = 2 * PAS_DIXIEMES * PAS_DIXIEMES * y0 + 2 * PAS_DIXIEMES * f * delta1 + f * (f - PAS_DIXIEMES) * delta2;
+
+    // × HR(‰), puis ÷ 2·pas², Q16 → Q8 (÷256) et ‰ → fraction (÷1000), arrondi au plus proche
+    const int64_t diviseur = 2 * PAS_DIXIEMES * PAS_DIXIEMES * 256 * 1000;
+    const int64_t resultat = (densite * humidite_dixiemes + diviseur / 2) / diviseur;
+    return resultat > 0xFFFF ? 0xFFFF : (uint16_t)resultat;
+}
@@ -0,0 +1,511 @@
+/**
+ * @file journal.cpp
+ * @brief Implémentation du journal flash des échantillons (segments SPIFFS, curseur en NVS).
+ */
+
+#include "journal.h"
+#include <FS.h>
+#include <SPIFFS.h>
+#include <Preferences.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
+
+// En-tête d'un segment (16 octets), écrit et vidé en flash avant le premier enregistrement
+struct EnteteSegment {
+  uint32_t magique;
+  uint32_t sequence;       // Numéro croissant du segment
+  uint32_t premier;        // Index absolu du premier enregistrement du segment
+  uint16_t tailleEnregistrement;
+  uint16_t crc;            // CRC-16 CCITT des 14 octets précédents
+};
+
+// Segment présent en flash
+struct Segment {
+  uint32_t sequence;
+  uint32_t premier;
+  uint32_t nombre;         // Enregistrements complets dans le fichier
+};
+
+// Échantillon en attente d'écriture, posté par l'abonné aux mesures
+struct EchantillonEnAttente {
+  Horodatage horodatage;   // Instant de capture
+  float valeur;
+  CanalMesure canal;
+  NatureValeur nature;
+};
+
+static const uint32_t MAGIQUE_SEGMENT = 0x314C4E4A;   // "JNL1"
+static const char PREFIXE_SEGMENT[] = "jnl";
+
+static QueueHandle_t fileJournal = NULL;
+
+// Segments du plus ancien au plus récent (anneau), le dernier est le segment d'écriture
+static Segment segments[JOURNAL_NB_SEGMENTS];
+static size_t premierSegment = 0;
+static size_t nbSegments = 0;
+
+static bool monte = false;             // SPIFFS monté et segments inventoriés
+static bool ouvert = false;            // Un segment est ouvert en écriture
+static File ecriture;                  // Segment courant, ouvert en ajout
+static File lecture;                   // Dernier segment lu, gardé ouvert pour les lectures séquentielles
+static uint32_t sequenceLecture = 0;
+
+static uint32_t curseur = 0;
+static uint32_t curseurPersiste = 0;
+static uint32_t derniereSauvegarde_ms = 0;
+static Preferences prefsJournal;
+
+static StatsJournal stats = {};
+
+/**
+ * @brief CRC-16 CCITT (polynôme 0x1021, valeur initiale 0xFFFF).
+ */
+static uint16_t crc16(const uint8_t *donnees, size_t longueur)
+{
+    uint16_t crc = 0xFFFF;
+    for (size_t i = 0; i < longueur; i++) {
+        crc ^= (uint16_t)donnees[i] << 8;
+        for (uint8_t b = 0; b < 8; b++) {
+            crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : crc << 1;
+        }
+    }
+    return crc;
+}
+
+static bool enregistrementValide(const EnregistrementJournal &e)
+{
+    return e.canal < NB_CANAUX && e.crc == crc16((const uint8_t *)&e, offsetof(EnregistrementJournal, crc));
+}
+
+static void cheminSegment(char *chemin, size_t taille, uint32_t sequence)
+{
+    snprintf(chemin, taille, "/%s%08lx.bin", PREFIXE_SEGMENT, (unsigned long)sequence);
+}
+
+static Segment &segment(size_t i)
+{
+    return segments[(premierSegment + i) % JOURNAL_NB_SEGMENTS];
+}
+
+static uint32_t finSegment(const Segment &s)
+{
+    return s.premier + s.nombre;
+}
+
+void ajouterJournal(CanalMesure canal, float valeur, const Horodatage &capture, NatureValeur nature)
+{
+    const EchantillonEnAttente echantillon = { capture, valeur, canal, nature };
+    if (fileJournal == NULL || xQueueSend(fileJournal, &echantillon, 0) != pdTRUE) {
+        stats.perdus++;
+    }
+}
+
+void initJournal()
+{
+    fileJournal = xQueueCreate(JOURNAL_FILE_PROFONDEUR, sizeof(EchantillonEnAttente));
+}
+
+/**
+ * @brief Supprime le plus ancien segment ; les enregistrements non acquittés sont comptés comme évincés.
+ */
+static void evincerSegment()
+{
+    const Segment &ancien = segment(0);
+    if ((int32_t)(finSegment(ancien) - curseur) > 0) {
+        stats.evinces += finSegment(ancien) - max(curseur, ancien.premier);
+        curseur = finSegment(ancien);
+    }
+    if (lecture && sequenceLecture == ancien.sequence) {
+        lecture.close();
+    }
+
+    char chemin[24];
+    cheminSegment(chemin, sizeof(chemin), ancien.sequence);
+    SPIFFS.remove(chemin);
+    premierSegment = (premierSegment + 1) % JOURNAL_NB_SEGMENTS;
+    nbSegments--;
+}
+
+/**
+ * @brief Clôt le segment courant et en ouvre un nouveau, après éviction du plus ancien si besoin.
+ */
+static bool nouveauSegment()
+{
+    uint32_t sequence = 1;
+    uint32_t premier = 0;
+    if (nbSegments > 0) {
+        sequence = segment(nbSegments - 1).sequence + 1;
+        premier = finSegment(segment(nbSegments - 1));
+    }
+    if (ecriture) {
+        ecriture.close();
+    }
+    if (nbSegments == JOURNAL_NB_SEGMENTS) {
+        evincerSegment();
+    }
+
+    char chemin[24];
+    cheminSegment(chemin, sizeof(chemin), sequence);
+    ecriture = SPIFFS.open(chemin, FILE_WRITE);
+    if (!ecriture) {
+        return false;
+    }
+
+    EnteteSegment entete = { MAGIQUE_SEGMENT, sequence, premier, sizeof(EnregistrementJournal), 0 };
+    entete.crc = crc16((const uint8_t *)&entete, offsetof(EnteteSegment, crc));
+    if (ecriture.write((const uint8_t *)&entete, sizeof(entete)) != sizeof(entete)) {
+        ecriture.close();
+        SPIFFS.remove(chemin);
+        return false;
+    }
+    ecriture.flush();
+
+    segment(nbSegments++) = { sequence, premier, 0 };
+    return true;
+}
+
+/**
+ * @brief Après une erreur d'écriture (flash pleine), évince le plus ancien segment puis ouvre un nouveau segment.
+ *
+ * Le segment courant est clos tel quel (l'enregistrement partiel éventuel est ignoré) et n'est
+ * jamais évincé. L'éviction n'est tentée qu'une fois par vidage (`evince`).
+ */
+static bool rouvrirApresErreur(bool &evince)
+{
+    if (ecriture) {
+        ecriture.close();
+    }
+    if (!evince && nbSegments > 1) {
+        evincerSegment();
+        evince = true;
+    }
+    return nouveauSegment();
+}
+
+/**
+ * @brief Lit l'en-tête d'un fichier de segment et compte ses enregistrements complets.
+ *
+ * @return false si le fichier n'est pas un segment valide (en-tête tronqué ou corrompu).
+ */
+static bool lireEnteteSegment(File &fichier, Segment &s)
+{
+    EnteteSegment entete;
+    if (fichier.read((uint8_t *)&entete, sizeof(entete)) != sizeof(entete) ||
+        entete.magique != MAGIQUE_SEGMENT ||
+        entete.tailleEnregistrement != sizeof(EnregistrementJournal) ||
+        entete.crc != crc16((const uint8_t *)&entete, offsetof(EnteteSegment, crc))) {
+        return false;
+    }
+    s.sequence = entete.sequence;
+    s.premier = entete.premier;
+    s.nombre = (fichier.size() - sizeof(EnteteSegment)) / sizeof(EnregistrementJournal);
+    return true;
+}
+
+/**
+ * @brief Reprend l'écriture dans le dernier segment si sa fin est intacte.
+ *
+ * Seul le dernier enregistrement est relu : une écriture interrompue laisse un enregistrement
+ * partiel (taille du fichier) ou un CRC invalide. Dans ce cas le segment est clos tel quel
+ * (les enregistrements partiels sont ignorés) et un nouveau segment est ouvert.
+ */
+static bool reprendreDernierSegment()
+{
+    if (nbSegments == 0) {
+        return false;
+    }
+    Segment &dernier = segment(nbSegments - 1);
+    if (dernier.nombre >= JOURNAL_ENREGISTREMENTS_PAR_SEGMENT) {
+        return false;
+    }
+
+    char chemin[24];
+    cheminSegment(chemin, sizeof(chemin), dernier.sequence);
+    File fichier = SPIFFS.open(chemin, FILE_READ);
+    const size_t tailleAttendue = sizeof(EnteteSegment) + dernier.nombre * sizeof(EnregistrementJournal);
+    bool intact = fichier && fichier.size() == tailleAttendue;
+    if (intact && dernier.nombre > 0) {
+        EnregistrementJournal e;
+        intact = fichier.seek(tailleAttendue - sizeof(e)) &&
+                 fichier.read((uint8_t *)&e, sizeof(e)) == sizeof(e) && enregistrementValide(e);
+    }
+    fichier.close();
+    if (!intact) {
+        return false;
+    }
+
+    ecriture = SPIFFS.open(chemin, FILE_APPEND);
+    return (bool)ecriture;
+}
+
+bool ouvrirJournal()
+{
+    // SPIFFS est normalement déjà monté par la tâche WiFi ; begin() ne remonte pas un système monté
+    if (!SPIFFS.begin(true)) {
+        Serial.println("[JOURNAL] SPIFFS inaccessible, echantillons non conserves");
+        return false;
+    }
+
+    // Inventaire des segments : un seul en-tête de 16 octets lu par fichier
+    Segment trouves[JOURNAL_NB_SEGMENTS];
+    size_t nbTrouves = 0;
+    File racine = SPIFFS.open("/");
+    for (File fichier = racine.openNextFile(); fichier; fichier = racine.openNextFile()) {
+        const char *nom = fichier.name();
+        if (nom[0] == '/') nom++;
+        if (strncmp(nom, PREFIXE_SEGMENT, sizeof(PREFIXE_SEGMENT) - 1) != 0) {
+            continue;
+        }
+
+        char chemin[24];
+        snprintf(chemin, sizeof(chemin), "/%s", nom);
+        Segment s;
+        const bool valide = lireEnteteSegment(fichier, s);
+        fichier.close();
+        if (!valide) {
+            SPIFFS.remove(chemin);
+            continue;
+        }
+
+        // Tri par séquence ; au-delà de JOURNAL_NB_SEGMENTS, le plus ancien est supprimé
+        size_t i = nbTrouves;
+        if (nbTrouves == JOURNAL_NB_SEGMENTS) {
+            if (s.sequence < trouves[0].sequence) {
+                SPIFFS.remove(chemin);
+                continue;
+            }
+            char ancien[24];
+            cheminSegment(ancien, sizeof(ancien), trouves[0].sequence);
+            SPIFFS.remove(ancien);
+            memmove(&trouves[0], &trouves[1], (--nbTrouves) * sizeof(Segment));
+            i = nbTrouves;
+        }
+        while (i > 0 && trouves[i - 1].sequence > s.sequence) {
+            trouves[i] = trouves[i - 1];
+            i--;
+        }
+        trouves[i] = s;
+        nbTrouves++;
+    }
+    racine.close();
+
+    // Un segment clos après une erreur d'écriture peut contenir des octets au-delà de son dernier
+    // enregistrement complet : il s'arrête au premier index du segment suivant
+    for (size_t k = 0; k + 1 < nbTrouves; k++) {
+        const uint32_t nombreMax = trouves[k + 1].premier - trouves[k].premier;
+        if (trouves[k].nombre > nombreMax) {
+            trouves[k].nombre = nombreMax;
+        }
+    }
+
+    premierSegment = 0;
+    nbSegments = nbTrouves;
+    memcpy(segments, trouves, nbTrouves * sizeof(Segment));
+
+    prefsJournal.begin("journal", true);
+    curseur = prefsJournal.getUInt("curseur", 0);
+    prefsJournal.end();
+
+    // Curseur hors du journal (segments évincés ou flash effacée) : ramené dans les bornes
+    if (nbSegments == 0) {
+        curseur = 0;
+    } else if ((int32_t)(curseur - segment(0).premier) < 0) {
+        curseur = segment(0).premier;
+    } else if ((int32_t)(curseur - finJournal()) > 0) {
+        curseur = finJournal();
+    }
+    curseurPersiste = curseur;
+    monte = true;
+
+    if (!reprendreDernierSegment() && !nouveauSegment()) {
+        Serial.println("[JOURNAL] Creation de segment impossible");
+        return false;
+    }
+    ouvert = true;
+    stats.segments = nbSegments;
+
+    Serial.printf("[JOURNAL] %u segments, %u echantillons en attente\n",
+                  (unsigned)nbSegments, (unsigned)(finJournal() - curseur));
+    return true;
+}
+
+size_t viderFileJournal()
+{
+    if (fileJournal == NULL) {
+        return 0;
+    }
+
+    // Après une erreur d'écriture (flash pleine...), un nouveau segment est retenté à chaque vidage
+    // qui a des échantillons à écrire, au prix d'au plus un segment évincé
+    bool evince = false;
+    if (!ouvert && monte && uxQueueMessagesWaiting(fileJournal) > 0) {
+        ouvert = rouvrirApresErreur(evince);
+    }
+
+    EchantillonEnAttente echantillon;
+    if (!ouvert) {
+        while (xQueueReceive(fileJournal, &echantillon, 0) == pdTRUE) {
+            stats.perdus++;
+        }
+        return 0;
+    }
+
+    EnregistrementJournal tampon[32];
+    size_t ecrits = 0;
+    size_t n;
+    do {
+        if (segment(nbSegments - 1).nombre >= JOURNAL_ENREGISTREMENTS_PAR_SEGMENT &&
+            !nouveauSegment() && !rouvrirApresErreur(evince)) {
+            ouvert = false;
+            break;
+        }
+
+        // Lot limité à la place restante du segment courant
+        const size_t place = JOURNAL_ENREGISTREMENTS_PAR_SEGMENT - segment(nbSegments - 1).nombre;
+        const size_t maxLot = place < 32 ? place : 32;
+        n = 0;
+        while (n < maxLot && xQueueReceive(fileJournal, &echantillon, 0) == pdTRUE) {
+            // Capture antérieure à la synchronisation NTP : convertie en epoch si l'heure est connue depuis
+            const bool epoch = convertirEpoch(echantillon.horodatage);
+            EnregistrementJournal &e = tampon[n++];
+            e.horodatage_ms = echantillon.horodatage.ms;
+            e.valeur = echantillon.valeur;
+            e.canal = echantillon.canal;
+            e.drapeaux = (epoch ? JOURNAL_HORODATAGE_EPOCH : 0) | echantillon.nature << 1;
+            e.crc = crc16((const uint8_t *)&e, offsetof(EnregistrementJournal, crc));
+        }
+        if (n == 0) {
+            break;
+        }
+
+        const size_t octets = n * sizeof(EnregistrementJournal);
+        bool ecrit = ecriture.write((const uint8_t *)tampon, octets) == octets;
+        if (!ecrit && !evince) {
+            // Flash pleine ou erreur : le segment est clos tel quel, le plus ancien est évincé pour
+            // faire de la place et le lot est réécrit une fois dans un nouveau segment
+            ecrit = rouvrirApresErreur(evince) && ecriture.write((const uint8_t *)tampon, octets) == octets;
+        }
+        if (!ecrit) {
+            // Nouvel essai au prochain vidage, avec l'éviction d'un autre segment
+            stats.perdus += n;
+            if (ecriture) {
+                ecriture.close();
+            }
+            ouvert = false;
+            break;
+        }
+        segment(nbSegments - 1).nombre += n;
+        ecrits += n;
+    } while (n == 32 || segment(nbSegments - 1).nombre >= JOURNAL_ENREGISTREMENTS_PAR_SEGMENT);
+
+    if (ecrits > 0 && ecriture) {
+        ecriture.flush();
+        stats.ecrits += ecrits;
+    }
+    stats.segments = nbSegments;
+    return ecrits;
+}
+
+/**
+ * @brief Segment qui ne peut pas être lu : la lecture reprendra après lui.
+ */
+static size_t segmentIllisible(const Segment &s, uint32_t &suivant)
+{
+    stats.illisibles++;
+    suivant = finSegment(s);
+    return JOURNAL_ILLISIBLE;
+}
+
+size_t lireJournal(uint32_t depuis, EnregistrementJournal *destination, size_t max, uint32_t &suivant)
+{
+    suivant = depuis;
+    // Les segments déjà écrits restent lisibles quand la flash est pleine (`ouvert` faux)
+    if (!monte) {
+        return 0;
+    }
+
+    // Premier segment qui contient encore des enregistrements à partir de `depuis`
+    size_t i = 0;
+    while (i < nbSegments && (int32_t)(finSegment(segment(i)) - depuis) <= 0) {
+        i++;
+    }
+    if (i == nbSegments) {
+        return 0;
+    }
+    const Segment &s = segment(i);
+    if ((int32_t)(depuis - s.premier) < 0) {
+        depuis = s.premier;
+    }
+    size_t disponibles = finSegment(s) - depuis;
+    if (disponibles > max) {
+        disponibles = max;
+    }
+
+    if (!lecture || sequenceLecture != s.sequence) {
+        if (lecture) {
+            lecture.close();
+        }
+        char chemin[24];
+        cheminSegment(chemin, sizeof(chemin), s.sequence);
+        lecture = SPIFFS.open(chemin, FILE_READ);
+        sequenceLecture = s.sequence;
+        if (!lecture) {
+            return segmentIllisible(s, suivant);
+        }
+    }
+
+    const size_t position = sizeof(EnteteSegment) + (depuis - s.premier) * sizeof(EnregistrementJournal);
+    const size_t octets = disponibles * sizeof(EnregistrementJournal);
+    if (!lecture.seek(position) || lecture.read((uint8_t *)destination, octets) != octets) {
+        lecture.close();
+        return segmentIllisible(s, suivant);
+    }
+
+    // Les enregistrements corrompus restent à leur place pour garder la correspondance avec les index
+    for (size_t k = 0; k < disponibles; k++) {
+        if (!enregistrementValide(destination[k])) {
+            destination[k].canal = JOURNAL_CANAL_CORROMPU;
+            stats.corrompus++;
+        }
+    }
+    suivant = depuis + disponibles;
+    return disponibles;
+}
+
+uint32_t finJournal()
+{
+    return nbSegments > 0 ? finSegment(segment(nbSegments - 1)) : 0;
+}
+
+uint32_t curseurJournal()
+{
+    return curseur;
+}
+
+void avancerCurseurJournal(uint32_t index)
+{
+    if ((int32_t)(index - curseur) <= 0) {
+        return;
+    }
+    curseur = index;
+    if (millis() - derniereSauvegarde_ms >= JOURNAL_PERSISTANCE_CURSEUR_MS) {
+        persisterCurseurJournal();
+    }
+}
+
+void persisterCurseurJournal()
+{
+    if (curseur == curseurPersiste) {
+        return;
+    }
+    prefsJournal.begin("journal", false);
+    prefsJournal.putUInt("curseur", curseur);
+    prefsJournal.end();
+    curseurPersiste = curseur;
+    derniereSauvegarde_ms = millis();
+}
+
+StatsJournal lireStatsJournal()
+{
+    return stats;
+}
@@ -5,7 +5,6 @@ Framework utilisé : Arduino
 Board : ESP32s2 Saola 
 */
 #include "variablesGlobales.h"
-#include <Wire.h>
 
 // Déclaration d'une handle pour la tâche de gestion de l'afficheur OLED
 TaskHandle_t tache_oledhandle = NULL;
@@ -17,8 +16,9 @@ void setup() {
   Serial.println("\n=== Demarrage ESP32-S2 ===");
   
   // Initialisation du bus I2C avec les broches GPIO8 (SDA) et GPIO9 (SCL)
-  // Doit être fait UNE SEULE FOIS avant toutes les tâches utilisant I2C (OLED, SGP30, etc.)
-  Wire.begin(8, 9);
+  // Seule la tâche du bus I2C accède ensuite à Wire ; l'OLED et le SGP30 lui passent leurs transactions
+  initBusI2c();
+  xTaskCreate(&tache_bus_i2c, "Bus I2C", 4096, NULL, 8, NULL); // Tâche propriétaire du bus I2C
   Serial.println("Bus I2C initialise sur GPIO8 (SDA) et GPIO9 (SCL)");
 
   xTaskCreate(&tache_oled, "affichage_OLED", 8192*2, NULL, 4, &tache_oledhandle); // Tâche  OLED SSD1306
@@ -30,6 +30,7 @@ void setup() {
   }
 // Délai pour laisser la tâche OLED tourner un moment avant de lancer les autres tâches : 5 secondes
   vTaskDelay(2000 / portTICK_PERIOD_MS);
+  initHorloge(); // Service d'heure, calé à chaque synchronisation SNTP
   xTaskCreate(&wifi, "WIFI", 8192*2, NULL, 1, NULL); // Thread connecion WIFI
 
   // Délai pour laisser la tâche WIFI tourner un moment avant de lancer les autres tâches : 5 secondes
@@ -41,13 +42,18 @@ void setup() {
 
   xTaskCreate(&task_ledrgb, "LEDRGB", 8192, NULL, 5, NULL); // Tâche LED RGB WS2812 interne 
  
-  xTaskCreate(&tache_tempHum,"TempHum DHT22", 8192, NULL, 6, NULL); // Thread température/humidité DHT22
+  // Journal flash, statistiques en flux, politique d'envoi et alarmes (abonnées aux mesures) avant le démarrage de l'acquisition
+  initJournal();
+  initStatistiques();
+  initPolitiqueEnvoi();
+  initAlarmes();
 
-  xTaskCreate(&tache_co2,"capteur CO2 SGP30", 8192, NULL, 7, NULL); // Thread CO2/TVOC SGP30
+  // Une seule tâche pour tous les capteurs (DHT22, SGP30, luminosité Grove) : voir registre_capteurs.h
+  xTaskCreate(&tache_acquisition,"Acquisition capteurs", 8192, NULL, 7, NULL); // Thread d'acquisition des capteurs
 
-  xTaskCreate(&tache_luminosite,"Luminosite Grove", 4096, NULL, 8, NULL); // Thread capteur de luminosité Grove
+  // Ajouter d'autres capteurs dans registre_capteurs.h.....
 
-  // Ajouter d'autres tâches pour d'autres capteurs.....
+  xTaskCreate(&tache_envoi, "Envoi MQTT", 8192, NULL, 2, NULL); // Journal flash et publication des mesures vers le serveur
 
   Serial.println("\n Démarrage");
 
@@ -0,0 +1,136 @@
+/**
+ * @file mesures.cpp
+ * @brief Implémentation du magasin de mesures protégé par un verrou de séquence.
+ *
+ * Principe du seqlock :
+ * - l'écrivain incrémente le compteur (il devient impair), modifie les entrées,
+ *   puis l'incrémente à nouveau (il redevient pair) ;
+ * - le lecteur copie les entrées entre deux lectures du compteur et recommence
+ *   si le compteur était impair ou a changé pendant la copie.
+ *
+ * Les écrivains (plusieurs tâches capteurs) sont sérialisés entre eux par une section
+ * critique très courte ; les lecteurs ne bloquent jamais et ne ralentissent pas les écrivains.
+ */
+
+#include "mesures.h"
+#include "historique.h"
+#include <atomic>
+#include <freertos/FreeRTOS.h>
+
+// Compteur du verrou de séquence (impair = écriture en cours)
+static std::atomic<uint32_t> compteurVerrou(0);
+
+// Numéro de la dernière publication
+static uint32_t derniereSequence = 0;
+
+// Entrées du magasin, toutes invalides au démarrage
+static EntreeMesure entrees[NB_CANAUX] = {};
+
+// Abonnés notifiés après chaque publication
+static AbonneMesures abonnes[MESURES_NB_ABONNES];
+static std::atomic<size_t> nbAbonnes(0);
+
+// Section critique qui sérialise les écrivains entre eux
+static portMUX_TYPE verrouEcrivains = portMUX_INITIALIZER_UNLOCKED;
+
+/**
+ * @brief Ouvre une écriture : prend la section critique et rend le compteur impair.
+ *
+ * @return Numéro de la publication en cours.
+ */
+static uint32_t debutEcriture()
+{
+    portENTER_CRITICAL(&verrouEcrivains);
+    compteurVerrou.store(compteurVerrou.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    return ++derniereSequence;
+}
+
+/**
+ * @brief Ferme une écriture : rend le compteur pair et libère la section critique.
+ */
+static void finEcriture()
+{
+    compteurVerrou.store(compteurVerrou.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    portEXIT_CRITICAL(&verrouEcrivains);
+}
+
+void publierMesure(CanalMesure canal, float valeur)
+{
+    publierMesures(&canal, &valeur, 1);
+}
+
+void publierMesures(const CanalMesure canaux[], const float valeurs[], size_t nb)
+{
+    const uint32_t maintenant = millis();
+    const Horodatage capture = lireHorodatage();
+
+    const uint32_t sequence = debutEcriture();
+    for (size_t i = 0; i < nb; i++) {
+        EntreeMesure &entree = entrees[canaux[i]];
+        entree.valeur = valeurs[i];
+        entree.valide = true;
+        entree.horodatage = capture;
+        entree.sequence = sequence;
+    }
+    finEcriture();
+
+    // Conservation dans l'historique (hors du verrou de séquence)
+    for (size_t i = 0; i < nb; i++) {
+        ajouterHistorique(canaux[i], maintenant, valeurs[i]);
+    }
+
+    // Notification des abonnés (événements de changement)
+    const size_t abonnesActifs = nbAbonnes.load(std::memory_order_acquire);
+    for (size_t i = 0; i < abonnesActifs; i++) {
+        abonnes[i](canaux, valeurs, nb, capture);
+    }
+}
+
+bool abonnerMesures(AbonneMesures abonne)
+{
+    portENTER_CRITICAL(&verrouEcrivains);
+    const size_t n = nbAbonnes.load(std::memory_order_relaxed);
+    const bool ajoute = n < MESURES_NB_ABONNES;
+    if (ajoute) {
+        abonnes[n] = abonne;
+        nbAbonnes.store(n + 1, std::memory_order_release);
+    }
+    portEXIT_CRITICAL(&verrouEcrivains);
+    return ajoute;
+}
+
+void invaliderMesure(CanalMesure canal)
+{
+    const uint32_t sequence = debutEcriture();
+    entrees[canal].valide = false;
+    entrees[canal].sequence = sequence;
+    finEcriture();
+}
+
+void lireInstantane(SensorSnapshot &instantane)
+{
+    uint32_t avant, apres;
+    do {
+        avant = compteurVerrou.load(std::memory_order_acquire);
+        for (size_t i = 0; i < NB_CANAUX; i++) {
+            instantane.canaux[i] = entrees[i];
+        }
+        instantane.sequence = derniereSequence;
+        std::atomic_thread_fence(std::memory_order_acquire);
+        apres = compteurVerrou.load(std::memory_order_relaxed);
+    } while ((avant & 1) || avant != apres);
+}
+
+EntreeMesure lireMesure(CanalMesure canal)
+{
+    EntreeMesure entree;
+    uint32_t avant, apres;
+    do {
+        avant = compteurVerrou.load(std::memory_order_acquire);
+        entree = entrees[canal];
+        std::atomic_thread_fence(std::memory_order_acquire);
+        apres = compteurVerrou.load(std::memory_order_relaxed);
+    } while ((avant & 1) || avant != apres);
+    return entree;
+}
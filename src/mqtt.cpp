@@ -0,0 +1,282 @@
+/**
+ * @file mqtt.cpp
+ * @brief Implémentation du client MQTT 3.1.1 minimal (CONNECT, PUBLISH QoS 1, PUBACK, PINGREQ).
+ */
+
+#include "mqtt.h"
+
+// Types de paquets (4 bits de poids fort de l'en-tête fixe)
+static const uint8_t MQTT_CONNECT = 0x10;
+static const uint8_t MQTT_CONNACK = 0x20;
+static const uint8_t MQTT_PUBLISH = 0x30;
+static const uint8_t MQTT_PUBACK = 0x40;
+static const uint8_t MQTT_PINGREQ = 0xC0;
+static const uint8_t MQTT_PINGRESP = 0xD0;
+static const uint8_t MQTT_DISCONNECT = 0xE0;
+
+// Drapeaux de PUBLISH
+static const uint8_t PUBLISH_DUP = 0x08;
+static const uint8_t PUBLISH_QOS1 = 0x02;
+
+// Drapeaux de CONNECT
+static const uint8_t CONNECT_UTILISATEUR = 0x80;
+static const uint8_t CONNECT_MOT_DE_PASSE = 0x40;
+
+/**
+ * @brief Écrit une chaîne préfixée par sa longueur sur 16 bits.
+ *
+ * @return Nombre d'octets écrits.
+ */
+static size_t ecrireChaine(uint8_t *destination, const char *chaine, size_t longueur)
+{
+    destination[0] = longueur >> 8;
+    destination[1] = longueur & 0xFF;
+    memcpy(destination + 2, chaine, longueur);
+    return longueur + 2;
+}
+
+/**
+ * @brief Encode la longueur restante de l'en-tête fixe (1 à 4 octets de 7 bits).
+ *
+ * @return Nombre d'octets écrits.
+ */
+static size_t encoderLongueur(uint8_t *destination, size_t longueur)
+{
+    size_t n = 0;
+    do {
+        uint8_t octet = longueur % 128;
+        longueur /= 128;
+        if (longueur > 0) {
+            octet |= 0x80;
+        }
+        destination[n++] = octet;
+    } while (longueur > 0 && n < 4);
+    return n;
+}
+
+bool ClientMqtt::envoyerPaquet(uint8_t entete, const uint8_t *corps, size_t longueur)
+{
+    uint8_t enTeteFixe[5];
+    enTeteFixe[0] = entete;
+    const size_t n = 1 + encoderLongueur(enTeteFixe + 1, longueur);
+    if (transport.write(enTeteFixe, n) != n ||
+        (longueur > 0 && transport.write(corps, longueur) != longueur)) {
+        transport.stop();
+        return false;
+    }
+    dernierEnvoi_ms = millis();
+    return true;
+}
+
+bool ClientMqtt::lirePaquet(uint8_t &entete, uint8_t *corps, size_t taille, size_t &longueur, uint32_t delai_ms)
+{
+    transport.setTimeout(delai_ms);
+    if (transport.readBytes(&entete, 1) != 1) {
+        return false;
+    }
+
+    size_t restant = 0;
+    uint32_t multiplicateur = 1;
+    for (uint8_t i = 0; i < 4; i++) {
+        uint8_t octet;
+        if (transport.readBytes(&octet, 1) != 1) {
+            return false;
+        }
+        restant += (octet & 0x7F) * multiplicateur;
+        multiplicateur *= 128;
+        if (!(octet & 0x80)) {
+            break;
+        }
+    }
+
+    // Les paquets attendus sont courts ; le surplus éventuel est lu et ignoré
+    longueur = restant < taille ? restant : taille;
+    if (transport.readBytes(corps, longueur) != longueur) {
+        return false;
+    }
+    for (size_t i = longueur; i < restant; i++) {
+        uint8_t ignore;
+        if (transport.readBytes(&ignore, 1) != 1) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool ClientMqtt::connecter(const char *hote, uint16_t port, const char *idClient,
+                           const char *utilisateur, const char *motDePasse)
+{
+    transport.stop();
+    if (!transport.connect(hote, port)) {
+        stats.echecsConnexion++;
+        return false;
+    }
+
+    // En-tête variable : nom et niveau du protocole, drapeaux, keep-alive ; puis identifiants
+    const size_t lId = strlen(idClient);
+    const size_t lUtilisateur = utilisateur ? strlen(utilisateur) : 0;
+    const size_t lMotDePasse = motDePasse ? strlen(motDePasse) : 0;
+    uint8_t corps[10 + 6 + 64 + 32 + 32];
+    if (lId > 64 || lUtilisateur > 32 || lMotDePasse > 32) {
+        transport.stop();
+        stats.echecsConnexion++;
+        return false;
+    }
+
+    size_t n = ecrireChaine(corps, "MQTT", 4);
+    corps[n++] = 4;                 // MQTT 3.1.1
+    uint8_t drapeaux = 0;           // Clean session = 0 : session persistante
+    if (lUtilisateur > 0) drapeaux |= CONNECT_UTILISATEUR;
+    if (lUtilisateur > 0 && lMotDePasse > 0) drapeaux |= CONNECT_MOT_DE_PASSE;
+    corps[n++] = drapeaux;
+    corps[n++] = keepAlive_s >> 8;
+    corps[n++] = keepAlive_s & 0xFF;
+    n += ecrireChaine(corps + n, idClient, lId);
+    if (drapeaux & CONNECT_UTILISATEUR) n += ecrireChaine(corps + n, utilisateur, lUtilisateur);
+    if (drapeaux & CONNECT_MOT_DE_PASSE) n += ecrireChaine(corps + n, motDePasse, lMotDePasse);
+
+    uint8_t entete;
+    uint8_t reponse[2];
+    size_t longueur;
+    if (!envoyerPaquet(MQTT_CONNECT, corps, n) ||
+        !lirePaquet(entete, reponse, sizeof(reponse), longueur, MQTT_DELAI_CONNEXION_MS) ||
+        (entete & 0xF0) != MQTT_CONNACK || longueur != 2 || reponse[1] != 0) {
+        transport.stop();
+        stats.echecsConnexion++;
+        return false;
+    }
+    stats.connexions++;
+    pingEnAttente = false;
+
+    // Les messages non acquittés sont renvoyés (QoS 1 : un doublon est permis, une perte non)
+    for (size_t i = 0; i < MQTT_FENETRE; i++) {
+        if (fenetre[i].occupe) {
+            if (!envoyerPublish(fenetre[i], true)) {
+                return false;
+            }
+            stats.renvois++;
+        }
+    }
+    return true;
+}
+
+void ClientMqtt::deconnecter()
+{
+    if (transport.connected()) {
+        envoyerPaquet(MQTT_DISCONNECT, NULL, 0);
+    }
+    transport.stop();
+}
+
+bool ClientMqtt::connecte()
+{
+    return transport.connected();
+}
+
+void ClientMqtt::oublierMessages()
+{
+    for (size_t i = 0; i < MQTT_FENETRE; i++) {
+        fenetre[i].occupe = false;
+    }
+}
+
+size_t ClientMqtt::placesLibres() const
+{
+    size_t libres = 0;
+    for (size_t i = 0; i < MQTT_FENETRE; i++) {
+        if (!fenetre[i].occupe) libres++;
+    }
+    return libres;
+}
+
+bool ClientMqtt::envoyerPublish(const MessageEnVol &message, bool dup)
+{
+    // En-tête variable : sujet puis identifiant du paquet ; la charge suit sans copie supplémentaire
+    uint8_t enTeteFixe[5];
+    uint8_t enTeteVariable[2 + MQTT_TAILLE_SUJET + 2];
+    size_t n = ecrireChaine(enTeteVariable, message.sujet, message.longueurSujet);
+    enTeteVariable[n++] = message.id >> 8;
+    enTeteVariable[n++] = message.id & 0xFF;
+
+    enTeteFixe[0] = MQTT_PUBLISH | PUBLISH_QOS1 | (dup ? PUBLISH_DUP : 0);
+    const size_t f = 1 + encoderLongueur(enTeteFixe + 1, n + message.longueurCharge);
+    if (transport.write(enTeteFixe, f) != f ||
+        transport.write(enTeteVariable, n) != n ||
+        transport.write(message.charge, message.longueurCharge) != message.longueurCharge) {
+        transport.stop();
+        return false;
+    }
+    dernierEnvoi_ms = millis();
+    return true;
+}
+
+bool ClientMqtt::publier(const char *sujet, const uint8_t *charge, size_t longueur, uint32_t jeton)
+{
+    const size_t longueurSujet = strlen(sujet);
+    if (longueur > MQTT_TAILLE_MESSAGE || longueurSujet > MQTT_TAILLE_SUJET || !transport.connected()) {
+        return false;
+    }
+
+    MessageEnVol *message = NULL;
+    for (size_t i = 0; i < MQTT_FENETRE && message == NULL; i++) {
+        if (!fenetre[i].occupe) message = &fenetre[i];
+    }
+    if (message == NULL) {
+        return false;
+    }
+
+    message->id = prochainId;
+    prochainId = prochainId == 0xFFFF ? 1 : prochainId + 1;   // 0 est un identifiant interdit
+    message->jeton = jeton;
+    message->longueurSujet = longueurSujet;
+    message->longueurCharge = longueur;
+    memcpy(message->sujet, sujet, longueurSujet);
+    memcpy(message->charge, charge, longueur);
+    message->occupe = true;
+    stats.publications++;
+
+    // En cas d'échec d'écriture, le message reste en vol et sera renvoyé à la reconnexion
+    envoyerPublish(*message, false);
+    return true;
+}
+
+void ClientMqtt::traiter()
+{
+    if (!transport.connected()) {
+        return;
+    }
+
+    while (transport.available() > 0) {
+        uint8_t entete;
+        uint8_t corps[4];
+        size_t longueur;
+        if (!lirePaquet(entete, corps, sizeof(corps), longueur, 1000)) {
+            transport.stop();
+            return;
+        }
+
+        if ((entete & 0xF0) == MQTT_PUBACK && longueur == 2) {
+            const uint16_t id = (corps[0] << 8) | corps[1];
+            for (size_t i = 0; i < MQTT_FENETRE; i++) {
+                if (fenetre[i].occupe && fenetre[i].id == id) {
+                    fenetre[i].occupe = false;
+                    stats.acquittements++;
+                    if (rappelAcquittement) rappelAcquittement(fenetre[i].jeton);
+                    break;
+                }
+            }
+        } else if ((entete & 0xF0) == MQTT_PINGRESP) {
+            pingEnAttente = false;
+        }
+    }
+
+    // Keep-alive : PINGREQ après une demi-période sans émission ; sans réponse, la session est perdue
+    const uint32_t maintenant = millis();
+    if (pingEnAttente && maintenant - dernierEnvoi_ms >= keepAlive_s * 1000UL) {
+        transport.stop();
+        return;
+    }
+    if (!pingEnAttente && maintenant - dernierEnvoi_ms >= keepAlive_s * 500UL) {
+        pingEnAttente = envoyerPaquet(MQTT_PINGREQ, NULL, 0);
+    }
+}
@@ -0,0 +1,180 @@
+/**
+ * @file ordonnanceur.cpp
+ * @brief Implémentation de la roue temporelle hachée des acquisitions.
+ *
+ * Le temps est découpé en "tops" de ORDONNANCEUR_RESOLUTION_MS. Un travail dont l'échéance
+ * absolue est le top E est rangé dans l'alvéole E % ORDONNANCEUR_NB_ALVEOLES. À chaque réveil,
+ * seule l'alvéole du top courant est parcourue : les travaux dont l'échéance est ce top sont
+ * exécutés puis réinsérés à E + période. Les échéances sont ancrées sur l'origine de la roue
+ * (pas de dérive liée au temps d'exécution des travaux).
+ *
+ * Entre deux réveils, la tâche dort jusqu'au prochain top occupé : les tops sans travail
+ * ne provoquent aucun changement de contexte.
+ */
+
+#include "ordonnanceur.h"
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <esp_timer.h>
+
+// Travail périodique
+struct Travail {
+  const char *nom;
+  FonctionTravail fonction;
+  uint32_t periode;         // Période en tops
+  uint32_t echeance;        // Top absolu de la prochaine exécution
+  uint8_t priorite;         // Ordre d'exécution dans un même top (le plus grand d'abord)
+  int8_t suivant;           // Travail suivant dans la même alvéole (-1 = fin)
+  uint64_t sommeRetard_us;
+  StatsTravail stats;
+};
+
+static Travail travaux[ORDONNANCEUR_NB_TRAVAUX];
+static int nbTravaux = 0;
+
+// Tête de liste de chaque alvéole (-1 = vide)
+static int8_t alveoles[ORDONNANCEUR_NB_ALVEOLES];
+
+// Top courant de la roue et instant (µs) correspondant au top 0
+static uint32_t topCourant = 0;
+static int64_t origine_us = 0;
+
+static inline uint32_t msEnTops(uint32_t ms)
+{
+    return (ms + ORDONNANCEUR_RESOLUTION_MS / 2) / ORDONNANCEUR_RESOLUTION_MS;
+}
+
+/**
+ * @brief Range un travail dans l'alvéole de son échéance, par priorité décroissante.
+ */
+static void insererTravail(int id)
+{
+    int8_t *lien = &alveoles[travaux[id].echeance % ORDONNANCEUR_NB_ALVEOLES];
+    while (*lien >= 0 && travaux[*lien].priorite >= travaux[id].priorite) {
+        lien = &travaux[*lien].suivant;
+    }
+    travaux[id].suivant = *lien;
+    *lien = id;
+}
+
+/**
+ * @brief Cherche le prochain top dont l'alvéole contient un travail à échéance.
+ *
+ * Parcourt au plus un tour de roue ; si aucun travail n'échoit dans ce tour
+ * (période plus longue que la roue), la tâche se réveille au bout d'un tour complet.
+ */
+static uint32_t prochainTopOccupe()
+{
+    for (uint32_t ecart = 1; ecart <= ORDONNANCEUR_NB_ALVEOLES; ecart++) {
+        const uint32_t top = topCourant + ecart;
+        for (int8_t id = alveoles[top % ORDONNANCEUR_NB_ALVEOLES]; id >= 0; id = travaux[id].suivant) {
+            if (travaux[id].echeance == top) {
+                return top;
+            }
+        }
+    }
+    return topCourant + ORDONNANCEUR_NB_ALVEOLES;
+}
+
+/**
+ * @brief Exécute les travaux de l'alvéole du top courant arrivés à échéance.
+ */
+static void traiterAlveole()
+{
+    int8_t &tete = alveoles[topCourant % ORDONNANCEUR_NB_ALVEOLES];
+
+    // Détache les travaux échus, dans l'ordre de priorité, avant de les exécuter
+    // (ils seront réinsérés plus loin)
+    int8_t echus = -1;
+    int8_t *queueEchus = &echus;
+    int8_t *lien = &tete;
+    while (*lien >= 0) {
+        const int8_t id = *lien;
+        if (travaux[id].echeance == topCourant) {
+            *lien = travaux[id].suivant;
+            travaux[id].suivant = -1;
+            *queueEchus = id;
+            queueEchus = &travaux[id].suivant;
+        } else {
+            lien = &travaux[id].suivant;
+        }
+    }
+
+    while (echus >= 0) {
+        const int8_t id = echus;
+        Travail &t = travaux[id];
+        echus = t.suivant;
+
+        const int64_t prevu_us = origine_us + (int64_t)t.echeance * ORDONNANCEUR_RESOLUTION_MS * 1000;
+        const int64_t debut_us = esp_timer_get_time();
+        t.fonction();
+        const int64_t fin_us = esp_timer_get_time();
+
+        const uint32_t retard_us = debut_us > prevu_us ? (uint32_t)(debut_us - prevu_us) : 0;
+        const uint32_t duree_us = (uint32_t)(fin_us - debut_us);
+        t.stats.executions++;
+        t.sommeRetard_us += retard_us;
+        t.stats.retardMoyen_us = (uint32_t)(t.sommeRetard_us / t.stats.executions);
+        if (retard_us > t.stats.retardMax_us) t.stats.retardMax_us = retard_us;
+        if (duree_us > t.stats.dureeMax_us) t.stats.dureeMax_us = duree_us;
+
+        // Prochaine échéance ancrée sur la période ; les échéances déjà dépassées sont sautées
+        const uint32_t topReel = (uint32_t)((fin_us - origine_us) / (ORDONNANCEUR_RESOLUTION_MS * 1000));
+        t.echeance += t.periode;
+        while ((int32_t)(t.echeance - topReel) <= 0) {
+            t.echeance += t.periode;
+            t.stats.echeancesManquees++;
+        }
+        insererTravail(id);
+    }
+}
+
+int ajouterTravail(const char *nom, FonctionTravail fonction, uint32_t periode_ms, uint32_t dephasage_ms,
+                   uint8_t priorite)
+{
+    if (nbTravaux >= ORDONNANCEUR_NB_TRAVAUX) {
+        Serial.println("[ORDO] Table des travaux pleine !");
+        return -1;
+    }
+    if (nbTravaux == 0) {
+        memset(alveoles, -1, sizeof(alveoles));
+    }
+
+    const int id = nbTravaux++;
+    Travail &t = travaux[id];
+    t.nom = nom;
+    t.fonction = fonction;
+    t.periode = msEnTops(periode_ms) ? msEnTops(periode_ms) : 1;
+    t.echeance = topCourant + (msEnTops(dephasage_ms) ? msEnTops(dephasage_ms) : 1);
+    t.priorite = priorite;
+    t.sommeRetard_us = 0;
+    t.stats = StatsTravail{};
+    insererTravail(id);
+    return id;
+}
+
+void executerOrdonnanceur()
+{
+    TickType_t reveil = xTaskGetTickCount();
+    origine_us = esp_timer_get_time() - (int64_t)topCourant * ORDONNANCEUR_RESOLUTION_MS * 1000;
+
+    for (;;) {
+        const uint32_t prochain = prochainTopOccupe();
+
+        // Réveil ancré : vTaskDelayUntil ne bloque pas si l'instant est déjà passé
+        vTaskDelayUntil(&reveil, pdMS_TO_TICKS((prochain - topCourant) * ORDONNANCEUR_RESOLUTION_MS));
+        topCourant = prochain;
+
+        traiterAlveole();
+    }
+}
+
+void afficherStatsOrdonnanceur()
+{
+    for (int id = 0; id < nbTravaux; id++) {
+        const StatsTravail &s = travaux[id].stats;
+        Serial.printf("[ORDO] %-20s n=%u retard moy=%u us max=%u us | duree max=%u us | manquees=%u\n",
+                      travaux[id].nom, s.executions, s.retardMoyen_us, s.retardMax_us,
+                      s.dureeMax_us, s.echeancesManquees);
+    }
+}
@@ -0,0 +1,255 @@
+/**
+ * @file politique_envoi.cpp
+ * @brief Implémentation de la politique d'envoi sur changement.
+ */
+
+#include "politique_envoi.h"
+#include "registre_capteurs.h"
+#include "journal.h"
+#include "statistiques.h"
+
+// État d'un canal, mis à jour uniquement dans la tâche qui publie les mesures
+struct EtatCanal {
+  bool retenu;               // Au moins un échantillon retenu depuis le démarrage
+  float valeur;              // Dernière valeur retenue
+  uint32_t instant_ms;       // Instant du dernier échantillon retenu
+};
+
+// Configuration modifiable par le portail (tâche WiFi) et lue par la tâche d'acquisition
+static PolitiqueCanal politiques[NB_CANAUX] = {};
+static uint32_t heartbeat_ms = RAPPORT_HEARTBEAT_S * 1000UL;
+static bool configuree = false;   // Configuration du portail déjà appliquée (la tâche WiFi démarre avant)
+static portMUX_TYPE verrouPolitique = portMUX_INITIALIZER_UNLOCKED;
+
+static EtatCanal etats[NB_CANAUX] = {};
+
+// Heartbeat : canaux qui doivent encore retenir un échantillon avant la demande de rapport
+static uint32_t dernierHeartbeat_ms = 0;
+static uint32_t canauxHeartbeat = 0;
+static bool heartbeatEnCours = false;
+
+static volatile bool rapportDemande = false;
+static StatsPolitique stats = {};
+
+/**
+ * @brief Évalue la politique pour un échantillon et l'ajoute au journal s'il est retenu.
+ */
+static void evaluerEchantillon(CanalMesure canal, float valeur, uint32_t maintenant,
+                               const Horodatage &capture, const PolitiqueCanal &politique)
+{
+    EtatCanal &etat = etats[canal];
+    const uint32_t masque = 1UL << canal;
+
+    // Canal envoyé en statistiques de fenêtre : les échantillons ne sont pas journalisés
+    if (politique.agreger) {
+        canauxHeartbeat &= ~masque;
+        return;
+    }
+
+    const uint32_t ecoule = maintenant - etat.instant_ms;
+
+    // Le premier échantillon d'un canal compte comme un événement : rapport dès le démarrage
+    bool evenement = !etat.retenu;
+    bool retenir = evenement || (canauxHeartbeat & masque) || ecoule >= politique.intervalleMax_s * 1000UL;
+    if (!retenir && ecoule >= politique.intervalleMin_s * 1000UL) {
+        const float bande = politique.bandeRelative ? fabsf(etat.valeur) * politique.bandeMorte / 100.0f
+                                                   : politique.bandeMorte;
+        evenement = fabsf(valeur - etat.valeur) > bande;
+        retenir = evenement;
+    }
+
+    if (!retenir) {
+        stats.ignores++;
+        return;
+    }
+    etat.retenu = true;
+    etat.valeur = valeur;
+    etat.instant_ms = maintenant;
+    canauxHeartbeat &= ~masque;
+    ajouterJournal(canal, valeur, capture);
+    stats.retenus++;
+
+    if (evenement) {
+        stats.evenements++;
+        rapportDemande = true;
+    }
+}
+
+/**
+ * @brief Abonné aux mesures : évaluation incrémentale, dans la tâche qui publie.
+ */
+static void evaluerMesures(const CanalMesure canaux[], const float valeurs[], size_t nb, const Horodatage &capture)
+{
+    const uint32_t maintenant = millis();
+
+    PolitiqueCanal copie[NB_CANAUX];
+    portENTER_CRITICAL(&verrouPolitique);
+    memcpy(copie, politiques, sizeof(copie));
+    const uint32_t periodeHeartbeat = heartbeat_ms;
+    portEXIT_CRITICAL(&verrouPolitique);
+
+    // Début d'un heartbeat : le prochain échantillon de chaque canal actif est retenu
+    if (!heartbeatEnCours && maintenant - dernierHeartbeat_ms >= periodeHeartbeat) {
+        dernierHeartbeat_ms = maintenant;
+        heartbeatEnCours = true;
+        for (const InfoCanal &info : TABLE_CANAUX) {
+            canauxHeartbeat |= 1UL << info.canal;
+        }
+    }
+
+    for (size_t i = 0; i < nb; i++) {
+        evaluerEchantillon(canaux[i], valeurs[i], maintenant, capture, copie[canaux[i]]);
+    }
+
+    // Fin du heartbeat quand tous les canaux ont répondu, ou après un délai (capteur en panne)
+    if (heartbeatEnCours &&
+        (canauxHeartbeat == 0 || maintenant - dernierHeartbeat_ms >= RAPPORT_DELAI_HEARTBEAT_MS)) {
+        canauxHeartbeat = 0;
+        heartbeatEnCours = false;
+        stats.heartbeats++;
+        rapportDemande = true;
+    }
+}
+
+/**
+ * @brief Rappel de fin de fenêtre : journalise les statistiques des canaux agrégés.
+ *
+ * Elles partent avec le rapport suivant, sans en demander un.
+ */
+static void journaliserStatistiques(CanalMesure canal, const StatistiquesFenetre &s, const Horodatage &debut)
+{
+    portENTER_CRITICAL(&verrouPolitique);
+    const bool agreger = politiques[canal].agreger;
+    portEXIT_CRITICAL(&verrouPolitique);
+    if (!agreger) {
+        return;
+    }
+    ajouterJournal(canal, s.nombre, debut, NATURE_NOMBRE);
+    ajouterJournal(canal, s.min, debut, NATURE_MIN);
+    ajouterJournal(canal, s.max, debut, NATURE_MAX);
+    ajouterJournal(canal, s.moyenne, debut, NATURE_MOYENNE);
+    ajouterJournal(canal, s.ecartType, debut, NATURE_ECART_TYPE);
+    ajouterJournal(canal, s.p50, debut, NATURE_P50);
+    ajouterJournal(canal, s.p95, debut, NATURE_P95);
+    stats.agregats++;
+}
+
+void initPolitiqueEnvoi()
+{
+    portENTER_CRITICAL(&verrouPolitique);
+    if (!configuree) {
+        for (const InfoCanal &info : TABLE_CANAUX) {
+            politiques[info.canal] = info.politique;
+        }
+    }
+    portEXIT_CRITICAL(&verrouPolitique);
+    abonnerMesures(evaluerMesures);
+    surFinFenetre(journaliserStatistiques);
+}
+
+/**
+ * @brief Lit une entrée "cle=bande[%]/min_s/max_s" (les champs absents gardent leur valeur)
+ * ou "cle=stats" (statistiques de fenêtre à la place des échantillons).
+ *
+ * @return false si l'entrée est invalide.
+ */
+static bool lireEntree(const char *entree, size_t longueur, PolitiqueCanal nouvelles[])
+{
+    const char *egal = (const char *)memchr(entree, '=', longueur);
+    if (egal == NULL) {
+        return false;
+    }
+    const InfoCanal *info = NULL;
+    for (const InfoCanal &i : TABLE_CANAUX) {
+        if (strlen(i.cle) == (size_t)(egal - entree) && strncmp(i.cle, entree, egal - entree) == 0) {
+            info = &i;
+        }
+    }
+    if (info == NULL) {
+        return false;
+    }
+
+    char valeurs[32];
+    const size_t l = longueur - (egal + 1 - entree);
+    if (l >= sizeof(valeurs)) {
+        return false;
+    }
+    memcpy(valeurs, egal + 1, l);
+    valeurs[l] = '\0';
+
+    PolitiqueCanal p = nouvelles[info->canal];
+    if (strcmp(valeurs, "stats") == 0) {
+        nouvelles[info->canal].agreger = true;
+        return true;
+    }
+    p.agreger = false;
+    char *suite;
+    p.bandeMorte = strtof(valeurs, &suite);
+    if (suite == valeurs || p.bandeMorte < 0) {
+        return false;
+    }
+    p.bandeRelative = *suite == '%';
+    if (p.bandeRelative) suite++;
+
+    if (*suite == '/') {
+        const char *debut = suite + 1;
+        const unsigned long n = strtoul(debut, &suite, 10);
+        if (suite == debut || n > UINT16_MAX) return false;
+        p.intervalleMin_s = n;
+    }
+    if (*suite == '/') {
+        const char *debut = suite + 1;
+        const unsigned long n = strtoul(debut, &suite, 10);
+        if (suite == debut || n > UINT16_MAX) return false;
+        p.intervalleMax_s = n;
+    }
+    if (*suite != '\0' || p.intervalleMax_s == 0 || p.intervalleMin_s > p.intervalleMax_s) {
+        return false;
+    }
+    nouvelles[info->canal] = p;
+    return true;
+}
+
+bool appliquerPolitiqueEnvoi(const char *politique, const char *heartbeat_s)
+{
+    PolitiqueCanal nouvelles[NB_CANAUX] = {};
+    for (const InfoCanal &info : TABLE_CANAUX) {
+        nouvelles[info.canal] = info.politique;
+    }
+
+    bool valide = true;
+    const char *entree = politique;
+    while (entree && *entree) {
+        const size_t longueur = strcspn(entree, ";");
+        if (longueur > 0 && !lireEntree(entree, longueur, nouvelles)) {
+            Serial.printf("[POLITIQUE] Entree ignoree : %.*s\n", (int)longueur, entree);
+            valide = false;
+        }
+        entree += longueur;
+        if (*entree == ';') entree++;
+    }
+
+    const long heartbeat = heartbeat_s ? atol(heartbeat_s) : 0;
+
+    portENTER_CRITICAL(&verrouPolitique);
+    memcpy(politiques, nouvelles, sizeof(politiques));
+    heartbeat_ms = (heartbeat > 0 ? heartbeat : RAPPORT_HEARTBEAT_S) * 1000UL;
+    configuree = true;
+    portEXIT_CRITICAL(&verrouPolitique);
+    return valide;
+}
+
+bool prendreRapportDemande()
+{
+    // Lecture et remise à zéro indivisibles : une demande posée entre les deux ne peut être perdue
+    portENTER_CRITICAL(&verrouPolitique);
+    const bool demande = rapportDemande;
+    rapportDemande = false;
+    portEXIT_CRITICAL(&verrouPolitique);
+    return demande;
+}
+
+StatsPolitique lireStatsPolitique()
+{
+    return stats;
+}
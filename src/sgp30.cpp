@@ -0,0 +1,137 @@
+/**
+ * @file sgp30.cpp
+ * @brief Implémentation du pilote SGP30 (commandes et CRC de la fiche technique Sensirion).
+ */
+
+#include "sgp30.h"
+#include "configuration.h"
+#include "taches/tache_bus_i2c.h"
+
+// Codes des commandes et temps d'exécution maximaux (fiche technique, tableau 10)
+static const uint16_t CMD_IAQ_INIT = 0x2003;
+static const uint16_t CMD_MESURE_IAQ = 0x2008;
+static const uint16_t CMD_LIRE_BASELINE = 0x2015;
+static const uint16_t CMD_ECRIRE_BASELINE = 0x201E;
+static const uint16_t CMD_HUMIDITE = 0x2061;
+static const uint16_t CMD_FONCTIONNALITES = 0x202F;
+static const uint16_t CMD_MESURE_BRUTE = 0x2050;
+static const uint16_t CMD_NUMERO_SERIE = 0x3682;
+
+// Nombre maximal de mots (arguments ou réponse) d'une commande
+static const uint8_t NB_MOTS_MAX = 3;
+
+/**
+ * @brief CRC-8 Sensirion (polynôme 0x31, valeur initiale 0xFF) d'un mot de 16 bits.
+ */
+static uint8_t crcSgp30(uint16_t mot)
+{
+    uint8_t crc = 0xFF;
+    const uint8_t octets[2] = { (uint8_t)(mot >> 8), (uint8_t)mot };
+    for (uint8_t i = 0; i < 2; i++) {
+        crc ^= octets[i];
+        for (uint8_t b = 0; b < 8; b++) {
+            crc = (crc & 0x80) ? (uint8_t)((crc << 1) ^ 0x31) : (uint8_t)(crc << 1);
+        }
+    }
+    return crc;
+}
+
+bool CapteurSgp30::commande(uint16_t code, const uint16_t *arguments, uint8_t nbArguments,
+                            uint16_t delai_ms, uint16_t *reponse, uint8_t nbMots)
+{
+    // Code de commande puis chaque argument suivi de son CRC
+    uint8_t trame[2 + 3 * NB_MOTS_MAX];
+    size_t longueur = 0;
+    trame[longueur++] = code >> 8;
+    trame[longueur++] = code & 0xFF;
+    for (uint8_t i = 0; i < nbArguments; i++) {
+        trame[longueur++] = arguments[i] >> 8;
+        trame[longueur++] = arguments[i] & 0xFF;
+        trame[longueur++] = crcSgp30(arguments[i]);
+    }
+    if (ecrireI2c(SGP30_ADRESSE, trame, longueur, I2C_PRIORITE_CAPTEUR) != I2C_OK) {
+        return false;
+    }
+
+    // Le SGP30 n'accepte pas de lecture pendant l'exécution : attente passive
+    vTaskDelay(pdMS_TO_TICKS(delai_ms));
+    if (nbMots == 0) {
+        return true;
+    }
+
+    uint8_t octets[3 * NB_MOTS_MAX];
+    if (lireI2c(SGP30_ADRESSE, octets, 3 * nbMots, I2C_PRIORITE_CAPTEUR) != I2C_OK) {
+        return false;
+    }
+    for (uint8_t i = 0; i < nbMots; i++) {
+        const uint16_t mot = (octets[3 * i] << 8) | octets[3 * i + 1];
+        if (crcSgp30(mot) != octets[3 * i + 2]) {
+            return false;
+        }
+        reponse[i] = mot;
+    }
+    return true;
+}
+
+bool CapteurSgp30::begin()
+{
+    if (!commande(CMD_NUMERO_SERIE, NULL, 0, 1, serialnumber, 3)) {
+        return false;
+    }
+    // Type de produit (4 bits de poids fort) : 0 pour le SGP30
+    uint16_t fonctionnalites;
+    if (!commande(CMD_FONCTIONNALITES, NULL, 0, 10, &fonctionnalites, 1)) {
+        return false;
+    }
+    return (fonctionnalites & 0xF000) == 0;
+}
+
+bool CapteurSgp30::IAQinit()
+{
+    return commande(CMD_IAQ_INIT, NULL, 0, 10, NULL, 0);
+}
+
+bool CapteurSgp30::IAQmeasure()
+{
+    uint16_t reponse[2];
+    if (!commande(CMD_MESURE_IAQ, NULL, 0, 12, reponse, 2)) {
+        return false;
+    }
+    eCO2 = reponse[0];
+    TVOC = reponse[1];
+    return true;
+}
+
+bool CapteurSgp30::IAQmeasureRaw()
+{
+    uint16_t reponse[2];
+    if (!commande(CMD_MESURE_BRUTE, NULL, 0, 25, reponse, 2)) {
+        return false;
+    }
+    rawH2 = reponse[0];
+    rawEthanol = reponse[1];
+    return true;
+}
+
+bool CapteurSgp30::getIAQBaseline(uint16_t *eco2_base, uint16_t *tvoc_base)
+{
+    uint16_t reponse[2];
+    if (!commande(CMD_LIRE_BASELINE, NULL, 0, 10, reponse, 2)) {
+        return false;
+    }
+    *eco2_base = reponse[0];
+    *tvoc_base = reponse[1];
+    return true;
+}
+
+bool CapteurSgp30::setIAQBaseline(uint16_t eco2_base, uint16_t tvoc_base)
+{
+    // Ordre inverse de la lecture : TVOC puis eCO2
+    const uint16_t arguments[2] = { tvoc_base, eco2_base };
+    return commande(CMD_ECRIRE_BASELINE, arguments, 2, 10, NULL, 0);
+}
+
+bool CapteurSgp30::setHumidity(uint16_t absolute_humidity)
+{
+    return commande(CMD_HUMIDITE, &absolute_humidity, 1, 10, NULL, 0);
+}
@@ -0,0 +1,176 @@
+/**
+ * @file statistiques.cpp
+ * @brief Implémentation des statistiques en flux (Welford et P²) sur fenêtres consécutives.
+ */
+
+#include "statistiques.h"
+
+void EstimateurP2::ajouter(float x)
+{
+    // Cinq premiers échantillons : conservés tels quels, puis triés pour initialiser les marqueurs
+    if (n < 5) {
+        hauteurs[n++] = x;
+        if (n == 5) {
+            for (int i = 1; i < 5; i++) {
+                for (int j = i; j > 0 && hauteurs[j] < hauteurs[j - 1]; j--) {
+                    const float t = hauteurs[j];
+                    hauteurs[j] = hauteurs[j - 1];
+                    hauteurs[j - 1] = t;
+                }
+            }
+            for (int i = 0; i < 5; i++) {
+                positions[i] = i + 1;
+            }
+        }
+        return;
+    }
+    n++;
+
+    // Cellule k qui contient x ; les extrêmes sont étendus si besoin
+    int k;
+    if (x < hauteurs[0]) {
+        hauteurs[0] = x;
+        k = 0;
+    } else if (x >= hauteurs[4]) {
+        hauteurs[4] = x;
+        k = 3;
+    } else {
+        k = 0;
+        while (x >= hauteurs[k + 1]) k++;
+    }
+    for (int i = k + 1; i < 5; i++) {
+        positions[i]++;
+    }
+
+    // Ajustement des marqueurs intermédiaires trop éloignés de leur position souhaitée,
+    // 1 + (n - 1) × incrément (calculée directement : pas de dérive d'une somme de flottants)
+    const float increments[5] = { 0, p / 2, p, (1 + p) / 2, 1 };
+    for (int i = 1; i < 4; i++) {
+        const float d = 1 + (n - 1) * increments[i] - positions[i];
+        if ((d >= 1 && positions[i + 1] - positions[i] > 1) || (d <= -1 && positions[i - 1] - positions[i] < -1)) {
+            const int s = d > 0 ? 1 : -1;
+            const float ecartSuivant = positions[i + 1] - positions[i];
+            const float ecartPrecedent = positions[i] - positions[i - 1];
+            const float parabolique = hauteurs[i] + s / (float)(positions[i + 1] - positions[i - 1]) *
+                ((ecartPrecedent + s) * (hauteurs[i + 1] - hauteurs[i]) / ecartSuivant +
+                 (ecartSuivant - s) * (hauteurs[i] - hauteurs[i - 1]) / ecartPrecedent);
+            if (hauteurs[i - 1] < parabolique && parabolique < hauteurs[i + 1]) {
+                hauteurs[i] = parabolique;
+            } else {
+                // Interpolation parabolique hors des voisins : linéaire vers le voisin du côté de s
+                hauteurs[i] += s * (hauteurs[i + s] - hauteurs[i]) / (positions[i + s] - positions[i]);
+            }
+            positions[i] += s;
+        }
+    }
+}
+
+float EstimateurP2::valeur() const
+{
+    if (n >= 5) {
+        return hauteurs[2];
+    }
+    if (n == 0) {
+        return 0;
+    }
+    // Moins de cinq échantillons : quantile exact sur une copie triée
+    float tries[4];
+    for (uint32_t i = 0; i < n; i++) {
+        uint32_t j = i;
+        for (; j > 0 && tries[j - 1] > hauteurs[i]; j--) {
+            tries[j] = tries[j - 1];
+        }
+        tries[j] = hauteurs[i];
+    }
+    return tries[(uint32_t)lroundf(p * (n - 1))];
+}
+
+void AccumulateurStatistiques::ajouter(float x)
+{
+    n++;
+    if (n == 1) {
+        min = max = x;
+    } else {
+        if (x < min) min = x;
+        if (x > max) max = x;
+    }
+    const float ecart = x - moyenne;
+    moyenne += ecart / n;
+    m2 += ecart * (x - moyenne);
+    p50.ajouter(x);
+    p95.ajouter(x);
+}
+
+StatistiquesFenetre AccumulateurStatistiques::lire() const
+{
+    if (n == 0) {
+        return {};
+    }
+    return { n, min, max, moyenne, sqrtf(m2 / n), p50.valeur(), p95.valeur() };
+}
+
+void AccumulateurStatistiques::reinitialiser()
+{
+    n = 0;
+    moyenne = 0;
+    m2 = 0;
+    p50.reinitialiser();
+    p95.reinitialiser();
+}
+
+// Fenêtre en cours et dernière fenêtre close d'un canal (dernière lue par d'autres tâches)
+struct FenetreCanal {
+  AccumulateurStatistiques accumulateur;
+  Horodatage debut;             // Capture du premier échantillon de la fenêtre
+  uint32_t debut_ms;            // millis() du début de la fenêtre
+  StatistiquesFenetre derniere;
+};
+
+static FenetreCanal fenetres[NB_CANAUX];
+static RappelFinFenetre rappelFinFenetre = nullptr;
+static portMUX_TYPE verrouStatistiques = portMUX_INITIALIZER_UNLOCKED;
+
+/**
+ * @brief Abonné aux mesures : ajoute chaque échantillon à la fenêtre de son canal.
+ */
+static void accumulerMesures(const CanalMesure canaux[], const float valeurs[], size_t nb, const Horodatage &capture)
+{
+    const uint32_t maintenant = millis();
+    for (size_t i = 0; i < nb; i++) {
+        FenetreCanal &f = fenetres[canaux[i]];
+
+        if (f.accumulateur.nombre() > 0 && maintenant - f.debut_ms >= STATISTIQUES_FENETRE_S * 1000UL) {
+            const StatistiquesFenetre s = f.accumulateur.lire();
+            portENTER_CRITICAL(&verrouStatistiques);
+            f.derniere = s;
+            portEXIT_CRITICAL(&verrouStatistiques);
+            if (rappelFinFenetre) {
+                rappelFinFenetre(canaux[i], s, f.debut);
+            }
+            f.accumulateur.reinitialiser();
+        }
+        if (f.accumulateur.nombre() == 0) {
+            f.debut = capture;
+            f.debut_ms = maintenant;
+        }
+        f.accumulateur.ajouter(valeurs[i]);
+    }
+}
+
+void initStatistiques()
+{
+    abonnerMesures(accumulerMesures);
+}
+
+void surFinFenetre(RappelFinFenetre rappel)
+{
+    rappelFinFenetre = rappel;
+}
+
+bool lireStatistiques(CanalMesure canal, StatistiquesFenetre &statistiques)
+{
+    portENTER_CRITICAL(&verrouStatistiques);
+    statistiques = fenetres[canal].derniere;
+    portEXIT_CRITICAL(&verrouStatistiques);
+    return statistiques.nombre > 0;
+}
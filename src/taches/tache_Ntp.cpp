@@ -3,7 +3,8 @@
  * @brief Implémentation de la tâche de gestion du temps via le protocole NTP.
  * 
  * Ce fichier définit une tâche FreeRTOS qui récupère et met à jour l'heure locale depuis un serveur NTP.
- * L'heure est ensuite affichée et peut être utilisée pour d'autres opérations (affichage sur OLED, envoi de données via MQTT, etc.).
+ * L'heure système réglée par SNTP cale le service d'heure (horloge.h), qui horodate les mesures et
+ * fournit les textes de l'OLED.
  */
 
 #include "taches/tache_Ntp.h"
@@ -11,18 +12,9 @@
 #include "variablesGlobales.h"
 #include <WiFiManager.h>
 
-// Drapeau pour indiquer l'envoi de données (variable volatile car modifiée par des interruptions ou des tâches)
-volatile bool Flag_Envoi_donnees = false;
-
 // Déclaration des paramètres personnalisés
 extern CustomParams params;
 
-// Variables pour l'affichage de l'horodatage et de l'heure locale
-char affHorodatageNtp[50]; 
-char horodatageNtp[15]; 
-char affHorodatageNTPDate[10];
-char affHorodatageNTPHeure[6];
-
 // Fuseau horaire par défaut (GMT+2)
 long tzf = 2;
 
@@ -32,12 +24,6 @@ String weekDays[7] = {"Dimanche", "Lundi", "Mardi", "Mercredi", "Jeudi", "Vendre
 // Mois de l'année en français
 String months[12] = {"Janvier", "Février", "Mars", "Avril", "Mai", "Juin", "Juillet", "Août", "Septembre", "Octobre", "Novembre", "Décembre"};
 
-// Dernière heure d'envoi de données (en millisecondes)
-unsigned long lastSendTime = 0;
-
-// Intervalle de temps pour l'envoi de données (15 minutes en millisecondes)
-const unsigned long interval = 15 * 60 * 1000;
-
 // Nom du serveur NTP à interroger
 const char* ntpServer = NTP_SERVER;
 
@@ -45,8 +31,8 @@ const char* ntpServer = NTP_SERVER;
  * @brief Affiche l'heure locale récupérée depuis le serveur NTP.
  * 
  * Cette fonction récupère l'heure locale en utilisant le fuseau horaire configuré par l'utilisateur.
- * Si l'obtention de l'heure échoue, un message d'erreur est affiché. Les horodatages sont stockés 
- * dans des variables globales pour être utilisés par d'autres tâches (OLED, MQTT, etc.).
+ * Si l'obtention de l'heure échoue, un message d'erreur est affiché. Les autres tâches lisent
+ * l'heure par le service d'heure (horloge.h), jamais par des textes préformatés.
  */
 void printLocalTime(){
     struct tm timeinfo;
@@ -73,20 +59,14 @@ void printLocalTime(){
 
     // Affiche l'heure complète en format lisible pour le débogage
     Serial.println(&timeinfo, "%A, %B %d %Y %H:%M:%S");
-
-    // Formate les différentes parties de l'horodatage pour affichage OLED et envoi MQTT
-    strftime(affHorodatageNTPDate, 10, "%D", &timeinfo);  // Date (format mm/dd/yy) pour OLED
-    strftime(affHorodatageNTPHeure, 6, "%H:%M", &timeinfo);  // Heure (format HH:MM) pour OLED
-    strftime(affHorodatageNtp, 50, "%D %H:%M", &timeinfo);  // Horodatage complet pour OLED
-    strftime(horodatageNtp, 15, "%D %H:%M", &timeinfo);  // Horodatage complet pour MQTT
 }
 
 /**
  * @brief Tâche FreeRTOS pour récupérer l'heure depuis le serveur NTP.
  * 
- * Cette tâche se connecte au serveur NTP pour récupérer l'heure et met à jour régulièrement l'horodatage.
- * L'heure est mise à jour à chaque intervalle défini (toutes les 15 minutes par défaut) et le drapeau 
- * `Flag_Envoi_donnees` est activé pour signaler qu'un envoi de données est prêt.
+ * Cette tâche attend la connexion WiFi, configure le client SNTP et récupère l'heure une première
+ * fois, puis se termine : SNTP resynchronise ensuite l'horloge de lui-même. Les envois ne sont plus
+ * cadencés ici mais par la politique d'envoi (politique_envoi.h).
  * 
  * @param parameter Paramètre non utilisé, requis par le prototype de la fonction FreeRTOS.
  */
@@ -99,19 +79,5 @@ void fetchTimeFromNTP(void * parameter){
     // Récupère l'heure locale à partir du serveur NTP
     printLocalTime();
 
-    // Boucle infinie de la tâche
-    for (;;)
-    {
-        // Obtenir l'heure actuelle en millisecondes
-        unsigned long currentTime = millis();
-
-        // Vérifier si l'intervalle de 15 minutes est écoulé depuis le dernier envoi
-        if (currentTime - lastSendTime >= interval) {
-            lastSendTime = currentTime; // Met à jour le dernier temps d'envoi
-            Flag_Envoi_donnees = true;  // Active le drapeau d'envoi de données
-        }
-
-        // Temporisation de la tâche pour éviter les appels excessifs
-        vTaskDelay(NTP_UPDATE_INTERVAL_MS / portTICK_PERIOD_MS);
-    }
+    vTaskDelete(NULL);
 }
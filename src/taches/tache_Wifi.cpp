@@ -2,6 +2,8 @@
 #include "taches/tache_Wifi.h" // Tâches personnalisées pour WiFi
 #include <Arduino.h> // Bibliothèque principale Arduino
 #include "variablesGlobales.h" // Variables globales du projet
+#include "politique_envoi.h" // Politique d'envoi sur changement
+#include "api_web.h" // Points d'accès /api/sensors, /api/history et /metrics
 #include "SPIFFS.h" // Système de fichiers pour ESP32
 #include <FS.h> // Interface pour le système de fichiers
 
@@ -31,7 +33,7 @@ char _oled_checkbox[34] = "type=\"checkbox\""; // pour les checkbox
 
 // Structure pour stocker les paramètres MQTT
 CustomParams params = {
-  "https://hostname.fr", "8080", "user", "password", "à définir ou pas", "+2"
+  "https://hostname.fr", "8080", "user", "password", "à définir ou pas", "+2", "", "3600", ""
 };
 
 // Instance de WiFiManager
@@ -45,6 +47,9 @@ WiFiManagerParameter custom_user("user", "Nom de login", params.user_mon_serveur
 WiFiManagerParameter custom_pass("pass", "Mot de passe", params.pass_mon_serveur, 32);
 WiFiManagerParameter custom_data("data", "Donneés particuliéres", params.data_mon_serveur, 32);
 WiFiManagerParameter custom_GMT("gmt", "GMT exemple:+2", params.timeZone, 3, "pattern='^[\\+\\-]\\d{1}$' title='Seulement un signe (+ ou -) et un chiffre'");
+WiFiManagerParameter custom_politique("politique", "Envoi sur changement (ex: co2=100/10/600;tvoc=stats;luminosite=30%)", params.politique, sizeof(params.politique) - 1, "pattern='[^,]*' title='Pas de virgule'");
+WiFiManagerParameter custom_alarmes("alarmes", "Seuils d'alarme (ex: co2>1200/100;temperature<5/1;tvoc=off)", params.alarmes, sizeof(params.alarmes) - 1, "pattern='[^,]*' title='Pas de virgule'");
+WiFiManagerParameter custom_heartbeat("heartbeat", "Heartbeat en s", params.heartbeat, sizeof(params.heartbeat) - 1, "pattern='\\d{1,5}' title='5 chiffres maximum'");
 WiFiManagerParameter custom_checkbox_oled("oled_en", "OLED Activé", "true", 4, _oled_checkbox, WFM_LABEL_AFTER);
 
 // Fonction pour afficher les informations sur la connexion WiFi Mqtt ....
@@ -61,6 +66,9 @@ void Info() {
   Serial.println("[MES PARAMS] Mot de passe : " + String(params.pass_mon_serveur));
   Serial.println("[MES PARAMS] Données: " + String(params.data_mon_serveur));
   Serial.println("[NTP]Time Zone: " + String(params.timeZone));
+  Serial.println("[MES PARAMS] Politique d'envoi: " + String(params.politique));
+  Serial.println("[MES PARAMS] Heartbeat: " + String(params.heartbeat));
+  Serial.println("[MES PARAMS] Alarmes: " + String(params.alarmes));
   Serial.println(OLED ? "[OLED] activé" : "[OLED] désactivé");
 }
 
@@ -77,6 +85,11 @@ void saveCustomParameters() {
   strcpy(params.pass_mon_serveur, custom_pass.getValue());
   strcpy(params.data_mon_serveur, custom_data.getValue());
   strcpy(params.timeZone, custom_GMT.getValue());
+  strlcpy(params.politique, custom_politique.getValue(), sizeof(params.politique));
+  strlcpy(params.heartbeat, custom_heartbeat.getValue(), sizeof(params.heartbeat));
+  appliquerPolitiqueEnvoi(params.politique, params.heartbeat);
+  strlcpy(params.alarmes, custom_alarmes.getValue(), sizeof(params.alarmes));
+  appliquerAlarmes(params.alarmes);
    // Sauvegarder la valeur de la checkbox OLED
     const char* oled_value = custom_checkbox_oled.getValue();
     Serial.print("[SAVE]oled_value : ");
@@ -90,7 +103,8 @@ void saveCustomParameters() {
     String data = String(params.adr_mon_serveur) + "," + String(params.port_mon_serveur) + "," +
                   String(params.user_mon_serveur) + "," + String(params.pass_mon_serveur) + "," +
                   String(params.data_mon_serveur) + "," + String(params.timeZone) + "," +
-                  (OLED ? "1" : "0");
+                  (OLED ? "1" : "0") + "," + String(params.politique) + "," + String(params.heartbeat) + "," +
+                  String(params.alarmes);
     configFile.println(data);
     configFile.close();
     Serial.println("Paramètres sauvegardés dans SPIFFS.");
@@ -109,10 +123,11 @@ void restoreCustomParameters() {
             Serial.println(content);
 
             int lastComma = -1;
-            for (int i = 0; i < 7; i++) {
+            for (int i = 0; i < 10; i++) {
                 int nextComma = content.indexOf(',', lastComma + 1);
                 if (nextComma == -1) nextComma = content.length();
                 String param = content.substring(lastComma + 1, nextComma);
+                param.trim(); // Fin de ligne après le dernier paramètre
                 Serial.print("[RESTORE] Paramètre ");
                 Serial.print(i);
                 Serial.print(": ");
@@ -131,6 +146,10 @@ void restoreCustomParameters() {
                         Serial.println(OLED ? "1" : "0");
 
                         break;
+                    // Champs ajoutés après OLED : absents d'un ancien config.txt, les défauts sont gardés
+                    case 7: if (param.length() > 0) param.toCharArray(params.politique, sizeof(params.politique)); break;
+                    case 8: if (param.length() > 0) param.toCharArray(params.heartbeat, sizeof(params.heartbeat)); break;
+                    case 9: if (param.length() > 0) param.toCharArray(params.alarmes, sizeof(params.alarmes)); break;
                 }
                 lastComma = nextComma;
             }
@@ -143,6 +162,11 @@ void restoreCustomParameters() {
               custom_user.setValue(params.user_mon_serveur, 32);
               custom_pass.setValue(params.pass_mon_serveur, 32);
               custom_data.setValue(params.data_mon_serveur, 32);
+              custom_politique.setValue(params.politique, sizeof(params.politique) - 1);
+              custom_heartbeat.setValue(params.heartbeat, sizeof(params.heartbeat) - 1);
+              appliquerPolitiqueEnvoi(params.politique, params.heartbeat);
+              custom_alarmes.setValue(params.alarmes, sizeof(params.alarmes) - 1);
+              appliquerAlarmes(params.alarmes);
             // Charger la valeur de OLED à partir du fichier SPIFFS (dernier élément)
 
               if (OLED) {
@@ -186,6 +210,27 @@ void handleRouteEraseSpiffs() {
 // Attache des routes supplémentaires pour le serveur
 void bindServerCallback() {
   wm.server->on("/erasespiffs", handleRouteEraseSpiffs); // Route personnalisée
+  ajouterRoutesApi(*wm.server); // API en lecture seule (JSON et métriques Prometheus)
+}
+
+/**
+ * Serveur de l'API en mode station : seulement les routes en lecture de api_web. Les pages de
+ * configuration (paramètres, OTA, effacement, redémarrage) restent réservées au portail.
+ */
+static std::unique_ptr<ServeurWeb> serveurStation;
+
+static void demarrerServeurApi() {
+  serveurStation.reset(new ServeurWeb(80));
+  ajouterRoutesApi(*serveurStation);
+  serveurStation->begin();
+}
+
+// Libère le port 80 avant l'ouverture du portail, qui crée son propre serveur
+static void arreterServeurApi() {
+  if (serveurStation) {
+    serveurStation->stop();
+    serveurStation.reset();
+  }
 }
 
 // Callback pour gérer les mises à jour OTA
@@ -220,6 +265,9 @@ void wifi(void *pvParameters) {
   wm.addParameter(&custom_pass);
   wm.addParameter(&custom_data);
   wm.addParameter(&custom_GMT);
+  wm.addParameter(&custom_politique);
+  wm.addParameter(&custom_heartbeat);
+  wm.addParameter(&custom_alarmes);
   wm.addParameter(&custom_checkbox_oled);
 
   // Définir les callbacks pour différents événements
@@ -264,11 +312,19 @@ void wifi(void *pvParameters) {
 
   Info(); // Réafficher les infos après connexion
 
+  // Serveur gardé actif en mode station pour l'API et les métriques (sans point d'accès ni DNS)
+  if (API_SERVEUR_PERMANENT && WiFi.isConnected()) {
+    demarrerServeurApi();
+  }
+
   pinMode(ONDDEMANDPIN, INPUT_PULLUP); // Configurer le bouton en entrée avec pull-up
 
   for (;;) { // Boucle infinie pour gérer la configuration et le WiFi
-    if (!WMISBLOCKING) {
-      wm.process(); // Gérer les événements non-bloquants de WiFiManager
+    if (!WMISBLOCKING || wm.getWebPortalActive()) {
+      wm.process(); // Gérer les événements non-bloquants de WiFiManager et les requêtes du serveur web
+    }
+    if (serveurStation) {
+      serveurStation->handleClient(); // Sans effet avec WM_ASYNCWEBSERVER (tâche httpd)
     }
 
     // Gestion de la demande de portail via un bouton
@@ -287,6 +343,7 @@ void wifi(void *pvParameters) {
         }
 
         if (BUTTONFUNC == 1) {
+          arreterServeurApi(); // Le portail recrée son propre serveur
           if (!wm.startConfigPortal(IOTName, pwdportail)) {
             Serial.println("Échec du portail de configuration");
             delay(3000);
@@ -304,6 +361,10 @@ void wifi(void *pvParameters) {
         configPortail = false;
       }
     }
-    vTaskDelay(100); // Attendre avant de vérifier à nouveau
+#ifdef WM_ASYNCWEBSERVER
+    vTaskDelay(100); // Requêtes servies par la tâche httpd : la boucle ne surveille que le bouton et le portail
+#else
+    vTaskDelay(serveurStation || wm.getWebPortalActive() ? API_BOUCLE_MS : 100); // Attendre avant de vérifier à nouveau
+#endif
   }
 }
@@ -0,0 +1,48 @@
+/**
+ * @file tache_acquisition.cpp
+ * @brief Implémentation de la tâche d'acquisition commune à tous les capteurs.
+ * 
+ * Au lieu d'une tâche FreeRTOS (et d'une pile) par capteur, chaque pilote du registre
+ * (registre_capteurs.h) enregistre sa fonction de mesure et sa période auprès de
+ * l'ordonnanceur (roue temporelle).
+ * Les mesures qui tombent au même instant sont exécutées dans le même réveil.
+ */
+
+#include "taches/tache_acquisition.h"
+#include "variablesGlobales.h"
+#include "ordonnanceur.h"
+#include "acquisition_adc.h"
+#include "registre_capteurs.h"
+#include "alarmes.h"
+
+/**
+ * @brief Tâche FreeRTOS d'acquisition des capteurs.
+ * 
+ * Initialise les capteurs, enregistre leurs mesures périodiques puis exécute
+ * l'ordonnanceur (ne retourne jamais).
+ * 
+ * @param pvParameters Paramètre non utilisé, requis par le prototype de la fonction FreeRTOS.
+ */
+void tache_acquisition(void *pvParameters)
+{
+    // Initialisation des capteurs actifs du registre
+    initialiserPilotes(PilotesActifs{});
+
+    // Démarrage de l'ADC en mode continu pour toutes les voies analogiques déclarées
+    if (demarrerAcquisitionAdc()) {
+        ajouterTravail("Vidage DMA ADC", drainerAdc, ADC_VIDAGE_INTERVAL_MS, ADC_VIDAGE_INTERVAL_MS);
+    }
+
+    // Mesures périodiques et travaux annexes de chaque capteur (période, déphasage et
+    // priorité sont décrits dans registre_capteurs.h)
+    planifierPilotes(PilotesActifs{});
+
+    // Alarmes de défaut : canaux sans échantillon valide neuf (alarmes.h)
+    ajouterTravail("Surveillance capteurs", surveillerCapteurs, ALARMES_VERIFICATION_MS, ALARMES_VERIFICATION_MS);
+
+    // Rapport périodique des retards de l'ordonnanceur
+    ajouterTravail("Stats ordonnanceur", afficherStatsOrdonnanceur, ORDONNANCEUR_RAPPORT_MS, ORDONNANCEUR_RAPPORT_MS);
+    ajouterTravail("Stats bus I2C", afficherStatsBusI2c, I2C_RAPPORT_MS, I2C_RAPPORT_MS + ORDONNANCEUR_RESOLUTION_MS);
+
+    executerOrdonnanceur();
+}
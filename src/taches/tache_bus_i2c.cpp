@@ -0,0 +1,274 @@
+/**
+ * @file tache_bus_i2c.cpp
+ * @brief Implémentation de l'arbitre du bus I2C.
+ *
+ * Chaque client dépose un pointeur vers sa transaction (allouée sur sa pile) dans la file
+ * de sa priorité, signale le sémaphore de travail puis dort jusqu'à la notification de fin.
+ * La tâche du bus prend toujours la transaction en tête de la file la plus prioritaire.
+ *
+ * En cas d'erreur de bus (ligne SDA maintenue à 0 par un esclave interrompu au milieu d'un
+ * octet), les broches sont reprises temporairement en GPIO pour envoyer jusqu'à 9 impulsions
+ * d'horloge et une condition STOP, puis rendues au contrôleur : le pilote Wire n'est pas
+ * réinitialisé. Le redémarrage complet du contrôleur n'intervient qu'après
+ * I2C_ECHECS_AVANT_REINIT erreurs de bus consécutives.
+ */
+
+#include "taches/tache_bus_i2c.h"
+#include <Wire.h>
+#include <esp_timer.h>
+#include <driver/gpio.h>
+#include <esp_rom_gpio.h>
+#include <soc/gpio_sig_map.h>
+#include <soc/i2c_periph.h>
+
+// Transaction déposée par un client
+struct TransactionI2c {
+  uint8_t adresse;
+  const uint8_t *ecriture;
+  size_t longueurEcriture;
+  uint8_t *lecture;
+  size_t longueurLecture;
+  PrioriteI2c priorite;
+  TaskHandle_t client;          // Tâche à réveiller en fin de transaction
+  int64_t depot_us;             // Instant du dépôt (mesure de latence)
+  ResultatI2c resultat;
+  volatile bool terminee;
+};
+
+// Une file par priorité et un sémaphore compteur du nombre de transactions en attente
+static QueueHandle_t files[I2C_NB_PRIORITES] = {};
+static SemaphoreHandle_t semTransactions = NULL;
+
+// Statistiques, protégées par une section critique (lues depuis d'autres tâches)
+static portMUX_TYPE verrouStats = portMUX_INITIALIZER_UNLOCKED;
+static StatsBusI2c stats = {};
+static uint64_t sommeLatences_us[I2C_NB_PRIORITES] = {};
+static int64_t occupe_us = 0;
+static int64_t debutOccupation_us = 0;
+
+// Erreurs de bus consécutives (remise à zéro à la première transaction réussie)
+static uint8_t echecsConsecutifs = 0;
+
+void initBusI2c()
+{
+    Wire.begin(I2C_SDA_PIN, I2C_SCL_PIN, I2C_FREQUENCE_HZ);
+
+    for (int p = 0; p < I2C_NB_PRIORITES; p++) {
+        files[p] = xQueueCreate(I2C_FILE_PROFONDEUR, sizeof(TransactionI2c *));
+    }
+    semTransactions = xSemaphoreCreateCounting(I2C_FILE_PROFONDEUR * I2C_NB_PRIORITES, 0);
+    debutOccupation_us = esp_timer_get_time();
+}
+
+/**
+ * @brief Libère un bus dont la ligne SDA est maintenue à 0 par un esclave.
+ *
+ * @return true si les deux lignes sont revenues à l'état de repos.
+ */
+static bool debloquerBus()
+{
+    const gpio_num_t sda = (gpio_num_t)I2C_SDA_PIN;
+    const gpio_num_t scl = (gpio_num_t)I2C_SCL_PIN;
+    if (gpio_get_level(sda) == 1 && gpio_get_level(scl) == 1) {
+        return true;
+    }
+
+    // Les broches (déjà en drain ouvert) sont pilotées directement le temps du déblocage
+    esp_rom_gpio_connect_out_signal(scl, SIG_GPIO_OUT_IDX, false, false);
+    esp_rom_gpio_connect_out_signal(sda, SIG_GPIO_OUT_IDX, false, false);
+    gpio_set_level(sda, 1);
+    gpio_set_level(scl, 1);
+
+    // Jusqu'à 9 impulsions : l'esclave termine l'octet en cours et relâche SDA
+    for (int i = 0; i < 9 && gpio_get_level(sda) == 0; i++) {
+        gpio_set_level(scl, 0);
+        delayMicroseconds(5);
+        gpio_set_level(scl, 1);
+        delayMicroseconds(5);
+    }
+
+    // Condition STOP (SDA monte pendant que SCL est à 1)
+    gpio_set_level(scl, 0);
+    delayMicroseconds(5);
+    gpio_set_level(sda, 0);
+    delayMicroseconds(5);
+    gpio_set_level(scl, 1);
+    delayMicroseconds(5);
+    gpio_set_level(sda, 1);
+    delayMicroseconds(5);
+
+    // Les broches sont rendues au contrôleur I2C
+    esp_rom_gpio_connect_out_signal(scl, i2c_periph_signal[I2C_NUM_0].scl_out_sig, false, false);
+    esp_rom_gpio_connect_out_signal(sda, i2c_periph_signal[I2C_NUM_0].sda_out_sig, false, false);
+    return gpio_get_level(sda) == 1 && gpio_get_level(scl) == 1;
+}
+
+/**
+ * @brief Exécute une transaction avec la bibliothèque Wire.
+ */
+static ResultatI2c executerTransaction(const TransactionI2c &t)
+{
+    if (t.longueurEcriture > 0) {
+        Wire.beginTransmission(t.adresse);
+        Wire.write(t.ecriture, t.longueurEcriture);
+        // Pas de STOP si une lecture suit : redémarrage direct
+        const uint8_t erreur = Wire.endTransmission(t.longueurLecture == 0);
+        if (erreur == 2 || erreur == 3) {
+            return I2C_ERREUR_NACK;
+        }
+        if (erreur != 0) {
+            return I2C_ERREUR_BUS;
+        }
+    }
+
+    if (t.longueurLecture > 0) {
+        const size_t recus = Wire.requestFrom((uint16_t)t.adresse, t.longueurLecture, true);
+        if (recus != t.longueurLecture) {
+            // Une lecture refusée laisse le bus au repos ; sinon le bus est bloqué
+            const bool auRepos = gpio_get_level((gpio_num_t)I2C_SDA_PIN) == 1 &&
+                                 gpio_get_level((gpio_num_t)I2C_SCL_PIN) == 1;
+            return recus == 0 && auRepos ? I2C_ERREUR_NACK : I2C_ERREUR_BUS;
+        }
+        Wire.readBytes(t.lecture, t.longueurLecture);
+    }
+    return I2C_OK;
+}
+
+/**
+ * @brief Traite une erreur de bus : déblocage, puis redémarrage du contrôleur en dernier recours.
+ */
+static void traiterErreurBus()
+{
+    const bool libere = debloquerBus();
+    portENTER_CRITICAL(&verrouStats);
+    stats.deblocages++;
+    portEXIT_CRITICAL(&verrouStats);
+
+    if (libere && ++echecsConsecutifs < I2C_ECHECS_AVANT_REINIT) {
+        return;
+    }
+
+    Serial.println("[I2C] Bus bloque : redemarrage du controleur");
+    Wire.end();
+    Wire.begin(I2C_SDA_PIN, I2C_SCL_PIN, I2C_FREQUENCE_HZ);
+    echecsConsecutifs = 0;
+    portENTER_CRITICAL(&verrouStats);
+    stats.reinitialisations++;
+    portEXIT_CRITICAL(&verrouStats);
+}
+
+void tache_bus_i2c(void *pvParameters)
+{
+    for (;;) {
+        xSemaphoreTake(semTransactions, portMAX_DELAY);
+
+        // Transaction la plus prioritaire
+        TransactionI2c *t = NULL;
+        for (int p = 0; p < I2C_NB_PRIORITES && t == NULL; p++) {
+            xQueueReceive(files[p], &t, 0);
+        }
+        if (t == NULL) {
+            continue;
+        }
+
+        const int64_t debut_us = esp_timer_get_time();
+        t->resultat = executerTransaction(*t);
+        const int64_t fin_us = esp_timer_get_time();
+
+        const uint32_t latence_us = (uint32_t)(fin_us - t->depot_us);
+        const PrioriteI2c p = t->priorite;
+        portENTER_CRITICAL(&verrouStats);
+        occupe_us += fin_us - debut_us;
+        stats.transactions[p]++;
+        sommeLatences_us[p] += latence_us;
+        stats.latenceMoyenne_us[p] = (uint32_t)(sommeLatences_us[p] / stats.transactions[p]);
+        if (latence_us > stats.latenceMax_us[p]) stats.latenceMax_us[p] = latence_us;
+        if (t->resultat != I2C_OK) stats.erreurs++;
+        portEXIT_CRITICAL(&verrouStats);
+
+        const ResultatI2c resultat = t->resultat;
+        const TaskHandle_t client = t->client;
+        t->terminee = true;      // La transaction peut disparaître dès cet instant
+        xTaskNotifyGive(client);
+
+        if (resultat == I2C_ERREUR_BUS) {
+            traiterErreurBus();
+        } else if (resultat == I2C_OK) {
+            echecsConsecutifs = 0;
+        }
+    }
+}
+
+/**
+ * @brief Dépose une transaction et attend son exécution par la tâche du bus.
+ */
+static ResultatI2c soumettre(TransactionI2c &t)
+{
+    if (semTransactions == NULL) {
+        return I2C_ERREUR_FILE;
+    }
+    if (t.longueurEcriture > I2C_BUFFER_LENGTH || t.longueurLecture > I2C_BUFFER_LENGTH) {
+        return I2C_ERREUR_TAILLE;
+    }
+
+    t.client = xTaskGetCurrentTaskHandle();
+    t.depot_us = esp_timer_get_time();
+    t.terminee = false;
+
+    TransactionI2c *pt = &t;
+    if (xQueueSend(files[t.priorite], &pt, pdMS_TO_TICKS(I2C_DELAI_FILE_MS)) != pdTRUE) {
+        return I2C_ERREUR_FILE;
+    }
+    xSemaphoreGive(semTransactions);
+
+    // La tâche du bus termine toujours la transaction (Wire a son propre délai maximal)
+    while (!t.terminee) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    }
+    return t.resultat;
+}
+
+ResultatI2c ecrireI2c(uint8_t adresse, const uint8_t *donnees, size_t longueur, PrioriteI2c priorite)
+{
+    TransactionI2c t = { adresse, donnees, longueur, NULL, 0, priorite };
+    return soumettre(t);
+}
+
+ResultatI2c lireI2c(uint8_t adresse, uint8_t *donnees, size_t longueur, PrioriteI2c priorite)
+{
+    TransactionI2c t = { adresse, NULL, 0, donnees, longueur, priorite };
+    return soumettre(t);
+}
+
+ResultatI2c ecrireLireI2c(uint8_t adresse, const uint8_t *ecriture, size_t longueurEcriture,
+                          uint8_t *lecture, size_t longueurLecture, PrioriteI2c priorite)
+{
+    TransactionI2c t = { adresse, ecriture, longueurEcriture, lecture, longueurLecture, priorite };
+    return soumettre(t);
+}
+
+void lireStatsBusI2c(StatsBusI2c &copie)
+{
+    const int64_t maintenant = esp_timer_get_time();
+    portENTER_CRITICAL(&verrouStats);
+    const int64_t ecoule_us = maintenant - debutOccupation_us;
+    stats.occupation_pourcent = ecoule_us > 0 ? (uint8_t)(occupe_us * 100 / ecoule_us) : 0;
+    copie = stats;
+    occupe_us = 0;
+    debutOccupation_us = maintenant;
+    portEXIT_CRITICAL(&verrouStats);
+}
+
+void afficherStatsBusI2c()
+{
+    StatsBusI2c s;
+    lireStatsBusI2c(s);
+    Serial.printf("[I2C] occupation=%u%% | capteurs n=%u lat moy=%u us max=%u us | affichage n=%u lat moy=%u us max=%u us\n",
+                  s.occupation_pourcent,
+                  s.transactions[I2C_PRIORITE_CAPTEUR], s.latenceMoyenne_us[I2C_PRIORITE_CAPTEUR],
+                  s.latenceMax_us[I2C_PRIORITE_CAPTEUR],
+                  s.transactions[I2C_PRIORITE_AFFICHAGE], s.latenceMoyenne_us[I2C_PRIORITE_AFFICHAGE],
+                  s.latenceMax_us[I2C_PRIORITE_AFFICHAGE]);
+    Serial.printf("[I2C] erreurs=%u deblocages=%u reinitialisations=%u\n",
+                  s.erreurs, s.deblocages, s.reinitialisations);
+}
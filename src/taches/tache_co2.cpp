@@ -8,129 +8,144 @@
  * d'autres tâches (comme l'affichage OLED ou l'envoi via MQTT).
  * 
  * La compensation de l'humidité est effectuée à partir des données du capteur DHT22
- * pour améliorer la précision des mesures de eCO2 et TVOC.
+ * pour améliorer la précision des mesures de eCO2 et TVOC, à chaque changement
+ * significatif de la température ou de l'humidité.
  */
 
 #include "taches/tache_co2.h"
-#include <Wire.h>
+#include "variablesGlobales.h"
+#include "humidite_absolue.h"
+#include <esp_timer.h>
 
-// Instance du capteur SGP30
-Adafruit_SGP30 sgp30;
+#if CAPTEUR_SGP30_ACTIF  // Pilote retiré de la compilation si le capteur est désactivé
 
-// Variable globale pour stocker la valeur de CO2 équivalent (eCO2 en ppm)
-volatile uint16_t co2 = 0;
-
-// Variable globale pour stocker la valeur de TVOC (en ppb)
-volatile uint16_t tvoc = 0;
-
-// Nom du capteur CO2
-const char* Nom_co2 = "CO2"; // Capteur de CO2 (SGP30)
+// Instance du capteur SGP30 (accès au bus par l'arbitre I2C)
+CapteurSgp30 sgp30;
 
 // Indicateur d'état du capteur
 static bool sgp30_ok = false;
 
+// Espace NVS de la baseline IAQ (clés "eco2", "tvoc" et "epoch" de sauvegarde)
+static Preferences prefsSgp30;
+
+// État de la baseline IAQ exposé en télémétrie
+static EtatBaselineSgp30 etatBaseline = { false, false, 0, 0, -1 };
+
+// Epoch de la baseline sauvegardée (0 = aucune)
+static time_t epochBaseline = 0;
+
+// millis() du dernier IAQinit() et de la dernière sauvegarde
+static uint32_t debutIAQ = 0;
+static uint32_t derniereSauvegarde = 0;
+static bool sauvegardeFaite = false;
+
+// Restauration différée tant que l'heure NTP n'est pas connue (âge de la baseline incalculable)
+static bool restaurationEnAttente = false;
+
+// Histogramme de la gigue des périodes de mesure : classes de 250 µs, la dernière regroupe le reste
+static const uint32_t CADENCE_CLASSE_US = 250;
+static const uint32_t CADENCE_NB_CLASSES = 128;
+
+// Statistiques de cadence des appels à IAQmeasure()
+static struct {
+  uint32_t nombre;
+  int64_t sommePeriodes_us;
+  uint32_t gigueMax_us;
+  uint32_t histogramme[CADENCE_NB_CLASSES];
+} cadence = {};
+
+// Instant de la mesure précédente (0 = pas de mesure précédente)
+static int64_t instantPrecedent_us = 0;
+
+// Nombre d'échecs de IAQmeasure()
+static uint32_t erreursMesure = 0;
+
+// Dernière compensation d'humidité envoyée au SGP30 (valeurs en dixièmes de °C et de %)
+static struct {
+  bool appliquee;       // false : la prochaine trame DHT22 est envoyée sans condition
+  int16_t temperature;
+  int16_t humidite;
+  uint16_t valeur8_8;
+} compensation = {};
+
 /**
- * @brief Calcule l'humidité absolue à partir de la température et de l'humidité relative.
- * 
- * Cette fonction convertit l'humidité relative (%) et la température (°C) en humidité
- * absolue (g/m³), puis la formate au format attendu par le SGP30 (8.8 fixed point).
+ * @brief Lit l'heure courante si elle a été synchronisée par NTP.
  * 
- * Formule utilisée: humidité absolue = (humidité relative / 100) * 6.112 * exp((17.62 * T) / (243.12 + T)) * 216.7 / (273.15 + T)
+ * @param epoch Heure courante en secondes depuis 1970 (sortie)
+ * @return true si l'heure est synchronisée.
+ */
+static bool epochActuelle(time_t &epoch)
+{
+    const Horodatage h = lireHorodatage();
+    epoch = h.ms / 1000;
+    return h.epoch;
+}
+
+/**
+ * @brief Restaure la baseline IAQ sauvegardée en NVS si elle est assez récente.
  * 
- * @param temperature Température en degrés Celsius
- * @param humidite Humidité relative en pourcentage (0-100%)
- * @return Humidité absolue au format 8.8 fixed point pour le SGP30
+ * Après un IAQinit(), le SGP30 repart d'une baseline par défaut et a besoin de 12 h
+ * pour la recalibrer. Restaurer une baseline de moins de SGP30_BASELINE_AGE_MAX_S rend
+ * les mesures eCO2/TVOC fiables en quelques secondes. Si l'heure n'est pas encore connue,
+ * la restauration est différée (voir gererBaselineSgp30).
  */
-uint32_t getAbsoluteHumidity(float temperature, float humidite) 
+static void restaurerBaselineSgp30()
 {
-    // Constantes pour le calcul de la pression de vapeur saturante (formule de Magnus)
-    const float A = 17.62f;
-    const float B = 243.12f;
-    
-    // Calcul de l'humidité absolue en g/m³
-    // Formule: AH = (RH/100) * 6.112 * exp((A*T)/(B+T)) * 216.7 / (273.15+T)
-    float absHumidity = (humidite / 100.0f) * 6.112f * 
-                        exp((A * temperature) / (B + temperature)) * 
-                        216.7f / (273.15f + temperature);
-    
-    // Conversion au format 8.8 fixed point (8 bits entiers, 8 bits décimaux)
-    // Multiplier par 256 pour décaler de 8 bits
-    uint32_t absoluteHumidity = (uint32_t)(absHumidity * 256.0f);
-    
-    // Limiter la valeur maximale (le SGP30 accepte max 255.99 g/m³)
-    if (absoluteHumidity > 0xFFFF) {
-        absoluteHumidity = 0xFFFF;
+    time_t maintenant;
+    if (!epochActuelle(maintenant)) {
+        restaurationEnAttente = true;
+        return;
     }
-    
-    return absoluteHumidity;
+    restaurationEnAttente = false;
+
+    prefsSgp30.begin("sgp30", true);
+    const uint16_t eco2 = prefsSgp30.getUShort("eco2", 0);
+    const uint16_t tvoc = prefsSgp30.getUShort("tvoc", 0);
+    epochBaseline = (time_t)prefsSgp30.getLong64("epoch", 0);
+    prefsSgp30.end();
+
+    if (epochBaseline == 0) {
+        Serial.println("SGP30 - Aucune baseline sauvegardee, calibration complete necessaire");
+        return;
+    }
+
+    etatBaseline.age_s = (int32_t)(maintenant - epochBaseline);
+    if (etatBaseline.age_s < 0 || etatBaseline.age_s > SGP30_BASELINE_AGE_MAX_S) {
+        Serial.print("SGP30 - Baseline sauvegardee trop ancienne (s): ");
+        Serial.println(etatBaseline.age_s);
+        return;
+    }
+
+    if (!sgp30.setIAQBaseline(eco2, tvoc)) {
+        Serial.println("SGP30 - Erreur de restauration de la baseline");
+        return;
+    }
+
+    etatBaseline.eco2 = eco2;
+    etatBaseline.tvoc = tvoc;
+    etatBaseline.restauree = true;
+    etatBaseline.valide = true;
+    Serial.printf("SGP30 - Baseline restauree: eCO2=0x%04X TVOC=0x%04X (age %d s)\n",
+                  eco2, tvoc, etatBaseline.age_s);
 }
 
 /**
  * @brief Initialise le capteur SGP30.
  * 
- * Cette fonction doit être appelée avant de démarrer la tâche tache_co2.
- * Elle initialise la communication I2C avec le capteur SGP30 et vérifie sa présence.
+ * Cette fonction doit être appelée avant la première mesure (mesurerCo2).
+ * Elle vérifie la présence du capteur SGP30 (numéro de série et type de produit)
+ * puis démarre l'algorithme IAQ.
  * 
  * @return true si l'initialisation a réussi, false sinon.
  */
 bool initSGP30()
 {
-    // Note: Wire.begin(8, 9) est appelé UNE SEULE FOIS dans main.cpp setup()
-    // Ne jamais réappeler Wire.begin() ici !
-    
-    // Scan I2C pour diagnostic
-    Serial.println("Scan I2C en cours...");
-    byte count = 0;
-    for (byte i = 1; i < 127; i++) {
-        Wire.beginTransmission(i);
-        if (Wire.endTransmission() == 0) {
-            Serial.print("Peripherique I2C trouve a l'adresse 0x");
-            if (i < 16) Serial.print("0");
-            Serial.println(i, HEX);
-            count++;
-        }
-    }
-    Serial.print("Nombre de peripheriques I2C trouves: ");
-    Serial.println(count);
-    
-    // Délai pour stabiliser le bus I2C après le scan
-    delay(500);
-    
-    // Test de communication directe avec le SGP30 à l'adresse 0x58
-    Wire.beginTransmission(0x58);
-    byte error = Wire.endTransmission();
-    if (error != 0) {
-        Serial.print("Erreur communication I2C avec SGP30: ");
-        Serial.println(error);
+    // Le bus est détenu par la tâche du bus I2C : pas de scan ni de réinitialisation de Wire ici
+    if (!sgp30.begin()) {
+        Serial.println("Erreur: Capteur SGP30 non detecte (0x58) !");
         sgp30_ok = false;
         return false;
     }
-    Serial.println("Communication I2C avec SGP30 OK (0x58)");
-    
-    // Réinitialiser Wire avec les bonnes broches avant sgp30.begin()
-    // car la bibliothèque Adafruit peut appeler Wire.begin() sans paramètres
-    Wire.end();
-    delay(100);
-    Wire.begin(8, 9);
-    delay(100);
-    
-    // Tentative d'initialisation du capteur SGP30
-    if (!sgp30.begin()) {
-        Serial.println("Erreur: sgp30.begin() a echoue !");
-        Serial.println("Tentative avec Wire explicite...");
-        
-        // Réessayer avec Wire explicite
-        Wire.end();
-        delay(100);
-        Wire.begin(8, 9);
-        delay(100);
-        
-        if (!sgp30.begin(&Wire)) {
-            Serial.println("Erreur: Capteur SGP30 non initialise !");
-            sgp30_ok = false;
-            return false;
-        }
-    }
     
     Serial.print("SGP30 trouvé - Numéro de série: ");
     Serial.print(sgp30.serialnumber[0], HEX);
@@ -148,127 +163,235 @@ bool initSGP30()
     
     Serial.println("SGP30 initialise avec succes !");
     sgp30_ok = true;
+
+    // IAQinit() efface la compensation : elle sera renvoyée à la prochaine trame du DHT22
+    compensation.appliquee = false;
+
+    // Nouvelle calibration : reprise de la baseline sauvegardée si possible
+    debutIAQ = millis();
+    etatBaseline.valide = false;
+    etatBaseline.restauree = false;
+    restaurerBaselineSgp30();
     return true;
 }
 
 /**
- * @brief Tâche FreeRTOS dédiée à la gestion du capteur SGP30.
+ * @brief Gestion périodique de la baseline IAQ du SGP30.
+ * 
+ * - termine une restauration différée dès que l'heure NTP est connue ;
+ * - déclare la baseline fiable après SGP30_BASELINE_CALIBRATION_S de fonctionnement ;
+ * - sauvegarde la baseline fiable en NVS toutes les SGP30_BASELINE_SAUVEGARDE_S avec son epoch.
+ * 
+ * Appelée par l'ordonnanceur toutes les `SGP30_BASELINE_INTERVAL_MS`.
+ */
+void gererBaselineSgp30()
+{
+    if (!sgp30_ok) {
+        return;
+    }
+
+    if (restaurationEnAttente) {
+        restaurerBaselineSgp30();
+    }
+
+    if (!etatBaseline.valide && millis() - debutIAQ >= SGP30_BASELINE_CALIBRATION_S * 1000UL) {
+        etatBaseline.valide = true;
+        Serial.println("SGP30 - Calibration de la baseline terminee");
+    }
+
+    uint16_t eco2, tvoc;
+    if (!sgp30.getIAQBaseline(&eco2, &tvoc)) {
+        Serial.println("SGP30 - Erreur de lecture de la baseline");
+        return;
+    }
+    etatBaseline.eco2 = eco2;
+    etatBaseline.tvoc = tvoc;
+
+    time_t maintenant;
+    const bool heureConnue = epochActuelle(maintenant);
+    if (etatBaseline.valide && heureConnue &&
+        (!sauvegardeFaite || millis() - derniereSauvegarde >= SGP30_BASELINE_SAUVEGARDE_S * 1000UL)) {
+        prefsSgp30.begin("sgp30", false);
+        prefsSgp30.putUShort("eco2", eco2);
+        prefsSgp30.putUShort("tvoc", tvoc);
+        prefsSgp30.putLong64("epoch", (int64_t)maintenant);
+        prefsSgp30.end();
+
+        epochBaseline = maintenant;
+        derniereSauvegarde = millis();
+        sauvegardeFaite = true;
+        Serial.printf("SGP30 - Baseline sauvegardee: eCO2=0x%04X TVOC=0x%04X\n", eco2, tvoc);
+    }
+
+    etatBaseline.age_s = (heureConnue && epochBaseline != 0) ? (int32_t)(maintenant - epochBaseline) : -1;
+}
+
+void lireEtatBaselineSgp30(EtatBaselineSgp30 &etat)
+{
+    etat = etatBaseline;
+}
+
+/**
+ * @brief Enregistre l'instant d'une mesure IAQ dans les statistiques de cadence.
+ * 
+ * @param instant_us Instant de l'appel à IAQmeasure() (esp_timer_get_time)
+ */
+static void enregistrerCadence(int64_t instant_us)
+{
+    if (instantPrecedent_us != 0) {
+        const int64_t periode_us = instant_us - instantPrecedent_us;
+        const int64_t ecart_us = periode_us - (int64_t)CO2_INTERVAL_MS * 1000;
+        const uint32_t gigue_us = (uint32_t)(ecart_us < 0 ? -ecart_us : ecart_us);
+
+        cadence.nombre++;
+        cadence.sommePeriodes_us += periode_us;
+        if (gigue_us > cadence.gigueMax_us) cadence.gigueMax_us = gigue_us;
+        const uint32_t classe = gigue_us / CADENCE_CLASSE_US;
+        cadence.histogramme[classe < CADENCE_NB_CLASSES ? classe : CADENCE_NB_CLASSES - 1]++;
+    }
+    instantPrecedent_us = instant_us;
+}
+
+void lireStatsCadenceCo2(StatsCadenceCo2 &stats)
+{
+    stats.nombre = cadence.nombre;
+    stats.gigueMax_us = cadence.gigueMax_us;
+    stats.periodeMoyenne_us = cadence.nombre ? (uint32_t)(cadence.sommePeriodes_us / cadence.nombre) : 0;
+
+    // 99e centile de la gigue : borne haute de la classe qui atteint 99 % des périodes
+    stats.gigueP99_us = 0;
+    const uint32_t seuil = cadence.nombre - cadence.nombre / 100;
+    uint32_t cumul = 0;
+    for (uint32_t c = 0; c < CADENCE_NB_CLASSES && cadence.nombre; c++) {
+        cumul += cadence.histogramme[c];
+        if (cumul >= seuil) {
+            stats.gigueP99_us = (c + 1) * CADENCE_CLASSE_US;
+            break;
+        }
+    }
+}
+
+/**
+ * @brief Mesure du capteur SGP30 (chemin critique à 1 Hz).
  * 
- * Cette tâche lit les valeurs de CO2 équivalent (eCO2) et de TVOC depuis le capteur SGP30
- * et met à jour les variables globales `co2` (eCO2) et `tvoc`.
- * La compensation de l'humidité est effectuée à partir des données du DHT22 pour
- * améliorer la précision des mesures.
- * La tâche est configurée pour se mettre en veille pendant un certain intervalle 
- * de temps (défini par `CO2_INTERVAL_MS`) avant de mettre à jour à nouveau les valeurs.
+ * Cette fonction lit les valeurs de CO2 équivalent (eCO2) et de TVOC depuis le capteur SGP30
+ * et les publie dans le magasin de mesures (canaux `CANAL_CO2` et `CANAL_TVOC`).
+ * Elle est appelée par l'ordonnanceur toutes les `CO2_INTERVAL_MS`, sur des échéances
+ * absolues et en priorité sur les autres travaux du même top ; la première mesure
+ * est déphasée pour que le DHT22 ait déjà publié un couple température/humidité.
+ * Le travail annexe (valeurs brutes, affichage série) est fait par d'autres travaux
+ * décalés d'une demi-période pour ne pas retarder la mesure ; la compensation d'humidité
+ * est appliquée à la publication des trames du DHT22.
  * 
  * Note: Le SGP30 doit être interrogé au moins toutes les secondes pour maintenir
  * l'algorithme de calibration interne.
- * 
- * @param pvParameters Paramètre non utilisé, requis par le prototype de la fonction FreeRTOS.
  */
-void tache_co2(void *pvParameters)
+void mesurerCo2()
 {
-    // Attendre que la tâche DHT22 ait effectué sa première mesure valide
-    Serial.println("CO2 - Attente des donnees temperature/humidite du DHT22...");
-    
-    // Attendre que le sémaphore soit créé par la tâche DHT22
-    while (xSemaphoreTempHumReady == NULL) {
-        Serial.println("CO2 - Attente de la creation du semaphore...");
-        vTaskDelay(pdMS_TO_TICKS(500));
+    if (!sgp30_ok) {
+        // Si le capteur n'est pas initialisé, afficher un message d'erreur
+        Serial.println("SGP30 non initialise - tentative de reinitialisation...");
+        instantPrecedent_us = 0;   // La réinitialisation interrompt la cadence
+        initSGP30();
+        return;
     }
-    
-    // Attendre le sémaphore avec un timeout de 30 secondes
-    if (xSemaphoreTake(xSemaphoreTempHumReady, pdMS_TO_TICKS(30000)) == pdTRUE) {
-        Serial.println("CO2 - Donnees DHT22 disponibles, demarrage des mesures CO2");
-        // Redonner le sémaphore pour d'autres tâches éventuelles
-        xSemaphoreGive(xSemaphoreTempHumReady);
+
+    // Lecture des mesures IAQ (eCO2 et TVOC)
+    enregistrerCadence(esp_timer_get_time());
+    if (sgp30.IAQmeasure()) {
+        // Publication des deux valeurs d'une même mesure
+        static const CanalMesure canaux[2] = { CANAL_CO2, CANAL_TVOC };
+        const float valeurs[2] = { (float)sgp30.eCO2,    // eCO2 en ppm (400-60000)
+                                   (float)sgp30.TVOC };  // TVOC en ppb (0-60000)
+        publierMesures(canaux, valeurs, 2);
     } else {
-        Serial.println("CO2 - Timeout en attendant DHT22, demarrage quand meme...");
+        invaliderMesure(CANAL_CO2);
+        invaliderMesure(CANAL_TVOC);
+        erreursMesure++;
     }
-    
-    // Initialisation du SGP30 après avoir reçu les données du DHT22
-    initSGP30();
-    
-    // Appliquer immédiatement la compensation d'humidité avec les valeurs du DHT22
-    if (sgp30_ok && !isnan(temperature) && !isnan(humidite)) {
-        uint32_t absHumidity = getAbsoluteHumidity(temperature, humidite);
-        sgp30.setHumidity(absHumidity);
-        Serial.print("CO2 - Compensation initiale appliquee: T=");
-        Serial.print(temperature);
-        Serial.print("C, H=");
-        Serial.print(humidite);
-        Serial.print("%, AH=");
-        Serial.print(absHumidity / 256.0f, 2);
-        Serial.println(" g/m3");
+}
+
+/**
+ * @brief Compensation de l'humidité du SGP30 pilotée par les publications du DHT22.
+ * 
+ * Abonnée au magasin de mesures par la tâche d'acquisition, elle ne traite que les couples température/humidité
+ * d'une même trame. L'humidité absolue n'est recalculée (table de Magnus en virgule fixe)
+ * que si T ou HR sortent de la bande morte autour des dernières valeurs appliquées, et la
+ * commande I2C n'est envoyée que si la valeur 8.8 résultante a changé.
+ * Exécutée dans la tâche d'acquisition, comme les autres accès au SGP30.
+ */
+void compenserHumiditeSgp30(const CanalMesure canaux[], const float valeurs[], size_t nb, const Horodatage &)
+{
+    if (nb != 2 || canaux[0] != CANAL_TEMPERATURE || canaux[1] != CANAL_HUMIDITE || !sgp30_ok) {
+        return;
+    }
+
+    // Valeurs en dixièmes (résolution du DHT22)
+    const int16_t temperature = (int16_t)lroundf(valeurs[0] * 10.0f);
+    const int16_t humidite = (int16_t)lroundf(valeurs[1] * 10.0f);
+    if (temperature <= HUMIDITE_TEMP_MIN_DIXIEMES || temperature >= HUMIDITE_TEMP_MAX_DIXIEMES ||
+        humidite < 0 || humidite > 1000) {
+        return;
+    }
+
+    if (compensation.appliquee &&
+        abs(temperature - compensation.temperature) < SGP30_BANDE_MORTE_TEMP_DIXIEMES &&
+        abs(humidite - compensation.humidite) < SGP30_BANDE_MORTE_HUM_DIXIEMES) {
+        return;
+    }
+    compensation.temperature = temperature;
+    compensation.humidite = humidite;
+
+    const uint16_t absHumidity = humiditeAbsolue8_8(temperature, humidite);
+    if (compensation.appliquee && absHumidity == compensation.valeur8_8) {
+        return;
+    }
+
+    if (!sgp30.setHumidity(absHumidity)) {
+        Serial.println("SGP30 - Erreur d'envoi de la compensation d'humidite");
+        compensation.appliquee = false;
+        return;
+    }
+    compensation.valeur8_8 = absHumidity;
+    compensation.appliquee = true;
+
+    Serial.printf("SGP30 - Compensation humidite appliquee: T=%.1fC, H=%.1f%%, AH=%.2f g/m3\n",
+                  valeurs[0], valeurs[1], absHumidity / 256.0f);
+}
+
+/**
+ * @brief Diagnostic du SGP30 (hors chemin critique).
+ * 
+ * Affiche les dernières mesures, les valeurs brutes (H2 et Ethanol), utiles pour le
+ * diagnostic et la calibration, et les statistiques de cadence des mesures.
+ * Appelée par l'ordonnanceur toutes les `SGP30_DIAGNOSTIC_INTERVAL_MS`.
+ */
+void diagnostiquerSgp30()
+{
+    if (!sgp30_ok) {
+        return;
     }
-    
-    // Compteur pour la calibration et la mise à jour de l'humidité
-    static uint32_t counter = 0;
-    
-    // Boucle infinie de la tâche
-    for (;;)
-    {
-        if (sgp30_ok) {
-            // Compensation de l'humidité toutes les 10 mesures (environ 10 secondes)
-            // Utilise les valeurs de température et humidité du DHT22
-            if (counter % 10 == 0) {
-                // Vérifier que les valeurs du DHT22 sont valides
-                if (!isnan(temperature) && !isnan(humidite) && 
-                    temperature > -40.0f && temperature < 85.0f &&
-                    humidite >= 0.0f && humidite <= 100.0f) {
-                    
-                    // Calcul de l'humidité absolue au format 8.8 fixed point
-                    uint32_t absHumidity = getAbsoluteHumidity(temperature, humidite);
-                    
-                    // Envoi de la compensation au SGP30
-                    sgp30.setHumidity(absHumidity);
-                    
-                    Serial.print("SGP30 - Compensation humidite appliquee: T=");
-                    Serial.print(temperature);
-                    Serial.print("C, H=");
-                    Serial.print(humidite);
-                    Serial.print("%, AH=");
-                    Serial.print(absHumidity / 256.0f, 2);
-                    Serial.println(" g/m3");
-                }
-            }
-            
-            // Lecture des mesures IAQ (eCO2 et TVOC)
-            if (sgp30.IAQmeasure()) {
-                // Mise à jour des variables globales avec les nouvelles valeurs
-                co2 = sgp30.eCO2;  // eCO2 en ppm (400-60000)
-                tvoc = sgp30.TVOC;      // TVOC en ppb (0-60000)
-                
-                // Affichage de debug (peut être désactivé en production)
-                Serial.print("eCO2: ");
-                Serial.print(co2);
-                Serial.print(" ppm\t TVOC: ");
-                Serial.print(tvoc);
-                Serial.println(" ppb");
-            } else {
-                Serial.println("Erreur de lecture du SGP30 !");
-            }
-            
-            // Optionnel: Récupération des valeurs brutes (H2 et Ethanol)
-            // Utile pour le diagnostic et la calibration
-            if (counter % 30 == 0) {  // Toutes les 30 mesures
-                if (sgp30.IAQmeasureRaw()) {
-                    Serial.print("H2 brut: ");
-                    Serial.print(sgp30.rawH2);
-                    Serial.print(" \t Ethanol brut: ");
-                    Serial.println(sgp30.rawEthanol);
-                }
-            }
-            
-            counter++;
-        } else {
-            // Si le capteur n'est pas initialisé, afficher un message d'erreur
-            Serial.println("SGP30 non initialise - tentative de reinitialisation...");
-            initSGP30();
-        }
 
-        // Temporisation de la tâche avant la prochaine mesure
-        // Note: Le SGP30 recommande une lecture toutes les secondes pour la calibration
-        vTaskDelay(CO2_INTERVAL_MS / portTICK_PERIOD_MS);
+    const EntreeMesure eco2 = lireMesure(CANAL_CO2);
+    const EntreeMesure tvoc = lireMesure(CANAL_TVOC);
+    Serial.print("eCO2: ");
+    Serial.print((int)eco2.valeur);
+    Serial.print(" ppm\t TVOC: ");
+    Serial.print((int)tvoc.valeur);
+    Serial.print(" ppb\t erreurs: ");
+    Serial.println(erreursMesure);
+
+    if (sgp30.IAQmeasureRaw()) {
+        Serial.print("H2 brut: ");
+        Serial.print(sgp30.rawH2);
+        Serial.print(" \t Ethanol brut: ");
+        Serial.println(sgp30.rawEthanol);
     }
+
+    StatsCadenceCo2 stats;
+    lireStatsCadenceCo2(stats);
+    Serial.printf("SGP30 - Cadence: n=%u periode moy=%u us | gigue p99<=%u us max=%u us\n",
+                  stats.nombre, stats.periodeMoyenne_us, stats.gigueP99_us, stats.gigueMax_us);
 }
+
+#endif // CAPTEUR_SGP30_ACTIF
@@ -0,0 +1,907 @@
+/**
+ * @file tache_envoi.cpp
+ * @brief Implémentation de la tâche d'envoi des mesures vers le serveur MQTT.
+ *
+ * La tâche garde une session MQTT persistante avec le serveur saisi dans le portail
+ * (adr_mon_serveur, port_mon_serveur, user_mon_serveur, pass_mon_serveur) et vide le journal
+ * flash des échantillons (journal.h) par lots séquentiels : un message contient jusqu'à
+ * ENVOI_ECHANTILLONS_PAR_LOT échantillons, regroupés par canal, encodés en binaire compact
+ * dans une enveloppe CBOR (encodage_lot.h) ou en JSON selon ENVOI_FORMAT_CBOR. Un vidage est déclenché
+ * quand la politique d'envoi le demande (changement hors bande morte ou heartbeat, voir
+ * politique_envoi.h), à chaque ouverture de session (reprise après une coupure WiFi) ou dès que
+ * ENVOI_SEUIL_VIDAGE échantillons sont en attente.
+ *
+ * Le curseur d'envoi avance dès la publication (plusieurs lots peuvent être en vol), le
+ * curseur du journal seulement quand tous les lots qui le précèdent sont acquittés.
+ * C'est aussi cette tâche qui écrit le journal en flash, hors de la tâche d'acquisition.
+ *
+ * Si l'adresse du serveur commence par "http://", le journal est envoyé en POST HTTP/1.1 sur une
+ * connexion persistante (client_http.h) : le corps est produit fragment par fragment depuis le
+ * journal pendant l'envoi et, faute de copie côté client, les lots sans réponse sont relus depuis
+ * le journal après une reconnexion. Une réponse d'erreur espace les reconnexions (délai doublé à
+ * chaque refus) et un lot refusé HTTP_REFUS_MAX fois en 4xx est écarté du journal.
+ * Si l'adresse commence par "udp://" ou "coap://", le journal part en datagrammes UDP sans connexion
+ * ni acquittement (client_udp.h), un lot par datagramme, en trame brute ou en message CoAP non
+ * confirmable : le curseur du journal avance dès l'envoi et un datagramme perdu n'est pas renvoyé.
+ * L'hôte est résolu de nouveau toutes les UDP_RESOLUTION_MS, après une reconnexion WiFi et dès que
+ * l'adresse ou le port change dans le portail.
+ *
+ * Les alarmes (alarmes.h) forment une voie prioritaire : la tâche est réveillée dès qu'une alarme
+ * est détectée et la publie avant tout lot du journal, sur le sujet "<nom>/alarmes" ou en POST sur
+ * "<chemin>/alarmes", en JSON. Les lots du journal laissent libres ALARMES_PLACES_RESERVEES places
+ * de la fenêtre MQTT ou du pipeline HTTP ; une alarme est conservée jusqu'à son acquittement et
+ * renvoyée si la connexion la perd.
+ * La tâche a une priorité basse : connexion et reconnexions ne retardent jamais l'acquisition.
+ */
+
+#include "taches/tache_envoi.h"
+#include "variablesGlobales.h"
+#include "journal.h"
+#include "politique_envoi.h"
+#include "alarmes.h"
+#include "encodage_lot.h"
+#include "registre_capteurs.h"
+#include "mqtt.h"
+#include "client_http.h"
+#include "client_udp.h"
+#include <WiFi.h>
+#include <WiFiUdp.h>
+#include <stdarg.h>
+
+// Connexion TCP, partagée par MQTT et HTTP (un seul transport est utilisé à la fois)
+static WiFiClient connexionTcp;
+static ClientMqtt clientMqtt(connexionTcp);
+static ClientHttp clientHttp(connexionTcp);
+static WiFiUDP socketUdp;
+static ClientUdp clientUdp(socketUdp);
+
+// Transport choisi à la connexion d'après le schéma de l'adresse du serveur
+enum Transport : uint8_t {
+  TRANSPORT_MQTT = 0,
+  TRANSPORT_HTTP,
+  TRANSPORT_UDP
+};
+static const char *const NOMS_TRANSPORT[] = { "MQTT", "HTTP", "UDP" };
+static Transport transport = TRANSPORT_MQTT;
+
+// Chemin du POST HTTP ou Uri-Path CoAP
+static char cheminServeur[sizeof(params.adr_mon_serveur)] = HTTP_CHEMIN_DEFAUT;
+static char cheminAlarmes[sizeof(params.adr_mon_serveur) + 8] = HTTP_CHEMIN_DEFAUT "/alarmes";
+
+// UDP : adresse et port du portail à la dernière résolution, et instant de cette résolution
+static char adresseResolue[sizeof(params.adr_mon_serveur)] = "";
+static char portResolu[sizeof(params.port_mon_serveur)] = "";
+static uint32_t resolution_ms = 0;
+
+// Lots en vol au maximum, quel que soit le transport
+static const size_t NB_LOTS = MQTT_FENETRE > HTTP_PIPELINE ? MQTT_FENETRE : HTTP_PIPELINE;
+
+// Index du journal du prochain échantillon à publier
+static uint32_t curseurEnvoi = 0;
+
+// Lots en vol ; le jeton MQTT ou HTTP d'un lot est son indice
+static struct {
+  bool occupe;
+  bool acquitte;
+  uint32_t debut;        // Index du journal du premier échantillon du lot
+  uint32_t fin;          // Index qui suit le dernier échantillon du lot
+} lots[NB_LOTS] = {};
+
+// Alarmes en attente d'acquittement, en anneau dans l'ordre de détection ; le jeton MQTT ou HTTP
+// d'une alarme est JETON_ALARME plus sa place dans l'anneau
+static const uint32_t JETON_ALARME = 0x80000000UL;
+static struct {
+  EvenementAlarme evenement;
+  bool envoyee;          // En vol (fenêtre MQTT ou pipeline HTTP)
+  bool acquittee;        // Acquittée hors séquence, en attente de celles qui la précèdent
+  uint8_t envois;        // Envois, renvois après une perte de connexion compris
+  uint8_t refus;         // Refus définitifs (4xx) de cette alarme, comme refusLot pour un lot
+} alarmes[ALARMES_EN_ATTENTE] = {};
+static size_t premiereAlarme = 0;
+static size_t nbAlarmes = 0;
+
+// Refus HTTP (réponse non 2xx) : reconnexion différée de delaiRefus, doublé à chaque refus
+// consécutif et remis à zéro au premier succès
+static uint32_t delaiRefus = 0;
+static uint32_t dernierRefus_ms = 0;
+
+// Refus définitifs consécutifs du lot qui commence à l'index debutRefuse du journal
+static uint32_t debutRefuse = 0;
+static uint8_t refusLot = 0;
+static uint32_t echantillonsEcartes = 0;
+
+// L'en-tête Host doit contenir l'adresse saisie dans le portail suivie de ":port"
+static_assert(HTTP_TAILLE_HOTE >= sizeof(params.adr_mon_serveur) + 6, "HTTP_TAILLE_HOTE trop petit");
+
+// Message d'une alarme
+static char messageAlarme[192];
+static size_t longueurAlarme = 0;
+
+// Tampons de construction d'un lot
+static EnregistrementJournal enregistrements[ENVOI_ECHANTILLONS_PAR_LOT];
+static char message[MQTT_TAILLE_MESSAGE];
+
+#if ENVOI_FORMAT_CBOR
+// Identité du nœud portée par l'enveloppe CBOR (MAC lue au démarrage de la tâche)
+static IdentiteNoeud identite = { IOTName, {} };
+#endif
+
+/**
+ * @brief Cherche la description d'un canal actif dans le registre.
+ */
+static const InfoCanal *chercherCanal(CanalMesure canal)
+{
+    for (const InfoCanal &info : TABLE_CANAUX) {
+        if (info.canal == canal) {
+            return &info;
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief Acquittement d'une alarme : latence mesurée, puis place libérée.
+ *
+ * Les places ne sont libérées qu'en tête d'anneau, pour garder l'ordre de détection.
+ */
+static void acquitterAlarme(size_t place)
+{
+    if (place >= ALARMES_EN_ATTENTE || (place + ALARMES_EN_ATTENTE - premiereAlarme) % ALARMES_EN_ATTENTE >= nbAlarmes ||
+        !alarmes[place].envoyee) {
+        return;
+    }
+    alarmes[place].acquittee = true;
+    noterAcquittementAlarme(alarmes[place].evenement);
+
+    const StatsAlarmes s = lireStatsAlarmes();
+    const EvenementAlarme &e = alarmes[place].evenement;
+    Serial.printf("[ALARME] %s %s acquittee en %u ms (moyenne %u ms, max %u ms)\n",
+                  chercherCanal(e.canal)->cle, NOMS_ALARME[e.type], s.latenceDerniere_ms,
+                  s.latenceMoyenne_ms, s.latenceMax_ms);
+
+    while (nbAlarmes > 0 && alarmes[premiereAlarme].acquittee) {
+        premiereAlarme = (premiereAlarme + 1) % ALARMES_EN_ATTENTE;
+        nbAlarmes--;
+    }
+}
+
+/**
+ * @brief Avance le curseur du journal sur la suite contiguë de lots acquittés et libère ces lots.
+ */
+static void avancerLotsAcquittes()
+{
+    bool avance = true;
+    while (avance) {
+        avance = false;
+        for (auto &lot : lots) {
+            // Un lot évincé du journal entre-temps (debut < curseur) est simplement libéré
+            if (lot.occupe && lot.acquitte && (int32_t)(lot.debut - curseurJournal()) <= 0) {
+                avancerCurseurJournal(lot.fin);
+                lot.occupe = false;
+                avance = true;
+            }
+        }
+    }
+}
+
+/**
+ * @brief Rappel du client à la réception du PUBACK MQTT ou de la réponse HTTP 2xx d'un lot ou d'une alarme.
+ *
+ * Les acquittements peuvent arriver dans le désordre : le curseur du journal n'avance que
+ * sur la suite contiguë de lots acquittés.
+ */
+static void acquitterLot(uint32_t jeton)
+{
+    delaiRefus = 0;
+    if (jeton & JETON_ALARME) {
+        acquitterAlarme(jeton & ~JETON_ALARME);
+        return;
+    }
+    if (jeton >= NB_LOTS || !lots[jeton].occupe) {
+        return;
+    }
+    lots[jeton].acquitte = true;
+    avancerLotsAcquittes();
+}
+
+/**
+ * @brief Rappel du client HTTP à la réception d'une réponse non 2xx d'un lot ou d'une alarme.
+ *
+ * La connexion est fermée par le client et les requêtes en vol seront reconstruites : la
+ * reconnexion est différée (délai doublé à chaque refus consécutif). Un statut 4xx autre que
+ * 408 ou 429 est définitif : au bout de HTTP_REFUS_MAX refus du même lot, ses échantillons sont
+ * écartés du journal ; une alarme refusée autant de fois est retirée de l'anneau (ses renvois
+ * après une perte de connexion ne comptent pas). Les erreurs
+ * 5xx ne font qu'espacer les reprises : aucune donnée n'est perdue pendant une panne du serveur.
+ */
+static void noterRefus(uint32_t jeton, int statut)
+{
+    delaiRefus = delaiRefus == 0 ? ENVOI_RECONNEXION_MIN_MS : min<uint32_t>(delaiRefus * 2, ENVOI_RECONNEXION_MAX_MS);
+    dernierRefus_ms = millis();
+
+    const bool definitif = statut >= 400 && statut < 500 && statut != 408 && statut != 429;
+    if (jeton & JETON_ALARME) {
+        const size_t place = jeton & ~JETON_ALARME;
+        if (!definitif || place >= ALARMES_EN_ATTENTE ||
+            (place + ALARMES_EN_ATTENTE - premiereAlarme) % ALARMES_EN_ATTENTE >= nbAlarmes) {
+            return;
+        }
+        if (++alarmes[place].refus < HTTP_REFUS_MAX) {
+            Serial.printf("[HTTP] Alarme refusee (statut %d, %u/%u), nouvel essai dans %u ms\n",
+                          statut, alarmes[place].refus, HTTP_REFUS_MAX, delaiRefus);
+        } else {
+            Serial.printf("[HTTP] Alarme refusee %u fois (statut %d) : abandonnee\n", alarmes[place].refus, statut);
+            alarmes[place].acquittee = true;
+            while (nbAlarmes > 0 && alarmes[premiereAlarme].acquittee) {
+                premiereAlarme = (premiereAlarme + 1) % ALARMES_EN_ATTENTE;
+                nbAlarmes--;
+            }
+        }
+        return;
+    }
+    if (jeton >= NB_LOTS || !lots[jeton].occupe) {
+        return;
+    }
+    if (!definitif) {
+        Serial.printf("[HTTP] Statut %d, nouvel essai dans %u ms\n", statut, delaiRefus);
+        return;
+    }
+
+    // Les réponses arrivent dans l'ordre : les lots précédents sont acquittés, ce lot est en tête
+    if (lots[jeton].debut != debutRefuse) {
+        debutRefuse = lots[jeton].debut;
+        refusLot = 0;
+    }
+    if (++refusLot < HTTP_REFUS_MAX) {
+        Serial.printf("[HTTP] Lot refuse (statut %d, %u/%u), nouvel essai dans %u ms\n",
+                      statut, refusLot, HTTP_REFUS_MAX, delaiRefus);
+        return;
+    }
+    echantillonsEcartes += lots[jeton].fin - lots[jeton].debut;
+    Serial.printf("[HTTP] Lot de %u echantillons refuse %u fois (statut %d) : ecarte (%u au total)\n",
+                  lots[jeton].fin - lots[jeton].debut, refusLot, statut, echantillonsEcartes);
+    refusLot = 0;
+    if ((int32_t)(lots[jeton].debut - curseurJournal()) <= 0) {
+        avancerCurseurJournal(lots[jeton].fin);
+    }
+}
+
+#if !ENVOI_FORMAT_CBOR
+// Suffixe de la clé JSON de chaque nature de valeur ("co2_p95"...), vide pour les échantillons
+static const char *const SUFFIXES_NATURE[NB_NATURES] = {
+    "", "_nombre", "_min", "_max", "_moyenne", "_ecart_type", "_p50", "_p95"
+};
+
+/**
+ * @brief Ajoute du texte formaté à la suite du message, sans dépasser `capacite` octets.
+ *
+ * @return false si la place manque.
+ */
+static bool ajouter(size_t &n, size_t capacite, const char *format, ...)
+{
+    va_list args;
+    va_start(args, format);
+    const int m = vsnprintf(message + n, capacite - n, format, args);
+    va_end(args);
+    if (m < 0 || (size_t)m >= capacite - n) {
+        return false;
+    }
+    n += m;
+    return true;
+}
+
+/**
+ * @brief Écrit le message JSON des `nb` premiers enregistrements lus, regroupés par série.
+ *
+ * Format : {"horloge":"epoch","mesures":{"co2":[[t,v],...],"co2_p95":[[t,v],...],"temperature":[[t,v],...]}}
+ * où t est en ms depuis 1970 ("epoch") ou depuis le démarrage ("millis") ; les statistiques d'une
+ * fenêtre (suffixes SUFFIXES_NATURE) sont horodatées au début de la fenêtre.
+ *
+ * @return Longueur du message, 0 si les enregistrements ne tiennent pas dans le tampon.
+ */
+static size_t ecrireLot(size_t nb, bool epoch, size_t capacite)
+{
+    size_t n = 0;
+    if (!ajouter(n, capacite, "{\"horloge\":\"%s\",\"mesures\":{", epoch ? "epoch" : "millis")) {
+        return 0;
+    }
+    bool premierCanal = true;
+    for (const InfoCanal &info : TABLE_CANAUX) {
+        for (uint8_t nature = 0; nature < NB_NATURES; nature++) {
+            const int decimales = nature == NATURE_NOMBRE ? 0 : info.decimales;
+            bool premier = true;
+            for (size_t i = 0; i < nb; i++) {
+                const EnregistrementJournal &e = enregistrements[i];
+                if (e.canal != info.canal || JOURNAL_NATURE(e.drapeaux) != nature) {
+                    continue;
+                }
+                if (premier && !ajouter(n, capacite, "%s\"%s%s\":[", premierCanal ? "" : ",", info.cle, SUFFIXES_NATURE[nature])) {
+                    return 0;
+                }
+                if (!ajouter(n, capacite, "%s[%lld,%.*f]", premier ? "" : ",", (long long)e.horodatage_ms,
+                             decimales, e.valeur)) {
+                    return 0;
+                }
+                premier = false;
+                premierCanal = false;
+            }
+            if (!premier && !ajouter(n, capacite, "]")) {
+                return 0;
+            }
+        }
+    }
+    return ajouter(n, capacite, "}}") ? n : 0;
+}
+
+#endif
+
+/**
+ * @brief Lit un lot séquentiel du journal et construit son message.
+ *
+ * Un lot ne mélange pas les horloges : il s'arrête au premier échantillon dont
+ * l'horodatage n'est pas du même type que le premier (synchronisation NTP en cours de route).
+ * Les segments illisibles sont sautés : leurs index font partie du lot qui les suit, et leurs
+ * échantillons sont écartés quand ce lot est acquitté.
+ *
+ * @param depuis Index du journal du premier échantillon
+ * @param max Nombre maximal d'échantillons (au plus ENVOI_ECHANTILLONS_PAR_LOT)
+ * @param fin Index du journal qui suit le dernier échantillon du lot (sortie)
+ * @param capacite Longueur maximale du message (au plus la taille du tampon)
+ * @return Longueur du message, 0 s'il n'y a rien à envoyer ; si `fin` dépasse alors `depuis`,
+ *         le journal ne contient jusqu'à `fin` que des segments illisibles, à écarter.
+ */
+static size_t construireLot(uint32_t depuis, size_t max, uint32_t &fin, size_t capacite = sizeof(message))
+{
+    uint32_t suivant;
+    size_t nb;
+    while ((nb = lireJournal(depuis, enregistrements, max, suivant)) == JOURNAL_ILLISIBLE) {
+        Serial.printf("[JOURNAL] Segment illisible : echantillons %u a %u ecartes\n", depuis, suivant - 1);
+        depuis = suivant;
+    }
+    fin = suivant;
+    if (nb == 0) {
+        return 0;
+    }
+    const uint32_t premierIndex = suivant - nb;
+
+    int horloge = -1;
+    for (size_t i = 0; i < nb; i++) {
+        if (enregistrements[i].canal >= NB_CANAUX) {
+            continue;       // Enregistrement corrompu
+        }
+        const int h = enregistrements[i].drapeaux & JOURNAL_HORODATAGE_EPOCH;
+        if (horloge < 0) {
+            horloge = h;
+        } else if (h != horloge) {
+            nb = i;
+            break;
+        }
+    }
+
+    // Lot réduit de moitié tant qu'il ne tient pas dans un message
+    size_t longueur;
+    for (;;) {
+#if ENVOI_FORMAT_CBOR
+        longueur = encoderLot(enregistrements, nb, horloge > 0, &identite, (uint8_t *)message, capacite);
+#else
+        longueur = ecrireLot(nb, horloge > 0, capacite);
+#endif
+        if (longueur > 0 || nb <= 1) {
+            break;
+        }
+        nb /= 2;
+    }
+    fin = premierIndex + nb;
+    return longueur;
+}
+
+/**
+ * @brief Cherche un lot libre.
+ *
+ * Un lot acquitté hors séquence garde sa place jusqu'à l'acquittement de ceux qui le précèdent.
+ * @return Indice du lot, NB_LOTS si tous sont occupés.
+ */
+static uint32_t lotLibre()
+{
+    uint32_t jeton = 0;
+    while (jeton < NB_LOTS && lots[jeton].occupe) jeton++;
+    return jeton;
+}
+
+/**
+ * @brief Libère les lots en vol et reprend l'envoi au curseur du journal (lots perdus par le transport).
+ *
+ * Les alarmes en vol sont perdues avec eux : elles seront renvoyées.
+ */
+static void abandonnerLots()
+{
+    for (auto &lot : lots) {
+        lot.occupe = false;
+    }
+    curseurEnvoi = curseurJournal();
+    for (auto &alarme : alarmes) {
+        alarme.envoyee = false;
+    }
+}
+
+/**
+ * @brief Ajoute une alarme reçue de la file à la fin de l'anneau (l'appelant vérifie la place).
+ */
+static void ajouterAlarme(const EvenementAlarme &evenement)
+{
+    const size_t place = (premiereAlarme + nbAlarmes) % ALARMES_EN_ATTENTE;
+    alarmes[place] = { evenement, false, false, 0, 0 };
+    nbAlarmes++;
+    const InfoCanal *info = chercherCanal(evenement.canal);
+    Serial.printf("[ALARME] %s %s : %.*f\n", info->cle, NOMS_ALARME[evenement.type],
+                  info->decimales, evenement.valeur);
+}
+
+/**
+ * @brief Écrit le message JSON d'une alarme dans messageAlarme.
+ *
+ * Format : {"canal":"co2","alarme":"seuil","valeur":1612,"seuil":1500,"horloge":"epoch","t":...,"attente_ms":12}
+ * où t est l'instant de la capture (base de la latence de bout en bout côté serveur) et attente_ms
+ * le délai entre la détection et cet envoi.
+ */
+static void ecrireAlarme(const EvenementAlarme &e)
+{
+    const InfoCanal *info = chercherCanal(e.canal);
+    Horodatage capture = e.capture;
+    const bool epoch = convertirEpoch(capture);
+    const int n = snprintf(messageAlarme, sizeof(messageAlarme),
+                           "{\"canal\":\"%s\",\"alarme\":\"%s\",\"valeur\":%.*f,\"seuil\":%.*f,"
+                           "\"horloge\":\"%s\",\"t\":%lld,\"attente_ms\":%lu}",
+                           info->cle, NOMS_ALARME[e.type], info->decimales, e.valeur, info->decimales, e.seuil,
+                           epoch ? "epoch" : "millis", (long long)capture.ms,
+                           (unsigned long)(millis() - e.detection_ms));
+    longueurAlarme = n > 0 && (size_t)n < sizeof(messageAlarme) ? n : 0;
+}
+
+/**
+ * @brief Source du corps HTTP d'une alarme : le message en un seul fragment.
+ */
+static size_t lireAlarme(const uint8_t **donnees)
+{
+    const size_t longueur = longueurAlarme;
+    longueurAlarme = 0;
+    *donnees = (const uint8_t *)messageAlarme;
+    return longueur;
+}
+
+/**
+ * @brief Envoie les alarmes qui ne sont pas en vol, dans l'ordre de détection.
+ *
+ * Les alarmes ont toute la fenêtre MQTT ou tout le pipeline HTTP, sans plafond de débit.
+ * En UDP, une alarme est considérée comme acquittée dès qu'elle est partie.
+ */
+static void publierAlarmes()
+{
+    char sujet[MQTT_TAILLE_SUJET];
+    snprintf(sujet, sizeof(sujet), "%s/alarmes", IOTName);
+
+    for (size_t k = 0; k < nbAlarmes; k++) {
+        const size_t place = (premiereAlarme + k) % ALARMES_EN_ATTENTE;
+        auto &alarme = alarmes[place];
+        if (alarme.envoyee || alarme.acquittee) {
+            continue;
+        }
+        if ((transport == TRANSPORT_HTTP && clientHttp.placesLibres(true) == 0) ||
+            (transport == TRANSPORT_MQTT && clientMqtt.placesLibres() == 0)) {
+            return;
+        }
+
+        ecrireAlarme(alarme.evenement);
+        bool envoyee = false;
+        switch (transport) {
+        case TRANSPORT_MQTT:
+            envoyee = clientMqtt.publier(sujet, (const uint8_t *)messageAlarme, longueurAlarme, JETON_ALARME | place);
+            break;
+        case TRANSPORT_HTTP:
+            envoyee = clientHttp.envoyer(cheminAlarmes, "application/json", lireAlarme, JETON_ALARME | place);
+            break;
+        case TRANSPORT_UDP:
+            envoyee = clientUdp.envoyer(cheminAlarmes, CONTENU_JSON, (const uint8_t *)messageAlarme, longueurAlarme);
+            break;
+        }
+        if (!envoyee) {
+            return;
+        }
+        alarme.envoyee = true;
+        noterEnvoiAlarme(alarme.envois > 0);
+        if (alarme.envois < UINT8_MAX) alarme.envois++;
+        if (transport == TRANSPORT_UDP) {
+            acquitterAlarme(place);
+        }
+    }
+}
+
+/**
+ * @brief Écarte les segments illisibles de la fin du journal, de curseurEnvoi à `fin`.
+ *
+ * Ils occupent un lot acquitté d'office : le curseur du journal les passe quand les lots en vol
+ * qui les précèdent sont acquittés.
+ */
+static void ecarterIllisibles(uint32_t jeton, uint32_t fin)
+{
+    if (fin == curseurEnvoi) {
+        return;
+    }
+    lots[jeton] = { true, true, curseurEnvoi, fin };
+    curseurEnvoi = fin;
+    avancerLotsAcquittes();
+}
+
+/**
+ * @brief Publie des lots MQTT tant que la fenêtre QoS 1 a de la place.
+ *
+ * @return true quand tout le journal a été publié.
+ */
+static bool publierLotsMqtt()
+{
+    char sujet[MQTT_TAILLE_SUJET];
+    snprintf(sujet, sizeof(sujet), ENVOI_FORMAT_CBOR ? "%s/mesures/cbor" : "%s/mesures", IOTName);
+
+    while (clientMqtt.placesLibres() > ALARMES_PLACES_RESERVEES) {
+        const uint32_t jeton = lotLibre();
+        if (jeton == NB_LOTS) {
+            return false;
+        }
+
+        uint32_t fin;
+        const size_t longueur = construireLot(curseurEnvoi, ENVOI_ECHANTILLONS_PAR_LOT, fin);
+        if (longueur == 0) {
+            ecarterIllisibles(jeton, fin);
+            return true;
+        }
+
+        if (!clientMqtt.publier(sujet, (const uint8_t *)message, longueur, jeton)) {
+            return false;
+        }
+        lots[jeton] = { true, false, curseurEnvoi, fin };
+        curseurEnvoi = fin;
+    }
+    return false;
+}
+
+// Position de la source du corps HTTP en cours d'envoi
+static uint32_t sourceIndex = 0;
+static uint32_t sourceRestant = 0;
+static size_t fragmentPret = 0;     // Premier fragment déjà encodé dans message
+
+/**
+ * @brief Source du corps HTTP : encode le fragment suivant depuis le journal.
+ *
+ * Le corps est une suite de lots indépendants : séquence CBOR (application/cbor-seq)
+ * ou JSON délimité par des retours à la ligne (application/x-ndjson).
+ */
+static size_t lireFragment(const uint8_t **donnees)
+{
+    if (fragmentPret > 0) {
+        const size_t longueur = fragmentPret;
+        fragmentPret = 0;
+        *donnees = (const uint8_t *)message;
+        return longueur;
+    }
+    if (sourceRestant == 0) {
+        return 0;
+    }
+    uint32_t fin;
+    size_t longueur = construireLot(sourceIndex, min<uint32_t>(sourceRestant, HTTP_ECHANTILLONS_PAR_FRAGMENT), fin);
+    if (longueur == 0) {
+        // Segments illisibles en fin de journal : couverts par la requête
+        sourceIndex = fin;
+        sourceRestant = 0;
+        return 0;
+    }
+#if !ENVOI_FORMAT_CBOR
+    message[longueur++] = '\n';
+#endif
+    const uint32_t lus = fin - sourceIndex;
+    sourceRestant = lus < sourceRestant ? sourceRestant - lus : 0;
+    sourceIndex = fin;
+    *donnees = (const uint8_t *)message;
+    return longueur;
+}
+
+/**
+ * @brief Envoie des requêtes HTTP tant que le pipeline et le plafond de débit le permettent.
+ *
+ * @return true quand tout le journal a été envoyé.
+ */
+static bool publierLotsHttp()
+{
+    while (clientHttp.placesLibres() > ALARMES_PLACES_RESERVEES) {
+        if (finJournal() == curseurEnvoi) {
+            return true;
+        }
+        const uint32_t jeton = lotLibre();
+        if (jeton == NB_LOTS) {
+            return false;
+        }
+
+        // Premier fragment encodé avant la requête : pas de POST sans corps quand il ne reste
+        // que des segments illisibles
+        sourceIndex = curseurEnvoi;
+        sourceRestant = HTTP_ECHANTILLONS_PAR_REQUETE;
+        const uint8_t *donnees;
+        fragmentPret = lireFragment(&donnees);
+        if (fragmentPret == 0) {
+            ecarterIllisibles(jeton, sourceIndex);
+            return true;
+        }
+        if (!clientHttp.envoyer(cheminServeur, ENVOI_FORMAT_CBOR ? "application/cbor-seq" : "application/x-ndjson",
+                                lireFragment, jeton)) {
+            fragmentPret = 0;
+            return false;
+        }
+        lots[jeton] = { true, false, curseurEnvoi, sourceIndex };
+        curseurEnvoi = sourceIndex;
+    }
+    return false;
+}
+
+/**
+ * @brief Envoie des lots du journal en datagrammes UDP, au plus UDP_DATAGRAMMES_PAR_TOUR par tour.
+ *
+ * Sans acquittement, le curseur du journal avance dès que la pile réseau a pris le datagramme ;
+ * un datagramme refusé par la pile est retenté au tour suivant.
+ *
+ * @return true quand tout le journal a été envoyé.
+ */
+static bool publierLotsUdp()
+{
+    const size_t capacite = min(sizeof(message), clientUdp.chargeMax(cheminServeur));
+    for (size_t i = 0; i < UDP_DATAGRAMMES_PAR_TOUR; i++) {
+        uint32_t fin;
+        const size_t longueur = construireLot(curseurEnvoi, ENVOI_ECHANTILLONS_PAR_LOT, fin, capacite);
+        if (longueur == 0) {
+            // Segments illisibles en fin de journal : écartés
+            curseurEnvoi = fin;
+            avancerCurseurJournal(fin);
+            return true;
+        }
+        if (!clientUdp.envoyer(cheminServeur, ENVOI_FORMAT_CBOR ? CONTENU_CBOR : CONTENU_JSON,
+                               (const uint8_t *)message, longueur)) {
+            return false;
+        }
+        curseurEnvoi = fin;
+        avancerCurseurJournal(fin);
+    }
+    return false;
+}
+
+/**
+ * @brief Vrai si le transport choisi peut envoyer (connexion TCP ouverte, destination UDP résolue).
+ */
+static bool sessionOuverte()
+{
+    switch (transport) {
+    case TRANSPORT_HTTP:
+        return clientHttp.connecte();
+    case TRANSPORT_UDP:
+        return clientUdp.configure();
+    default:
+        return clientMqtt.connecte();
+    }
+}
+
+/**
+ * @brief Envoie des lots du journal avec le transport choisi.
+ *
+ * @return true quand tout le journal a été envoyé.
+ */
+static bool publierLots()
+{
+    switch (transport) {
+    case TRANSPORT_HTTP:
+        return publierLotsHttp();
+    case TRANSPORT_UDP:
+        return publierLotsUdp();
+    default:
+        return publierLotsMqtt();
+    }
+}
+
+/**
+ * @brief Ouvre la session avec le serveur configuré dans le portail.
+ *
+ * L'adresse peut être saisie avec un schéma et un chemin : "http://hote/chemin" sélectionne le
+ * transport HTTP (chemin du POST, HTTP_CHEMIN_DEFAUT par défaut), "udp://hote/chemin" ou
+ * "coap://hote/chemin" le transport UDP (trame brute ou CoAP, chemin en Uri-Path), toute autre
+ * adresse MQTT. En UDP, seule l'adresse est résolue : aucun paquet n'est échangé.
+ */
+static bool connecterServeur()
+{
+    const bool coap = strncasecmp(params.adr_mon_serveur, "coap://", 7) == 0;
+    const Transport choisi = strncasecmp(params.adr_mon_serveur, "http://", 7) == 0 ? TRANSPORT_HTTP
+                           : coap || strncasecmp(params.adr_mon_serveur, "udp://", 6) == 0 ? TRANSPORT_UDP
+                           : TRANSPORT_MQTT;
+    if (choisi != transport) {
+        // Changement de transport : les lots en vol de l'autre transport ne seront jamais acquittés
+        abandonnerLots();
+        clientMqtt.oublierMessages();
+        connexionTcp.stop();
+        transport = choisi;
+    }
+
+    char hote[sizeof(params.adr_mon_serveur)];
+    const char *debut = strstr(params.adr_mon_serveur, "://");
+    debut = debut ? debut + 3 : params.adr_mon_serveur;
+    size_t l = strcspn(debut, "/:");
+    if (l >= sizeof(hote)) l = sizeof(hote) - 1;
+    memcpy(hote, debut, l);
+    hote[l] = '\0';
+
+    const long port = atol(params.port_mon_serveur);
+
+    const char *chemin = strchr(debut, '/');
+    strlcpy(cheminServeur, chemin ? chemin : HTTP_CHEMIN_DEFAUT, sizeof(cheminServeur));
+    snprintf(cheminAlarmes, sizeof(cheminAlarmes), "%s/alarmes", cheminServeur);
+
+    if (transport == TRANSPORT_UDP) {
+        IPAddress adresse;
+        if (!WiFi.hostByName(hote, adresse)) {
+            return false;
+        }
+        clientUdp.configurer(adresse, port > 0 && port <= 65535 ? (uint16_t)port
+                                      : coap ? COAP_PORT_DEFAUT : UDP_PORT_DEFAUT,
+                             coap ? TRAME_COAP : TRAME_BRUTE);
+        strlcpy(adresseResolue, params.adr_mon_serveur, sizeof(adresseResolue));
+        strlcpy(portResolu, params.port_mon_serveur, sizeof(portResolu));
+        resolution_ms = millis();
+        return true;
+    }
+
+    if (transport == TRANSPORT_HTTP) {
+        return clientHttp.connecter(hote, port > 0 && port <= 65535 ? (uint16_t)port : HTTP_PORT_DEFAUT,
+                                    params.user_mon_serveur, params.pass_mon_serveur);
+    }
+
+    // Identifiant stable d'une session à l'autre (session persistante côté broker)
+    static char idClient[48] = "";
+    if (idClient[0] == '\0') {
+        String mac = WiFi.macAddress();
+        mac.replace(":", "");
+        snprintf(idClient, sizeof(idClient), "%s-%s", IOTName, mac.c_str());
+    }
+
+    return clientMqtt.connecter(hote, port > 0 && port <= 65535 ? (uint16_t)port : MQTT_PORT_DEFAUT, idClient,
+                                params.user_mon_serveur, params.pass_mon_serveur);
+}
+
+/**
+ * @brief Tâche FreeRTOS d'envoi des mesures.
+ *
+ * @param pvParameters Paramètre non utilisé, requis par le prototype de la fonction FreeRTOS.
+ */
+void tache_envoi(void *pvParameters)
+{
+    clientMqtt.surAcquittement(acquitterLot);
+    clientHttp.surReponse(acquitterLot);
+    clientHttp.surRefus(noterRefus);
+#if ENVOI_FORMAT_CBOR
+    WiFi.macAddress(identite.mac);
+#endif
+    ouvrirJournal();
+    curseurEnvoi = curseurJournal();
+
+    bool vidageDemande = finJournal() != curseurEnvoi;
+    uint32_t delaiReconnexion = ENVOI_RECONNEXION_MIN_MS;
+    uint32_t derniereTentative = 0;
+    bool premiereTentative = true;
+
+    for (;;) {
+        // Attente du tour suivant, écourtée par une alarme ; anneau plein : les alarmes restent dans la file
+        EvenementAlarme alarme;
+        if (nbAlarmes == ALARMES_EN_ATTENTE) {
+            vTaskDelay(ENVOI_BOUCLE_MS / portTICK_PERIOD_MS);
+        } else if (attendreAlarme(alarme, ENVOI_BOUCLE_MS)) {
+            ajouterAlarme(alarme);
+            while (nbAlarmes < ALARMES_EN_ATTENTE && attendreAlarme(alarme, 0)) {
+                ajouterAlarme(alarme);
+            }
+        }
+
+        // Écriture en flash des échantillons du dernier tour, même sans réseau
+        viderFileJournal();
+
+        if (prendreRapportDemande()) {
+            vidageDemande = true;
+        }
+        if (finJournal() - curseurEnvoi >= ENVOI_SEUIL_VIDAGE) {
+            vidageDemande = true;
+        }
+
+        if (WiFi.status() != WL_CONNECTED) {
+            // Réseau ou serveur DNS peut-être différents à la reconnexion : l'hôte UDP sera résolu de nouveau
+            clientUdp.oublier();
+            continue;
+        }
+
+        // UDP : adresse modifiée dans le portail, ou résolution trop ancienne (l'hôte a pu changer d'IP)
+        bool renouvellement = false;
+        if (transport == TRANSPORT_UDP && clientUdp.configure()) {
+            if (strcmp(adresseResolue, params.adr_mon_serveur) != 0 || strcmp(portResolu, params.port_mon_serveur) != 0) {
+                clientUdp.oublier();
+            } else if (millis() - resolution_ms >= UDP_RESOLUTION_MS) {
+                clientUdp.oublier();
+                renouvellement = true;
+            }
+        }
+
+        if (!sessionOuverte()) {
+            // HTTP : les requêtes sans réponse sont perdues avec la connexion
+            if (transport == TRANSPORT_HTTP) {
+                abandonnerLots();
+            }
+            // Nouvelle tentative avec un délai doublé à chaque échec
+            if (!premiereTentative && millis() - derniereTentative < delaiReconnexion) {
+                continue;
+            }
+            // Refus du serveur : reprise espacée même si la connexion TCP s'ouvre sans peine
+            if (transport == TRANSPORT_HTTP && delaiRefus > 0 && millis() - dernierRefus_ms < delaiRefus) {
+                continue;
+            }
+            premiereTentative = false;
+            derniereTentative = millis();
+            if (connecterServeur()) {
+                Serial.println(transport == TRANSPORT_HTTP ? "[HTTP] Connexion ouverte"
+                               : transport == TRANSPORT_UDP ? "[UDP] Destination resolue" : "[MQTT] Session ouverte");
+                delaiReconnexion = ENVOI_RECONNEXION_MIN_MS;
+                // Reprise après coupure : le journal accumulé est vidé sans attendre de rapport (pas
+                // pour une simple résolution périodique, qui n'interrompt pas l'envoi)
+                if (!renouvellement) {
+                    vidageDemande = vidageDemande || finJournal() != curseurEnvoi;
+                }
+            } else {
+                Serial.printf("[%s] Connexion impossible, nouvel essai dans %u ms\n",
+                              NOMS_TRANSPORT[transport], delaiReconnexion);
+                delaiReconnexion = min<uint32_t>(delaiReconnexion * 2, ENVOI_RECONNEXION_MAX_MS);
+            }
+            continue;
+        }
+
+        if (transport == TRANSPORT_HTTP) {
+            clientHttp.traiter();
+        } else if (transport == TRANSPORT_MQTT) {
+            clientMqtt.traiter();
+        }
+
+        // Voie prioritaire : les alarmes passent avant les lots du journal
+        publierAlarmes();
+
+        if (vidageDemande && publierLots()) {
+            vidageDemande = false;
+            const StatsJournal j = lireStatsJournal();
+            if (transport == TRANSPORT_HTTP) {
+                const StatsHttp &s = clientHttp.lireStats();
+                Serial.printf("[HTTP] Journal envoye : %u requetes, %u ok, %u erreurs, %u octets, latence %u ms (max %u)\n",
+                              s.requetes, s.reponsesOk, s.reponsesErreur, s.octetsCorps,
+                              s.latenceMoyenne_ms, s.latenceMax_ms);
+            } else if (transport == TRANSPORT_UDP) {
+                const StatsUdp &s = clientUdp.lireStats();
+                Serial.printf("[UDP] Journal envoye : %u datagrammes, %u refuses, %u octets, envoi %u us (max %u)\n",
+                              s.datagrammes, s.echecs, s.octets, s.dureeMoyenne_us, s.dureeMax_us);
+            } else {
+                const StatsMqtt &s = clientMqtt.lireStats();
+                Serial.printf("[MQTT] Journal publie : %u messages, %u acquittes, %u renvoyes, %u connexions\n",
+                              s.publications, s.acquittements, s.renvois, s.connexions);
+            }
+            Serial.printf("[JOURNAL] %u ecrits, %u perdus, %u evinces, %u corrompus, %u illisibles, %u segments\n",
+                          j.ecrits, j.perdus, j.evinces, j.corrompus, j.illisibles, j.segments);
+            const StatsPolitique p = lireStatsPolitique();
+            Serial.printf("[POLITIQUE] %u retenus, %u ignores, %u evenements, %u heartbeats, %u agregats\n",
+                          p.retenus, p.ignores, p.evenements, p.heartbeats, p.agregats);
+            const StatsAlarmes a = lireStatsAlarmes();
+            Serial.printf("[ALARME] %u detectees, %u perdues, %u envoyees, %u renvoyees, %u acquittees, latence %u ms (max %u)\n",
+                          a.detectees, a.perdues, a.envoyees, a.renvois, a.acquittees,
+                          a.latenceMoyenne_ms, a.latenceMax_ms);
+        }
+
+        // Tous les lots acquittés : le curseur est sauvegardé sans attendre l'intervalle minimal
+        if (!vidageDemande && curseurJournal() == curseurEnvoi) {
+            persisterCurseurJournal();
+        }
+    }
+}
@@ -2,22 +2,29 @@
  * @file tache_luminosite.cpp
  * @brief Implémentation de la tâche de gestion du capteur de luminosité Grove Light Sensor.
  * 
- * Ce fichier définit une tâche FreeRTOS qui lit les données du capteur de luminosité
+ * Ce fichier définit la mesure périodique (exécutée par l'ordonnanceur de la tâche
+ * d'acquisition) qui lit les données du capteur de luminosité
  * Grove Light Sensor (basé sur une photorésistance) connecté sur une entrée analogique.
- * La valeur brute est convertie en lux approximatifs pour l'affichage.
+ * L'entrée est échantillonnée en continu par le moteur ADC/DMA (acquisition_adc.h) ;
+ * la valeur filtrée est convertie en lux approximatifs pour l'affichage.
  * 
  * Le Grove Light Sensor utilise une photorésistance (LDR) et fournit une tension
  * proportionnelle à la luminosité ambiante.
  */
 
 #include "taches/tache_luminosite.h"
+#include "variablesGlobales.h"
 #include "configuration.h"
+#include "acquisition_adc.h"
 
-// Variable globale pour stocker la valeur de luminosité en lux (approximatif)
-volatile float luminosite = 0;
+#if CAPTEUR_LUMINOSITE_ACTIF  // Pilote retiré de la compilation si le capteur est désactivé
 
-// Nom du capteur
-const char* Nom_luminosite = "Lum";
+// Tous les échantillons d'une période de mesure doivent tenir dans la fenêtre de la voie
+static_assert((uint32_t)ADC_FREQUENCE_HZ * LUMINOSITE_INTERVAL_MS / 1000 <= ADC_FENETRE_ECHANTILLONS,
+              "ADC_FENETRE_ECHANTILLONS trop petite pour LUMINOSITE_INTERVAL_MS");
+
+// Voie du moteur d'acquisition analogique
+static int voieLuminosite = -1;
 
 /**
  * @brief Convertit la valeur analogique en lux approximatifs.
@@ -58,70 +65,48 @@ float convertToLux(int analogValue) {
 }
 
 /**
- * @brief Tâche FreeRTOS dédiée à la gestion du capteur de luminosité.
- * 
- * Cette tâche lit la valeur analogique du capteur Grove Light Sensor,
- * la convertit en lux approximatifs et met à jour la variable globale `luminosite`.
- * La tâche est configurée pour se mettre en veille pendant un certain intervalle 
- * de temps (défini par `LUMINOSITE_INTERVAL_MS`) avant de mettre à jour à nouveau la valeur.
+ * @brief Déclare l'entrée analogique du capteur de luminosité auprès du moteur ADC.
  * 
- * @param pvParameters Paramètre non utilisé, requis par le prototype de la fonction FreeRTOS.
+ * La moyenne tronquée rejette les pics (néons, scintillement) tout en lissant le bruit.
  */
-void tache_luminosite(void *pvParameters)
+void initLuminosite()
 {
-    // Configuration de l'ADC pour une meilleure résolution
-    analogReadResolution(12);  // ESP32-S2 supporte 12 bits (0-4095)
-    // Configurer l'atténuation pour la broche spécifique (plage 0-3.3V)
-    analogSetPinAttenuation(LUMINOSITE_PIN, ADC_11db);
+    voieLuminosite = ajouterVoieAdc(LUMINOSITE_ADC_CANAL, CANAL_LUMINOSITE, FILTRE_MOYENNE_TRONQUEE, convertToLux);
     
     Serial.print("Capteur de luminosite initialise sur GPIO");
     Serial.println(LUMINOSITE_PIN);
+}
+
+/**
+ * @brief Mesure du capteur de luminosité.
+ * 
+ * Cette fonction filtre les centaines d'échantillons acquis en arrière-plan depuis
+ * la mesure précédente, les convertit en lux approximatifs et les publie dans le
+ * magasin de mesures. Elle est appelée par l'ordonnanceur toutes les `LUMINOSITE_INTERVAL_MS`.
+ */
+void mesurerLuminosite()
+{
+    int valeurFiltree = 0;
+    uint16_t nbEchantillons = 0;
     
-    // Test de lecture initiale pour diagnostic
-    int testRead = analogRead(LUMINOSITE_PIN);
-    float testVoltage = (testRead / 4095.0f) * 3.3f;
-    Serial.print("Lecture initiale - ADC brut: ");
-    Serial.print(testRead);
-    Serial.print(" | Tension: ");
-    Serial.print(testVoltage, 3);
-    Serial.println(" V");
+    if (!publierVoieAdc(voieLuminosite, valeurFiltree, nbEchantillons)) {
+        Serial.println("Lum - Aucun echantillon ADC recu");
+        return;
+    }
     
-    // Délai initial pour stabilisation
-    delay(500);
+    // Calcul de la tension pour debug
+    float voltage = (valeurFiltree / 4095.0f) * 3.3f;
     
-    // Boucle infinie de la tâche
-    for (;;)
-    {
-        // Lecture de la valeur analogique (moyenne de plusieurs lectures pour stabilité)
-        long somme = 0;
-        const int nbLectures = 10;
-        
-        for (int i = 0; i < nbLectures; i++) {
-            somme += analogRead(LUMINOSITE_PIN);
-            delay(10);  // Petit délai entre les lectures
-        }
-        
-        int valeurMoyenne = somme / nbLectures;
-        
-        // Calcul de la tension pour debug
-        float voltage = (valeurMoyenne / 4095.0f) * 3.3f;
-        
-        // Conversion en lux
-        float lux = convertToLux(valeurMoyenne);
-        
-        // Mise à jour de la variable globale
-        luminosite = lux;
-        
-        // Affichage de debug détaillé
-        Serial.print("Lum - ADC: ");
-        Serial.print(valeurMoyenne);
-        Serial.print(" | V: ");
-        Serial.print(voltage, 3);
-        Serial.print("V | Lux: ");
-        Serial.print(lux, 1);
-        Serial.println(" lx");
-        
-        // Temporisation de la tâche avant la prochaine mesure
-        vTaskDelay(LUMINOSITE_INTERVAL_MS / portTICK_PERIOD_MS);
-    }
+    // Affichage de debug détaillé
+    Serial.print("Lum - ADC: ");
+    Serial.print(valeurFiltree);
+    Serial.print(" (");
+    Serial.print(nbEchantillons);
+    Serial.print(" ech.) | V: ");
+    Serial.print(voltage, 3);
+    Serial.print("V | Lux: ");
+    Serial.print(convertToLux(valeurFiltree), 1);
+    Serial.println(" lx");
 }
+
+#endif // CAPTEUR_LUMINOSITE_ACTIF
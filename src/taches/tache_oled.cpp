@@ -11,24 +11,52 @@
 /**
  * @brief Initialisation de la bibliothèque SSD1306 et de la tâche d'affichage.
  * 
- * Ce thread utilise la bibliothèque SSD1306Wire pour gérer l'écran OLED en utilisant le protocole I2C.
+ * Ce thread utilise la bibliothèque OLEDDisplay pour gérer l'écran OLED ; les échanges I2C
+ * passent par la tâche du bus I2C (ecran_ssd1306.h), en priorité basse devant les capteurs.
  * Il permet d'afficher diverses informations, telles que les valeurs des capteurs, la date et l'heure.
  */
 
-// Pour une connexion via I2C en utilisant la bibliothèque Wire d'Arduino.
-#include <Wire.h>
-#include "SSD1306Wire.h" // Bibliothèque pour gérer le SSD1306
+// Connexion I2C via l'arbitre du bus (pas d'accès direct à Wire)
+#include "ecran_ssd1306.h" // Écran SSD1306 sur la file de transactions I2C
 #include "OLEDDisplayUi.h" // Interface utilisateur pour l'affichage OLED
 #include "images.h" // Inclusion des images à afficher sur l'écran OLED
+#include "registre_capteurs.h" // Canaux affichés, unités et icônes
+#include "horloge.h" // Date et heure formatées à la demande
 #include <WiFi.h> // Bibliothèque pour gérer la connexion WiFi
 
 // Obtenir l'adresse MAC de l'ESP32 pour affichage en mode configuration
 String macAddress = WiFi.macAddress();
 
-// Initialisation de l'écran OLED en utilisant l'adresse I2C 0x3c et les broches SDA et SCL.
-SSD1306Wire display(0x3c, SDA, SCL);
+// Initialisation de l'écran OLED à l'adresse I2C 0x3c (bus initialisé par initBusI2c()).
+EcranSsd1306 display(OLED_ADRESSE);
 OLEDDisplayUi ui(&display);
 
+// Textes de l'heure, reformatés seulement quand la minute change (horloge.h)
+static VueHorloge vueHorodatage("%D %H:%M");   // Date et heure (overlay)
+static VueHorloge vueDate("%D");               // Date (format mm/dd/yy)
+static VueHorloge vueHeure("%H:%M");           // Heure (format HH:MM)
+
+/**
+ * @brief Formate la valeur d'un canal du magasin de mesures pour l'affichage.
+ * 
+ * La valeur est lue une seule fois par frame ; "--" est affiché tant que le canal
+ * n'a pas de mesure valide.
+ * 
+ * @param canal Canal de mesure à afficher.
+ * @param decimales Nombre de décimales affichées.
+ * @return Texte à dessiner.
+ */
+static String texteMesure(CanalMesure canal, unsigned int decimales) {
+  const EntreeMesure mesure = lireMesure(canal);
+  if (!mesure.valide) {
+    return "--";
+  }
+  if (decimales == 0) {
+    return String((int)mesure.valeur);
+  }
+  return String(mesure.valeur, decimales);
+}
+
 /**
  * @brief Overlay pour afficher l'horodatage NTP.
  * 
@@ -41,7 +69,7 @@ OLEDDisplayUi ui(&display);
 void msOverlay(OLEDDisplay *display, OLEDDisplayUiState* state) {
   display->setTextAlignment(TEXT_ALIGN_LEFT);
   display->setFont(ArialMT_Plain_10);
-  display->drawString(30, 0, affHorodatageNtp); // Affiche l'horodatage NTP
+  display->drawString(30, 0, vueHorodatage.texte()); // Affiche l'horodatage NTP
 }
 
 /**
@@ -64,61 +92,45 @@ void drawFrame1(OLEDDisplay *display, OLEDDisplayUiState* state, int16_t x, int1
   }
 }
 
-/**
- * @brief Slide d'affichage des informations du capteur 1.
- * 
- * Cette fonction affiche le logo et la valeur actuelle du capteur 1 sur l'écran OLED.
- * 
- * @param display Pointeur vers l'objet OLEDDisplay.
- * @param state Pointeur vers l'état actuel de l'affichage UI.
- * @param x Position X du dessin.
- * @param y Position Y du dessin.
- */
-void drawFrame2(OLEDDisplay *display, OLEDDisplayUiState* state, int16_t x, int16_t y) {
-  display->clear();
-  display->setFont(ArialMT_Plain_16);
-  display->drawXbm(0, 0, temp_width, temp_height, reinterpret_cast<const uint8_t*>(Logo_temp)); // Affiche le logo température
-  display->setFont(ArialMT_Plain_24);
-  display->drawString(60, 10, String(temperature)); // Affiche la température
-  display->drawString(75, 40, "°C"); // Affiche l'unité (température en °C)
-}
+// Disposition d'une frame de capteur selon son icône
+struct LogoFrame {
+  const uint8_t *bits;
+  uint8_t largeur;
+  uint8_t hauteur;
+  int16_t y;        // Position verticale du logo
+  int16_t uniteX;   // Position horizontale de l'unité
+};
 
 /**
- * @brief Slide d'affichage des informations du capteur d'humidité.
- * 
- * Cette fonction affiche le logo et la valeur actuelle du capteur d'humidité sur l'écran OLED.
- * 
- * @param display Pointeur vers l'objet OLEDDisplay.
- * @param state Pointeur vers l'état actuel de l'affichage UI.
- * @param x Position X du dessin.
- * @param y Position Y du dessin.
+ * @brief Logo et disposition associés à une icône du registre des capteurs.
  */
-void drawFrame3(OLEDDisplay *display, OLEDDisplayUiState* state, int16_t x, int16_t y) {
-  display->clear();
-  display->setFont(ArialMT_Plain_16);
-  display->drawXbm(0, 8, volume_width, volume_height, reinterpret_cast<const uint8_t*>(Logo_hum)); // Affiche le logo du capteur 2
-  display->setFont(ArialMT_Plain_24);
-  display->drawString(60, 10, String(humidite)); // Affiche la valeur d'humidité
-  display->drawString(60, 40, "%"); // Affiche l'unité (d'humidité en %)
+static constexpr LogoFrame logoFrame(IconeCapteur icone) {
+  return icone == ICONE_TEMPERATURE ? LogoFrame{ Logo_temp, temp_width, temp_height, 0, 75 } :
+         icone == ICONE_HUMIDITE    ? LogoFrame{ Logo_hum, volume_width, volume_height, 8, 60 } :
+         icone == ICONE_CO2         ? LogoFrame{ Logo_co2, co2_width, co2_height, 0, 60 } :
+                                      LogoFrame{ Logo_lum, lum_width, lum_height, 0, 60 };
 }
 
 /**
- * @brief Slide d'affichage du taux de CO2.
+ * @brief Slide d'affichage d'un canal du registre des capteurs.
  * 
- * Cette fonction affiche le logo CO2 et la valeur actuelle du capteur SGP30 sur l'écran OLED.
+ * Une instance est générée à la compilation pour chaque canal affiché (CanauxAffiches) :
+ * logo, valeur et unité sont des constantes du descripteur du canal.
  * 
  * @param display Pointeur vers l'objet OLEDDisplay.
  * @param state Pointeur vers l'état actuel de l'affichage UI.
  * @param x Position X du dessin.
  * @param y Position Y du dessin.
  */
-void drawFrame4(OLEDDisplay *display, OLEDDisplayUiState* state, int16_t x, int16_t y) {
+template <class Canal>
+void dessinerFrameCanal(OLEDDisplay *display, OLEDDisplayUiState* state, int16_t x, int16_t y) {
+  constexpr LogoFrame logo = logoFrame(Canal::icone);
   display->clear();
   display->setFont(ArialMT_Plain_16);
-  display->drawXbm(0, 0, co2_width, co2_height, reinterpret_cast<const uint8_t*>(Logo_co2)); // Affiche le logo CO2
+  display->drawXbm(0, logo.y, logo.largeur, logo.hauteur, logo.bits); // Affiche le logo du capteur
   display->setFont(ArialMT_Plain_24);
-  display->drawString(60, 10, String(co2)); // Affiche la valeur de CO2 en ppm
-  display->drawString(60, 40, "ppm"); // Affiche l'unité (ppm)
+  display->drawString(60, 10, texteMesure(Canal::canal, Canal::decimales)); // Affiche la valeur
+  display->drawString(logo.uniteX, 40, Canal::unite); // Affiche l'unité
 }
 
 /**
@@ -135,34 +147,21 @@ void drawFrame5(OLEDDisplay *display, OLEDDisplayUiState* state, int16_t x, int1
   display->clear();
   display->setFont(ArialMT_Plain_16);
   display->setTextAlignment(TEXT_ALIGN_LEFT);
-  display->drawString(0, 0, affHorodatageNTPDate); // Affiche la date NTP
+  display->drawString(0, 0, vueDate.texte()); // Affiche la date NTP
   display->setFont(ArialMT_Plain_24);
-  display->drawString(54, 28, affHorodatageNTPHeure); // Affiche l'heure NTP
+  display->drawString(54, 28, vueHeure.texte()); // Affiche l'heure NTP
 }
 
 /**
- * @brief Slide d'affichage de la luminosité.
- * 
- * Cette fonction affiche le logo soleil et la valeur actuelle du capteur de luminosité sur l'écran OLED.
- * 
- * @param display Pointeur vers l'objet OLEDDisplay.
- * @param state Pointeur vers l'état actuel de l'affichage UI.
- * @param x Position X du dessin.
- * @param y Position Y du dessin.
+ * @brief Liste des frames : état WiFi, un slide par canal affiché, puis date et heure.
  */
-void drawFrame6(OLEDDisplay *display, OLEDDisplayUiState* state, int16_t x, int16_t y) {
-  display->clear();
-  display->setFont(ArialMT_Plain_16);
-  display->drawXbm(0, 0, lum_width, lum_height, reinterpret_cast<const uint8_t*>(Logo_lum)); // Affiche le logo soleil
-  display->setFont(ArialMT_Plain_24);
-  display->drawString(60, 10, String((int)luminosite)); // Affiche la valeur de luminosité en lux
-  display->drawString(60, 40, "lux"); // Affiche l'unité (lux)
+template <class... Canaux>
+static constexpr std::array<FrameCallback, sizeof...(Canaux) + 2> genererFrames(ListeTypes<Canaux...>) {
+  return {{ drawFrame1, dessinerFrameCanal<Canaux>..., drawFrame5 }};
 }
 
-
-// Tableau de pointeurs vers les différentes frames d'affichage
-FrameCallback frames[] = { drawFrame1, drawFrame2, drawFrame3, drawFrame4, drawFrame5, drawFrame6 };
-int frameCount = 6; // Nombre de frames (ici 6 slides)
+// Tableau de pointeurs vers les différentes frames d'affichage, généré depuis le registre des capteurs
+static std::array<FrameCallback, CanauxAffiches::taille + 2> frames = genererFrames(CanauxAffiches{});
 
 // Overlays statiques qui se dessinent par-dessus une frame (exemple : horloge)
 OverlayCallback overlays[] = { msOverlay };
@@ -198,7 +197,7 @@ void tache_oled(void *pvParameters)
   ui.setIndicatorPosition(RIGHT); // Position des indicateurs : à droite
   ui.setIndicatorDirection(LEFT_RIGHT); // Direction des transitions : de gauche à droite
   ui.setFrameAnimation(SLIDE_LEFT); // Type de transition : glissement à gauche
-  ui.setFrames(frames, frameCount); // Ajoute les frames à l'interface
+  ui.setFrames(frames.data(), frames.size()); // Ajoute les frames à l'interface
 
   // Initialisation de l'interface UI (affiche également l'écran)
   ui.init();
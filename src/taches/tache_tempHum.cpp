@@ -1,89 +1,68 @@
  /**
  * @file tache_tempHum.cpp
- * @brief Implémentation de la tâche de gestion du capteur DHT22 (température et humidité).
+ * @brief Implémentation du pilote du capteur DHT22 (température et humidité).
  * 
- * Ce fichier définit une tâche FreeRTOS qui lit les données du capteur DHT22.
- * Les valeurs de température et d'humidité sont mises à jour à intervalles réguliers 
- * et peuvent être utilisées par d'autres tâches (comme l'affichage OLED).
- * 
- * Un sémaphore est utilisé pour signaler aux autres tâches (comme CO2) que les 
- * premières mesures valides sont disponibles.
+ * Ce fichier définit la mesure périodique du DHT22, exécutée par l'ordonnanceur
+ * de la tâche d'acquisition. La trame est capturée par le RMT (dht22_rmt.h) sans
+ * masquer les interruptions. Les valeurs de température et d'humidité sont publiées
+ * dans le magasin de mesures et peuvent être utilisées par d'autres tâches
+ * (comme l'affichage OLED ou la compensation du SGP30).
  */
 
 #include "taches/tache_tempHum.h"
 #include "variablesGlobales.h"
-#include <DHT.h>
-
-// Initialisation du capteur DHT22
-DHT dht(TEMPHUM_PIN, DHTTYPE);
-
-// Déclaration des variables globales pour stocker température et humidité
-volatile float temperature;
-volatile float humidite;
-
-// Noms des capteurs (peuvent être utilisés pour l'affichage ou le débogage)
-const char* Nom_temperature = "Temp"; 
-const char* Nom_humidite = "Hum";
+#include "dht22_rmt.h"
 
-// Sémaphore pour signaler que les premières mesures sont disponibles
-SemaphoreHandle_t xSemaphoreTempHumReady = NULL;
-
-// Indicateur pour savoir si le sémaphore a déjà été signalé
-static bool firstMeasureDone = false;
+#if CAPTEUR_DHT22_ACTIF  // Pilote retiré de la compilation si le capteur est désactivé
 
 /**
- * @brief Tâche FreeRTOS dédiée à la gestion du capteur DHT22.
- * 
- * Cette tâche lit les valeurs de température et d'humidité depuis le capteur DHT22
- * et met à jour les variables globales `temperature` et `humidite`. 
- * La tâche est configurée pour se mettre en veille pendant un certain intervalle 
- * de temps (défini par `TEMPHUM_INTERVAL_MS`) avant de mettre à jour à nouveau les valeurs.
+ * @brief Initialise le capteur DHT22.
  * 
- * @param pvParameters Paramètre non utilisé, requis par le prototype de la fonction FreeRTOS.
+ * Le délai de stabilisation de 2 s exigé par le DHT22 est assuré par le déphasage
+ * de la première mesure dans l'ordonnanceur.
  */
-void tache_tempHum(void *pvParameters)
-{ 
-    // Création du sémaphore binaire (initialement non disponible)
-    xSemaphoreTempHumReady = xSemaphoreCreateBinary();
-    if (xSemaphoreTempHumReady == NULL) {
-        Serial.println("Erreur: Impossible de creer le semaphore TempHumReady !");
+void initTempHum()
+{
+    if (initDht22Rmt(TEMPHUM_PIN, DHT22_RMT_CANAL)) {
+        Serial.println("DHT22 initialisé sur la broche 38 (capture RMT)");
     }
-    
-    // Initialisation du capteur DHT22
-    dht.begin();
-    Serial.println("DHT22 initialisé sur la broche 38");
-    
-    // Délai initial pour s'assurer que les initialisations du système sont terminées
-    delay(2000); // DHT22 nécessite un délai initial
+}
 
-    // Boucle infinie de la tâche
-    for (;;)
-    {
-        // Lecture de la température et de l'humidité depuis le DHT22
-        float temp = dht.readTemperature();
-        float hum = dht.readHumidity();
-        
-        // Vérification si les lectures sont valides
-        if (!isnan(temp) && !isnan(hum)) {
-            temperature = temp;
-            humidite = hum;
-            Serial.print("DHT22 - Température: ");
-            Serial.print(temp);
-            Serial.print(" °C | Humidité: ");
-            Serial.print(hum);
-            Serial.println(" %");
-            
-            // Signaler le sémaphore une seule fois après la première mesure valide
-            if (!firstMeasureDone && xSemaphoreTempHumReady != NULL) {
-                xSemaphoreGive(xSemaphoreTempHumReady);
-                firstMeasureDone = true;
-                Serial.println("DHT22 - Premiere mesure valide, semaphore signale !");
-            }
-        } else {
-            Serial.println("DHT22 - Erreur de lecture du capteur");
-        }
+/**
+ * @brief Mesure du capteur DHT22.
+ * 
+ * Cette fonction lit en une seule trame la température et l'humidité du capteur DHT22
+ * et les publie ensemble dans le magasin de mesures (même numéro de séquence). 
+ * Elle est appelée par l'ordonnanceur toutes les `TEMPHUM_INTERVAL_MS`.
+ */
+void mesurerTempHum()
+{
+    // Lecture de la température et de l'humidité depuis une seule trame du DHT22
+    TrameDht22 trame = {};
+    const ResultatDht22 resultat = lireDht22(trame);
+    
+    // Vérification si la trame est valide (les champs ne sont renseignés que dans ce cas)
+    if (resultat == DHT22_OK) {
+        const float temp = trame.temperature;
+        const float hum = trame.humidite;
 
-        // Temporisation de la tâche avant la prochaine mesure (en millisecondes)
-        vTaskDelay(TEMPHUM_INTERVAL_MS / portTICK_PERIOD_MS);
+        // Publication du couple dans une seule écriture pour que les lecteurs
+        // ne voient jamais une température et une humidité de cycles différents
+        static const CanalMesure canaux[2] = { CANAL_TEMPERATURE, CANAL_HUMIDITE };
+        const float valeurs[2] = { temp, hum };
+        publierMesures(canaux, valeurs, 2);
+        Serial.print("DHT22 - Température: ");
+        Serial.print(temp);
+        Serial.print(" °C | Humidité: ");
+        Serial.print(hum);
+        Serial.println(" %");
+    } else {
+        invaliderMesure(CANAL_TEMPERATURE);
+        invaliderMesure(CANAL_HUMIDITE);
+        Serial.print("DHT22 - Erreur de lecture du capteur : ");
+        Serial.println(resultat == DHT22_ERREUR_DELAI ? "pas de reponse" :
+                       resultat == DHT22_ERREUR_SOMME ? "somme de controle" : "trame invalide");
     }
 }
+
+#endif // CAPTEUR_DHT22_ACTIF
@@ -0,0 +1,55 @@
+/**
+ * @file Arduino.h
+ * @brief Sous-ensemble du cœur Arduino ESP32 pour compiler les modules purs sur PC (env:native).
+ *
+ * Seuls les types et fonctions utilisés par les modules testés sont fournis. millis() lit une
+ * horloge simulée que les tests avancent eux-mêmes (horlogeNatif_ms) : aucun test ne dort.
+ */
+
+#ifndef ARDUINO_NATIF
+#define ARDUINO_NATIF
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <strings.h>
+#include <algorithm>
+
+using std::min;
+using std::max;
+
+typedef uint8_t byte;
+
+// Horloge simulée (ms), avancée par les tests
+inline uint32_t horlogeNatif_ms = 0;
+
+inline unsigned long millis() { return horlogeNatif_ms; }
+inline unsigned long micros() { return horlogeNatif_ms * 1000UL; }
+inline void delay(unsigned long ms) { horlogeNatif_ms += ms; }
+
+#define PROGMEM
+#define PGM_P const char *
+#define F(texte) (texte)
+#define FPSTR(texte) (texte)
+#define strlen_P strlen
+#define memcpy_P memcpy
+#define pgm_read_byte(adresse) (*(const uint8_t *)(adresse))
+
+// Console série : les traces des modules sont ignorées
+struct SerialNatif {
+  template <class... T> size_t print(T...) { return 0; }
+  template <class... T> size_t println(T...) { return 0; }
+  size_t printf(const char *, ...) { return 0; }
+};
+inline SerialNatif Serial;
+
+// Sections critiques FreeRTOS : les tests sont mono-tâche
+typedef int portMUX_TYPE;
+#define portMUX_INITIALIZER_UNLOCKED 0
+#define portENTER_CRITICAL(verrou) ((void)(verrou))
+#define portEXIT_CRITICAL(verrou) ((void)(verrou))
+
+#endif
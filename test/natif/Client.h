@@ -0,0 +1,54 @@
+/**
+ * @file Client.h
+ * @brief Interface Arduino `Client` (avec la partie de `Stream` utilisée) pour les tests sur PC.
+ *
+ * Les lectures de Stream n'attendent pas : le temps est simulé (horlogeNatif_ms), une lecture
+ * sans donnée disponible expire donc immédiatement, comme après setTimeout() écoulé.
+ */
+
+#ifndef CLIENT_NATIF
+#define CLIENT_NATIF
+
+#include <Arduino.h>
+
+class Client {
+public:
+  virtual ~Client() {}
+
+  virtual int connect(const char *hote, uint16_t port) = 0;
+  virtual size_t write(const uint8_t *tampon, size_t taille) = 0;
+  virtual int available() = 0;
+  virtual int read() = 0;
+  virtual void stop() = 0;
+  virtual uint8_t connected() = 0;
+
+  void setTimeout(unsigned long delai_ms) { delai = delai_ms; }
+
+  size_t readBytes(uint8_t *tampon, size_t taille) { return readBytes((char *)tampon, taille); }
+
+  size_t readBytes(char *tampon, size_t taille)
+  {
+    size_t n = 0;
+    int c;
+    while (n < taille && (c = read()) >= 0) {
+      tampon[n++] = (char)c;
+    }
+    return n;
+  }
+
+  // Le terminateur est consommé mais pas copié
+  size_t readBytesUntil(char terminateur, char *tampon, size_t taille)
+  {
+    size_t n = 0;
+    int c;
+    while (n < taille && (c = read()) >= 0 && c != terminateur) {
+      tampon[n++] = (char)c;
+    }
+    return n;
+  }
+
+protected:
+  unsigned long delai = 1000;
+};
+
+#endif
@@ -0,0 +1,79 @@
+/**
+ * @file ClientSimule.h
+ * @brief Client TCP simulé en mémoire : le test joue le serveur.
+ *
+ * Les octets écrits par le module testé s'accumulent dans `emis` ; ceux que le test place
+ * dans `aRecevoir` sont lus par le module comme venant du serveur. Connexion refusée et
+ * écriture interrompue se simulent avec `refuserConnexion` et `limiteEcriture`.
+ */
+
+#ifndef CLIENT_SIMULE
+#define CLIENT_SIMULE
+
+#include <Client.h>
+#include <string>
+
+class ClientSimule : public Client {
+public:
+  std::string emis;                   // Octets envoyés au serveur
+  std::string aRecevoir;              // Octets du serveur pas encore lus
+  std::string hote;                   // Dernier hôte demandé à connect()
+  uint16_t port = 0;
+  bool ouvert = false;
+  bool refuserConnexion = false;
+  size_t limiteEcriture = SIZE_MAX;   // Octets encore acceptés avant une erreur d'écriture
+  uint32_t nbConnexions = 0;
+
+  int connect(const char *h, uint16_t p) override
+  {
+    hote = h;
+    port = p;
+    if (refuserConnexion) {
+      return 0;
+    }
+    ouvert = true;
+    nbConnexions++;
+    return 1;
+  }
+
+  size_t write(const uint8_t *tampon, size_t taille) override
+  {
+    if (!ouvert) {
+      return 0;
+    }
+    const size_t n = taille < limiteEcriture ? taille : limiteEcriture;
+    emis.append((const char *)tampon, n);
+    limiteEcriture -= limiteEcriture == SIZE_MAX ? 0 : n;
+    return n;
+  }
+
+  int available() override { return ouvert ? (int)aRecevoir.size() : 0; }
+
+  int read() override
+  {
+    if (!ouvert || aRecevoir.empty()) {
+      return -1;
+    }
+    const uint8_t c = aRecevoir[0];
+    aRecevoir.erase(0, 1);
+    return c;
+  }
+
+  void stop() override { ouvert = false; }
+
+  uint8_t connected() override { return ouvert; }
+
+  // Ajoute des octets bruts à recevoir
+  void recevoir(const void *donnees, size_t longueur) { aRecevoir.append((const char *)donnees, longueur); }
+  void recevoir(const std::string &texte) { aRecevoir.append(texte); }
+
+  // Vide et rend les octets émis depuis l'appel précédent
+  std::string prendreEmis()
+  {
+    std::string s;
+    s.swap(emis);
+    return s;
+  }
+};
+
+#endif
@@ -0,0 +1,133 @@
+/**
+ * @file FS.h
+ * @brief Système de fichiers simulé en mémoire (sous-ensemble de fs::File) pour les tests natifs.
+ *
+ * Les fichiers sont des tableaux d'octets dans `flashNatif`, que les tests lisent et modifient
+ * directement (enregistrement tronqué, octet corrompu...). Une flash pleine se simule avec
+ * `capacite` (une écriture s'arrête au dernier octet libre) et un fichier illisible en ajoutant
+ * son chemin à `illisibles` (ouverture refusée).
+ */
+
+#ifndef FS_NATIF
+#define FS_NATIF
+
+#include <Arduino.h>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+#define FILE_READ "r"
+#define FILE_WRITE "w"
+#define FILE_APPEND "a"
+
+struct FlashNatif {
+  std::map<std::string, std::vector<uint8_t>> fichiers;   // Chemin absolu -> contenu
+  std::set<std::string> illisibles;                       // Chemins dont l'ouverture échoue
+  size_t capacite = SIZE_MAX;                             // Octets de données au total
+
+  size_t utilises() const
+  {
+    size_t n = 0;
+    for (const auto &f : fichiers) n += f.second.size();
+    return n;
+  }
+
+  void effacer()
+  {
+    fichiers.clear();
+    illisibles.clear();
+    capacite = SIZE_MAX;
+  }
+};
+inline FlashNatif flashNatif;
+
+class File {
+public:
+  File() = default;
+
+  explicit operator bool() const { return ouvert && (racine || flashNatif.fichiers.count(chemin) > 0); }
+
+  size_t read(uint8_t *tampon, size_t taille)
+  {
+    if (!*this || racine) {
+      return 0;
+    }
+    const std::vector<uint8_t> &octets = flashNatif.fichiers[chemin];
+    const size_t n = position < octets.size() ? min(taille, octets.size() - position) : 0;
+    memcpy(tampon, octets.data() + position, n);
+    position += n;
+    return n;
+  }
+
+  size_t write(const uint8_t *tampon, size_t taille)
+  {
+    if (!*this || racine || lecture) {
+      return 0;
+    }
+    const size_t utilises = flashNatif.utilises();
+    const size_t libres = flashNatif.capacite > utilises ? flashNatif.capacite - utilises : 0;
+    const size_t n = min(taille, libres);
+    std::vector<uint8_t> &octets = flashNatif.fichiers[chemin];
+    octets.insert(octets.end(), tampon, tampon + n);
+    position = octets.size();
+    return n;
+  }
+
+  bool seek(uint32_t pos)
+  {
+    if (!*this || pos > size()) {
+      return false;
+    }
+    position = pos;
+    return true;
+  }
+
+  size_t size() const { return *this && !racine ? flashNatif.fichiers[chemin].size() : 0; }
+  void flush() {}
+  void close() { ouvert = false; }
+
+  // Nom sans le "/" initial, comme le cœur Arduino ESP32 2.x
+  const char *name() const { return chemin.c_str() + 1; }
+
+  File openNextFile()
+  {
+    if (!racine || suivant >= contenu.size()) {
+      return File();
+    }
+    return File(contenu[suivant++], FILE_READ);
+  }
+
+  File(const std::string &c, const char *mode) : chemin(c), lecture(strcmp(mode, FILE_READ) == 0)
+  {
+    if (chemin == "/") {
+      racine = true;
+      ouvert = true;
+      for (const auto &f : flashNatif.fichiers) contenu.push_back(f.first);
+      return;
+    }
+    if (flashNatif.illisibles.count(chemin) > 0) {
+      return;
+    }
+    if (strcmp(mode, FILE_WRITE) == 0) {
+      flashNatif.fichiers[chemin].clear();
+    } else if (strcmp(mode, FILE_APPEND) == 0) {
+      flashNatif.fichiers[chemin];
+    } else if (flashNatif.fichiers.count(chemin) == 0) {
+      return;
+    }
+    ouvert = true;
+    position = lecture ? 0 : flashNatif.fichiers[chemin].size();
+  }
+
+private:
+  std::string chemin;
+  bool lecture = true;
+  bool ouvert = false;
+  size_t position = 0;
+  bool racine = false;
+  std::vector<std::string> contenu;   // Racine : chemins présents à l'ouverture
+  size_t suivant = 0;
+};
+
+#endif
@@ -0,0 +1,23 @@
+/**
+ * @file IPAddress.h
+ * @brief Adresse IPv4 Arduino réduite à ce qu'utilisent les modules testés sur PC.
+ */
+
+#ifndef IPADDRESS_NATIF
+#define IPADDRESS_NATIF
+
+#include <Arduino.h>
+
+class IPAddress {
+public:
+  IPAddress() {}
+  IPAddress(uint8_t a, uint8_t b, uint8_t c, uint8_t d) : octets{ a, b, c, d } {}
+
+  uint8_t operator[](int i) const { return octets[i]; }
+  bool operator==(const IPAddress &autre) const { return memcmp(octets, autre.octets, 4) == 0; }
+
+private:
+  uint8_t octets[4] = {};
+};
+
+#endif
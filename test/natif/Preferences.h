@@ -0,0 +1,41 @@
+/**
+ * @file Preferences.h
+ * @brief Stockage NVS simulé en mémoire : les valeurs survivent aux redémarrages simulés.
+ */
+
+#ifndef PREFERENCES_NATIF
+#define PREFERENCES_NATIF
+
+#include <Arduino.h>
+#include <map>
+#include <string>
+
+// Clés "espace/cle" -> valeur ; les tests peuvent les lire, les modifier ou les effacer
+inline std::map<std::string, uint32_t> nvsNatif;
+
+class Preferences {
+public:
+  bool begin(const char *nom, bool lectureSeule = false)
+  {
+    espace = nom;
+    return true;
+  }
+  void end() {}
+
+  uint32_t getUInt(const char *cle, uint32_t defaut = 0)
+  {
+    const auto v = nvsNatif.find(espace + "/" + cle);
+    return v != nvsNatif.end() ? v->second : defaut;
+  }
+
+  size_t putUInt(const char *cle, uint32_t valeur)
+  {
+    nvsNatif[espace + "/" + cle] = valeur;
+    return sizeof(valeur);
+  }
+
+private:
+  std::string espace;
+};
+
+#endif
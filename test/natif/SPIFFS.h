@@ -0,0 +1,19 @@
+/**
+ * @file SPIFFS.h
+ * @brief Partition SPIFFS simulée en mémoire (voir FS.h), toujours montée.
+ */
+
+#ifndef SPIFFS_NATIF
+#define SPIFFS_NATIF
+
+#include <FS.h>
+
+struct SPIFFSNatif {
+  bool begin(bool formaterSiEchec = false) { return true; }
+  File open(const char *chemin, const char *mode = FILE_READ) { return File(chemin, mode); }
+  bool exists(const char *chemin) { return flashNatif.fichiers.count(chemin) > 0; }
+  bool remove(const char *chemin) { return flashNatif.fichiers.erase(chemin) > 0; }
+};
+inline SPIFFSNatif SPIFFS;
+
+#endif
@@ -0,0 +1,21 @@
+/**
+ * @file Udp.h
+ * @brief Interface Arduino `UDP` (partie émission) pour les tests sur PC.
+ */
+
+#ifndef UDP_NATIF
+#define UDP_NATIF
+
+#include <Arduino.h>
+#include <IPAddress.h>
+
+class UDP {
+public:
+  virtual ~UDP() {}
+
+  virtual int beginPacket(IPAddress adresse, uint16_t port) = 0;
+  virtual size_t write(const uint8_t *tampon, size_t taille) = 0;
+  virtual int endPacket() = 0;
+};
+
+#endif
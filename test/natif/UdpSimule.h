@@ -0,0 +1,63 @@
+/**
+ * @file UdpSimule.h
+ * @brief Socket UDP simulée en mémoire : chaque datagramme remis est conservé pour le test.
+ *
+ * Un datagramme refusé par la pile réseau se simule avec `refuserPaquet` (beginPacket) ou
+ * `refuserEnvoi` (endPacket).
+ */
+
+#ifndef UDP_SIMULE
+#define UDP_SIMULE
+
+#include <Udp.h>
+#include <string>
+#include <vector>
+
+class UdpSimule : public UDP {
+public:
+  std::vector<std::string> datagrammes;   // Datagrammes remis, dans l'ordre
+  IPAddress adresse;                      // Destination du dernier datagramme
+  uint16_t port = 0;
+  bool refuserPaquet = false;
+  bool refuserEnvoi = false;
+
+  int beginPacket(IPAddress a, uint16_t p) override
+  {
+    if (refuserPaquet) {
+      return 0;
+    }
+    adresse = a;
+    port = p;
+    enCours.clear();
+    ouvert = true;
+    return 1;
+  }
+
+  size_t write(const uint8_t *tampon, size_t taille) override
+  {
+    if (!ouvert) {
+      return 0;
+    }
+    enCours.append((const char *)tampon, taille);
+    return taille;
+  }
+
+  int endPacket() override
+  {
+    if (!ouvert) {
+      return 0;
+    }
+    ouvert = false;
+    if (refuserEnvoi) {
+      return 0;
+    }
+    datagrammes.push_back(enCours);
+    return 1;
+  }
+
+private:
+  std::string enCours;
+  bool ouvert = false;
+};
+
+#endif
@@ -0,0 +1,15 @@
+/**
+ * @file esp_sntp.h
+ * @brief Client SNTP absent des tests natifs : aucune synchronisation n'est notifiée.
+ */
+
+#ifndef ESP_SNTP_NATIF
+#define ESP_SNTP_NATIF
+
+#include <sys/time.h>
+
+typedef void (*sntp_sync_time_cb_t)(struct timeval *tv);
+
+inline void sntp_set_time_sync_notification_cb(sntp_sync_time_cb_t rappel) {}
+
+#endif
@@ -0,0 +1,13 @@
+/**
+ * @file esp_timer.h
+ * @brief Compteur monotone ESP-IDF lu sur l'horloge simulée des tests natifs.
+ */
+
+#ifndef ESP_TIMER_NATIF
+#define ESP_TIMER_NATIF
+
+#include <Arduino.h>
+
+inline int64_t esp_timer_get_time() { return (int64_t)horlogeNatif_ms * 1000; }
+
+#endif
@@ -0,0 +1,22 @@
+/**
+ * @file FreeRTOS.h
+ * @brief Types et délais FreeRTOS pour les tests natifs (mono-tâche) : un délai avance l'horloge simulée.
+ */
+
+#ifndef FREERTOS_NATIF
+#define FREERTOS_NATIF
+
+#include <Arduino.h>
+
+typedef uint32_t TickType_t;
+typedef int BaseType_t;
+typedef unsigned int UBaseType_t;
+
+#define pdTRUE 1
+#define pdFALSE 0
+#define portTICK_PERIOD_MS 1
+#define pdMS_TO_TICKS(ms) ((TickType_t)(ms))
+
+inline void vTaskDelay(TickType_t ticks) { horlogeNatif_ms += ticks; }
+
+#endif
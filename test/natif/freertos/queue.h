@@ -0,0 +1,49 @@
+/**
+ * @file queue.h
+ * @brief Files FreeRTOS simulées en mémoire, sans attente (tests mono-tâche).
+ */
+
+#ifndef FREERTOS_QUEUE_NATIF
+#define FREERTOS_QUEUE_NATIF
+
+#include "freertos/FreeRTOS.h"
+#include <deque>
+#include <vector>
+
+struct FileNatif {
+  size_t profondeur;
+  size_t taille;
+  std::deque<std::vector<uint8_t>> elements;
+};
+typedef FileNatif *QueueHandle_t;
+
+inline QueueHandle_t xQueueCreate(UBaseType_t profondeur, UBaseType_t taille)
+{
+  return new FileNatif{ profondeur, taille, {} };
+}
+
+inline void vQueueDelete(QueueHandle_t file) { delete file; }
+
+inline BaseType_t xQueueSend(QueueHandle_t file, const void *element, TickType_t attente)
+{
+  if (file->elements.size() >= file->profondeur) {
+    return pdFALSE;
+  }
+  const uint8_t *octets = (const uint8_t *)element;
+  file->elements.emplace_back(octets, octets + file->taille);
+  return pdTRUE;
+}
+
+inline BaseType_t xQueueReceive(QueueHandle_t file, void *element, TickType_t attente)
+{
+  if (file->elements.empty()) {
+    return pdFALSE;
+  }
+  memcpy(element, file->elements.front().data(), file->taille);
+  file->elements.pop_front();
+  return pdTRUE;
+}
+
+inline UBaseType_t uxQueueMessagesWaiting(QueueHandle_t file) { return file->elements.size(); }
+
+#endif
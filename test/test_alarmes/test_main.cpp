@@ -0,0 +1,179 @@
+/**
+ * @file test_main.cpp
+ * @brief Tests natifs des alarmes de seuil : chaîne du portail, hystérésis et changement de configuration.
+ *
+ * Les échantillons passent par le magasin de mesures (publierMesures), comme sur la cible, et
+ * les événements sont relus dans la file de la tâche d'envoi (attendreAlarme). Chaque test part
+ * des seuils par défaut du registre (eCO2 > 1500 ppm, hystérésis 200) et d'un canal hors alarme.
+ */
+
+#include <unity.h>
+#include <vector>
+#include "alarmes.h"
+
+static const CanalMesure CO2 = CANAL_CO2;
+
+static void publier(CanalMesure canal, float valeur)
+{
+    publierMesures(&canal, &valeur, 1);
+}
+
+// Événements déposés depuis l'appel précédent
+static std::vector<EvenementAlarme> relever()
+{
+    std::vector<EvenementAlarme> evenements;
+    EvenementAlarme e;
+    while (attendreAlarme(e, 0)) {
+        evenements.push_back(e);
+    }
+    return evenements;
+}
+
+void setUp()
+{
+    TEST_ASSERT_TRUE(appliquerAlarmes(""));
+    publier(CO2, 400);
+    relever();
+}
+
+void tearDown() {}
+
+// Chaîne du portail : entrées invalides ignorées, les autres appliquées
+static void test_analyse_configuration()
+{
+    TEST_ASSERT_TRUE(appliquerAlarmes("co2>1200/100;temperature<5/1;tvoc=off"));
+    TEST_ASSERT_TRUE(appliquerAlarmes(";co2>1200;"));
+
+    TEST_ASSERT_FALSE(appliquerAlarmes("co2"));
+    TEST_ASSERT_FALSE(appliquerAlarmes("co2>"));
+    TEST_ASSERT_FALSE(appliquerAlarmes("co2>x"));
+    TEST_ASSERT_FALSE(appliquerAlarmes("co2>1200/"));
+    TEST_ASSERT_FALSE(appliquerAlarmes("co2>1200/-5"));
+    TEST_ASSERT_FALSE(appliquerAlarmes("co2>1200/100x"));
+    TEST_ASSERT_FALSE(appliquerAlarmes("co2=on"));
+    TEST_ASSERT_FALSE(appliquerAlarmes("inconnu>1"));
+
+    // Entrée invalide à côté d'une valide : la valide s'applique
+    TEST_ASSERT_FALSE(appliquerAlarmes("inconnu>1;co2>800/50"));
+    publier(CO2, 900);
+    const std::vector<EvenementAlarme> e = relever();
+    TEST_ASSERT_EQUAL(1, e.size());
+    TEST_ASSERT_EQUAL(ALARME_SEUIL, e[0].type);
+    TEST_ASSERT_EQUAL_FLOAT(800, e[0].seuil);
+}
+
+// eCO2 qui oscille autour du seuil sans repasser sous l'hystérésis : une levée, puis une fin au retour
+static void test_oscillation_autour_du_seuil()
+{
+    for (int k = 0; k < 200; k++) {
+        publier(CO2, 1500 + (k % 2 ? 150 : -150) + k % 7);
+    }
+    publier(CO2, 1250);
+
+    const std::vector<EvenementAlarme> e = relever();
+    TEST_ASSERT_EQUAL(2, e.size());
+    TEST_ASSERT_EQUAL(ALARME_SEUIL, e[0].type);
+    TEST_ASSERT_EQUAL_FLOAT(1651, e[0].valeur);
+    TEST_ASSERT_EQUAL_FLOAT(1500, e[0].seuil);
+    TEST_ASSERT_EQUAL(ALARME_FIN_SEUIL, e[1].type);
+    TEST_ASSERT_EQUAL_FLOAT(1250, e[1].valeur);
+}
+
+// Alarme basse : levée sous le seuil, close au-dessus du seuil plus l'hystérésis
+static void test_alarme_basse()
+{
+    TEST_ASSERT_TRUE(appliquerAlarmes("temperature<5/1"));
+    publier(CANAL_TEMPERATURE, 4.5f);
+    publier(CANAL_TEMPERATURE, 5.5f);
+    publier(CANAL_TEMPERATURE, 4.0f);
+    publier(CANAL_TEMPERATURE, 6.5f);
+
+    const std::vector<EvenementAlarme> e = relever();
+    TEST_ASSERT_EQUAL(2, e.size());
+    TEST_ASSERT_EQUAL(ALARME_SEUIL, e[0].type);
+    TEST_ASSERT_EQUAL(ALARME_FIN_SEUIL, e[1].type);
+    TEST_ASSERT_EQUAL_FLOAT(6.5f, e[1].valeur);
+}
+
+// Canal désactivé dans le portail pendant une alarme : la fin est signalée avant l'oubli de l'état
+static void test_desactivation_close_l_alarme()
+{
+    publier(CO2, 1600);
+    TEST_ASSERT_EQUAL(1, relever().size());
+
+    TEST_ASSERT_TRUE(appliquerAlarmes("co2=off"));
+    publier(CO2, 1600);
+    publier(CO2, 2000);
+
+    const std::vector<EvenementAlarme> e = relever();
+    TEST_ASSERT_EQUAL(1, e.size());
+    TEST_ASSERT_EQUAL(ALARME_FIN_SEUIL, e[0].type);
+    TEST_ASSERT_EQUAL_FLOAT(1500, e[0].seuil);
+}
+
+// Seuil modifié pendant une alarme : fin sur l'ancien seuil, puis comparaison au nouveau
+static void test_changement_de_seuil()
+{
+    publier(CO2, 1600);
+    TEST_ASSERT_EQUAL(1, relever().size());
+
+    // Nouveau seuil au-dessus de la valeur : l'alarme est close
+    TEST_ASSERT_TRUE(appliquerAlarmes("co2>1800/100"));
+    publier(CO2, 1600);
+    std::vector<EvenementAlarme> e = relever();
+    TEST_ASSERT_EQUAL(1, e.size());
+    TEST_ASSERT_EQUAL(ALARME_FIN_SEUIL, e[0].type);
+    TEST_ASSERT_EQUAL_FLOAT(1500, e[0].seuil);
+
+    // Nouveau seuil toujours franchi : fin sur l'ancien, levée sur le nouveau au même échantillon
+    publier(CO2, 1900);
+    TEST_ASSERT_TRUE(appliquerAlarmes("co2>1700/100"));
+    publier(CO2, 1900);
+    e = relever();
+    TEST_ASSERT_EQUAL(3, e.size());
+    TEST_ASSERT_EQUAL(ALARME_SEUIL, e[0].type);
+    TEST_ASSERT_EQUAL_FLOAT(1800, e[0].seuil);
+    TEST_ASSERT_EQUAL(ALARME_FIN_SEUIL, e[1].type);
+    TEST_ASSERT_EQUAL_FLOAT(1800, e[1].seuil);
+    TEST_ASSERT_EQUAL(ALARME_SEUIL, e[2].type);
+    TEST_ASSERT_EQUAL_FLOAT(1700, e[2].seuil);
+
+    // Hystérésis seule modifiée : l'alarme reste levée
+    TEST_ASSERT_TRUE(appliquerAlarmes("co2>1700/300"));
+    publier(CO2, 1500);
+    TEST_ASSERT_EQUAL(0, relever().size());
+}
+
+// File pleine : la fin due à la désactivation est retentée à l'échantillon suivant
+static void test_fin_retentee_file_pleine()
+{
+    publier(CO2, 1600);
+    relever();
+    TEST_ASSERT_TRUE(appliquerAlarmes("co2=off;temperature<5"));
+    for (int k = 0; k < ALARMES_FILE_PROFONDEUR; k++) {
+        publier(CANAL_TEMPERATURE, k % 2 ? 10 : 0);
+    }
+    const uint32_t perdues = lireStatsAlarmes().perdues;
+    publier(CO2, 1600);
+    TEST_ASSERT_EQUAL_UINT32(perdues + 1, lireStatsAlarmes().perdues);
+
+    TEST_ASSERT_EQUAL(ALARMES_FILE_PROFONDEUR, relever().size());
+    publier(CO2, 1600);
+    const std::vector<EvenementAlarme> e = relever();
+    TEST_ASSERT_EQUAL(1, e.size());
+    TEST_ASSERT_EQUAL(ALARME_FIN_SEUIL, e[0].type);
+    TEST_ASSERT_EQUAL(CO2, e[0].canal);
+}
+
+int main(int argc, char **argv)
+{
+    initAlarmes();
+    UNITY_BEGIN();
+    RUN_TEST(test_analyse_configuration);
+    RUN_TEST(test_oscillation_autour_du_seuil);
+    RUN_TEST(test_alarme_basse);
+    RUN_TEST(test_desactivation_close_l_alarme);
+    RUN_TEST(test_changement_de_seuil);
+    RUN_TEST(test_fin_retentee_file_pleine);
+    return UNITY_END();
+}
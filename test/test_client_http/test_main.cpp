@@ -0,0 +1,294 @@
+/**
+ * @file test_main.cpp
+ * @brief Tests natifs du client HTTP contre un Client simulé : requêtes chunked, pipelining
+ *        keep-alive, lecture des réponses (Content-Length, chunked, Connection: close), refus et délai.
+ */
+
+#include <unity.h>
+#include <ClientSimule.h>
+#include <vector>
+#include "client_http.h"
+
+static ClientSimule transport;
+static std::vector<uint32_t> reponses;
+static std::vector<std::pair<uint32_t, int>> refus;
+
+// Fragments du corps rendus un à un par la source
+static std::vector<std::string> fragments;
+static size_t prochainFragment;
+
+static size_t source(const uint8_t **donnees)
+{
+    if (prochainFragment == fragments.size()) {
+        return 0;
+    }
+    const std::string &f = fragments[prochainFragment++];
+    *donnees = (const uint8_t *)f.data();
+    return f.size();
+}
+
+static void noterReponse(uint32_t jeton)
+{
+    reponses.push_back(jeton);
+}
+
+static void noterRefus(uint32_t jeton, int statut)
+{
+    refus.push_back({ jeton, statut });
+}
+
+// Requête dont le corps est `corps` en un seul fragment
+static bool envoyer(ClientHttp &http, const std::string &corps, uint32_t jeton)
+{
+    fragments = { corps };
+    prochainFragment = 0;
+    return http.envoyer("/mesures", "application/cbor-seq", source, jeton);
+}
+
+static ClientHttp *connecter(ClientHttp &http)
+{
+    http.surReponse(noterReponse);
+    http.surRefus(noterRefus);
+    TEST_ASSERT_TRUE(http.connecter("serveur", 8080, nullptr, nullptr));
+    return &http;
+}
+
+static const char REPONSE_204[] = "HTTP/1.1 204 No Content\r\n\r\n";
+
+void setUp()
+{
+    transport = ClientSimule();
+    horlogeNatif_ms = 1000;
+    reponses.clear();
+    refus.clear();
+}
+
+void tearDown() {}
+
+// Octets exacts d'un POST : en-têtes, un fragment chunked par fragment de la source, fragment final
+static void test_requete_chunked()
+{
+    ClientHttp http(transport);
+    connecter(http);
+    TEST_ASSERT_EQUAL_STRING("serveur", transport.hote.c_str());
+    TEST_ASSERT_EQUAL(8080, transport.port);
+
+    fragments = { "bonjour", std::string(300, 'x') };
+    prochainFragment = 0;
+    TEST_ASSERT_TRUE(http.envoyer("/mesures", "application/x-ndjson", source, 1));
+
+    const std::string attendu = "POST /mesures HTTP/1.1\r\nHost: serveur:8080\r\nContent-Type: application/x-ndjson\r\n"
+                                "Transfer-Encoding: chunked\r\n\r\n"
+                                "7\r\nbonjour\r\n12c\r\n" + std::string(300, 'x') + "\r\n0\r\n\r\n";
+    TEST_ASSERT_EQUAL_STRING(attendu.c_str(), transport.prendreEmis().c_str());
+    TEST_ASSERT_EQUAL(307, http.lireStats().octetsCorps);
+    TEST_ASSERT_EQUAL(1, http.enVol());
+}
+
+// Port 80 : Host sans port ; identifiants en Basic
+static void test_host_et_authentification()
+{
+    ClientHttp http(transport);
+    TEST_ASSERT_TRUE(http.connecter("serveur", 80, "u", "mdp"));
+    TEST_ASSERT_TRUE(envoyer(http, "a", 1));
+    const std::string emis = transport.prendreEmis();
+    TEST_ASSERT_TRUE(emis.find("\r\nHost: serveur\r\n") != std::string::npos);
+    TEST_ASSERT_TRUE(emis.find("\r\nAuthorization: Basic dTptZHA=\r\n") != std::string::npos);
+}
+
+// Adresse du portail de 79 caractères : l'en-tête Host la contient avec le port
+static void test_hote_long()
+{
+    ClientHttp http(transport);
+    const std::string hote(79, 'h');
+    TEST_ASSERT_TRUE(http.connecter(hote.c_str(), 65535, nullptr, nullptr));
+    TEST_ASSERT_TRUE(envoyer(http, "a", 1));
+    TEST_ASSERT_TRUE(transport.prendreEmis().find("\r\nHost: " + hote + ":65535\r\n") != std::string::npos);
+
+    // Au-delà, la connexion est refusée plutôt que d'envoyer un Host tronqué
+    const std::string tropLong(HTTP_TAILLE_HOTE, 'h');
+    TEST_ASSERT_FALSE(http.connecter(tropLong.c_str(), 8080, nullptr, nullptr));
+    TEST_ASSERT_EQUAL(1, transport.nbConnexions);
+    TEST_ASSERT_EQUAL(1, http.lireStats().echecsConnexion);
+}
+
+// HTTP_PIPELINE requêtes sans attendre ; les réponses groupées sont rendues dans l'ordre et la
+// connexion est gardée (keep-alive)
+static void test_pipeline_keepalive()
+{
+    ClientHttp http(transport);
+    connecter(http);
+
+    for (uint32_t i = 0; i < HTTP_PIPELINE; i++) {
+        TEST_ASSERT_TRUE(http.placesLibres(true) > 0);
+        TEST_ASSERT_TRUE(envoyer(http, "lot", 10 + i));
+    }
+    TEST_ASSERT_EQUAL(0, http.placesLibres(true));
+    TEST_ASSERT_FALSE(envoyer(http, "lot", 99));
+    TEST_ASSERT_EQUAL(HTTP_PIPELINE, http.lireStats().requetes);
+
+    // Réponses arrivées d'un bloc, corps en Content-Length, chunked ou absent
+    transport.recevoir("HTTP/1.1 200 OK\r\nContent-Length: 5\r\n\r\nmerci");
+    transport.recevoir("HTTP/1.1 201 Created\r\nTransfer-Encoding: chunked\r\n\r\n3\r\nabc\r\n0\r\n\r\n");
+    transport.recevoir(REPONSE_204);
+    http.traiter();
+    TEST_ASSERT_EQUAL(3, reponses.size());
+    TEST_ASSERT_EQUAL_UINT32(10, reponses[0]);
+    TEST_ASSERT_EQUAL_UINT32(11, reponses[1]);
+    TEST_ASSERT_EQUAL_UINT32(12, reponses[2]);
+    TEST_ASSERT_EQUAL(1, http.enVol());
+    TEST_ASSERT_TRUE(http.connecte());
+
+    // La même connexion sert aux requêtes suivantes
+    TEST_ASSERT_TRUE(envoyer(http, "lot", 20));
+    transport.recevoir(REPONSE_204);
+    transport.recevoir(REPONSE_204);
+    http.traiter();
+    TEST_ASSERT_EQUAL(5, reponses.size());
+    TEST_ASSERT_EQUAL_UINT32(13, reponses[3]);
+    TEST_ASSERT_EQUAL_UINT32(20, reponses[4]);
+    TEST_ASSERT_EQUAL(1, transport.nbConnexions);
+    TEST_ASSERT_EQUAL(5, http.lireStats().reponsesOk);
+}
+
+// Corps chunked en plusieurs fragments, extension de fragment et en-têtes de fin
+static void test_reponse_chunked_complete()
+{
+    ClientHttp http(transport);
+    connecter(http);
+    TEST_ASSERT_TRUE(envoyer(http, "a", 1));
+    TEST_ASSERT_TRUE(envoyer(http, "b", 2));
+
+    transport.recevoir("HTTP/1.1 200 OK\r\ntransfer-encoding: chunked\r\n\r\n"
+                       "4;ext=1\r\nabcd\r\n1A\r\n" + std::string(26, 'z') + "\r\n0\r\nX-Fin: 1\r\n\r\n");
+    transport.recevoir("HTTP/1.0 200 OK\r\nContent-Length: 0\r\n\r\n");
+    http.traiter();
+    TEST_ASSERT_EQUAL(2, reponses.size());
+    TEST_ASSERT_EQUAL(0, transport.aRecevoir.size());
+    TEST_ASSERT_TRUE(http.connecte());
+}
+
+// Connection: close après un succès : la réponse compte, puis la connexion est fermée
+static void test_connection_close()
+{
+    ClientHttp http(transport);
+    connecter(http);
+    TEST_ASSERT_TRUE(envoyer(http, "a", 7));
+    transport.recevoir("HTTP/1.1 200 OK\r\nConnection: close\r\nContent-Length: 2\r\n\r\nok");
+    http.traiter();
+    TEST_ASSERT_EQUAL(1, reponses.size());
+    TEST_ASSERT_FALSE(http.connecte());
+    TEST_ASSERT_EQUAL(0, http.placesLibres(true));
+}
+
+// Réponse d'erreur : statut et jeton signalés, connexion fermée, requêtes suivantes perdues
+static void test_reponse_erreur()
+{
+    ClientHttp http(transport);
+    connecter(http);
+    TEST_ASSERT_TRUE(envoyer(http, "a", 1));
+    TEST_ASSERT_TRUE(envoyer(http, "b", 2));
+    TEST_ASSERT_TRUE(envoyer(http, "c", 3));
+
+    transport.recevoir(REPONSE_204);
+    transport.recevoir("HTTP/1.1 413 Payload Too Large\r\nContent-Length: 4\r\n\r\ngros");
+    transport.recevoir(REPONSE_204);
+    http.traiter();
+
+    TEST_ASSERT_EQUAL(1, reponses.size());
+    TEST_ASSERT_EQUAL(1, refus.size());
+    TEST_ASSERT_EQUAL_UINT32(2, refus[0].first);
+    TEST_ASSERT_EQUAL(413, refus[0].second);
+    TEST_ASSERT_FALSE(http.connecte());
+    TEST_ASSERT_EQUAL(1, http.lireStats().reponsesErreur);
+
+    // Reconnexion : pipeline vide, l'appelant reconstruit les requêtes perdues
+    TEST_ASSERT_TRUE(http.connecter("serveur", 8080, nullptr, nullptr));
+    TEST_ASSERT_EQUAL(0, http.enVol());
+    TEST_ASSERT_EQUAL(HTTP_PIPELINE, http.placesLibres(true));
+}
+
+// Ligne d'état illisible : connexion fermée sans rappel
+static void test_reponse_illisible()
+{
+    ClientHttp http(transport);
+    connecter(http);
+    TEST_ASSERT_TRUE(envoyer(http, "a", 1));
+    transport.recevoir("SSH-2.0-OpenSSH\r\n");
+    http.traiter();
+    TEST_ASSERT_FALSE(http.connecte());
+    TEST_ASSERT_EQUAL(0, reponses.size());
+    TEST_ASSERT_EQUAL(0, refus.size());
+}
+
+// Pas de réponse dans HTTP_DELAI_REPONSE_MS : connexion considérée comme perdue
+static void test_delai_reponse()
+{
+    ClientHttp http(transport);
+    connecter(http);
+    TEST_ASSERT_TRUE(envoyer(http, "a", 1));
+
+    horlogeNatif_ms += HTTP_DELAI_REPONSE_MS;
+    http.traiter();
+    TEST_ASSERT_TRUE(http.connecte());
+
+    horlogeNatif_ms += 1;
+    http.traiter();
+    TEST_ASSERT_FALSE(http.connecte());
+    TEST_ASSERT_EQUAL(1, http.lireStats().reponsesErreur);
+}
+
+// Plafond de débit pour les lots, pas pour une requête prioritaire (alarme)
+static void test_plafond_debit()
+{
+    ClientHttp http(transport);
+    connecter(http);
+    TEST_ASSERT_EQUAL(HTTP_PIPELINE, http.placesLibres());
+    TEST_ASSERT_TRUE(envoyer(http, "a", 1));
+
+    TEST_ASSERT_EQUAL(0, http.placesLibres());
+    TEST_ASSERT_EQUAL(HTTP_PIPELINE - 1, http.placesLibres(true));
+    horlogeNatif_ms += 1000 / HTTP_REQUETES_PAR_S;
+    TEST_ASSERT_EQUAL(HTTP_PIPELINE - 1, http.placesLibres());
+}
+
+// Écriture interrompue pendant le corps : envoi refusé, connexion fermée, rien en vol
+static void test_echec_ecriture()
+{
+    ClientHttp http(transport);
+    connecter(http);
+    transport.limiteEcriture = 100;
+    TEST_ASSERT_FALSE(envoyer(http, std::string(200, 'x'), 1));
+    TEST_ASSERT_FALSE(http.connecte());
+    TEST_ASSERT_EQUAL(0, http.enVol());
+    TEST_ASSERT_EQUAL(0, http.lireStats().requetes);
+}
+
+// Octets reçus sans requête en vol : ignorés
+static void test_donnees_hors_requete()
+{
+    ClientHttp http(transport);
+    connecter(http);
+    transport.recevoir("\r\n");
+    http.traiter();
+    TEST_ASSERT_TRUE(http.connecte());
+    TEST_ASSERT_EQUAL(0, transport.aRecevoir.size());
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_requete_chunked);
+    RUN_TEST(test_host_et_authentification);
+    RUN_TEST(test_hote_long);
+    RUN_TEST(test_pipeline_keepalive);
+    RUN_TEST(test_reponse_chunked_complete);
+    RUN_TEST(test_connection_close);
+    RUN_TEST(test_reponse_erreur);
+    RUN_TEST(test_reponse_illisible);
+    RUN_TEST(test_delai_reponse);
+    RUN_TEST(test_plafond_debit);
+    RUN_TEST(test_echec_ecriture);
+    RUN_TEST(test_donnees_hors_requete);
+    return UNITY_END();
+}
@@ -0,0 +1,175 @@
+/**
+ * @file test_main.cpp
+ * @brief Tests natifs du client UDP contre une socket simulée : trame brute et octets de l'en-tête CoAP NON.
+ *
+ * Les en-têtes CoAP attendus sont écrits à la main d'après la RFC 7252 (§3 en-tête, §3.1 options) :
+ * Ver=1, T=NON (1), TKL=4 -> 0x54 ; code 0.02 POST ; Message ID ; jeton ; options ; 0xFF.
+ */
+
+#include <unity.h>
+#include <UdpSimule.h>
+#include "client_udp.h"
+
+static const IPAddress PUITS(192, 168, 1, 20);
+
+static UdpSimule socketUdp;
+
+static std::string octets(std::initializer_list<uint8_t> liste)
+{
+    return std::string(liste.begin(), liste.end());
+}
+
+void setUp()
+{
+    socketUdp = UdpSimule();
+}
+
+void tearDown() {}
+
+// Trame brute : séquence gros-boutiste sur 4 octets puis la charge
+static void test_trame_brute()
+{
+    ClientUdp udp(socketUdp);
+    udp.configurer(PUITS, UDP_PORT_DEFAUT, TRAME_BRUTE);
+    TEST_ASSERT_TRUE(udp.envoyer("/ignore", CONTENU_CBOR, (const uint8_t *)"ab", 2));
+    TEST_ASSERT_TRUE(udp.envoyer("/ignore", CONTENU_CBOR, (const uint8_t *)"cd", 2));
+
+    TEST_ASSERT_EQUAL(2, socketUdp.datagrammes.size());
+    TEST_ASSERT_TRUE(socketUdp.adresse == PUITS);
+    TEST_ASSERT_EQUAL(UDP_PORT_DEFAUT, socketUdp.port);
+    TEST_ASSERT_EQUAL_MEMORY(octets({ 0, 0, 0, 0, 'a', 'b' }).data(), socketUdp.datagrammes[0].data(), 6);
+    const std::string attendu = octets({ 0, 0, 0, 1, 'c', 'd' });
+    TEST_ASSERT_EQUAL(attendu.size(), socketUdp.datagrammes[1].size());
+    TEST_ASSERT_EQUAL_MEMORY(attendu.data(), socketUdp.datagrammes[1].data(), attendu.size());
+}
+
+// POST NON sur /mesures en CBOR : octets exacts de l'en-tête
+static void test_en_tete_coap()
+{
+    ClientUdp udp(socketUdp);
+    udp.configurer(PUITS, COAP_PORT_DEFAUT, TRAME_COAP);
+    TEST_ASSERT_TRUE(udp.envoyer("/mesures", CONTENU_CBOR, (const uint8_t *)"\xA3", 1));
+
+    const std::string attendu = octets({
+        0x54, 0x02, 0x00, 0x00,              // Ver 1, NON, TKL 4 ; POST ; Message ID 0
+        0x00, 0x00, 0x00, 0x00,              // Jeton : séquence 0
+        0xB7, 'm', 'e', 's', 'u', 'r', 'e', 's',   // Uri-Path (11), 7 octets
+        0x11, 60,                            // Content-Format (11 + 1), 1 octet : 60 application/cbor
+        0xFF, 0xA3 });                       // Fin des options, charge
+    TEST_ASSERT_EQUAL(1, socketUdp.datagrammes.size());
+    TEST_ASSERT_EQUAL(attendu.size(), socketUdp.datagrammes[0].size());
+    TEST_ASSERT_EQUAL_MEMORY(attendu.data(), socketUdp.datagrammes[0].data(), attendu.size());
+    TEST_ASSERT_EQUAL(COAP_PORT_DEFAUT, socketUdp.port);
+}
+
+// Chemin à plusieurs segments : Uri-Path répété (delta 0), longueur étendue au-delà de 12, JSON
+static void test_chemin_plusieurs_segments()
+{
+    ClientUdp udp(socketUdp);
+    udp.configurer(PUITS, COAP_PORT_DEFAUT, TRAME_COAP);
+    TEST_ASSERT_TRUE(udp.envoyer("/campus//batiment-nord/", CONTENU_JSON, (const uint8_t *)"{}", 2));
+
+    const std::string attendu = octets({ 0x54, 0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xB6 }) + "campus" +
+                                octets({ 0x0D, 13 - 13 }) + "batiment-nord" +
+                                octets({ 0x11, 50, 0xFF }) + "{}";
+    TEST_ASSERT_EQUAL(attendu.size(), socketUdp.datagrammes[0].size());
+    TEST_ASSERT_EQUAL_MEMORY(attendu.data(), socketUdp.datagrammes[0].data(), attendu.size());
+}
+
+// Sans chemin : Content-Format seul, delta 12
+static void test_sans_chemin()
+{
+    ClientUdp udp(socketUdp);
+    udp.configurer(PUITS, COAP_PORT_DEFAUT, TRAME_COAP);
+    TEST_ASSERT_TRUE(udp.envoyer("", CONTENU_CBOR, (const uint8_t *)"x", 1));
+    const std::string attendu = octets({ 0x54, 0x02, 0, 0, 0, 0, 0, 0, 0xC1, 60, 0xFF, 'x' });
+    TEST_ASSERT_EQUAL(attendu.size(), socketUdp.datagrammes[0].size());
+    TEST_ASSERT_EQUAL_MEMORY(attendu.data(), socketUdp.datagrammes[0].data(), attendu.size());
+}
+
+// Message ID = 16 bits de poids faible de la séquence, jeton = séquence complète, gros-boutistes
+static void test_identifiant_et_jeton()
+{
+    ClientUdp udp(socketUdp);
+    udp.configurer(PUITS, COAP_PORT_DEFAUT, TRAME_COAP);
+    for (int i = 0; i <= 0x10203; i++) {
+        TEST_ASSERT_TRUE(udp.envoyer("/m", CONTENU_CBOR, (const uint8_t *)"x", 1));
+        if (socketUdp.datagrammes.size() > 1) {
+            socketUdp.datagrammes.erase(socketUdp.datagrammes.begin());
+        }
+    }
+    const std::string &d = socketUdp.datagrammes.back();
+    const std::string attendu = octets({ 0x54, 0x02, 0x02, 0x03, 0x00, 0x01, 0x02, 0x03 });
+    TEST_ASSERT_EQUAL_MEMORY(attendu.data(), d.data(), attendu.size());
+    TEST_ASSERT_EQUAL(0x10204, udp.lireStats().datagrammes);
+}
+
+// Datagramme refusé par la pile : la séquence n'avance pas
+static void test_refus_pile()
+{
+    ClientUdp udp(socketUdp);
+    udp.configurer(PUITS, COAP_PORT_DEFAUT, TRAME_COAP);
+    socketUdp.refuserEnvoi = true;
+    TEST_ASSERT_FALSE(udp.envoyer("/m", CONTENU_CBOR, (const uint8_t *)"x", 1));
+    socketUdp.refuserEnvoi = false;
+    socketUdp.refuserPaquet = true;
+    TEST_ASSERT_FALSE(udp.envoyer("/m", CONTENU_CBOR, (const uint8_t *)"x", 1));
+    socketUdp.refuserPaquet = false;
+    TEST_ASSERT_TRUE(udp.envoyer("/m", CONTENU_CBOR, (const uint8_t *)"x", 1));
+
+    TEST_ASSERT_EQUAL(1, socketUdp.datagrammes.size());
+    TEST_ASSERT_EQUAL_HEX8(0x00, socketUdp.datagrammes[0][3]);   // Message ID 0
+    TEST_ASSERT_EQUAL(2, udp.lireStats().echecs);
+    TEST_ASSERT_EQUAL(1, udp.lireStats().datagrammes);
+}
+
+// chargeMax : la charge remplit exactement UDP_TAILLE_DATAGRAMME, un octet de plus est refusé
+static void test_charge_max()
+{
+    ClientUdp udp(socketUdp);
+    udp.configurer(PUITS, COAP_PORT_DEFAUT, TRAME_COAP);
+    const size_t max = udp.chargeMax("/mesures");
+    TEST_ASSERT_EQUAL(UDP_TAILLE_DATAGRAMME - 19, max);
+
+    const std::string charge(max + 1, 'x');
+    TEST_ASSERT_TRUE(udp.envoyer("/mesures", CONTENU_CBOR, (const uint8_t *)charge.data(), max));
+    TEST_ASSERT_EQUAL(UDP_TAILLE_DATAGRAMME, socketUdp.datagrammes[0].size());
+    TEST_ASSERT_FALSE(udp.envoyer("/mesures", CONTENU_CBOR, (const uint8_t *)charge.data(), max + 1));
+
+    udp.configurer(PUITS, UDP_PORT_DEFAUT, TRAME_BRUTE);
+    TEST_ASSERT_EQUAL(UDP_TAILLE_DATAGRAMME - 4, udp.chargeMax("/mesures"));
+}
+
+// Chemin qui ne tient pas dans l'en-tête, ou destination non fixée ou oubliée : rien n'est envoyé
+static void test_refus_avant_envoi()
+{
+    ClientUdp udp(socketUdp);
+    TEST_ASSERT_FALSE(udp.configure());
+    TEST_ASSERT_FALSE(udp.envoyer("/m", CONTENU_CBOR, (const uint8_t *)"x", 1));
+
+    udp.configurer(PUITS, COAP_PORT_DEFAUT, TRAME_COAP);
+    const std::string chemin = "/" + std::string(120, 'c');
+    TEST_ASSERT_EQUAL(0, udp.chargeMax(chemin.c_str()));
+    TEST_ASSERT_FALSE(udp.envoyer(chemin.c_str(), CONTENU_CBOR, (const uint8_t *)"x", 1));
+    TEST_ASSERT_EQUAL(0, socketUdp.datagrammes.size());
+    TEST_ASSERT_EQUAL(2, udp.lireStats().echecs);
+
+    udp.oublier();
+    TEST_ASSERT_FALSE(udp.configure());
+    TEST_ASSERT_FALSE(udp.envoyer("/m", CONTENU_CBOR, (const uint8_t *)"x", 1));
+    TEST_ASSERT_EQUAL(0, socketUdp.datagrammes.size());
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_trame_brute);
+    RUN_TEST(test_en_tete_coap);
+    RUN_TEST(test_chemin_plusieurs_segments);
+    RUN_TEST(test_sans_chemin);
+    RUN_TEST(test_identifiant_et_jeton);
+    RUN_TEST(test_refus_pile);
+    RUN_TEST(test_charge_max);
+    RUN_TEST(test_refus_avant_envoi);
+    return UNITY_END();
+}
@@ -0,0 +1,135 @@
+/**
+ * @file test_main.cpp
+ * @brief Tests natifs du décodage des trames DHT22 (decoderTrameDht22).
+ *
+ * Les trames sont construites comme le RMT les livre : durées des impulsions hautes en µs,
+ * réponse du capteur (~80 µs) puis 40 bits (0 ≈ 27 µs, 1 ≈ 70 µs), poids fort en premier.
+ */
+
+#include <unity.h>
+#include "dht22_rmt.h"
+
+static const uint16_t DUREE_REPONSE_US = 80;
+static const uint16_t DUREE_ZERO_US = 27;
+static const uint16_t DUREE_UN_US = 70;
+
+// Durées hautes d'une trame complète : réponse du capteur puis les 5 octets
+static size_t construireTrame(const uint8_t octets[5], uint16_t durees[DHT22_NB_BITS + 1])
+{
+    size_t nb = 0;
+    durees[nb++] = DUREE_REPONSE_US;
+    for (size_t i = 0; i < DHT22_NB_BITS; i++) {
+        durees[nb++] = (octets[i / 8] >> (7 - i % 8)) & 1 ? DUREE_UN_US : DUREE_ZERO_US;
+    }
+    return nb;
+}
+
+// Octets d'une trame avec sa somme de contrôle
+static void remplirOctets(uint16_t humidite_dixiemes, uint16_t temperature_brute, uint8_t octets[5])
+{
+    octets[0] = humidite_dixiemes >> 8;
+    octets[1] = humidite_dixiemes;
+    octets[2] = temperature_brute >> 8;
+    octets[3] = temperature_brute;
+    octets[4] = octets[0] + octets[1] + octets[2] + octets[3];
+}
+
+void setUp() {}
+void tearDown() {}
+
+// Exemple de la datasheet : 65,2 %HR et 35,1 °C
+static void test_trame_valide()
+{
+    uint8_t octets[5];
+    remplirOctets(652, 351, octets);
+    TEST_ASSERT_EQUAL_HEX8(0xEE, octets[4]);
+
+    uint16_t durees[DHT22_NB_BITS + 1];
+    const size_t nb = construireTrame(octets, durees);
+    TrameDht22 trame = {};
+    TEST_ASSERT_EQUAL(DHT22_OK, decoderTrameDht22(durees, nb, trame));
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 65.2f, trame.humidite);
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 35.1f, trame.temperature);
+}
+
+// Les impulsions qui précèdent les 40 derniers bits (relâchement, réponse) sont ignorées
+static void test_impulsions_initiales_ignorees()
+{
+    uint8_t octets[5];
+    remplirOctets(1000, 0, octets);
+
+    uint16_t durees[DHT22_NB_BITS + 3];
+    durees[0] = 5;
+    durees[1] = 95;
+    const size_t nb = 2 + construireTrame(octets, durees + 2);
+    TrameDht22 trame = {};
+    TEST_ASSERT_EQUAL(DHT22_OK, decoderTrameDht22(durees, nb, trame));
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 100.0f, trame.humidite);
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 0.0f, trame.temperature);
+}
+
+static void test_somme_invalide()
+{
+    uint8_t octets[5];
+    remplirOctets(652, 351, octets);
+    octets[4] ^= 0x01;
+
+    uint16_t durees[DHT22_NB_BITS + 1];
+    const size_t nb = construireTrame(octets, durees);
+    TrameDht22 trame = {};
+    TEST_ASSERT_EQUAL(DHT22_ERREUR_SOMME, decoderTrameDht22(durees, nb, trame));
+}
+
+// Bit de poids fort de la température = signe : 0x8065 -> -10,1 °C
+static void test_temperature_negative()
+{
+    uint8_t octets[5];
+    remplirOctets(453, 0x8000 | 101, octets);
+
+    uint16_t durees[DHT22_NB_BITS + 1];
+    const size_t nb = construireTrame(octets, durees);
+    TrameDht22 trame = {};
+    TEST_ASSERT_EQUAL(DHT22_OK, decoderTrameDht22(durees, nb, trame));
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, -10.1f, trame.temperature);
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 45.3f, trame.humidite);
+}
+
+// Capture interrompue : moins de 40 impulsions, ou aucune
+static void test_trame_tronquee()
+{
+    uint8_t octets[5];
+    remplirOctets(652, 351, octets);
+
+    uint16_t durees[DHT22_NB_BITS + 1];
+    construireTrame(octets, durees);
+    TrameDht22 trame = {};
+    TEST_ASSERT_EQUAL(DHT22_ERREUR_TRAME, decoderTrameDht22(durees + 2, DHT22_NB_BITS - 1, trame));
+    TEST_ASSERT_EQUAL(DHT22_ERREUR_TRAME, decoderTrameDht22(durees, 0, trame));
+}
+
+// Ligne restée haute (capteur qui ne répond plus en cours de trame) ou impulsion nulle
+static void test_duree_hors_plage()
+{
+    uint8_t octets[5];
+    remplirOctets(652, 351, octets);
+
+    uint16_t durees[DHT22_NB_BITS + 1];
+    const size_t nb = construireTrame(octets, durees);
+    TrameDht22 trame = {};
+    durees[20] = 150;
+    TEST_ASSERT_EQUAL(DHT22_ERREUR_TRAME, decoderTrameDht22(durees, nb, trame));
+    durees[20] = 0;
+    TEST_ASSERT_EQUAL(DHT22_ERREUR_TRAME, decoderTrameDht22(durees, nb, trame));
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_trame_valide);
+    RUN_TEST(test_impulsions_initiales_ignorees);
+    RUN_TEST(test_somme_invalide);
+    RUN_TEST(test_temperature_negative);
+    RUN_TEST(test_trame_tronquee);
+    RUN_TEST(test_duree_hors_plage);
+    return UNITY_END();
+}
@@ -0,0 +1,398 @@
+/**
+ * @file test_main.cpp
+ * @brief Tests natifs de l'encodage des lots : décodage aller-retour et banc octets/temps face au JSON.
+ *
+ * Le décodeur ci-dessous suit la description de la trame (encodage_lot.h) et de l'enveloppe CBOR ;
+ * il sert de référence pour un décodeur côté serveur. Le JSON du banc reproduit le format
+ * d'ecrireLot() (tache_envoi.cpp) : {"horloge":"epoch","mesures":{"cle[_nature]":[[t,v],...]}}.
+ */
+
+#include <unity.h>
+#include <chrono>
+#include <random>
+#include <string>
+#include <vector>
+#include "encodage_lot.h"
+#include "registre_capteurs.h"
+
+static const char *const SUFFIXES_NATURE[NB_NATURES] = {
+    "", "_nombre", "_min", "_max", "_moyenne", "_ecart_type", "_p50", "_p95"
+};
+
+// Échantillon décodé
+struct Echantillon {
+  uint8_t canal;
+  uint8_t nature;
+  int64_t horodatage_ms;
+  double valeur;
+};
+
+// Lecture séquentielle bornée d'un tampon
+struct Lecteur {
+  const uint8_t *p;
+  const uint8_t *fin;
+  bool erreur = false;
+
+  uint8_t octet()
+  {
+      if (p >= fin) {
+          erreur = true;
+          return 0;
+      }
+      return *p++;
+  }
+
+  uint64_t varint()
+  {
+      uint64_t v = 0;
+      for (int decalage = 0; decalage < 64; decalage += 7) {
+          const uint8_t o = octet();
+          v |= (uint64_t)(o & 0x7F) << decalage;
+          if (!(o & 0x80)) {
+              return v;
+          }
+      }
+      erreur = true;
+      return 0;
+  }
+
+  int64_t zigzag()
+  {
+      const uint64_t u = varint();
+      return (int64_t)(u >> 1) ^ -(int64_t)(u & 1);
+  }
+
+  // En-tête CBOR : type majeur et argument
+  uint64_t cbor(uint8_t typeAttendu)
+  {
+      const uint8_t o = octet();
+      if (o >> 5 != typeAttendu) {
+          erreur = true;
+      }
+      const uint8_t info = o & 0x1F;
+      if (info < 24) {
+          return info;
+      }
+      const int nb = info == 24 ? 1 : info == 25 ? 2 : info == 26 ? 4 : info == 27 ? 8 : 0;
+      if (nb == 0) {
+          erreur = true;
+      }
+      uint64_t v = 0;
+      for (int i = 0; i < nb; i++) {
+          v = v << 8 | octet();
+      }
+      return v;
+  }
+
+  std::string cborTexte()
+  {
+      const uint64_t n = cbor(3);
+      if (n > (uint64_t)(fin - p)) {
+          erreur = true;
+          return "";
+      }
+      std::string s((const char *)p, n);
+      p += n;
+      return s;
+  }
+};
+
+// Décode une trame binaire ; false si elle est mal formée
+static bool decoderTrame(const uint8_t *trame, size_t longueur, bool &epoch, std::vector<Echantillon> &sortie)
+{
+    Lecteur l = { trame, trame + longueur };
+    const uint8_t entete = l.octet();
+    if (entete >> 4 != ENCODAGE_LOT_VERSION) {
+        return false;
+    }
+    epoch = entete & 0x01;
+
+    while (l.p < l.fin && !l.erreur) {
+        const uint8_t serie = l.octet();
+        const uint8_t decimales = l.octet();
+        const uint64_t nombre = l.varint();
+        double echelle = 1;
+        for (uint8_t i = 0; i < decimales; i++) echelle *= 10;
+
+        int64_t horodatage = (int64_t)l.varint();
+        int64_t valeur = l.zigzag();
+        int64_t delta = 0;
+        for (uint64_t i = 0; i < nombre && !l.erreur; i++) {
+            if (i > 0) {
+                delta += l.zigzag();
+                horodatage += delta;
+                valeur += l.zigzag();
+            }
+            sortie.push_back({ (uint8_t)(serie & 0x0F), (uint8_t)(serie >> 4), horodatage, valeur / echelle });
+        }
+    }
+    return !l.erreur && l.p == l.fin;
+}
+
+// Décode l'enveloppe CBOR {"id", "mac", "lot"} puis la trame
+static bool decoderEnveloppe(const uint8_t *tampon, size_t longueur, std::string &nom, uint8_t mac[6],
+                             bool &epoch, std::vector<Echantillon> &sortie)
+{
+    Lecteur l = { tampon, tampon + longueur };
+    if (l.cbor(5) != 3 || l.cborTexte() != "id") {
+        return false;
+    }
+    nom = l.cborTexte();
+    if (l.cborTexte() != "mac" || l.cbor(2) != 6) {
+        return false;
+    }
+    for (int i = 0; i < 6; i++) mac[i] = l.octet();
+    if (l.cborTexte() != "lot") {
+        return false;
+    }
+    const uint64_t n = l.cbor(2);
+    if (l.erreur || n != (uint64_t)(l.fin - l.p)) {
+        return false;
+    }
+    return decoderTrame(l.p, n, epoch, sortie);
+}
+
+// Décimales d'un canal dans le registre
+static uint8_t decimalesCanal(uint8_t canal)
+{
+    for (const InfoCanal &info : TABLE_CANAUX) {
+        if (info.canal == canal) return info.decimales;
+    }
+    return 0;
+}
+
+/**
+ * Lot représentatif du journal : tous les canaux actifs échantillonnés toutes les 30 s
+ * (gigue de quelques ms), valeurs en marche aléatoire, et les statistiques d'une fenêtre
+ * pour la température.
+ */
+static std::vector<EnregistrementJournal> genererLot(size_t nb)
+{
+    std::mt19937 alea(1234);
+    std::uniform_int_distribution<int> gigue(-3, 3);
+    std::normal_distribution<float> pas(0.0f, 1.0f);
+
+    float valeurs[NB_CANAUX] = {};
+    valeurs[CANAL_TEMPERATURE] = 24.5f;
+    valeurs[CANAL_HUMIDITE] = 61.0f;
+    valeurs[CANAL_CO2] = 650;
+    valeurs[CANAL_TVOC] = 80;
+    valeurs[CANAL_LUMINOSITE] = 320;
+    const float ampleurs[NB_CANAUX] = { 0.05f, 0.2f, 8, 3, 5 };
+
+    std::vector<EnregistrementJournal> lot;
+    int64_t t = 1760000000000LL;
+    while (lot.size() < nb) {
+        for (const InfoCanal &info : TABLE_CANAUX) {
+            if (lot.size() == nb) break;
+            valeurs[info.canal] += ampleurs[info.canal] * pas(alea);
+            lot.push_back({ t + gigue(alea), valeurs[info.canal], (uint8_t)info.canal, JOURNAL_HORODATAGE_EPOCH, 0 });
+        }
+        if (lot.size() % 50 < 5) {
+            for (uint8_t nature = NATURE_NOMBRE; nature < NB_NATURES && lot.size() < nb; nature++) {
+                const float v = nature == NATURE_NOMBRE ? 20 : valeurs[CANAL_TEMPERATURE] + nature * 0.01f;
+                lot.push_back({ t, v, CANAL_TEMPERATURE, (uint8_t)(JOURNAL_HORODATAGE_EPOCH | nature << 1), 0 });
+            }
+        }
+        t += 30000;
+    }
+    return lot;
+}
+
+// Ordre attendu après encodage : canaux dans l'ordre du registre, puis nature, puis ordre du lot
+static std::vector<EnregistrementJournal> ordreEncode(const std::vector<EnregistrementJournal> &lot)
+{
+    std::vector<EnregistrementJournal> attendu;
+    for (const InfoCanal &info : TABLE_CANAUX) {
+        for (uint8_t nature = 0; nature < NB_NATURES; nature++) {
+            for (const EnregistrementJournal &r : lot) {
+                if (r.canal == info.canal && JOURNAL_NATURE(r.drapeaux) == nature) {
+                    attendu.push_back(r);
+                }
+            }
+        }
+    }
+    return attendu;
+}
+
+static void verifierAllerRetour(const std::vector<EnregistrementJournal> &lot, const std::vector<Echantillon> &decode)
+{
+    const std::vector<EnregistrementJournal> attendu = ordreEncode(lot);
+    TEST_ASSERT_EQUAL(attendu.size(), decode.size());
+    for (size_t i = 0; i < attendu.size(); i++) {
+        const EnregistrementJournal &r = attendu[i];
+        const uint8_t nature = JOURNAL_NATURE(r.drapeaux);
+        TEST_ASSERT_EQUAL(r.canal, decode[i].canal);
+        TEST_ASSERT_EQUAL(nature, decode[i].nature);
+        TEST_ASSERT_EQUAL_INT64(r.horodatage_ms, decode[i].horodatage_ms);
+        // Valeur arrondie aux décimales du registre (entière pour le nombre d'échantillons)
+        const uint8_t decimales = nature == NATURE_NOMBRE ? 0 : decimalesCanal(r.canal);
+        TEST_ASSERT_FLOAT_WITHIN(0.5 * pow(10, -decimales) * 1.001, r.valeur, decode[i].valeur);
+    }
+}
+
+// JSON équivalent, au format d'ecrireLot()
+static size_t encoderJson(const EnregistrementJournal enregistrements[], size_t nb, bool epoch, char *tampon, size_t taille)
+{
+    size_t n = 0;
+    auto ajouter = [&](const char *format, auto... args) {
+        const int m = snprintf(tampon + n, taille - n, format, args...);
+        if (m < 0 || (size_t)m >= taille - n) return false;
+        n += m;
+        return true;
+    };
+    if (!ajouter("{\"horloge\":\"%s\",\"mesures\":{", epoch ? "epoch" : "millis")) return 0;
+    bool premierCanal = true;
+    for (const InfoCanal &info : TABLE_CANAUX) {
+        for (uint8_t nature = 0; nature < NB_NATURES; nature++) {
+            const int decimales = nature == NATURE_NOMBRE ? 0 : info.decimales;
+            bool premier = true;
+            for (size_t i = 0; i < nb; i++) {
+                const EnregistrementJournal &e = enregistrements[i];
+                if (e.canal != info.canal || JOURNAL_NATURE(e.drapeaux) != nature) continue;
+                if (premier && !ajouter("%s\"%s%s\":[", premierCanal ? "" : ",", info.cle, SUFFIXES_NATURE[nature])) return 0;
+                if (!ajouter("%s[%lld,%.*f]", premier ? "" : ",", (long long)e.horodatage_ms, decimales, e.valeur)) return 0;
+                premier = false;
+                premierCanal = false;
+            }
+            if (!premier && !ajouter("]")) return 0;
+        }
+    }
+    return ajouter("}}") ? n : 0;
+}
+
+static const IdentiteNoeud IDENTITE = { "SmartCampus-07", { 0x7C, 0xDF, 0xA1, 0x00, 0x12, 0x34 } };
+
+void setUp() {}
+void tearDown() {}
+
+static void test_aller_retour_trame()
+{
+    const std::vector<EnregistrementJournal> lot = genererLot(ENVOI_ECHANTILLONS_PAR_LOT);
+    uint8_t tampon[4096];
+    const size_t n = encoderLot(lot.data(), lot.size(), true, nullptr, tampon, sizeof(tampon));
+    TEST_ASSERT_TRUE(n > 0);
+
+    bool epoch = false;
+    std::vector<Echantillon> decode;
+    TEST_ASSERT_TRUE(decoderTrame(tampon, n, epoch, decode));
+    TEST_ASSERT_TRUE(epoch);
+    verifierAllerRetour(lot, decode);
+}
+
+static void test_aller_retour_enveloppe_cbor()
+{
+    const std::vector<EnregistrementJournal> lot = genererLot(100);
+    uint8_t tampon[4096];
+    const size_t n = encoderLot(lot.data(), lot.size(), false, &IDENTITE, tampon, sizeof(tampon));
+    TEST_ASSERT_TRUE(n > 0);
+    TEST_ASSERT_EQUAL_HEX8(0xA3, tampon[0]);   // Table CBOR de 3 paires
+
+    std::string nom;
+    uint8_t mac[6];
+    bool epoch = true;
+    std::vector<Echantillon> decode;
+    TEST_ASSERT_TRUE(decoderEnveloppe(tampon, n, nom, mac, epoch, decode));
+    TEST_ASSERT_EQUAL_STRING(IDENTITE.nom, nom.c_str());
+    TEST_ASSERT_EQUAL_MEMORY(IDENTITE.mac, mac, 6);
+    TEST_ASSERT_FALSE(epoch);
+    verifierAllerRetour(lot, decode);
+}
+
+// Valeurs extrêmes des deltas : horodatages non monotones, sauts de valeur, négatifs
+static void test_deltas_extremes()
+{
+    std::vector<EnregistrementJournal> lot = {
+        { 5, -40.0f, CANAL_TEMPERATURE, 0, 0 },
+        { 4000000000LL, 85.0f, CANAL_TEMPERATURE, 0, 0 },
+        { 3999999000LL, -39.99f, CANAL_TEMPERATURE, 0, 0 },
+        { 3999999000LL, -39.99f, CANAL_TEMPERATURE, 0, 0 },
+        { 0, 60000.0f, CANAL_CO2, 0, 0 },
+        { 1, 0.0f, CANAL_CO2, 0, 0 },
+    };
+    uint8_t tampon[256];
+    const size_t n = encoderLot(lot.data(), lot.size(), false, nullptr, tampon, sizeof(tampon));
+    TEST_ASSERT_TRUE(n > 0);
+
+    bool epoch;
+    std::vector<Echantillon> decode;
+    TEST_ASSERT_TRUE(decoderTrame(tampon, n, epoch, decode));
+    verifierAllerRetour(lot, decode);
+}
+
+// Enregistrements corrompus ignorés ; lot vide réduit à l'en-tête
+static void test_corrompus_et_lot_vide()
+{
+    std::vector<EnregistrementJournal> lot = genererLot(20);
+    lot[3].canal = JOURNAL_CANAL_CORROMPU;
+    uint8_t tampon[1024];
+    size_t n = encoderLot(lot.data(), lot.size(), true, nullptr, tampon, sizeof(tampon));
+    bool epoch;
+    std::vector<Echantillon> decode;
+    TEST_ASSERT_TRUE(decoderTrame(tampon, n, epoch, decode));
+    TEST_ASSERT_EQUAL(lot.size() - 1, decode.size());
+
+    n = encoderLot(lot.data(), 0, true, nullptr, tampon, sizeof(tampon));
+    TEST_ASSERT_EQUAL(1, n);
+    TEST_ASSERT_EQUAL_HEX8(ENCODAGE_LOT_VERSION << 4 | 0x01, tampon[0]);
+}
+
+// Tampon trop petit : 0, quelle que soit la taille manquante
+static void test_tampon_trop_petit()
+{
+    const std::vector<EnregistrementJournal> lot = genererLot(64);
+    uint8_t tampon[2048];
+    const size_t complet = encoderLot(lot.data(), lot.size(), true, &IDENTITE, tampon, sizeof(tampon));
+    TEST_ASSERT_TRUE(complet > 0);
+    for (size_t taille = 0; taille < complet; taille++) {
+        TEST_ASSERT_EQUAL(0, encoderLot(lot.data(), lot.size(), true, &IDENTITE, tampon, taille));
+    }
+    TEST_ASSERT_EQUAL(complet, encoderLot(lot.data(), lot.size(), true, &IDENTITE, tampon, complet));
+}
+
+// Banc : octets et temps d'encodage d'un lot complet, binaire CBOR contre JSON
+static void test_banc_binaire_json()
+{
+    const std::vector<EnregistrementJournal> lot = genererLot(ENVOI_ECHANTILLONS_PAR_LOT);
+    static uint8_t binaire[8192];
+    static char json[16384];
+    const int tours = 2000;
+    using horloge = std::chrono::steady_clock;
+
+    size_t octetsBinaire = 0;
+    const auto debutBinaire = horloge::now();
+    for (int i = 0; i < tours; i++) {
+        octetsBinaire = encoderLot(lot.data(), lot.size(), true, &IDENTITE, binaire, sizeof(binaire));
+    }
+    size_t octetsJson = 0;
+    const auto debutJson = horloge::now();
+    for (int i = 0; i < tours; i++) {
+        octetsJson = encoderJson(lot.data(), lot.size(), true, json, sizeof(json));
+    }
+    const auto fin = horloge::now();
+    TEST_ASSERT_TRUE(octetsBinaire > 0 && octetsJson > 0);
+
+    const double usBinaire = std::chrono::duration<double, std::micro>(debutJson - debutBinaire).count() / tours;
+    const double usJson = std::chrono::duration<double, std::micro>(fin - debutJson).count() / tours;
+    char message[160];
+    snprintf(message, sizeof(message),
+             "%u echantillons : CBOR %u octets (%.2f/ech.) en %.1f us, JSON %u octets (%.2f/ech.) en %.1f us",
+             (unsigned)lot.size(), (unsigned)octetsBinaire, (double)octetsBinaire / lot.size(), usBinaire,
+             (unsigned)octetsJson, (double)octetsJson / lot.size(), usJson);
+    TEST_MESSAGE(message);
+
+    // Ordre de grandeur annoncé : au moins 5 fois plus compact que le JSON
+    TEST_ASSERT_LESS_THAN(octetsJson / 5, octetsBinaire);
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_aller_retour_trame);
+    RUN_TEST(test_aller_retour_enveloppe_cbor);
+    RUN_TEST(test_deltas_extremes);
+    RUN_TEST(test_corrompus_et_lot_vide);
+    RUN_TEST(test_tampon_trop_petit);
+    RUN_TEST(test_banc_binaire_json);
+    return UNITY_END();
+}
@@ -0,0 +1,138 @@
+/**
+ * @file test_main.cpp
+ * @brief Tests natifs de humiditeAbsolue8_8 : précision face à la formule flottante et banc de temps.
+ *
+ * La référence est l'ancienne getAbsoluteHumidity() de tache_co2.cpp (formule de Magnus avec exp()),
+ * évaluée sans troncature. La grille couvre toute la plage de la table au pas du DHT22
+ * (0,1 °C) et l'humidité de 0 à 100 % par pas de 0,5 %.
+ */
+
+#include <unity.h>
+#include <chrono>
+#include "humidite_absolue.h"
+
+// Écart maximal admis avec la valeur flottante × 256 : 0,5 d'arrondi + erreur d'interpolation
+static const double TOLERANCE_LSB = 0.52;
+
+// Formule de Magnus de l'ancienne compensation, en g/m³ × 256, limitée comme le format 8.8
+static double referenceDouble(double temperature, double humidite)
+{
+    const double valeur = (humidite / 100.0) * 6.112 * exp((17.62 * temperature) / (243.12 + temperature)) *
+                          216.7 / (273.15 + temperature) * 256.0;
+    return valeur > 0xFFFF ? 0xFFFF : valeur;
+}
+
+// Même formule en float, comme sur la cible avant le passage en virgule fixe
+static uint32_t referenceFloat(float temperature, float humidite)
+{
+    const float absHumidity = (humidite / 100.0f) * 6.112f * expf((17.62f * temperature) / (243.12f + temperature)) *
+                              216.7f / (273.15f + temperature);
+    const uint32_t valeur = (uint32_t)(absHumidity * 256.0f);
+    return valeur > 0xFFFF ? 0xFFFF : valeur;
+}
+
+void setUp() {}
+void tearDown() {}
+
+static void test_precision_plage_complete()
+{
+    double pire = 0;
+    double pire0a50 = 0;
+    for (int16_t t = HUMIDITE_TEMP_MIN_DIXIEMES; t <= HUMIDITE_TEMP_MAX_DIXIEMES; t++) {
+        for (int16_t h = 0; h <= 1000; h += 5) {
+            const double ecart = fabs(humiditeAbsolue8_8(t, h) - referenceDouble(t / 10.0, h / 10.0));
+            if (ecart > pire) pire = ecart;
+            if (t >= 0 && t <= 500 && ecart > pire0a50) pire0a50 = ecart;
+        }
+    }
+    char message[96];
+    snprintf(message, sizeof(message), "ecart max %.3f LSB (0-50 C : %.3f LSB)", pire, pire0a50);
+    TEST_MESSAGE(message);
+    TEST_ASSERT_LESS_OR_EQUAL(TOLERANCE_LSB, pire);
+}
+
+// 74,5 °C et 98 %HR : 11 LSB d'écart avec l'ancienne interpolation linéaire au degré
+static void test_point_chaud_humide()
+{
+    const double attendu = referenceDouble(74.5, 98.0);
+    TEST_ASSERT_FLOAT_WITHIN(TOLERANCE_LSB, attendu, humiditeAbsolue8_8(745, 980));
+}
+
+// L'ancienne formule tronquait : le résultat est la valeur tronquée ou la suivante
+static void test_ancienne_formule_float()
+{
+    for (int16_t t = HUMIDITE_TEMP_MIN_DIXIEMES; t <= HUMIDITE_TEMP_MAX_DIXIEMES; t += 7) {
+        for (int16_t h = 0; h <= 1000; h += 13) {
+            const int32_t ancien = referenceFloat(t / 10.0f, h / 10.0f);
+            const int32_t ecart = (int32_t)humiditeAbsolue8_8(t, h) - ancien;
+            TEST_ASSERT_TRUE(ecart >= 0 && ecart <= 1);
+        }
+    }
+}
+
+static void test_bornes()
+{
+    TEST_ASSERT_EQUAL_UINT16(0, humiditeAbsolue8_8(250, 0));
+    TEST_ASSERT_EQUAL_UINT16(0, humiditeAbsolue8_8(250, -50));
+    TEST_ASSERT_EQUAL_UINT16(humiditeAbsolue8_8(250, 1000), humiditeAbsolue8_8(250, 1200));
+    TEST_ASSERT_EQUAL_UINT16(humiditeAbsolue8_8(HUMIDITE_TEMP_MIN_DIXIEMES, 500), humiditeAbsolue8_8(-600, 500));
+    TEST_ASSERT_EQUAL_UINT16(humiditeAbsolue8_8(HUMIDITE_TEMP_MAX_DIXIEMES, 500), humiditeAbsolue8_8(1000, 500));
+}
+
+// Croissante en température à humidité fixe (pas de marche entre deux segments de la table)
+static void test_monotone()
+{
+    for (int16_t h = 100; h <= 1000; h += 300) {
+        uint16_t precedent = 0;
+        for (int16_t t = HUMIDITE_TEMP_MIN_DIXIEMES; t <= HUMIDITE_TEMP_MAX_DIXIEMES; t++) {
+            const uint16_t v = humiditeAbsolue8_8(t, h);
+            TEST_ASSERT_TRUE(v >= precedent);
+            precedent = v;
+        }
+    }
+}
+
+// Banc de temps sur PC : virgule fixe contre formule float (indicatif, non vérifié)
+static void test_banc()
+{
+    using horloge = std::chrono::steady_clock;
+    volatile uint32_t puits = 0;
+    const int tours = 20;
+
+    const auto debutFixe = horloge::now();
+    for (int n = 0; n < tours; n++) {
+        for (int16_t t = HUMIDITE_TEMP_MIN_DIXIEMES; t <= HUMIDITE_TEMP_MAX_DIXIEMES; t++) {
+            for (int16_t h = 0; h <= 1000; h += 10) {
+                puits = puits + humiditeAbsolue8_8(t, h);
+            }
+        }
+    }
+    const auto debutFloat = horloge::now();
+    for (int n = 0; n < tours; n++) {
+        for (int16_t t = HUMIDITE_TEMP_MIN_DIXIEMES; t <= HUMIDITE_TEMP_MAX_DIXIEMES; t++) {
+            for (int16_t h = 0; h <= 1000; h += 10) {
+                puits = puits + referenceFloat(t / 10.0f, h / 10.0f);
+            }
+        }
+    }
+    const auto fin = horloge::now();
+
+    const double appels = tours * (double)(HUMIDITE_TEMP_MAX_DIXIEMES - HUMIDITE_TEMP_MIN_DIXIEMES + 1) * 101;
+    const double nsFixe = std::chrono::duration<double, std::nano>(debutFloat - debutFixe).count() / appels;
+    const double nsFloat = std::chrono::duration<double, std::nano>(fin - debutFloat).count() / appels;
+    char message[96];
+    snprintf(message, sizeof(message), "virgule fixe %.1f ns/appel, float %.1f ns/appel", nsFixe, nsFloat);
+    TEST_MESSAGE(message);
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_precision_plage_complete);
+    RUN_TEST(test_point_chaud_humide);
+    RUN_TEST(test_ancienne_formule_float);
+    RUN_TEST(test_bornes);
+    RUN_TEST(test_monotone);
+    RUN_TEST(test_banc);
+    return UNITY_END();
+}
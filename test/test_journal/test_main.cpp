@@ -0,0 +1,222 @@
+/**
+ * @file test_main.cpp
+ * @brief Tests natifs du journal flash sur une partition SPIFFS et une NVS simulées en mémoire.
+ *
+ * Chaque test part d'une flash vide ; un redémarrage se simule en rappelant ouvrirJournal(),
+ * qui refait l'inventaire des segments et relit le curseur en NVS. Les fichiers de segment sont
+ * modifiés directement dans flashNatif : enregistrement tronqué, octet corrompu, flash pleine,
+ * segment illisible.
+ */
+
+#include <unity.h>
+#include <FS.h>
+#include <Preferences.h>
+#include "journal.h"
+
+// En-tête d'un segment (EnteteSegment, journal.cpp) et taille d'un segment plein
+static const size_t ENTETE = 16;
+static const size_t TAILLE_SEGMENT = ENTETE + JOURNAL_ENREGISTREMENTS_PAR_SEGMENT * sizeof(EnregistrementJournal);
+
+static EnregistrementJournal lus[JOURNAL_ENREGISTREMENTS_PAR_SEGMENT];
+static float prochaineValeur = 0;
+
+static std::string chemin(uint32_t sequence)
+{
+    char c[24];
+    snprintf(c, sizeof(c), "/jnl%08x.bin", sequence);
+    return c;
+}
+
+// Poste n échantillons de valeurs croissantes dans la file d'écriture
+static void ajouter(uint32_t n)
+{
+    for (uint32_t i = 0; i < n; i++) {
+        ajouterJournal(CANAL_CO2, prochaineValeur++, { (int64_t)i, false });
+    }
+}
+
+// Ajoute n échantillons et les écrit en flash, file vidée à chaque remplissage
+static void ecrire(uint32_t n)
+{
+    while (n > 0) {
+        const uint32_t lot = min<uint32_t>(n, JOURNAL_FILE_PROFONDEUR);
+        ajouter(lot);
+        viderFileJournal();
+        n -= lot;
+    }
+}
+
+void setUp()
+{
+    flashNatif.effacer();
+    nvsNatif.clear();
+    prochaineValeur = 0;
+    TEST_ASSERT_TRUE(ouvrirJournal());
+}
+
+void tearDown() {}
+
+// Relecture séquentielle : index absolus, lots bornés par `max`
+static void test_relecture()
+{
+    ecrire(100);
+    TEST_ASSERT_EQUAL_UINT32(100, finJournal());
+
+    uint32_t suivant;
+    TEST_ASSERT_EQUAL(64, lireJournal(0, lus, 64, suivant));
+    TEST_ASSERT_EQUAL_UINT32(64, suivant);
+    TEST_ASSERT_EQUAL(CANAL_CO2, lus[10].canal);
+    TEST_ASSERT_EQUAL_FLOAT(10, lus[10].valeur);
+    TEST_ASSERT_EQUAL(36, lireJournal(suivant, lus, 64, suivant));
+    TEST_ASSERT_EQUAL_FLOAT(99, lus[35].valeur);
+    TEST_ASSERT_EQUAL(0, lireJournal(suivant, lus, 64, suivant));
+}
+
+// Coupure pendant une écriture : l'enregistrement partiel est ignoré, l'écriture reprend dans un nouveau segment
+static void test_dernier_enregistrement_tronque()
+{
+    ecrire(10);
+    std::vector<uint8_t> &fichier = flashNatif.fichiers[chemin(1)];
+    fichier.insert(fichier.end(), 7, 0xA5);
+
+    TEST_ASSERT_TRUE(ouvrirJournal());
+    TEST_ASSERT_EQUAL_UINT32(10, finJournal());
+    TEST_ASSERT_EQUAL(2, flashNatif.fichiers.size());
+
+    ecrire(5);
+    uint32_t suivant;
+    TEST_ASSERT_EQUAL(10, lireJournal(0, lus, 64, suivant));
+    TEST_ASSERT_EQUAL_FLOAT(9, lus[9].valeur);
+    TEST_ASSERT_EQUAL(5, lireJournal(suivant, lus, 64, suivant));
+    TEST_ASSERT_EQUAL_UINT32(15, suivant);
+    TEST_ASSERT_EQUAL_FLOAT(10, lus[0].valeur);
+}
+
+// CRC invalide : l'enregistrement garde sa place (canal JOURNAL_CANAL_CORROMPU) ; en fin de segment, il le clôt au démarrage
+static void test_crc_invalide()
+{
+    ecrire(10);
+    const uint32_t corrompus = lireStatsJournal().corrompus;
+    flashNatif.fichiers[chemin(1)][ENTETE + 3 * sizeof(EnregistrementJournal) + 8] ^= 0x01;
+
+    uint32_t suivant;
+    TEST_ASSERT_EQUAL(10, lireJournal(0, lus, 64, suivant));
+    TEST_ASSERT_EQUAL(JOURNAL_CANAL_CORROMPU, lus[3].canal);
+    TEST_ASSERT_EQUAL(CANAL_CO2, lus[2].canal);
+    TEST_ASSERT_EQUAL(CANAL_CO2, lus[4].canal);
+    TEST_ASSERT_EQUAL_UINT32(corrompus + 1, lireStatsJournal().corrompus);
+
+    flashNatif.fichiers[chemin(1)][ENTETE + 9 * sizeof(EnregistrementJournal) + 8] ^= 0x01;
+    TEST_ASSERT_TRUE(ouvrirJournal());
+    TEST_ASSERT_EQUAL(2, flashNatif.fichiers.size());
+    TEST_ASSERT_EQUAL_UINT32(10, finJournal());
+}
+
+// Curseur NVS hors du journal (flash effacée, segments évincés) : ramené dans les bornes au démarrage
+static void test_curseur_hors_bornes()
+{
+    ecrire(10);
+    nvsNatif["journal/curseur"] = 1000;
+    TEST_ASSERT_TRUE(ouvrirJournal());
+    TEST_ASSERT_EQUAL_UINT32(10, curseurJournal());
+
+    // Segment 1 complété par la reprise, puis évincé hors du journal
+    ecrire(JOURNAL_ENREGISTREMENTS_PAR_SEGMENT);
+    flashNatif.fichiers.erase(chemin(1));
+    nvsNatif["journal/curseur"] = 0;
+    TEST_ASSERT_TRUE(ouvrirJournal());
+    TEST_ASSERT_EQUAL_UINT32(JOURNAL_ENREGISTREMENTS_PAR_SEGMENT, curseurJournal());
+
+    avancerCurseurJournal(JOURNAL_ENREGISTREMENTS_PAR_SEGMENT + 5);
+    persisterCurseurJournal();
+    TEST_ASSERT_TRUE(ouvrirJournal());
+    TEST_ASSERT_EQUAL_UINT32(JOURNAL_ENREGISTREMENTS_PAR_SEGMENT + 5, curseurJournal());
+}
+
+// Au-delà de JOURNAL_NB_SEGMENTS, le plus ancien segment est évincé avec ses enregistrements non acquittés
+static void test_eviction()
+{
+    const uint32_t evinces = lireStatsJournal().evinces;
+    ecrire(JOURNAL_NB_SEGMENTS * JOURNAL_ENREGISTREMENTS_PAR_SEGMENT + 10);
+
+    TEST_ASSERT_EQUAL(JOURNAL_NB_SEGMENTS, flashNatif.fichiers.size());
+    TEST_ASSERT_EQUAL(0, flashNatif.fichiers.count(chemin(1)));
+    TEST_ASSERT_EQUAL_UINT32(JOURNAL_NB_SEGMENTS, lireStatsJournal().segments);
+    TEST_ASSERT_EQUAL_UINT32(evinces + JOURNAL_ENREGISTREMENTS_PAR_SEGMENT, lireStatsJournal().evinces);
+    TEST_ASSERT_EQUAL_UINT32(JOURNAL_ENREGISTREMENTS_PAR_SEGMENT, curseurJournal());
+
+    // Lecture d'un index évincé : elle commence au plus ancien enregistrement conservé
+    uint32_t suivant;
+    const size_t n = lireJournal(0, lus, 16, suivant);
+    TEST_ASSERT_EQUAL(16, n);
+    TEST_ASSERT_EQUAL_UINT32(JOURNAL_ENREGISTREMENTS_PAR_SEGMENT + 16, suivant);
+    TEST_ASSERT_EQUAL_FLOAT(JOURNAL_ENREGISTREMENTS_PAR_SEGMENT, lus[0].valeur);
+}
+
+// Flash pleine : un segment évincé par vidage au plus, le lot réécrit une fois dans un nouveau segment
+static void test_flash_pleine()
+{
+    const StatsJournal avant = lireStatsJournal();
+    const uint32_t fin = 2 * JOURNAL_ENREGISTREMENTS_PAR_SEGMENT + 100;
+    ecrire(fin);
+
+    // Place libre après l'éviction : un en-tête et une partie du premier lot de 32 enregistrements
+    flashNatif.capacite = flashNatif.utilises() - TAILLE_SEGMENT + 300;
+    ajouter(64);
+    TEST_ASSERT_EQUAL(0, viderFileJournal());
+    StatsJournal s = lireStatsJournal();
+    TEST_ASSERT_EQUAL_UINT32(avant.evinces + JOURNAL_ENREGISTREMENTS_PAR_SEGMENT, s.evinces);
+    TEST_ASSERT_EQUAL_UINT32(avant.perdus + 32, s.perdus);
+    TEST_ASSERT_EQUAL(0, flashNatif.fichiers.count(chemin(1)));
+    TEST_ASSERT_EQUAL_UINT32(fin, finJournal());
+
+    // Vidage suivant : un autre segment est évincé et l'écriture reprend
+    TEST_ASSERT_EQUAL(32, viderFileJournal());
+    s = lireStatsJournal();
+    TEST_ASSERT_EQUAL_UINT32(avant.evinces + 2 * JOURNAL_ENREGISTREMENTS_PAR_SEGMENT, s.evinces);
+    TEST_ASSERT_EQUAL_UINT32(avant.perdus + 32, s.perdus);
+    TEST_ASSERT_EQUAL(0, flashNatif.fichiers.count(chemin(2)));
+    TEST_ASSERT_EQUAL_UINT32(fin + 32, finJournal());
+
+    // Au démarrage, les enregistrements du lot perdu restés dans leur segment ne recouvrent pas
+    // les index du segment suivant
+    TEST_ASSERT_TRUE(ouvrirJournal());
+    TEST_ASSERT_EQUAL_UINT32(fin + 32, finJournal());
+    uint32_t suivant;
+    TEST_ASSERT_EQUAL(32, lireJournal(fin, lus, 64, suivant));
+    TEST_ASSERT_EQUAL_FLOAT(fin + 32, lus[0].valeur);
+}
+
+// Segment illisible ou disparu : erreur distincte de la fin du journal, la lecture reprend après lui
+static void test_segment_illisible()
+{
+    ecrire(JOURNAL_ENREGISTREMENTS_PAR_SEGMENT + 10);
+    const uint32_t illisibles = lireStatsJournal().illisibles;
+
+    uint32_t suivant;
+    TEST_ASSERT_EQUAL(10, lireJournal(JOURNAL_ENREGISTREMENTS_PAR_SEGMENT, lus, 64, suivant));
+    flashNatif.illisibles.insert(chemin(1));
+    TEST_ASSERT_EQUAL(JOURNAL_ILLISIBLE, lireJournal(5, lus, 64, suivant));
+    TEST_ASSERT_EQUAL_UINT32(JOURNAL_ENREGISTREMENTS_PAR_SEGMENT, suivant);
+    TEST_ASSERT_EQUAL(10, lireJournal(suivant, lus, 64, suivant));
+    TEST_ASSERT_EQUAL_UINT32(illisibles + 1, lireStatsJournal().illisibles);
+
+    flashNatif.illisibles.clear();
+    flashNatif.fichiers.erase(chemin(1));
+    TEST_ASSERT_EQUAL(JOURNAL_ILLISIBLE, lireJournal(0, lus, 64, suivant));
+    TEST_ASSERT_EQUAL_UINT32(JOURNAL_ENREGISTREMENTS_PAR_SEGMENT, suivant);
+}
+
+int main(int argc, char **argv)
+{
+    initJournal();
+    UNITY_BEGIN();
+    RUN_TEST(test_relecture);
+    RUN_TEST(test_dernier_enregistrement_tronque);
+    RUN_TEST(test_crc_invalide);
+    RUN_TEST(test_curseur_hors_bornes);
+    RUN_TEST(test_eviction);
+    RUN_TEST(test_flash_pleine);
+    RUN_TEST(test_segment_illisible);
+    return UNITY_END();
+}
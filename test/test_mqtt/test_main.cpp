@@ -0,0 +1,252 @@
+/**
+ * @file test_main.cpp
+ * @brief Tests natifs du client MQTT contre un Client simulé : CONNECT, QoS 1, PUBACK, renvoi DUP, keep-alive.
+ */
+
+#include <unity.h>
+#include <ClientSimule.h>
+#include "mqtt.h"
+
+static const uint8_t CONNACK_ACCEPTE[] = { 0x20, 0x02, 0x00, 0x00 };
+
+static ClientSimule transport;
+static uint32_t jetonsAcquittes[8];
+static size_t nbAcquittes;
+
+static void noterAcquittement(uint32_t jeton)
+{
+    jetonsAcquittes[nbAcquittes++ % 8] = jeton;
+}
+
+// PUBACK de l'identifiant de paquet `id`
+static void recevoirPuback(uint16_t id)
+{
+    const uint8_t puback[] = { 0x40, 0x02, (uint8_t)(id >> 8), (uint8_t)id };
+    transport.recevoir(puback, sizeof(puback));
+}
+
+// Connexion acceptée, octets du CONNECT écartés
+static void connecter(ClientMqtt &mqtt)
+{
+    transport.recevoir(CONNACK_ACCEPTE, sizeof(CONNACK_ACCEPTE));
+    TEST_ASSERT_TRUE(mqtt.connecter("broker", 1883, "noeud", nullptr, nullptr));
+    const std::string connect = transport.prendreEmis();
+    TEST_ASSERT_EQUAL_HEX8(0x10, connect[0]);
+}
+
+// PUBLISH QoS 1 attendu : en-tête fixe, sujet, identifiant puis charge
+static std::string publishAttendu(bool dup, const char *sujet, uint16_t id, const std::string &charge)
+{
+    std::string p;
+    p += (char)(0x32 | (dup ? 0x08 : 0));
+    size_t reste = 2 + strlen(sujet) + 2 + charge.size();
+    do {
+        p += (char)((reste % 128) | (reste > 127 ? 0x80 : 0));
+        reste /= 128;
+    } while (reste > 0);
+    p += (char)(strlen(sujet) >> 8);
+    p += (char)strlen(sujet);
+    p += sujet;
+    p += (char)(id >> 8);
+    p += (char)id;
+    return p + charge;
+}
+
+void setUp()
+{
+    transport = ClientSimule();
+    horlogeNatif_ms = 1000;
+    nbAcquittes = 0;
+}
+
+void tearDown() {}
+
+// CONNECT 3.1.1, session persistante (clean session = 0), keep-alive et identifiants
+static void test_connect()
+{
+    ClientMqtt mqtt(transport);
+    transport.recevoir(CONNACK_ACCEPTE, sizeof(CONNACK_ACCEPTE));
+    TEST_ASSERT_TRUE(mqtt.connecter("broker", 1883, "noeud", "u", "mdp"));
+    TEST_ASSERT_EQUAL_STRING("broker", transport.hote.c_str());
+
+    const std::string c = transport.prendreEmis();
+    const std::string attendu = std::string("\x10\x19\x00\x04MQTT\x04\xC0", 10) +
+                                std::string("\x00", 1) + (char)MQTT_KEEPALIVE_S +
+                                std::string("\x00\x05noeud\x00\x01u\x00\x03mdp", 15);
+    TEST_ASSERT_EQUAL(attendu.size(), c.size());
+    TEST_ASSERT_EQUAL_MEMORY(attendu.data(), c.data(), c.size());
+    TEST_ASSERT_EQUAL(1, mqtt.lireStats().connexions);
+}
+
+static void test_connack_refuse()
+{
+    ClientMqtt mqtt(transport);
+    const uint8_t refus[] = { 0x20, 0x02, 0x00, 0x05 };   // Non autorisé
+    transport.recevoir(refus, sizeof(refus));
+    TEST_ASSERT_FALSE(mqtt.connecter("broker", 1883, "noeud", nullptr, nullptr));
+    TEST_ASSERT_FALSE(mqtt.connecte());
+    TEST_ASSERT_EQUAL(1, mqtt.lireStats().echecsConnexion);
+
+    // Pas de CONNACK dans le délai
+    TEST_ASSERT_FALSE(mqtt.connecter("broker", 1883, "noeud", nullptr, nullptr));
+    TEST_ASSERT_EQUAL(2, mqtt.lireStats().echecsConnexion);
+}
+
+// PUBLISH QoS 1 puis PUBACK : le message quitte la fenêtre et le jeton est rendu
+static void test_publication_et_puback()
+{
+    ClientMqtt mqtt(transport);
+    mqtt.surAcquittement(noterAcquittement);
+    connecter(mqtt);
+
+    TEST_ASSERT_TRUE(mqtt.publier("campus/noeud", (const uint8_t *)"{\"t\":1}", 7, 42));
+    const std::string p = transport.prendreEmis();
+    const std::string attendu = publishAttendu(false, "campus/noeud", 1, "{\"t\":1}");
+    TEST_ASSERT_EQUAL(attendu.size(), p.size());
+    TEST_ASSERT_EQUAL_MEMORY(attendu.data(), p.data(), p.size());
+    TEST_ASSERT_EQUAL(MQTT_FENETRE - 1, mqtt.placesLibres());
+
+    recevoirPuback(1);
+    mqtt.traiter();
+    TEST_ASSERT_EQUAL(MQTT_FENETRE, mqtt.placesLibres());
+    TEST_ASSERT_EQUAL(1, nbAcquittes);
+    TEST_ASSERT_EQUAL_UINT32(42, jetonsAcquittes[0]);
+    TEST_ASSERT_EQUAL(1, mqtt.lireStats().acquittements);
+}
+
+// Fenêtre pleine : publier() refuse ; un PUBACK hors ordre libère la bonne place
+static void test_fenetre_pleine_et_puback_hors_ordre()
+{
+    ClientMqtt mqtt(transport);
+    mqtt.surAcquittement(noterAcquittement);
+    connecter(mqtt);
+
+    for (uint32_t i = 0; i < MQTT_FENETRE; i++) {
+        TEST_ASSERT_TRUE(mqtt.publier("s", (const uint8_t *)"x", 1, 100 + i));
+    }
+    TEST_ASSERT_FALSE(mqtt.publier("s", (const uint8_t *)"x", 1, 999));
+    TEST_ASSERT_EQUAL(0, mqtt.placesLibres());
+
+    recevoirPuback(99);   // Identifiant inconnu : ignoré
+    recevoirPuback(2);
+    mqtt.traiter();
+    TEST_ASSERT_EQUAL(1, mqtt.placesLibres());
+    TEST_ASSERT_EQUAL(1, nbAcquittes);
+    TEST_ASSERT_EQUAL_UINT32(101, jetonsAcquittes[0]);
+}
+
+// Connexion perdue avant le PUBACK : le message est renvoyé avec DUP et le même identifiant
+static void test_renvoi_apres_reconnexion()
+{
+    ClientMqtt mqtt(transport);
+    mqtt.surAcquittement(noterAcquittement);
+    connecter(mqtt);
+
+    TEST_ASSERT_TRUE(mqtt.publier("s", (const uint8_t *)"lot1", 4, 7));
+    TEST_ASSERT_TRUE(mqtt.publier("s", (const uint8_t *)"lot2", 4, 8));
+    recevoirPuback(1);
+    mqtt.traiter();
+    transport.prendreEmis();
+    transport.stop();
+
+    connecter(mqtt);
+    // Le message non acquitté repart juste après le CONNECT
+    TEST_ASSERT_EQUAL(1, mqtt.lireStats().renvois);
+    recevoirPuback(2);
+    mqtt.traiter();
+    TEST_ASSERT_EQUAL(MQTT_FENETRE, mqtt.placesLibres());
+    TEST_ASSERT_EQUAL(2, nbAcquittes);
+    TEST_ASSERT_EQUAL_UINT32(8, jetonsAcquittes[1]);
+}
+
+// Octets exacts du renvoi : drapeau DUP (0x08) et identifiant d'origine
+static void test_octets_du_renvoi()
+{
+    ClientMqtt mqtt(transport);
+    connecter(mqtt);
+    TEST_ASSERT_TRUE(mqtt.publier("s", (const uint8_t *)"abc", 3, 1));
+    transport.stop();
+
+    transport.recevoir(CONNACK_ACCEPTE, sizeof(CONNACK_ACCEPTE));
+    transport.prendreEmis();
+    TEST_ASSERT_TRUE(mqtt.connecter("broker", 1883, "noeud", nullptr, nullptr));
+    const std::string emis = transport.prendreEmis();
+    const std::string renvoi = publishAttendu(true, "s", 1, "abc");
+    TEST_ASSERT_TRUE(emis.size() > renvoi.size());
+    TEST_ASSERT_EQUAL_MEMORY(renvoi.data(), emis.data() + emis.size() - renvoi.size(), renvoi.size());
+}
+
+// Écriture interrompue pendant PUBLISH : le message reste en vol et part à la reconnexion
+static void test_echec_ecriture()
+{
+    ClientMqtt mqtt(transport);
+    connecter(mqtt);
+    transport.limiteEcriture = 3;
+    TEST_ASSERT_TRUE(mqtt.publier("s", (const uint8_t *)"abc", 3, 1));
+    TEST_ASSERT_FALSE(mqtt.connecte());
+    TEST_ASSERT_EQUAL(MQTT_FENETRE - 1, mqtt.placesLibres());
+
+    transport.limiteEcriture = SIZE_MAX;
+    transport.prendreEmis();
+    connecter(mqtt);
+    TEST_ASSERT_EQUAL(1, mqtt.lireStats().renvois);
+}
+
+// Charge de plus de 127 octets : longueur restante sur deux octets
+static void test_longueur_restante_deux_octets()
+{
+    ClientMqtt mqtt(transport);
+    connecter(mqtt);
+    const std::string charge(300, 'a');
+    TEST_ASSERT_TRUE(mqtt.publier("s", (const uint8_t *)charge.data(), charge.size(), 1));
+    const std::string p = transport.prendreEmis();
+    // 2 + 1 (sujet) + 2 (identifiant) + 300 = 305 = 0xB1 0x02
+    TEST_ASSERT_EQUAL_HEX8(0xB1, p[1]);
+    TEST_ASSERT_EQUAL_HEX8(0x02, p[2]);
+    TEST_ASSERT_EQUAL(3 + 305, p.size());
+}
+
+// PINGREQ après une demi-période sans émission ; session fermée sans PINGRESP
+static void test_keepalive()
+{
+    ClientMqtt mqtt(transport);
+    connecter(mqtt);
+
+    horlogeNatif_ms += MQTT_KEEPALIVE_S * 500UL - 1;
+    mqtt.traiter();
+    TEST_ASSERT_EQUAL(0, transport.emis.size());
+
+    horlogeNatif_ms += 1;
+    mqtt.traiter();
+    TEST_ASSERT_EQUAL(2, transport.emis.size());
+    TEST_ASSERT_EQUAL_HEX8(0xC0, transport.emis[0]);
+    TEST_ASSERT_EQUAL_HEX8(0x00, transport.emis[1]);
+    transport.prendreEmis();
+
+    // PINGRESP reçu : la session reste ouverte et un nouveau PINGREQ part une demi-période plus tard
+    transport.recevoir("\xD0\x00", 2);
+    horlogeNatif_ms += MQTT_KEEPALIVE_S * 500UL;
+    mqtt.traiter();
+    TEST_ASSERT_TRUE(mqtt.connecte());
+    TEST_ASSERT_EQUAL(2, transport.prendreEmis().size());
+
+    // Pas de PINGRESP : fermeture une période complète après le dernier envoi
+    horlogeNatif_ms += MQTT_KEEPALIVE_S * 1000UL;
+    mqtt.traiter();
+    TEST_ASSERT_FALSE(mqtt.connecte());
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_connect);
+    RUN_TEST(test_connack_refuse);
+    RUN_TEST(test_publication_et_puback);
+    RUN_TEST(test_fenetre_pleine_et_puback_hors_ordre);
+    RUN_TEST(test_renvoi_apres_reconnexion);
+    RUN_TEST(test_octets_du_renvoi);
+    RUN_TEST(test_echec_ecriture);
+    RUN_TEST(test_longueur_restante_deux_octets);
+    RUN_TEST(test_keepalive);
+    return UNITY_END();
+}
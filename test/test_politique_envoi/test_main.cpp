@@ -0,0 +1,175 @@
+/**
+ * @file test_main.cpp
+ * @brief Tests natifs de la politique d'envoi : bandes mortes, intervalles, heartbeat et chaîne du portail.
+ *
+ * Les échantillons passent par le magasin de mesures (publierMesures), comme sur la cible ; la
+ * politique garde l'état de chaque canal d'un test à l'autre, les compteurs sont donc comparés
+ * avant et après chaque scénario. La journée simulée tourne en premier, sur un état neuf.
+ */
+
+#include <unity.h>
+#include "politique_envoi.h"
+#include "registre_capteurs.h"
+
+static const CanalMesure T = CANAL_TEMPERATURE;
+static const CanalMesure L = CANAL_LUMINOSITE;
+
+static void publier(CanalMesure canal, float valeur)
+{
+    publierMesures(&canal, &valeur, 1);
+}
+
+// Vide les demandes de rapport des scénarios précédents
+static void oublierRapports()
+{
+    while (prendreRapportDemande()) {}
+}
+
+void setUp() {}
+
+void tearDown() {}
+
+/**
+ * Journée simulée avec les politiques par défaut : température, humidité et luminosité toutes
+ * les 4 s, bruitées mais stables (21 °C ± 0,1, 45 % ± 1, 300 lx ± 2 %), et un saut de la
+ * température à 25 °C pendant 10 s à midi. Les bandes mortes absorbent le bruit : seuls les
+ * premiers échantillons, l'intervalle maximal, les heartbeats et le saut sont journalisés.
+ */
+static void test_journee_simulee()
+{
+    uint32_t rapports = 0;
+    uint32_t publies = 0;
+    for (horlogeNatif_ms = 1000; horlogeNatif_ms < 86400000UL; horlogeNatif_ms += 4000) {
+        const uint32_t k = horlogeNatif_ms / 4000;
+        const CanalMesure canaux[3] = { T, CANAL_HUMIDITE, L };
+        float valeurs[3] = { 21.0f + 0.1f * (k % 3), 45.0f + k % 2, 300.0f * (1 + 0.02f * (k % 2)) };
+        if (horlogeNatif_ms >= 43200000UL && horlogeNatif_ms < 43210000UL) {
+            valeurs[0] = 25;
+        }
+        publierMesures(canaux, valeurs, 3);
+        publies += 3;
+        if (prendreRapportDemande()) {
+            rapports++;
+        }
+    }
+
+    const StatsPolitique s = lireStatsPolitique();
+    char texte[128];
+    snprintf(texte, sizeof(texte), "%u echantillons publies, %u journalises, %u rapports (%u evenements, %u heartbeats)",
+             publies, s.retenus, rapports, s.evenements, s.heartbeats);
+    TEST_MESSAGE(texte);
+    TEST_ASSERT_EQUAL_UINT32(64800, publies);
+    TEST_ASSERT_EQUAL_UINT32(publies, s.retenus + s.ignores);
+    TEST_ASSERT_EQUAL_UINT32(289, s.retenus);
+    TEST_ASSERT_EQUAL_UINT32(25, rapports);
+}
+
+// Bande morte absolue : rien pendant l'intervalle minimal, puis un écart au-delà de la bande est un événement
+static void test_bande_morte_absolue()
+{
+    TEST_ASSERT_TRUE(appliquerPolitiqueEnvoi("temperature=0.5/10/600", "86400"));
+    horlogeNatif_ms += 601000;
+    publier(T, 21.0f);                 // Intervalle maximal écoulé : retenu sans rapport
+    oublierRapports();
+    const StatsPolitique avant = lireStatsPolitique();
+
+    horlogeNatif_ms += 5000;
+    publier(T, 22.0f);                 // Hors bande, mais avant l'intervalle minimal
+    horlogeNatif_ms += 6000;
+    publier(T, 21.4f);                 // Dans la bande
+    TEST_ASSERT_FALSE(prendreRapportDemande());
+    horlogeNatif_ms += 1000;
+    publier(T, 21.6f);                 // Hors bande
+
+    const StatsPolitique s = lireStatsPolitique();
+    TEST_ASSERT_EQUAL_UINT32(avant.ignores + 2, s.ignores);
+    TEST_ASSERT_EQUAL_UINT32(avant.retenus + 1, s.retenus);
+    TEST_ASSERT_EQUAL_UINT32(avant.evenements + 1, s.evenements);
+    TEST_ASSERT_TRUE(prendreRapportDemande());
+    TEST_ASSERT_FALSE(prendreRapportDemande());
+}
+
+// Bande morte relative : en pourcentage de la dernière valeur retenue
+static void test_bande_morte_relative()
+{
+    TEST_ASSERT_TRUE(appliquerPolitiqueEnvoi("luminosite=10%/0/600", "86400"));
+    horlogeNatif_ms += 601000;
+    publier(L, 300.0f);
+    const StatsPolitique avant = lireStatsPolitique();
+
+    horlogeNatif_ms += 1000;
+    publier(L, 325.0f);                // 8,3 %
+    horlogeNatif_ms += 1000;
+    publier(L, 331.0f);                // 10,3 %
+
+    const StatsPolitique s = lireStatsPolitique();
+    TEST_ASSERT_EQUAL_UINT32(avant.ignores + 1, s.ignores);
+    TEST_ASSERT_EQUAL_UINT32(avant.evenements + 1, s.evenements);
+}
+
+// Heartbeat : le prochain échantillon de chaque canal est retenu et un seul rapport est demandé
+static void test_heartbeat()
+{
+    TEST_ASSERT_TRUE(appliquerPolitiqueEnvoi("", "3600"));
+    horlogeNatif_ms += 3600000;
+    oublierRapports();
+    const StatsPolitique avant = lireStatsPolitique();
+
+    // Dernières valeurs publiées, dans la bande morte : seul le heartbeat les fait journaliser
+    const EntreeMesure derniere = lireMesure(T);
+    publier(T, derniere.valeur);
+    TEST_ASSERT_FALSE(prendreRapportDemande());          // Les autres canaux n'ont pas encore répondu
+    for (const InfoCanal &info : TABLE_CANAUX) {
+        if (info.canal != T) {
+            publier(info.canal, lireMesure(info.canal).valeur);
+        }
+    }
+
+    const StatsPolitique s = lireStatsPolitique();
+    TEST_ASSERT_EQUAL_UINT32(avant.heartbeats + 1, s.heartbeats);
+    TEST_ASSERT_EQUAL_UINT32(avant.retenus + TABLE_CANAUX.size(), s.retenus);
+    TEST_ASSERT_TRUE(prendreRapportDemande());
+
+    // Heartbeat terminé : la même valeur est de nouveau dans la bande morte
+    horlogeNatif_ms += 60000;
+    publier(T, derniere.valeur);
+    TEST_ASSERT_EQUAL_UINT32(s.ignores + 1, lireStatsPolitique().ignores);
+}
+
+// Chaîne du portail : entrées invalides ignorées, les autres appliquées
+static void test_analyse_configuration()
+{
+    TEST_ASSERT_TRUE(appliquerPolitiqueEnvoi("co2=100/10/600;luminosite=30%;temperature=0.5/60", NULL));
+    TEST_ASSERT_TRUE(appliquerPolitiqueEnvoi("", NULL));
+    TEST_ASSERT_TRUE(appliquerPolitiqueEnvoi(";;co2=stats;", "0"));
+
+    TEST_ASSERT_FALSE(appliquerPolitiqueEnvoi("inconnu=1", NULL));
+    TEST_ASSERT_FALSE(appliquerPolitiqueEnvoi("temperature", NULL));
+    TEST_ASSERT_FALSE(appliquerPolitiqueEnvoi("temperature=x", NULL));
+    TEST_ASSERT_FALSE(appliquerPolitiqueEnvoi("temperature=-1", NULL));
+    TEST_ASSERT_FALSE(appliquerPolitiqueEnvoi("temperature=1/900/60", NULL));    // min > max
+    TEST_ASSERT_FALSE(appliquerPolitiqueEnvoi("temperature=1/0/0", NULL));       // max nul
+    TEST_ASSERT_FALSE(appliquerPolitiqueEnvoi("temperature=1/70000", NULL));     // > 65535 s
+    TEST_ASSERT_FALSE(appliquerPolitiqueEnvoi("temperature=1%x", NULL));
+
+    // Entrée invalide à côté d'une valide : la valide s'applique (co2 agrégé, ses échantillons ne sont pas évalués)
+    TEST_ASSERT_FALSE(appliquerPolitiqueEnvoi("inconnu=1;co2=stats", "86400"));
+    const StatsPolitique avant = lireStatsPolitique();
+    horlogeNatif_ms += 1000000;
+    publier(CANAL_CO2, 5000.0f);
+    const StatsPolitique s = lireStatsPolitique();
+    TEST_ASSERT_EQUAL_UINT32(avant.retenus, s.retenus);
+    TEST_ASSERT_EQUAL_UINT32(avant.ignores, s.ignores);
+}
+
+int main(int argc, char **argv)
+{
+    initPolitiqueEnvoi();
+    UNITY_BEGIN();
+    RUN_TEST(test_journee_simulee);
+    RUN_TEST(test_bande_morte_absolue);
+    RUN_TEST(test_bande_morte_relative);
+    RUN_TEST(test_heartbeat);
+    RUN_TEST(test_analyse_configuration);
+    return UNITY_END();
+}
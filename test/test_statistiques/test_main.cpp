@@ -0,0 +1,233 @@
+/**
+ * @file test_main.cpp
+ * @brief Tests natifs des statistiques en flux : EstimateurP2 contre les quantiles exacts, Welford.
+ *
+ * L'erreur d'un quantile estimé est mesurée en rang : écart entre p et la fraction des
+ * échantillons triés situés sous la valeur estimée (0 si p tombe dans l'intervalle des rangs
+ * de la valeur). Cette mesure ne dépend pas de l'échelle de la distribution.
+ */
+
+#include <unity.h>
+#include <algorithm>
+#include <random>
+#include <vector>
+#include "statistiques.h"
+
+// Convention de valeur() sous cinq échantillons : élément de rang arrondi p × (n - 1)
+static float quantileExact(std::vector<float> tries, float p)
+{
+    std::sort(tries.begin(), tries.end());
+    return tries[(size_t)lroundf(p * (tries.size() - 1))];
+}
+
+// Écart de rang entre la valeur estimée et le quantile p des échantillons
+static double erreurRang(std::vector<float> tries, float p, float estimee)
+{
+    std::sort(tries.begin(), tries.end());
+    const double dessous = (double)(std::lower_bound(tries.begin(), tries.end(), estimee) - tries.begin()) / tries.size();
+    const double jusqua = (double)(std::upper_bound(tries.begin(), tries.end(), estimee) - tries.begin()) / tries.size();
+    return p < dessous ? dessous - p : p > jusqua ? p - jusqua : 0;
+}
+
+static float estimer(const std::vector<float> &echantillons, float p)
+{
+    EstimateurP2 e(p);
+    for (float x : echantillons) e.ajouter(x);
+    return e.valeur();
+}
+
+// Suites de test : n échantillons d'une distribution donnée
+enum Distribution { UNIFORME, NORMALE, EXPONENTIELLE, BIMODALE, CROISSANTE, DECROISSANTE, PALIERS };
+static const char *const NOMS_DISTRIBUTION[] = {
+    "uniforme", "normale", "exponentielle", "bimodale", "croissante", "decroissante", "paliers"
+};
+
+static std::vector<float> generer(Distribution d, size_t n, uint32_t graine)
+{
+    std::mt19937 alea(graine);
+    std::uniform_real_distribution<float> uniforme(0, 100);
+    std::normal_distribution<float> normale(21.5f, 1.5f);
+    std::exponential_distribution<float> exponentielle(1 / 400.0f);
+    std::vector<float> v;
+    for (size_t i = 0; i < n; i++) {
+        switch (d) {
+        case UNIFORME:      v.push_back(uniforme(alea)); break;
+        case NORMALE:       v.push_back(normale(alea)); break;
+        case EXPONENTIELLE: v.push_back(400 + exponentielle(alea)); break;   // CO2 avec pics
+        case BIMODALE:      v.push_back(alea() % 4 == 0 ? 800 + normale(alea) : 40 + normale(alea)); break;
+        case CROISSANTE:    v.push_back((float)i); break;
+        case DECROISSANTE:  v.push_back((float)(n - i)); break;
+        case PALIERS:       v.push_back((float)(alea() % 5)); break;            // Valeurs entières répétées
+        }
+    }
+    return v;
+}
+
+void setUp() {}
+void tearDown() {}
+
+// Moins de cinq échantillons : valeur exacte, dans l'ordre d'arrivée quelconque
+static void test_exact_sous_cinq()
+{
+    TEST_ASSERT_EQUAL_FLOAT(0, EstimateurP2(0.5f).valeur());
+    std::mt19937 alea(7);
+    for (size_t n = 1; n <= 4; n++) {
+        for (int essai = 0; essai < 50; essai++) {
+            std::vector<float> v;
+            for (size_t i = 0; i < n; i++) v.push_back((float)(alea() % 1000) / 10);
+            TEST_ASSERT_EQUAL_FLOAT(quantileExact(v, 0.50f), estimer(v, 0.50f));
+            TEST_ASSERT_EQUAL_FLOAT(quantileExact(v, 0.95f), estimer(v, 0.95f));
+        }
+    }
+}
+
+// Exactement cinq échantillons : le marqueur central est la médiane exacte
+static void test_cinq_echantillons()
+{
+    const std::vector<float> v = { 9, 1, 7, 3, 5 };
+    TEST_ASSERT_EQUAL_FLOAT(5, estimer(v, 0.50f));
+}
+
+// Erreur de rang maximale de p50 et p95 sur 10 tirages d'une distribution
+static void erreursMax(Distribution d, size_t n, double &max50, double &max95)
+{
+    max50 = max95 = 0;
+    for (uint32_t graine = 1; graine <= 10; graine++) {
+        const std::vector<float> v = generer(d, n, graine);
+        max50 = std::max(max50, erreurRang(v, 0.50f, estimer(v, 0.50f)));
+        max95 = std::max(max95, erreurRang(v, 0.95f, estimer(v, 0.95f)));
+    }
+    char message[112];
+    snprintf(message, sizeof(message), "%-13s n=%-5u erreur de rang max p50 %.4f p95 %.4f",
+             NOMS_DISTRIBUTION[d], (unsigned)n, max50, max95);
+    TEST_MESSAGE(message);
+}
+
+/**
+ * p50 et p95 contre les quantiles exacts, distributions continues et unimodales. Une fenêtre de
+ * STATISTIQUES_FENETRE_S compte 75 (DHT22) à 300 (SGP30) échantillons : 20 et 100 encadrent ce cas.
+ * Bornes : erreurs mesurées relevées d'un rang, soit 4 rangs sur 20 échantillons, 6 sur 100, et
+ * 1,5 point de rang au-delà de 1000.
+ */
+static void test_precision_quantiles()
+{
+    static const Distribution CONTINUES[] = { UNIFORME, NORMALE, EXPONENTIELLE, CROISSANTE, DECROISSANTE };
+    static const size_t TAILLES[] = { 20, 100, 1000, 10000 };
+    static const double BORNES[] = { 0.20, 0.06, 0.015, 0.015 };
+    for (Distribution d : CONTINUES) {
+        for (size_t i = 0; i < 4; i++) {
+            double max50, max95;
+            erreursMax(d, TAILLES[i], max50, max95);
+            TEST_ASSERT_LESS_OR_EQUAL(BORNES[i], max50);
+            TEST_ASSERT_LESS_OR_EQUAL(BORNES[i], max95);
+        }
+    }
+}
+
+// Fenêtre de 300 s de température à 4 s (75 échantillons) : médiane sous la précision du DHT22 (±0,5 °C)
+static void test_fenetre_temperature()
+{
+    double pire = 0;
+    for (uint32_t graine = 1; graine <= 50; graine++) {
+        const std::vector<float> v = generer(NORMALE, STATISTIQUES_FENETRE_S * 1000 / TEMPHUM_INTERVAL_MS, graine);
+        pire = std::max(pire, (double)fabsf(estimer(v, 0.50f) - quantileExact(v, 0.50f)));
+    }
+    char message[64];
+    snprintf(message, sizeof(message), "ecart max de la mediane : %.3f C", pire);
+    TEST_MESSAGE(message);
+    TEST_ASSERT_LESS_OR_EQUAL(0.5, pire);
+}
+
+/**
+ * Limite connue de P² : valeurs répétées (paliers entiers). L'estimation tombe entre deux paliers,
+ * d'où une erreur de rang élevée, mais l'écart en valeur reste sous un palier.
+ */
+static void test_valeurs_repetees()
+{
+    double max50, max95;
+    erreursMax(PALIERS, 300, max50, max95);
+    for (uint32_t graine = 1; graine <= 10; graine++) {
+        const std::vector<float> v = generer(PALIERS, 300, graine);
+        TEST_ASSERT_FLOAT_WITHIN(1.0f, quantileExact(v, 0.50f), estimer(v, 0.50f));
+        TEST_ASSERT_FLOAT_WITHIN(1.0f, quantileExact(v, 0.95f), estimer(v, 0.95f));
+    }
+}
+
+/**
+ * Limite connue de P² : distribution bimodale (25 % des échantillons 760 unités plus haut). La
+ * médiane estimée est tirée vers le creux entre les modes sur les petites fenêtres ; l'écart reste
+ * sous 5 % de l'écart entre les modes à partir de 100 échantillons et se résorbe ensuite.
+ */
+static void test_bimodale()
+{
+    static const size_t TAILLES[] = { 100, 300, 1000, 10000 };
+    static const float BORNES[] = { 38, 38, 8, 1 };
+    for (size_t i = 0; i < 4; i++) {
+        double max50, max95;
+        erreursMax(BIMODALE, TAILLES[i], max50, max95);
+        for (uint32_t graine = 1; graine <= 10; graine++) {
+            const std::vector<float> v = generer(BIMODALE, TAILLES[i], graine);
+            TEST_ASSERT_FLOAT_WITHIN(BORNES[i], quantileExact(v, 0.50f), estimer(v, 0.50f));
+        }
+    }
+}
+
+// L'estimation reste entre le min et le max, et reinitialiser() repart de zéro
+static void test_bornes_et_reinitialisation()
+{
+    EstimateurP2 e(0.95f);
+    const std::vector<float> v = generer(EXPONENTIELLE, 500, 3);
+    for (float x : v) {
+        e.ajouter(x);
+        TEST_ASSERT_TRUE(e.valeur() >= *std::min_element(v.begin(), v.end()));
+        TEST_ASSERT_TRUE(e.valeur() <= *std::max_element(v.begin(), v.end()));
+    }
+    e.reinitialiser();
+    TEST_ASSERT_EQUAL_FLOAT(0, e.valeur());
+    e.ajouter(12.5f);
+    TEST_ASSERT_EQUAL_FLOAT(12.5f, e.valeur());
+}
+
+// Accumulateur : nombre, extrêmes, moyenne et écart-type de population (Welford) contre le calcul en double
+static void test_accumulateur()
+{
+    const std::vector<float> v = generer(NORMALE, 3600, 11);
+    AccumulateurStatistiques a;
+    double somme = 0;
+    for (float x : v) {
+        a.ajouter(x);
+        somme += x;
+    }
+    const double moyenne = somme / v.size();
+    double carres = 0;
+    for (float x : v) carres += (x - moyenne) * (x - moyenne);
+
+    const StatistiquesFenetre s = a.lire();
+    TEST_ASSERT_EQUAL(3600, s.nombre);
+    TEST_ASSERT_EQUAL_FLOAT(*std::min_element(v.begin(), v.end()), s.min);
+    TEST_ASSERT_EQUAL_FLOAT(*std::max_element(v.begin(), v.end()), s.max);
+    TEST_ASSERT_FLOAT_WITHIN(1e-3f, moyenne, s.moyenne);
+    TEST_ASSERT_FLOAT_WITHIN(1e-3f, sqrt(carres / v.size()), s.ecartType);
+
+    a.reinitialiser();
+    TEST_ASSERT_EQUAL(0, a.lire().nombre);
+    a.ajouter(3);
+    const StatistiquesFenetre un = a.lire();
+    TEST_ASSERT_EQUAL_FLOAT(3, un.min);
+    TEST_ASSERT_EQUAL_FLOAT(3, un.p95);
+    TEST_ASSERT_EQUAL_FLOAT(0, un.ecartType);
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_exact_sous_cinq);
+    RUN_TEST(test_cinq_echantillons);
+    RUN_TEST(test_precision_quantiles);
+    RUN_TEST(test_fenetre_temperature);
+    RUN_TEST(test_valeurs_repetees);
+    RUN_TEST(test_bimodale);
+    RUN_TEST(test_bornes_et_reinitialisation);
+    RUN_TEST(test_accumulateur);
+    return UNITY_END();
+}
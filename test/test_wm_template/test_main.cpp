@@ -0,0 +1,406 @@
+/**
+ * @file test_main.cpp
+ * @brief Tests natifs des gabarits précompilés du portail (WM_Template) : découpage, rendu et banc.
+ *
+ * Le rendu des paramètres et des réseaux du portail est comparé octet par octet à une référence
+ * qui reproduit l'ancien rendu : copie du gabarit puis remplacement de chaque jeton, dans l'ordre
+ * des anciens String::replace de writeParamOut (I, i, n, p, t, l, v, c) et de la liste des réseaux
+ * (V, v, e, r, R, q, i). Les gabarits sont ceux du portail (strings_fr.h).
+ *
+ * Le banc rend une page de 50 paramètres et de 60 réseaux par les deux chemins et compte les
+ * allocations du tas (operator new remplacé) : chiffres hôte, indicatifs pour l'ESP32-S2.
+ */
+
+#include <unity.h>
+#include <chrono>
+#include <new>
+#include <string>
+#include <vector>
+#include "strings_fr.h"
+#include "WM_Template.h"
+
+// Placement du libellé, valeurs de WiFiManager.h (WFM_NO_LABEL, WFM_LABEL_BEFORE, WFM_LABEL_AFTER)
+enum { SANS_LIBELLE = 0, LIBELLE_AVANT = 1, LIBELLE_APRES = 2 };
+
+// Compteur d'allocations du tas pendant les mesures
+static size_t allocations = 0;
+
+void *operator new(size_t taille)
+{
+    allocations++;
+    if (void *p = malloc(taille ? taille : 1)) return p;
+    throw std::bad_alloc();
+}
+void operator delete(void *p) noexcept { free(p); }
+void operator delete(void *p, size_t) noexcept { free(p); }
+
+struct Parametre {
+    const char *id;          // NULL : seul le HTML personnalisé est écrit
+    const char *libelle;
+    std::string valeur;
+    int longueur;
+    int placement;
+    const char *personnalise;
+};
+
+struct Reseau {
+    std::string ssidTexte;   // SSID déjà passé par htmlEntities
+    std::string ssidAttribut;
+    int rssi;
+    bool ouvert;
+    const char *chiffrement;
+};
+
+// Remplace toutes les occurrences, comme String::replace
+static void remplacer(std::string &texte, const char *jeton, const std::string &valeur)
+{
+    const size_t l = strlen(jeton);
+    for (size_t i = texte.find(jeton); i != std::string::npos; i = texte.find(jeton, i + valeur.size())) {
+        texte.replace(i, l, valeur);
+    }
+}
+
+static int qualite(int rssi)
+{
+    return rssi <= -100 ? 0 : rssi >= -50 ? 100 : 2 * (rssi + 100);
+}
+
+// Gabarit d'un réseau, composé comme dans la liste des réseaux du portail
+static std::string gabaritReseau(bool options)
+{
+    std::string item = HTTP_ITEM;
+    remplacer(item, "{qp}", HTTP_ITEM_QP);
+    remplacer(item, "{h}", options ? "" : "h");
+    remplacer(item, "{qi}", HTTP_ITEM_QI);
+    remplacer(item, "{h}", options ? "h" : "");
+    return item;
+}
+
+// Ancien rendu des paramètres : une copie du gabarit et un remplacement par jeton
+static void rendreParametresReference(const std::vector<Parametre> &parametres, std::string &sortie)
+{
+    for (size_t i = 0; i < parametres.size(); i++) {
+        const Parametre &p = parametres[i];
+        if (p.id == NULL) {
+            sortie += p.personnalise ? p.personnalise : "";
+            continue;
+        }
+        std::string item;
+        switch (p.placement) {
+        case LIBELLE_AVANT: item = std::string(HTTP_FORM_LABEL) + HTTP_FORM_PARAM; break;
+        case LIBELLE_APRES: item = std::string(HTTP_FORM_PARAM) + HTTP_FORM_LABEL; break;
+        default:            item = HTTP_FORM_PARAM; break;
+        }
+        remplacer(item, T_I, std::string(S_parampre) + std::to_string(i));
+        remplacer(item, T_i, p.id);
+        remplacer(item, T_n, p.id);
+        remplacer(item, T_p, T_t);
+        remplacer(item, T_t, p.libelle ? p.libelle : "");
+        remplacer(item, T_l, std::to_string(p.longueur));
+        remplacer(item, T_v, p.valeur);
+        remplacer(item, T_c, p.personnalise ? p.personnalise : "");
+        sortie += item;
+    }
+}
+
+// Nouveau rendu des paramètres, comme writeParamOut : un gabarit recompilé au changement de placement
+static void rendreParametres(const std::vector<Parametre> &parametres, std::string &sortie)
+{
+    const auto ecrire = [&](const char *texte, size_t longueur) { sortie.append(texte, longueur); };
+    WM_Template gabarit;
+    int placement = -1;
+    char idNum[16];
+    char longueurValeur[5];
+    for (size_t i = 0; i < parametres.size(); i++) {
+        const Parametre &p = parametres[i];
+        if (p.id == NULL) {
+            if (p.personnalise) sortie += p.personnalise;
+            continue;
+        }
+        if (p.placement != placement) {
+            placement = p.placement;
+            gabarit.clear();
+            switch (placement) {
+            case LIBELLE_AVANT: gabarit.append(HTTP_FORM_LABEL); gabarit.append(HTTP_FORM_PARAM); break;
+            case LIBELLE_APRES: gabarit.append(HTTP_FORM_PARAM); gabarit.append(HTTP_FORM_LABEL); break;
+            default:            gabarit.append(HTTP_FORM_PARAM); break;
+            }
+        }
+        snprintf(idNum, sizeof(idNum), "%s%u", S_parampre, (unsigned)i);
+        snprintf(longueurValeur, sizeof(longueurValeur), "%d", p.longueur);
+        gabarit.render(ecrire, [&](char jeton) -> const char * {
+            const char *v;
+            switch (jeton) {
+            case 'I': return idNum;
+            case 'i':
+            case 'n': return p.id;
+            case 'p':
+            case 't': v = p.libelle; break;
+            case 'l': return longueurValeur;
+            case 'v': v = p.valeur.c_str(); break;
+            case 'c': v = p.personnalise; break;
+            default:  return NULL;
+            }
+            return v != NULL ? v : "";
+        });
+    }
+}
+
+// Ancien rendu de la liste des réseaux
+static void rendreReseauxReference(const std::vector<Reseau> &reseaux, bool options, std::string &sortie)
+{
+    const std::string gabarit = gabaritReseau(options);
+    for (const Reseau &r : reseaux) {
+        const int pourcent = qualite(r.rssi);
+        std::string item = gabarit;
+        remplacer(item, T_V, r.ssidTexte);
+        remplacer(item, T_v, r.ssidAttribut);
+        remplacer(item, T_e, r.chiffrement);
+        remplacer(item, T_r, std::to_string(pourcent));
+        remplacer(item, T_R, std::to_string(r.rssi));
+        remplacer(item, T_q, std::to_string((int)round(pourcent * 3 / 100.0 + 1)));
+        remplacer(item, T_i, r.ouvert ? "" : "l");
+        sortie += item;
+    }
+}
+
+// Nouveau rendu : gabarit compilé une fois par page, valeurs formatées dans des tampons de pile
+static void rendreReseaux(const std::vector<Reseau> &reseaux, const std::string &composition, std::string &sortie)
+{
+    const auto ecrire = [&](const char *texte, size_t longueur) { sortie.append(texte, longueur); };
+    WM_Template gabarit;
+    gabarit.append(composition.c_str());
+    for (const Reseau &r : reseaux) {
+        const int pourcent = qualite(r.rssi);
+        char perc[5], rssi[5], qual[2];
+        snprintf(perc, sizeof(perc), "%d", pourcent);
+        snprintf(rssi, sizeof(rssi), "%d", r.rssi);
+        snprintf(qual, sizeof(qual), "%d", (int)round(pourcent * 3 / 100.0 + 1));
+        gabarit.render(ecrire, [&](char jeton) -> const char * {
+            switch (jeton) {
+            case 'V': return r.ssidTexte.c_str();
+            case 'v': return r.ssidAttribut.c_str();
+            case 'e': return r.chiffrement;
+            case 'r': return perc;
+            case 'R': return rssi;
+            case 'q': return qual;
+            case 'i': return r.ouvert ? "" : "l";
+            default:  return NULL;
+            }
+        });
+    }
+}
+
+// 50 paramètres : trois placements mélangés, libellés et attributs absents, HTML seul, valeurs vides
+static std::vector<Parametre> genererParametres()
+{
+    static const char *const ATTRIBUTS[] = { NULL, "", "type='checkbox'", "placeholder='ex : 192.168.1.20'" };
+    static std::vector<std::string> ids, libelles;
+    ids.clear();
+    libelles.clear();
+    for (int i = 0; i < 50; i++) {
+        ids.push_back("champ_" + std::to_string(i));
+        libelles.push_back("Réglage n°" + std::to_string(i) + " (unité)");
+    }
+    std::vector<Parametre> v;
+    for (int i = 0; i < 50; i++) {
+        Parametre p;
+        p.id = i % 11 == 10 ? NULL : ids[i].c_str();
+        p.libelle = i % 7 == 3 ? NULL : libelles[i].c_str();
+        p.valeur = i % 5 == 0 ? "" : std::string(i % 40 + 1, 'a' + i % 26) + " & 'x'";
+        p.longueur = i % 3 == 0 ? 40 : 1000 + i;
+        p.placement = (i / 3) % 3;   // Séries de placements identiques, comme dans un portail réel
+        p.personnalise = i % 11 == 10 ? "<hr><p>Section</p>" : ATTRIBUTS[i % 4];
+        v.push_back(p);
+    }
+    return v;
+}
+
+// 60 réseaux : RSSI de -30 à -100 dBm, ouverts ou chiffrés, SSID avec entités et longueurs variées
+static std::vector<Reseau> genererReseaux()
+{
+    static const char *const CHIFFREMENTS[] = { "", "WPA2", "WPA/WPA2", "WPA3", "WEP" };
+    std::vector<Reseau> v;
+    for (int i = 0; i < 60; i++) {
+        Reseau r;
+        r.ssidTexte = "Salle &amp; labo " + std::to_string(i) + std::string(i % 17, '-');
+        r.ssidAttribut = "Salle &amp; labo &#39;" + std::to_string(i) + "&#39;" + std::string(i % 17, '-');
+        r.rssi = -30 - (i * 70) / 59;
+        r.ouvert = i % 4 == 0;
+        r.chiffrement = CHIFFREMENTS[r.ouvert ? 0 : 1 + i % 4];
+        v.push_back(r);
+    }
+    return v;
+}
+
+void setUp() {}
+void tearDown() {}
+
+// Rendu d'un gabarit dans une chaîne
+static std::string rendre(const WM_Template &t, const char *(*valeur)(char))
+{
+    std::string sortie;
+    t.render([&](const char *texte, size_t longueur) { sortie.append(texte, longueur); }, valeur);
+    return sortie;
+}
+
+// Valeur de test : "[x]" pour le jeton x
+static const char *crochets(char jeton)
+{
+    static char v[4];
+    snprintf(v, sizeof(v), "[%c]", jeton);
+    return v;
+}
+
+// Découpage en parties : littéraux, jetons, accolades doublées et textes enchaînés
+static void test_decoupage()
+{
+    WM_Template t;
+    t.append("a{x}bc{{y}}{z}");
+    TEST_ASSERT_EQUAL(6, t.count());
+    TEST_ASSERT_EQUAL(0, t.part(0).token);
+    TEST_ASSERT_EQUAL(1, t.part(0).length);
+    TEST_ASSERT_EQUAL('x', t.part(1).token);
+    TEST_ASSERT_EQUAL(3, t.part(1).length);
+    TEST_ASSERT_EQUAL_MEMORY("{x}", t.part(1).str, 3);
+    TEST_ASSERT_EQUAL_STRING("a[x]bc{[y]}[z]", rendre(t, crochets).c_str());   // Comme replace("{y}")
+    TEST_ASSERT_TRUE(t.has('z'));
+    TEST_ASSERT_FALSE(t.has('a'));
+
+    t.append("{}{{}}{{");   // Pas de jeton : une seule partie littérale
+    TEST_ASSERT_EQUAL(7, t.count());
+    TEST_ASSERT_EQUAL_STRING("a[x]bc{[y]}[z]{}{{}}{{", rendre(t, crochets).c_str());
+
+    t.clear();
+    TEST_ASSERT_EQUAL(0, t.count());
+    t.append("");
+    TEST_ASSERT_EQUAL(0, t.count());
+    t.append("{a}");
+    TEST_ASSERT_EQUAL(1, t.count());
+    TEST_ASSERT_EQUAL_STRING("[a]", rendre(t, crochets).c_str());
+}
+
+// Jeton sans valeur (NULL) : le texte du jeton est conservé
+static void test_jeton_inconnu_conserve()
+{
+    WM_Template t;
+    t.append("<{a}|{b}|{{c}}>");
+    const std::string s = rendre(t, [](char jeton) -> const char * { return jeton == 'a' ? "A" : NULL; });
+    TEST_ASSERT_EQUAL_STRING("<A|{b}|{{c}}>", s.c_str());
+}
+
+/**
+ * Table de parties presque pleine : le reste du texte est écrit tel quel, sans perte. Chaque jeton
+ * précédé d'un littéral prend deux parties ; le découpage s'arrête quand trois ne tiennent plus.
+ */
+static void test_table_pleine()
+{
+    std::string texte;
+    for (int i = 0; i < WM_TEMPLATE_PARTS; i++) texte += "-{a}";
+    WM_Template t;
+    t.append(texte.c_str());
+    TEST_ASSERT_EQUAL(WM_TEMPLATE_PARTS - 1, t.count());
+
+    const int remplaces = (WM_TEMPLATE_PARTS - 1) / 2;
+    std::string attendu;
+    for (int i = 0; i < WM_TEMPLATE_PARTS; i++) attendu += i < remplaces ? "-A" : "-{a}";
+    TEST_ASSERT_EQUAL_STRING(attendu.c_str(), rendre(t, [](char) -> const char * { return "A"; }).c_str());
+
+    t.append("{b}");   // Table pleine : le texte ajouté est ignoré
+    TEST_ASSERT_EQUAL(WM_TEMPLATE_PARTS, t.count());
+    t.append("{c}");
+    TEST_ASSERT_EQUAL(WM_TEMPLATE_PARTS, t.count());
+}
+
+// Différence voulue avec l'ancien rendu : une valeur contenant un jeton est écrite telle quelle
+static void test_valeur_non_interpretee()
+{
+    std::vector<Parametre> v = { { "id", "{c}", "{v}{I}", 10, LIBELLE_AVANT, "x" } };
+    std::string nouveau;
+    rendreParametres(v, nouveau);
+    TEST_ASSERT_EQUAL_STRING("<label for='id'>{c}</label><br/><input id='id' name='id' maxlength='10' value='{v}{I}' x>\n",
+                             nouveau.c_str());
+}
+
+// 50 paramètres : sortie octet pour octet identique à l'ancien rendu
+static void test_parametres_identiques()
+{
+    const std::vector<Parametre> v = genererParametres();
+    std::string reference, nouveau;
+    rendreParametresReference(v, reference);
+    rendreParametres(v, nouveau);
+    TEST_ASSERT_TRUE(reference.size() > 5000);
+    TEST_ASSERT_EQUAL(reference.size(), nouveau.size());
+    TEST_ASSERT_EQUAL_STRING(reference.c_str(), nouveau.c_str());
+}
+
+// 60 réseaux, icônes et pourcentages affichés ou masqués : sortie identique à l'ancien rendu
+static void test_reseaux_identiques()
+{
+    const std::vector<Reseau> v = genererReseaux();
+    for (bool options : { false, true }) {
+        std::string reference, nouveau;
+        rendreReseauxReference(v, options, reference);
+        rendreReseaux(v, gabaritReseau(options), nouveau);
+        TEST_ASSERT_EQUAL(reference.size(), nouveau.size());
+        TEST_ASSERT_EQUAL_STRING(reference.c_str(), nouveau.c_str());
+    }
+}
+
+// Durée moyenne (µs) et allocations par rendu d'une page
+template <typename Rendu>
+static void mesurer(Rendu rendu, double &us, double &allocs)
+{
+    const int TOURS = 200;
+    std::string sortie;
+    sortie.reserve(64 * 1024);   // Le flux du serveur web n'alloue pas par écriture
+    allocations = 0;
+    const auto debut = std::chrono::steady_clock::now();
+    for (int i = 0; i < TOURS; i++) {
+        sortie.clear();
+        rendu(sortie);
+    }
+    const auto fin = std::chrono::steady_clock::now();
+    us = std::chrono::duration<double, std::micro>(fin - debut).count() / TOURS;
+    allocs = (double)allocations / TOURS;
+}
+
+/**
+ * Banc : 50 paramètres et 60 réseaux par l'ancien et le nouveau rendu. Le nouveau n'alloue rien
+ * par élément ; la durée est affichée, pas vérifiée (hôte et options de compilation variables).
+ */
+static void test_banc()
+{
+    const std::vector<Parametre> parametres = genererParametres();
+    const std::vector<Reseau> reseaux = genererReseaux();
+    const std::string composition = gabaritReseau(true);
+    double us[4], allocs[4];
+    mesurer([&](std::string &s) { rendreParametresReference(parametres, s); }, us[0], allocs[0]);
+    mesurer([&](std::string &s) { rendreParametres(parametres, s); }, us[1], allocs[1]);
+    mesurer([&](std::string &s) { rendreReseauxReference(reseaux, true, s); }, us[2], allocs[2]);
+    mesurer([&](std::string &s) { rendreReseaux(reseaux, composition, s); }, us[3], allocs[3]);
+
+    char message[128];
+    snprintf(message, sizeof(message), "50 parametres : replace %.1f us, %.0f allocations ; gabarit %.1f us, %.0f allocations",
+             us[0], allocs[0], us[1], allocs[1]);
+    TEST_MESSAGE(message);
+    snprintf(message, sizeof(message), "60 reseaux    : replace %.1f us, %.0f allocations ; gabarit %.1f us, %.0f allocations",
+             us[2], allocs[2], us[3], allocs[3]);
+    TEST_MESSAGE(message);
+    TEST_ASSERT_EQUAL_FLOAT(0, allocs[1]);
+    TEST_ASSERT_EQUAL_FLOAT(0, allocs[3]);
+    TEST_ASSERT_TRUE(allocs[0] >= 50 && allocs[2] >= 60);
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_decoupage);
+    RUN_TEST(test_jeton_inconnu_conserve);
+    RUN_TEST(test_table_pleine);
+    RUN_TEST(test_valeur_non_interpretee);
+    RUN_TEST(test_parametres_identiques);
+    RUN_TEST(test_reseaux_identiques);
+    RUN_TEST(test_banc);
+    return UNITY_END();
+}